@@ -2,6 +2,7 @@
 #
 # VULKAN_INCLUDE_DIR
 # VULKAN_LIBRARY
+# VULKAN_GLSLANG_VALIDATOR
 # VULKAN_FOUND
 
 if (WIN32)
@@ -41,7 +42,13 @@ else()
         "$ENV{VULKAN_SDK}/lib")
 endif()
 
+# Shader compiler
+find_program(VULKAN_GLSLANG_VALIDATOR NAMES glslangValidator HINTS
+    "$ENV{VULKAN_SDK}/Bin"
+    "$ENV{VULKAN_SDK}/bin"
+    "$ENV{VK_SDK_PATH}/Bin")
+
 include(FindPackageHandleStandardArgs)
 find_package_handle_standard_args(Vulkan DEFAULT_MSG VULKAN_LIBRARY VULKAN_INCLUDE_DIR)
 
-mark_as_advanced(VULKAN_INCLUDE_DIR VULKAN_LIBRARY VULKAN_STATIC_LIBRARY)
+mark_as_advanced(VULKAN_INCLUDE_DIR VULKAN_LIBRARY VULKAN_STATIC_LIBRARY VULKAN_GLSLANG_VALIDATOR)
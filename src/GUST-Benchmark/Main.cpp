@@ -0,0 +1,389 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <Engine.hpp>
+#include <Transform.hpp>
+#include <MeshRenderer.hpp>
+#include <Camera.hpp>
+#include <Lights.hpp>
+#include <Clock.hpp>
+#include <Threading.hpp>
+#include <ObjLoader.hpp>
+#include <GMesh.hpp>
+
+/**
+ * @def GUST_BENCHMARK_GRID_SIZE
+ * @brief Number of quads along each side of the synthetic grid (About a million vertices.)
+ */
+#define GUST_BENCHMARK_GRID_SIZE 1000
+
+/**
+ * @def GUST_BENCHMARK_STRESS_RENDERERS
+ * @brief Number of mesh renderers the stress test creates.
+ */
+#define GUST_BENCHMARK_STRESS_RENDERERS 100000
+
+/**
+ * @def GUST_BENCHMARK_STRESS_FRAMES
+ * @brief Number of frames the stress test renders before checking memory.
+ */
+#define GUST_BENCHMARK_STRESS_FRAMES 300
+
+/**
+ * @struct StressData
+ * @brief Fragment data of the standard shader.
+ */
+struct StressData
+{
+	/** UV scale. */
+	glm::vec2 uv = { 1.0f, 1.0f };
+};
+
+/** Number of failed checks. */
+static size_t failedChecks = 0;
+
+/**
+ * @brief Report a check that failed.
+ * @param Condition that must hold.
+ * @param What was checked.
+ * @note Unlike gAssert, checks are made in release builds too.
+ */
+static void check(bool condition, const std::string& description)
+{
+	if (!condition)
+	{
+		std::cerr << "Check failed: " << description << '\n';
+		++failedChecks;
+	}
+}
+
+/**
+ * @brief Get the directory to write temporary files to.
+ * @return Temporary directory.
+ */
+static std::string getTempDirectory()
+{
+	for (const char* name : { "TMPDIR", "TEMP", "TMP" })
+		if (const char* directory = std::getenv(name))
+			return directory;
+
+	return ".";
+}
+
+/**
+ * @brief Calculate tangents one triangle at a time (The implementation from before tangents were vectorized.)
+ * @param Vertices.
+ * @param Triangle indices.
+ */
+static void calculateReferenceTangents(std::vector<gust::Vertex>& vertices, const std::vector<uint32_t>& indices)
+{
+	for (gust::Vertex& vertex : vertices)
+		vertex.tangent = glm::vec3();
+
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		gust::Vertex& v0 = vertices[indices[i]];
+		gust::Vertex& v1 = vertices[indices[i + 1]];
+		gust::Vertex& v2 = vertices[indices[i + 2]];
+
+		const auto edge1 = v1.position - v0.position;
+		const auto edge2 = v2.position - v0.position;
+
+		const auto deltaU1 = v1.uv.x - v0.uv.x;
+		const auto deltaV1 = v1.uv.y - v0.uv.y;
+		const auto deltaU2 = v2.uv.x - v0.uv.x;
+		const auto deltaV2 = v2.uv.y - v0.uv.y;
+
+		const auto f = 1.0f / (deltaU1 * deltaV2 - deltaU2 * deltaV1);
+
+		glm::vec3 tangent = glm::vec3();
+
+		tangent.x = f * (deltaV2 * edge1.x - deltaV1 * edge2.x);
+		tangent.y = f * (deltaV2 * edge1.y - deltaV1 * edge2.y);
+		tangent.z = f * (deltaV2 * edge1.z - deltaV1 * edge2.z);
+
+		v0.tangent += tangent;
+		v1.tangent += tangent;
+		v2.tangent += tangent;
+	}
+
+	for (gust::Vertex& vertex : vertices)
+		vertex.tangent = glm::normalize(vertex.tangent);
+}
+
+/**
+ * @brief Check if two sets of tangents match.
+ * @param Tangents to check.
+ * @param Reference tangents.
+ * @return If every tangent is within rounding error of the reference (Degenerate UVs must give NaNs in both.)
+ */
+static bool tangentsMatch(const std::vector<gust::Vertex>& vertices, const std::vector<gust::Vertex>& reference)
+{
+	if (vertices.size() != reference.size())
+		return false;
+
+	for (size_t i = 0; i < vertices.size(); ++i)
+		for (glm::length_t j = 0; j < 3; ++j)
+		{
+			const float value = vertices[i].tangent[j];
+			const float expected = reference[i].tangent[j];
+
+			if (value != expected && !(std::isnan(value) && std::isnan(expected)) && !(std::abs(value - expected) <= 1e-5f))
+				return false;
+		}
+
+	return true;
+}
+
+/**
+ * @brief Write a grid of quads with UVs and a shared normal to an OBJ file.
+ * @param Path to file.
+ * @param Number of quads along each side.
+ */
+static void writeGrid(const std::string& path, size_t gridSize)
+{
+	std::ofstream stream(path);
+
+	for (size_t y = 0; y <= gridSize; ++y)
+		for (size_t x = 0; x <= gridSize; ++x)
+			stream << "v " << x << " 0 " << y << "\nvt " << (float)x / gridSize << ' ' << (float)y / gridSize << '\n';
+
+	stream << "vn 0 1 0\n";
+
+	// OBJ indices start at 1
+	for (size_t y = 0; y < gridSize; ++y)
+		for (size_t x = 0; x < gridSize; ++x)
+		{
+			const size_t a = y * (gridSize + 1) + x + 1;
+			const size_t b = a + 1;
+			const size_t c = a + gridSize + 1;
+			const size_t d = c + 1;
+
+			stream << "f " << a << '/' << a << "/1 " << c << '/' << c << "/1 " << b << '/' << b << "/1\n";
+			stream << "f " << b << '/' << b << "/1 " << c << '/' << c << "/1 " << d << '/' << d << "/1\n";
+		}
+}
+
+/**
+ * @brief Time OBJ and cooked mesh loading, tangents and meshlets for a mesh.
+ * @param Path to an OBJ file.
+ * @param Directory to cook the mesh into.
+ * @param Thread pool.
+ */
+static void benchmarkMesh(const std::string& path, const std::string& tempDirectory, gust::ThreadPool& threadPool)
+{
+	std::vector<gust::Vertex> vertices = {};
+	std::vector<uint32_t> indices = {};
+
+	gust::Clock clock = {};
+	check(gust::loadOBJ(path, vertices, indices), path + " loads");
+
+	std::cout <<
+		path << ": " << indices.size() / 3 << " triangles, " << vertices.size() << " vertices loaded in " <<
+		clock.getElapsedTime() << "s\n";
+
+	// Same file parsed on every worker (Must give the same vertices and indices)
+	std::vector<gust::Vertex> parallelVertices = {};
+	std::vector<uint32_t> parallelIndices = {};
+
+	gust::Clock parallelClock = {};
+	check(gust::loadOBJ(path, parallelVertices, parallelIndices, &threadPool), path + " loads on the thread pool");
+
+	std::cout <<
+		path << ": loaded in " << parallelClock.getElapsedTime() << "s on " << threadPool.getWorkerCount() << " threads\n";
+
+	check(parallelVertices == vertices, path + " has the same vertices when parsed on the thread pool");
+	check(parallelIndices == indices, path + " has the same indices when parsed on the thread pool");
+
+	// Tangents on the calling thread and on every worker (Both must match the old implementation)
+	std::vector<gust::Vertex> referenceVertices = vertices;
+	calculateReferenceTangents(referenceVertices, indices);
+
+	std::vector<gust::Vertex> serialVertices = vertices;
+
+	gust::Clock tangentClock = {};
+	gust::calculateTangents(serialVertices, indices);
+	const float serialTangentTime = tangentClock.getElapsedTime();
+
+	gust::Clock parallelTangentClock = {};
+	gust::calculateTangents(vertices, indices, &threadPool);
+
+	std::cout <<
+		path << ": tangents in " << serialTangentTime << "s, " << parallelTangentClock.getElapsedTime() <<
+		"s on " << threadPool.getWorkerCount() << " threads\n";
+
+	check(tangentsMatch(serialVertices, referenceVertices), path + " has the same tangents as the reference implementation");
+	check(tangentsMatch(vertices, referenceVertices), path + " has the same tangents as the reference implementation on the thread pool");
+
+	// Meshlets for culling a cluster at a time
+	gust::Clock meshletClock = {};
+	const std::vector<gust::Meshlet> meshlets = gust::buildMeshlets(vertices, indices);
+
+	std::cout <<
+		path << ": " << meshlets.size() << " meshlets built in " << meshletClock.getElapsedTime() << "s\n";
+
+	// Cook the mesh and time reading it back
+	const std::string name = path.substr(path.find_last_of("/\\") + 1);
+	const std::string cookedPath = tempDirectory + "/" + name.substr(0, name.size() - 4) + GUST_GMESH_EXTENSION;
+	check(gust::writeGMesh(cookedPath, { { vertices, indices } }), cookedPath + " is written");
+
+	gust::Clock cookedClock = {};
+	const gust::GMeshFile file(cookedPath);
+	check(file.isValid(), cookedPath + " is valid");
+
+	if (file.isValid())
+	{
+		std::vector<gust::Vertex> cookedVertices(file.getVertices(0), file.getVertices(0) + file.getLevel(0).vertexCount);
+
+		std::cout <<
+			cookedPath << ": " << cookedVertices.size() << " vertices loaded in " <<
+			cookedClock.getElapsedTime() << "s\n";
+	}
+
+	std::remove(cookedPath.c_str());
+}
+
+/**
+ * @brief Time mesh loading for the bundled meshes and a synthetic grid.
+ * @note Files are written to the temporary directory and removed afterwards.
+ */
+static void runLoadBenchmark()
+{
+	const std::string tempDirectory = getTempDirectory();
+	const std::string gridPath = tempDirectory + "/GUST-Benchmark.obj";
+	writeGrid(gridPath, GUST_BENCHMARK_GRID_SIZE);
+
+	gust::ThreadPool threadPool(std::max(std::thread::hardware_concurrency(), 1u));
+
+	for (const std::string& path :
+	{
+		std::string(GUST_BENCHMARK_MESH_DIR "/Cube.obj"),
+		std::string(GUST_BENCHMARK_MESH_DIR "/Sphere.obj"),
+		std::string(GUST_BENCHMARK_MESH_DIR "/CapsuleWall.obj"),
+		std::string(GUST_BENCHMARK_MESH_DIR "/Skybox.obj"),
+		gridPath
+	})
+		benchmarkMesh(path, tempDirectory, threadPool);
+
+	std::remove(gridPath.c_str());
+}
+
+/**
+ * @brief Draw a large number of mesh renderers, each with its own material (Two uniform buffers apiece.)
+ * @note Shaders, meshes and textures are loaded from the working directory, so run from where GUST-Testing runs.
+ * @note Runs for GUST_BENCHMARK_STRESS_FRAMES frames (Or until the window is closed) and then checks memory.
+ */
+static void runStressTest()
+{
+	gust::startup("GUST Stress Test", 1280, 720);
+
+	gust::scene.addSystem<gust::TransformSystem>();
+	gust::scene.addSystem<gust::DirectionalLightSystem>();
+	gust::scene.addSystem<gust::MeshRendererSystem>();
+	gust::scene.addSystem<gust::CameraSystem>();
+
+	// Standard shader (Bindless shaders read textures and material data from the descriptor heap)
+	const bool bindless = gust::graphics.isBindless();
+
+	gust::ShaderDescription description = {};
+	description.vertexPath = bindless ? "./Shaders/standard_bindless" GUST_VERTEX_SHADER_SUFFIX : "./Shaders/standard" GUST_VERTEX_SHADER_SUFFIX;
+	description.fragmentPath = bindless ? "./Shaders/standard_bindless-frag.spv" : "./Shaders/standard-frag.spv";
+	description.vertexDataSize = sizeof(gust::EmptyVertexData);
+	description.fragmentDataSize = sizeof(StressData);
+	description.textureCount = 5;
+	description.instancedVertexPath = bindless ? "" : "./Shaders/standard_instanced" GUST_VERTEX_SHADER_SUFFIX;
+
+	auto shader = gust::resourceManager.createShaders({ description })[0];
+	auto white = gust::resourceManager.createTexture("./Textures/White.png", vk::Filter::eNearest);
+	auto cube = gust::resourceManager.createMesh("./Meshes/Cube.gmesh");
+	check(cube != gust::Handle<gust::Mesh>::nullHandle(), "./Meshes/Cube.gmesh loads");
+
+	for (size_t i = 0; i < GUST_BENCHMARK_STRESS_RENDERERS; ++i)
+	{
+		auto entity = gust::Entity(&gust::scene);
+
+		auto transform = entity.getComponent<gust::Transform>();
+		transform->setPosition({ static_cast<float>(i % 316) * 2.0f - 316.0f, -8, static_cast<float>(i / 316) * 2.0f - 316.0f });
+
+		auto material = gust::resourceManager.createMaterial(shader);
+		material->setFragmentData<StressData>(StressData());
+
+		for (size_t j = 0; j < 5; ++j)
+			material->setTexture(white, j);
+
+		auto meshRenderer = entity.addComponent<gust::MeshRenderer>();
+		meshRenderer->setMaterial(material);
+		meshRenderer->setMesh(cube);
+	}
+
+	// Camera above the grid looking down
+	{
+		auto entity = gust::Entity(&gust::scene);
+
+		auto transform = entity.getComponent<gust::Transform>();
+		transform->setPosition({ 0, 32, 0 });
+		transform->setEulerAngles({ 60, 0, 0 });
+
+		auto camera = entity.addComponent<gust::Camera>();
+		gust::Camera::setMainCamera(camera);
+	}
+
+	// Sun
+	{
+		auto entity = gust::Entity(&gust::scene);
+
+		auto transform = entity.getComponent<gust::Transform>();
+		transform->setEulerAngles({ 35, 240, 0 });
+
+		auto light = entity.addComponent<gust::DirectionalLight>();
+		light->setIntensity(10.0f);
+	}
+
+	// Render long enough for every frames per draw data and pipelines to be allocated
+	gust::simulate(GUST_BENCHMARK_STRESS_FRAMES);
+
+	// Suballocation keeps the number of driver allocations far below the limit
+	const auto stats = gust::graphics.getMemoryStats();
+	const auto limit = gust::graphics.getPhysicalDevice().getProperties().limits.maxMemoryAllocationCount;
+
+	std::cout <<
+		"Memory: " << stats.allocationCount << " allocations in " << stats.blockCount << " blocks (Limit " << limit << "), " <<
+		stats.usedBytes << " bytes used, " << stats.unusedBytes << " bytes unused, " <<
+		stats.uniformPoolAllocationCount << " small uniform buffers in " << stats.uniformPoolSize << " bytes\n";
+
+	check(stats.blockCount < limit, "Memory blocks stay below the allocation limit");
+
+	gust::shutdown();
+}
+
+/**
+ * @brief Run a benchmark.
+ * @note Usage: GUST-Benchmark [load|stress]
+ * @return Zero if every check passed.
+ */
+int main(int argc, char** argv)
+{
+	const std::string mode = argc > 1 ? argv[1] : "load";
+
+	if (mode == "load")
+		runLoadBenchmark();
+	else if (mode == "stress")
+		runStressTest();
+	else
+	{
+		std::cerr << "Usage: " << argv[0] << " [load|stress]\n";
+		return 1;
+	}
+
+	if (failedChecks > 0)
+	{
+		std::cerr << failedChecks << " checks failed.\n";
+		return 1;
+	}
+
+	return 0;
+}
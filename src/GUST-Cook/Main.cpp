@@ -0,0 +1,76 @@
+#include <iostream>
+#include <string>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <Threading.hpp>
+#include <ObjLoader.hpp>
+#include <MeshOptimizer.hpp>
+#include <MeshSimplifier.hpp>
+#include <GMesh.hpp>
+
+/**
+ * @brief Cook an OBJ file into a GMesh file.
+ * @note Usage: GUST-Cook <input.obj> <output.gmesh> [level count] [ratio] [max error]
+ */
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <input.obj> <output" << GUST_GMESH_EXTENSION << "> [level count] [ratio] [max error]\n";
+		return 1;
+	}
+
+	const std::string input = argv[1];
+	const std::string output = argv[2];
+	const size_t levelCount = argc > 3 ? std::stoul(argv[3]) : 1;
+	const float ratio = argc > 4 ? std::stof(argv[4]) : 0.5f;
+	const float maxError = argc > 5 ? std::stof(argv[5]) : std::numeric_limits<float>::max();
+
+	try
+	{
+		std::vector<gust::GMeshLevel> levels(1);
+		gust::ThreadPool threadPool(std::max(std::thread::hardware_concurrency(), 1u));
+
+		// Everything the runtime would otherwise do at load
+		if (!gust::loadOBJ(input, levels[0].vertices, levels[0].indices, &threadPool))
+			return 1;
+
+		levels[0].optimizationStats = gust::optimizeMesh(levels[0].vertices, levels[0].indices);
+		gust::calculateTangents(levels[0].vertices, levels[0].indices, &threadPool);
+
+		// Simplify each level from the previous one (Collapsed vertices keep their tangents)
+		while (levels.size() < levelCount)
+		{
+			const gust::GMeshLevel& previous = levels.back();
+			const size_t target = static_cast<size_t>((previous.indices.size() / 3) * ratio) * 3;
+			gust::SimplifiedMesh simplified = gust::simplifyMesh(previous.vertices, previous.indices, target, maxError);
+
+			// Not worth another level
+			if (simplified.indices.empty() || simplified.indices.size() >= previous.indices.size() * 9 / 10)
+				break;
+
+			gust::GMeshLevel level = {};
+			level.vertices = std::move(simplified.vertices);
+			level.indices = std::move(simplified.indices);
+			level.error = simplified.error;
+			level.optimizationStats = gust::optimizeMesh(level.vertices, level.indices);
+			levels.push_back(std::move(level));
+		}
+
+		if (!gust::writeGMesh(output, levels))
+			return 1;
+
+		for (size_t i = 0; i < levels.size(); ++i)
+			std::cout <<
+				output << " level " << i << ": " << levels[i].indices.size() / 3 << " triangles, " <<
+				levels[i].vertices.size() << " vertices, ACMR " << levels[i].optimizationStats.acmrAfter << '\n';
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << input << ": " << e.what() << '\n';
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cmath>
+#include "Bounds.hpp"
+
+namespace gust
+{
+	AABB AABB::transform(const glm::mat4& matrix) const
+	{
+		// Transform the center and project the extents onto each axis
+		const glm::vec3 center = glm::vec3(matrix * glm::vec4(getCenter(), 1.0f));
+		const glm::vec3 extents = getExtents();
+
+		glm::vec3 newExtents = {};
+		for (int i = 0; i < 3; ++i)
+			newExtents[i] =
+				std::abs(matrix[0][i]) * extents.x +
+				std::abs(matrix[1][i]) * extents.y +
+				std::abs(matrix[2][i]) * extents.z;
+
+		AABB box = {};
+		box.min = center - newExtents;
+		box.max = center + newExtents;
+		return box;
+	}
+
+	BoundingSphere BoundingSphere::transform(const glm::mat4& matrix) const
+	{
+		const float scaleX = glm::dot(glm::vec3(matrix[0]), glm::vec3(matrix[0]));
+		const float scaleY = glm::dot(glm::vec3(matrix[1]), glm::vec3(matrix[1]));
+		const float scaleZ = glm::dot(glm::vec3(matrix[2]), glm::vec3(matrix[2]));
+
+		BoundingSphere sphere = {};
+		sphere.center = glm::vec3(matrix * glm::vec4(center, 1.0f));
+		sphere.radius = radius * std::sqrt(std::max(scaleX, std::max(scaleY, scaleZ)));
+		return sphere;
+	}
+
+	Bounds Bounds::fromPoints(const glm::vec3* points, size_t count, size_t stride)
+	{
+		Bounds bounds = {};
+
+		if (count == 0)
+			return bounds;
+
+		const char* data = reinterpret_cast<const char*>(points);
+		auto point = [data, stride](size_t i) -> const glm::vec3&
+		{
+			return *reinterpret_cast<const glm::vec3*>(data + (i * stride));
+		};
+
+		// Bounding box
+		bounds.box.min = point(0);
+		bounds.box.max = point(0);
+
+		for (size_t i = 1; i < count; ++i)
+		{
+			bounds.box.min = glm::min(bounds.box.min, point(i));
+			bounds.box.max = glm::max(bounds.box.max, point(i));
+		}
+
+		// Bounding sphere centered on the box (Tighter than the box's circumsphere)
+		bounds.sphere.center = bounds.box.getCenter();
+
+		float radiusSqr = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const glm::vec3 d = point(i) - bounds.sphere.center;
+			radiusSqr = std::max(radiusSqr, glm::dot(d, d));
+		}
+
+		bounds.sphere.radius = std::sqrt(radiusSqr);
+
+		return bounds;
+	}
+
+	Bounds Bounds::transform(const glm::mat4& matrix) const
+	{
+		Bounds bounds = {};
+		bounds.box = box.transform(matrix);
+		bounds.sphere = sphere.transform(matrix);
+		return bounds;
+	}
+}
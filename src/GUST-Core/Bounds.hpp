@@ -0,0 +1,217 @@
+#pragma once
+
+/**
+ * @file Bounds.hpp
+ * @brief Bounding volume header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/** Includes. */
+#include <cstddef>
+#include <vector>
+#include "Math.hpp"
+
+namespace gust
+{
+	/**
+	 * @struct AABB
+	 * @brief Axis aligned bounding box.
+	 */
+	struct AABB
+	{
+		/** Minimum corner. */
+		glm::vec3 min = {};
+
+		/** Maximum corner. */
+		glm::vec3 max = {};
+
+		/**
+		 * @brief Get the center of the box.
+		 * @return Center.
+		 */
+		inline glm::vec3 getCenter() const
+		{
+			return (min + max) * 0.5f;
+		}
+
+		/**
+		 * @brief Get half the size of the box.
+		 * @return Extents.
+		 */
+		inline glm::vec3 getExtents() const
+		{
+			return (max - min) * 0.5f;
+		}
+
+		/**
+		 * @brief Get the surface area of the box.
+		 * @return Surface area.
+		 */
+		inline float getSurfaceArea() const
+		{
+			const glm::vec3 d = max - min;
+			return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+		}
+
+		/**
+		 * @brief Check if the box contains another box.
+		 * @param Other box.
+		 * @return If the other box is entirely inside this one.
+		 */
+		inline bool contains(const AABB& other) const
+		{
+			return	min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+					max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+		}
+
+		/**
+		 * @brief Check if the box overlaps another box.
+		 * @param Other box.
+		 * @return If the boxes overlap.
+		 */
+		inline bool overlaps(const AABB& other) const
+		{
+			return	min.x <= other.max.x && max.x >= other.min.x &&
+					min.y <= other.max.y && max.y >= other.min.y &&
+					min.z <= other.max.z && max.z >= other.min.z;
+		}
+
+		/**
+		 * @brief Create a box enclosing two boxes.
+		 * @param First box.
+		 * @param Second box.
+		 * @return Merged box.
+		 */
+		static inline AABB merge(const AABB& a, const AABB& b)
+		{
+			AABB box = {};
+			box.min = glm::min(a.min, b.min);
+			box.max = glm::max(a.max, b.max);
+			return box;
+		}
+
+		/**
+		 * @brief Transform the box and enclose the result in a new box.
+		 * @param Transformation matrix.
+		 * @return Transformed box.
+		 */
+		AABB transform(const glm::mat4& matrix) const;
+	};
+
+	/**
+	 * @struct BoundingSphere
+	 * @brief Bounding sphere.
+	 */
+	struct BoundingSphere
+	{
+		/** Center of the sphere. */
+		glm::vec3 center = {};
+
+		/** Radius of the sphere. */
+		float radius = 0;
+
+		/**
+		 * @brief Transform the sphere.
+		 * @param Transformation matrix.
+		 * @return Transformed sphere.
+		 * @note The radius is scaled by the largest axis scale of the matrix.
+		 */
+		BoundingSphere transform(const glm::mat4& matrix) const;
+	};
+
+	/**
+	 * @struct Bounds
+	 * @brief Box and sphere bounding a set of points.
+	 */
+	struct Bounds
+	{
+		/** Bounding box. */
+		AABB box = {};
+
+		/** Bounding sphere. */
+		BoundingSphere sphere = {};
+
+		/**
+		 * @brief Compute bounds from a set of points.
+		 * @param Pointer to the first point.
+		 * @param Number of points.
+		 * @param Distance in bytes between consecutive points.
+		 * @return Bounds of the points.
+		 */
+		static Bounds fromPoints(const glm::vec3* points, size_t count, size_t stride = sizeof(glm::vec3));
+
+		/**
+		 * @brief Transform the bounds.
+		 * @param Transformation matrix.
+		 * @return Transformed bounds.
+		 */
+		Bounds transform(const glm::mat4& matrix) const;
+	};
+
+	/**
+	 * @struct AABBList
+	 * @brief List of boxes stored as center/extent components in separate arrays.
+	 * @note Layout used for batch (SIMD) tests.
+	 */
+	struct AABBList
+	{
+		/** Center X components. */
+		std::vector<float> centerX = {};
+
+		/** Center Y components. */
+		std::vector<float> centerY = {};
+
+		/** Center Z components. */
+		std::vector<float> centerZ = {};
+
+		/** Extent X components. */
+		std::vector<float> extentX = {};
+
+		/** Extent Y components. */
+		std::vector<float> extentY = {};
+
+		/** Extent Z components. */
+		std::vector<float> extentZ = {};
+
+		/**
+		 * @brief Get number of boxes.
+		 * @return Number of boxes.
+		 */
+		inline size_t size() const
+		{
+			return centerX.size();
+		}
+
+		/**
+		 * @brief Resize the list.
+		 * @param New number of boxes.
+		 */
+		inline void resize(size_t count)
+		{
+			centerX.resize(count);
+			centerY.resize(count);
+			centerZ.resize(count);
+			extentX.resize(count);
+			extentY.resize(count);
+			extentZ.resize(count);
+		}
+
+		/**
+		 * @brief Set a box in the list.
+		 * @param Index of the box.
+		 * @param Box.
+		 */
+		inline void set(size_t index, const AABB& box)
+		{
+			const glm::vec3 center = box.getCenter();
+			const glm::vec3 extents = box.getExtents();
+
+			centerX[index] = center.x;
+			centerY[index] = center.y;
+			centerZ[index] = center.z;
+			extentX[index] = extents.x;
+			extentY[index] = extents.y;
+			extentZ[index] = extents.z;
+		}
+	};
+}
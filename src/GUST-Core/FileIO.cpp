@@ -1,4 +1,15 @@
 #include <fstream>
+#include <utility>
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 #include "Debugging.hpp"
 #include "FileIO.hpp"
 
@@ -59,4 +70,118 @@ namespace gust
 		// Write data
 		stream.write(bytes.data(), bytes.size());
 	}
+
+	bool fileExists(const std::string& path)
+	{
+		std::ifstream stream(path, std::ios::binary | std::ios::in);
+		return stream.is_open();
+	}
+
+
+
+	MappedFile::MappedFile(const std::string& path)
+	{
+#ifdef _WIN32
+		m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (m_file == INVALID_HANDLE_VALUE)
+		{
+			m_file = nullptr;
+			return;
+		}
+
+		LARGE_INTEGER size = {};
+		if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+		{
+			close();
+			return;
+		}
+
+		m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_mapping == nullptr)
+		{
+			close();
+			return;
+		}
+
+		m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+		if (m_data == nullptr)
+		{
+			close();
+			return;
+		}
+
+		m_size = static_cast<size_t>(size.QuadPart);
+#else
+		const int file = open(path.c_str(), O_RDONLY);
+		if (file == -1)
+			return;
+
+		struct stat info = {};
+		if (fstat(file, &info) == 0 && info.st_size > 0)
+		{
+			void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+
+			if (data != MAP_FAILED)
+			{
+				// Contents are read front to back
+				madvise(data, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+				m_data = static_cast<const char*>(data);
+				m_size = static_cast<size_t>(info.st_size);
+			}
+		}
+
+		// The mapping keeps its own reference to the file
+		::close(file);
+#endif
+	}
+
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other)
+	{
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other)
+	{
+		if (this != &other)
+		{
+			close();
+
+			std::swap(m_data, other.m_data);
+			std::swap(m_size, other.m_size);
+#ifdef _WIN32
+			std::swap(m_file, other.m_file);
+			std::swap(m_mapping, other.m_mapping);
+#endif
+		}
+
+		return *this;
+	}
+
+	void MappedFile::close()
+	{
+#ifdef _WIN32
+		if (m_data)
+			UnmapViewOfFile(m_data);
+
+		if (m_mapping)
+			CloseHandle(m_mapping);
+
+		if (m_file)
+			CloseHandle(m_file);
+
+		m_file = nullptr;
+		m_mapping = nullptr;
+#else
+		if (m_data)
+			munmap(const_cast<char*>(m_data), m_size);
+#endif
+		m_data = nullptr;
+		m_size = 0;
+	}
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 /** Includes. */
 #include <string>
 #include <vector>
+#include <cstddef>
 
 namespace gust
 {
@@ -39,4 +40,111 @@ namespace gust
 	 * @param Binary data to write.
 	 */
 	extern void writeBinary(const std::string& path, const std::vector<char>& bytes);
+
+	/**
+	 * @brief Check if a file exists and can be opened for reading.
+	 * @param Path to file.
+	 * @return If the file exists.
+	 */
+	extern bool fileExists(const std::string& path);
+
+
+
+	/**
+	 * @class MappedFile
+	 * @brief Read only view of a file mapped into memory.
+	 * @note Pages are read in by the OS as they are touched, so nothing is copied up front.
+	 */
+	class MappedFile
+	{
+	public:
+
+		/**
+		 * @brief Default constructor.
+		 */
+		MappedFile() = default;
+
+		/**
+		 * @brief Constructor.
+		 * @param Path to file.
+		 * @note Check isOpen() to see if mapping succeeded.
+		 */
+		MappedFile(const std::string& path);
+
+		/**
+		 * @brief Destructor.
+		 */
+		~MappedFile();
+
+		/**
+		 * @brief Move constructor.
+		 * @param File to move.
+		 */
+		MappedFile(MappedFile&& other);
+
+		/**
+		 * @brief Move assignment operator.
+		 * @param File to move.
+		 * @return This file.
+		 */
+		MappedFile& operator=(MappedFile&& other);
+
+		/**
+		 * @brief Mappings can't be copied.
+		 */
+		MappedFile(const MappedFile&) = delete;
+
+		/**
+		 * @brief Mappings can't be copied.
+		 */
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/**
+		 * @brief Check if the file is mapped.
+		 * @return If the file is mapped.
+		 */
+		inline bool isOpen() const
+		{
+			return m_data != nullptr;
+		}
+
+		/**
+		 * @brief Get the contents of the file.
+		 * @return Contents of the file.
+		 */
+		inline const char* getData() const
+		{
+			return m_data;
+		}
+
+		/**
+		 * @brief Get the size of the file.
+		 * @return Size in bytes.
+		 */
+		inline size_t getSize() const
+		{
+			return m_size;
+		}
+
+		/**
+		 * @brief Unmap the file.
+		 */
+		void close();
+
+	private:
+
+		/** Contents of the file. */
+		const char* m_data = nullptr;
+
+		/** Size of the file in bytes. */
+		size_t m_size = 0;
+
+#ifdef _WIN32
+		/** File handle. */
+		void* m_file = nullptr;
+
+		/** File mapping handle. */
+		void* m_mapping = nullptr;
+#endif
+	};
 }
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include <cmath>
+#include "Frustum.hpp"
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define GUST_FRUSTUM_AVX
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#include <xmmintrin.h>
+	#define GUST_FRUSTUM_SSE
+#endif
+
+namespace gust
+{
+	Frustum::Frustum(const glm::mat4& viewProjection)
+	{
+		// Rows of the matrix (GLM is column major)
+		glm::vec4 rows[4];
+		for (int i = 0; i < 4; ++i)
+			rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+
+		m_planes[0] = rows[3] + rows[0];	// Left
+		m_planes[1] = rows[3] - rows[0];	// Right
+		m_planes[2] = rows[3] + rows[1];	// Bottom
+		m_planes[3] = rows[3] - rows[1];	// Top
+		m_planes[4] = rows[2];				// Near (Zero to one depth)
+		m_planes[5] = rows[3] - rows[2];	// Far
+
+		// Normalize planes
+		for (auto& plane : m_planes)
+			plane = plane / glm::length(glm::vec3(plane));
+	}
+
+	bool Frustum::intersects(const AABB& box) const
+	{
+		const glm::vec3 center = box.getCenter();
+		const glm::vec3 extents = box.getExtents();
+
+		for (const auto& plane : m_planes)
+		{
+			const float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+			const float radius = glm::dot(glm::abs(glm::vec3(plane)), extents);
+
+			if (distance + radius < 0)
+				return false;
+		}
+
+		return true;
+	}
+
+	bool Frustum::intersects(const BoundingSphere& sphere) const
+	{
+		for (const auto& plane : m_planes)
+			if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius)
+				return false;
+
+		return true;
+	}
+
+	size_t Frustum::intersects(const AABBList& boxes, size_t first, size_t count, uint8_t* visible) const
+	{
+		const float* cx = boxes.centerX.data() + first;
+		const float* cy = boxes.centerY.data() + first;
+		const float* cz = boxes.centerZ.data() + first;
+		const float* ex = boxes.extentX.data() + first;
+		const float* ey = boxes.extentY.data() + first;
+		const float* ez = boxes.extentZ.data() + first;
+
+		size_t visibleCount = 0;
+		size_t i = 0;
+
+#if defined(GUST_FRUSTUM_AVX)
+		// 8 boxes per iteration
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256 centerX = _mm256_loadu_ps(cx + i);
+			const __m256 centerY = _mm256_loadu_ps(cy + i);
+			const __m256 centerZ = _mm256_loadu_ps(cz + i);
+			const __m256 extentX = _mm256_loadu_ps(ex + i);
+			const __m256 extentY = _mm256_loadu_ps(ey + i);
+			const __m256 extentZ = _mm256_loadu_ps(ez + i);
+
+			// Boxes outside any plane are culled
+			__m256 outside = _mm256_setzero_ps();
+
+			for (const auto& plane : m_planes)
+			{
+				const __m256 nx = _mm256_set1_ps(plane.x);
+				const __m256 ny = _mm256_set1_ps(plane.y);
+				const __m256 nz = _mm256_set1_ps(plane.z);
+
+				__m256 distance = _mm256_add_ps(_mm256_mul_ps(nx, centerX), _mm256_set1_ps(plane.w));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(ny, centerY));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(nz, centerZ));
+
+				__m256 radius = _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.x)), extentX);
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.y)), extentY));
+				radius = _mm256_add_ps(radius, _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.z)), extentZ));
+
+				outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+			}
+
+			const int mask = _mm256_movemask_ps(outside);
+			for (size_t j = 0; j < 8; ++j)
+			{
+				visible[i + j] = ((mask >> j) & 1) ? 0 : 1;
+				visibleCount += visible[i + j];
+			}
+		}
+#elif defined(GUST_FRUSTUM_SSE)
+		// 4 boxes per iteration
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 centerX = _mm_loadu_ps(cx + i);
+			const __m128 centerY = _mm_loadu_ps(cy + i);
+			const __m128 centerZ = _mm_loadu_ps(cz + i);
+			const __m128 extentX = _mm_loadu_ps(ex + i);
+			const __m128 extentY = _mm_loadu_ps(ey + i);
+			const __m128 extentZ = _mm_loadu_ps(ez + i);
+
+			// Boxes outside any plane are culled
+			__m128 outside = _mm_setzero_ps();
+
+			for (const auto& plane : m_planes)
+			{
+				const __m128 nx = _mm_set1_ps(plane.x);
+				const __m128 ny = _mm_set1_ps(plane.y);
+				const __m128 nz = _mm_set1_ps(plane.z);
+
+				__m128 distance = _mm_add_ps(_mm_mul_ps(nx, centerX), _mm_set1_ps(plane.w));
+				distance = _mm_add_ps(distance, _mm_mul_ps(ny, centerY));
+				distance = _mm_add_ps(distance, _mm_mul_ps(nz, centerZ));
+
+				__m128 radius = _mm_mul_ps(_mm_set1_ps(std::abs(plane.x)), extentX);
+				radius = _mm_add_ps(radius, _mm_mul_ps(_mm_set1_ps(std::abs(plane.y)), extentY));
+				radius = _mm_add_ps(radius, _mm_mul_ps(_mm_set1_ps(std::abs(plane.z)), extentZ));
+
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+			}
+
+			const int mask = _mm_movemask_ps(outside);
+			for (size_t j = 0; j < 4; ++j)
+			{
+				visible[i + j] = ((mask >> j) & 1) ? 0 : 1;
+				visibleCount += visible[i + j];
+			}
+		}
+#endif
+
+		// Remaining boxes
+		for (; i < count; ++i)
+		{
+			uint8_t inside = 1;
+
+			for (const auto& plane : m_planes)
+			{
+				const float distance = plane.x * cx[i] + plane.y * cy[i] + plane.z * cz[i] + plane.w;
+				const float radius = std::abs(plane.x) * ex[i] + std::abs(plane.y) * ey[i] + std::abs(plane.z) * ez[i];
+
+				if (distance + radius < 0)
+				{
+					inside = 0;
+					break;
+				}
+			}
+
+			visible[i] = inside;
+			visibleCount += inside;
+		}
+
+		return visibleCount;
+	}
+}
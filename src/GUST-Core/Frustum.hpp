@@ -0,0 +1,76 @@
+#pragma once
+
+/**
+ * @file Frustum.hpp
+ * @brief Frustum header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/** Includes. */
+#include <array>
+#include <cstdint>
+#include "Bounds.hpp"
+
+namespace gust
+{
+	/**
+	 * @class Frustum
+	 * @brief View frustum represented by six planes.
+	 */
+	class Frustum
+	{
+	public:
+
+		/**
+		 * @brief Default constructor.
+		 */
+		Frustum() = default;
+
+		/**
+		 * @brief Constructor.
+		 * @param View projection matrix to extract the planes from.
+		 * @note Expects zero to one depth (GLM_FORCE_DEPTH_ZERO_TO_ONE.)
+		 */
+		Frustum(const glm::mat4& viewProjection);
+
+		/**
+		 * @brief Get a plane.
+		 * @param Plane index (Left, right, bottom, top, near, far.)
+		 * @return Plane. XYZ is the inward facing normal and W is the distance.
+		 */
+		inline const glm::vec4& getPlane(size_t index) const
+		{
+			return m_planes[index];
+		}
+
+		/**
+		 * @brief Check if a box is at least partially inside the frustum.
+		 * @param Box to test.
+		 * @return If the box is visible.
+		 */
+		bool intersects(const AABB& box) const;
+
+		/**
+		 * @brief Check if a sphere is at least partially inside the frustum.
+		 * @param Sphere to test.
+		 * @return If the sphere is visible.
+		 */
+		bool intersects(const BoundingSphere& sphere) const;
+
+		/**
+		 * @brief Test a range of boxes against the frustum.
+		 * @param Boxes to test.
+		 * @param Index of the first box to test.
+		 * @param Number of boxes to test.
+		 * @param Output. Element i is set to 1 if box (first + i) is visible and 0 otherwise.
+		 * @return Number of visible boxes.
+		 * @note Boxes are tested 8 (AVX) or 4 (SSE) at a time when available.
+		 */
+		size_t intersects(const AABBList& boxes, size_t first, size_t count, uint8_t* visible) const;
+
+	private:
+
+		/** Planes. */
+		std::array<glm::vec4, 6> m_planes = {};
+	};
+}
@@ -154,4 +154,25 @@ namespace gust
 		for (auto worker : workers)
 			worker->wait();
 	}
+
+
+
+	void runJobs(ThreadPool* threadPool, size_t jobCount, const std::function<void(size_t)>& job)
+	{
+		if (threadPool == nullptr || threadPool->getWorkerCount() == 0)
+		{
+			for (size_t i = 0; i < jobCount; ++i)
+				job(i);
+
+			return;
+		}
+
+		for (size_t i = 0; i < jobCount; ++i)
+			threadPool->workers[i % threadPool->getWorkerCount()]->addJob([&job, i]()
+			{
+				job(i);
+			});
+
+		threadPool->wait();
+	}
 }
\ No newline at end of file
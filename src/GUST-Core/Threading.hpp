@@ -175,4 +175,13 @@ namespace gust
 		/** Worker threads. */
 		std::vector<WorkerThread*> workers = {};
 	};
+
+	/**
+	 * @brief Run numbered jobs on a thread pool and wait for them.
+	 * @param Thread pool (Jobs run on the calling thread when null.)
+	 * @param Number of jobs.
+	 * @param Job (Given its number.)
+	 * @note Jobs are handed to workers round robin. They must not throw.
+	 */
+	extern void runJobs(ThreadPool* threadPool, size_t jobCount, const std::function<void(size_t)>& job);
 }
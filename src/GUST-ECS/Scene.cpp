@@ -14,6 +14,7 @@ namespace gust
 			system->m_destroyAllComponents();
 
 		m_systems.clear();
+		m_spatialIndex.clear();
 	}
 
 	size_t Scene::create()
@@ -12,6 +12,7 @@
 #include <queue>
 #include <memory>
 #include "System.hpp"
+#include "SpatialIndex.hpp"
 #include "Debugging.hpp"
 
 namespace gust
@@ -54,6 +55,15 @@ namespace gust
 		 */
 		void tick(float deltaTime);
 
+		/**
+		 * @brief Get the spatial index of the scene.
+		 * @return Spatial index.
+		 */
+		inline SpatialIndex& getSpatialIndex()
+		{
+			return m_spatialIndex;
+		}
+
 		/**
 		 * @brief Create a new entity.
 		 * @return Entity handle.
@@ -268,6 +278,9 @@ namespace gust
 		/** Vector of systems. */
 		std::vector<std::unique_ptr<System>> m_systems = {};
 
+		/** Spatial index of renderables and lights. */
+		SpatialIndex m_spatialIndex = {};
+
 		/** Entity handle counter. */
 		size_t m_entityHandleCounter = 0;
 
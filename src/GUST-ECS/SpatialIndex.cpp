@@ -0,0 +1,492 @@
+#include <algorithm>
+#include <cmath>
+#include "SpatialIndex.hpp"
+
+namespace gust
+{
+	size_t SpatialIndex::insert(const AABB& box, Entity entity, uint32_t layer)
+	{
+		const size_t proxy = allocateNode();
+
+		// Enlarge the box so small movements don't require reinsertion
+		const glm::vec3 margin = glm::vec3(GUST_SPATIAL_INDEX_MARGIN);
+		m_nodes[proxy].box.min = box.min - margin;
+		m_nodes[proxy].box.max = box.max + margin;
+		m_nodes[proxy].tight = box;
+		m_nodes[proxy].entity = entity;
+		m_nodes[proxy].userData = std::numeric_limits<size_t>::max();
+		m_nodes[proxy].height = 0;
+		m_nodes[proxy].layers = layer;
+
+		insertLeaf(proxy);
+		++m_proxyCount;
+
+		return proxy;
+	}
+
+	void SpatialIndex::remove(size_t proxy)
+	{
+		gAssert(proxy < m_nodes.size() && m_nodes[proxy].isLeaf());
+
+		removeLeaf(proxy);
+		freeNode(proxy);
+		--m_proxyCount;
+	}
+
+	bool SpatialIndex::update(size_t proxy, const AABB& box)
+	{
+		gAssert(proxy < m_nodes.size() && m_nodes[proxy].isLeaf());
+
+		m_nodes[proxy].tight = box;
+
+		// Still inside the enlarged box
+		if (m_nodes[proxy].box.contains(box))
+			return false;
+
+		removeLeaf(proxy);
+
+		const glm::vec3 margin = glm::vec3(GUST_SPATIAL_INDEX_MARGIN);
+		m_nodes[proxy].box.min = box.min - margin;
+		m_nodes[proxy].box.max = box.max + margin;
+
+		insertLeaf(proxy);
+		return true;
+	}
+
+	void SpatialIndex::clear()
+	{
+		m_nodes.clear();
+		m_root = nullProxy();
+		m_freeList = nullProxy();
+		m_proxyCount = 0;
+	}
+
+	void SpatialIndex::query(const AABB& box, std::vector<Entity>& results, uint32_t layers) const
+	{
+		if (m_root == nullProxy())
+			return;
+
+		std::vector<size_t> stack = {};
+		stack.reserve(64);
+		stack.push_back(m_root);
+
+		while (!stack.empty())
+		{
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+
+			if ((node.layers & layers) == 0 || !node.box.overlaps(box))
+				continue;
+
+			if (node.isLeaf())
+			{
+				if (node.tight.overlaps(box))
+					results.push_back(node.entity);
+			}
+			else
+			{
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+			}
+		}
+	}
+
+	void SpatialIndex::query(const BoundingSphere& sphere, std::vector<Entity>& results, uint32_t layers) const
+	{
+		if (m_root == nullProxy())
+			return;
+
+		const float radiusSqr = sphere.radius * sphere.radius;
+
+		// Squared distance from the sphere center to a box
+		auto distanceSqr = [&sphere](const AABB& box)
+		{
+			const glm::vec3 d = sphere.center - glm::clamp(sphere.center, box.min, box.max);
+			return glm::dot(d, d);
+		};
+
+		std::vector<size_t> stack = {};
+		stack.reserve(64);
+		stack.push_back(m_root);
+
+		while (!stack.empty())
+		{
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+
+			if ((node.layers & layers) == 0 || distanceSqr(node.box) > radiusSqr)
+				continue;
+
+			if (node.isLeaf())
+			{
+				if (distanceSqr(node.tight) <= radiusSqr)
+					results.push_back(node.entity);
+			}
+			else
+			{
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+			}
+		}
+	}
+
+	void SpatialIndex::query(const Frustum& frustum, std::vector<Entity>& results, uint32_t layers) const
+	{
+		std::vector<size_t> proxies = {};
+		queryProxies(frustum, proxies, layers);
+
+		for (const size_t proxy : proxies)
+			results.push_back(m_nodes[proxy].entity);
+	}
+
+	void SpatialIndex::queryProxies(const Frustum& frustum, std::vector<size_t>& results, uint32_t layers) const
+	{
+		if (m_root == nullProxy())
+			return;
+
+		std::vector<size_t> stack = {};
+		stack.reserve(64);
+		stack.push_back(m_root);
+
+		while (!stack.empty())
+		{
+			const size_t index = stack.back();
+			const Node& node = m_nodes[index];
+			stack.pop_back();
+
+			if ((node.layers & layers) == 0)
+				continue;
+
+			const AABB& box = node.isLeaf() ? node.tight : node.box;
+			const glm::vec3 center = box.getCenter();
+			const glm::vec3 extents = box.getExtents();
+
+			// Classify the box against every plane
+			bool outside = false;
+			bool inside = true;
+
+			for (size_t i = 0; i < 6; ++i)
+			{
+				const glm::vec4& plane = frustum.getPlane(i);
+				const float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+				const float radius = glm::dot(glm::abs(glm::vec3(plane)), extents);
+
+				if (distance + radius < 0)
+				{
+					outside = true;
+					break;
+				}
+
+				if (distance - radius < 0)
+					inside = false;
+			}
+
+			if (outside)
+				continue;
+
+			if (node.isLeaf())
+				results.push_back(index);
+			else if (inside)
+				gather(index, results, layers);
+			else
+			{
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+			}
+		}
+	}
+
+	void SpatialIndex::raycast
+	(
+		const glm::vec3& origin,
+		const glm::vec3& direction,
+		float maxDistance,
+		std::vector<Entity>& results,
+		uint32_t layers
+	) const
+	{
+		if (m_root == nullProxy())
+			return;
+
+		const glm::vec3 invDirection = glm::vec3(1.0f) / direction;
+
+		// Slab test
+		auto hit = [&origin, &invDirection, maxDistance](const AABB& box)
+		{
+			float tMin = 0;
+			float tMax = maxDistance;
+
+			for (int i = 0; i < 3; ++i)
+			{
+				float t0 = (box.min[i] - origin[i]) * invDirection[i];
+				float t1 = (box.max[i] - origin[i]) * invDirection[i];
+
+				if (t0 > t1)
+					std::swap(t0, t1);
+
+				// NaN (Origin on a slab with a zero direction component) leaves the interval unchanged
+				tMin = t0 > tMin ? t0 : tMin;
+				tMax = t1 < tMax ? t1 : tMax;
+
+				if (tMin > tMax)
+					return false;
+			}
+
+			return true;
+		};
+
+		std::vector<size_t> stack = {};
+		stack.reserve(64);
+		stack.push_back(m_root);
+
+		while (!stack.empty())
+		{
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+
+			if ((node.layers & layers) == 0 || !hit(node.box))
+				continue;
+
+			if (node.isLeaf())
+			{
+				if (hit(node.tight))
+					results.push_back(node.entity);
+			}
+			else
+			{
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+			}
+		}
+	}
+
+	size_t SpatialIndex::allocateNode()
+	{
+		// Grow the node list if there are no free nodes
+		if (m_freeList == nullProxy())
+		{
+			m_nodes.push_back(Node());
+			return m_nodes.size() - 1;
+		}
+
+		const size_t node = m_freeList;
+		m_freeList = m_nodes[node].parent;
+		m_nodes[node] = Node();
+
+		return node;
+	}
+
+	void SpatialIndex::freeNode(size_t node)
+	{
+		m_nodes[node] = Node();
+		m_nodes[node].parent = m_freeList;
+		m_freeList = node;
+	}
+
+	void SpatialIndex::insertLeaf(size_t leaf)
+	{
+		if (m_root == nullProxy())
+		{
+			m_root = leaf;
+			m_nodes[leaf].parent = nullProxy();
+			return;
+		}
+
+		// Find the best sibling using the surface area heuristic
+		const AABB leafBox = m_nodes[leaf].box;
+		size_t index = m_root;
+
+		while (!m_nodes[index].isLeaf())
+		{
+			const size_t left = m_nodes[index].left;
+			const size_t right = m_nodes[index].right;
+
+			const float area = m_nodes[index].box.getSurfaceArea();
+			const float combinedArea = AABB::merge(m_nodes[index].box, leafBox).getSurfaceArea();
+
+			// Cost of creating a new parent for this node and the leaf
+			const float cost = 2.0f * combinedArea;
+
+			// Minimum cost of pushing the leaf further down the tree
+			const float inheritanceCost = 2.0f * (combinedArea - area);
+
+			auto childCost = [this, &leafBox, inheritanceCost](size_t child)
+			{
+				const float mergedArea = AABB::merge(leafBox, m_nodes[child].box).getSurfaceArea();
+
+				if (m_nodes[child].isLeaf())
+					return mergedArea + inheritanceCost;
+
+				return (mergedArea - m_nodes[child].box.getSurfaceArea()) + inheritanceCost;
+			};
+
+			const float costLeft = childCost(left);
+			const float costRight = childCost(right);
+
+			if (cost < costLeft && cost < costRight)
+				break;
+
+			index = costLeft < costRight ? left : right;
+		}
+
+		const size_t sibling = index;
+
+		// Create a new parent
+		const size_t oldParent = m_nodes[sibling].parent;
+		const size_t newParent = allocateNode();
+		m_nodes[newParent].parent = oldParent;
+		m_nodes[newParent].left = sibling;
+		m_nodes[newParent].right = leaf;
+		m_nodes[sibling].parent = newParent;
+		m_nodes[leaf].parent = newParent;
+
+		if (oldParent == nullProxy())
+			m_root = newParent;
+		else if (m_nodes[oldParent].left == sibling)
+			m_nodes[oldParent].left = newParent;
+		else
+			m_nodes[oldParent].right = newParent;
+
+		// Walk back up the tree fixing bounds
+		refitAncestors(newParent);
+	}
+
+	void SpatialIndex::removeLeaf(size_t leaf)
+	{
+		if (leaf == m_root)
+		{
+			m_root = nullProxy();
+			return;
+		}
+
+		const size_t parent = m_nodes[leaf].parent;
+		const size_t grandParent = m_nodes[parent].parent;
+		const size_t sibling = m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+
+		// Replace the parent with the sibling
+		if (grandParent == nullProxy())
+		{
+			m_root = sibling;
+			m_nodes[sibling].parent = nullProxy();
+			freeNode(parent);
+		}
+		else
+		{
+			if (m_nodes[grandParent].left == parent)
+				m_nodes[grandParent].left = sibling;
+			else
+				m_nodes[grandParent].right = sibling;
+
+			m_nodes[sibling].parent = grandParent;
+			freeNode(parent);
+
+			refitAncestors(grandParent);
+		}
+
+		m_nodes[leaf].parent = nullProxy();
+	}
+
+	void SpatialIndex::refit(size_t node)
+	{
+		const Node& left = m_nodes[m_nodes[node].left];
+		const Node& right = m_nodes[m_nodes[node].right];
+
+		m_nodes[node].box = AABB::merge(left.box, right.box);
+		m_nodes[node].height = 1 + std::max(left.height, right.height);
+		m_nodes[node].layers = left.layers | right.layers;
+	}
+
+	void SpatialIndex::refitAncestors(size_t node)
+	{
+		while (node != nullProxy())
+		{
+			node = balance(node);
+			refit(node);
+			node = m_nodes[node].parent;
+		}
+	}
+
+	size_t SpatialIndex::balance(size_t a)
+	{
+		if (m_nodes[a].isLeaf() || m_nodes[a].height < 2)
+			return a;
+
+		const size_t b = m_nodes[a].left;
+		const size_t c = m_nodes[a].right;
+		const int32_t difference = m_nodes[c].height - m_nodes[b].height;
+
+		// Rotate the taller child up
+		auto rotate = [this, a](size_t up, bool upIsRight)
+		{
+			const size_t f = m_nodes[up].left;
+			const size_t g = m_nodes[up].right;
+
+			// Swap A and the child
+			m_nodes[up].left = a;
+			m_nodes[up].parent = m_nodes[a].parent;
+			m_nodes[a].parent = up;
+
+			if (m_nodes[up].parent == nullProxy())
+				m_root = up;
+			else if (m_nodes[m_nodes[up].parent].left == a)
+				m_nodes[m_nodes[up].parent].left = up;
+			else
+				m_nodes[m_nodes[up].parent].right = up;
+
+			// The taller grandchild stays with the child and the shorter one moves to A
+			const size_t keep = m_nodes[f].height > m_nodes[g].height ? f : g;
+			const size_t move = keep == f ? g : f;
+
+			m_nodes[up].right = keep;
+
+			if (upIsRight)
+				m_nodes[a].right = move;
+			else
+				m_nodes[a].left = move;
+
+			m_nodes[move].parent = a;
+
+			refit(a);
+			refit(up);
+		};
+
+		if (difference > 1)
+		{
+			rotate(c, true);
+			return c;
+		}
+
+		if (difference < -1)
+		{
+			rotate(b, false);
+			return b;
+		}
+
+		return a;
+	}
+
+	void SpatialIndex::gather(size_t node, std::vector<size_t>& results, uint32_t layers) const
+	{
+		std::vector<size_t> stack = {};
+		stack.reserve(64);
+		stack.push_back(node);
+
+		while (!stack.empty())
+		{
+			const size_t index = stack.back();
+			const Node& current = m_nodes[index];
+			stack.pop_back();
+
+			if ((current.layers & layers) == 0)
+				continue;
+
+			if (current.isLeaf())
+				results.push_back(index);
+			else
+			{
+				stack.push_back(current.left);
+				stack.push_back(current.right);
+			}
+		}
+	}
+}
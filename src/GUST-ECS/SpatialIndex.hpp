@@ -0,0 +1,324 @@
+#pragma once
+
+/**
+ * @file SpatialIndex.hpp
+ * @brief Spatial index header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/**
+ * @def GUST_SPATIAL_INDEX_MARGIN
+ * @brief Distance leaf boxes are enlarged by so small movements don't require reinsertion.
+ */
+#define GUST_SPATIAL_INDEX_MARGIN 0.1f
+
+/** Includes. */
+#include <vector>
+#include <limits>
+#include "Frustum.hpp"
+#include "Entity.hpp"
+
+namespace gust
+{
+	/**
+	 * @class SpatialIndex
+	 * @brief Dynamic bounding volume hierarchy of entities.
+	 * @note Leaves are inserted using a surface area heuristic and the tree is kept balanced with rotations.
+	 */
+	class SpatialIndex
+	{
+	public:
+
+		/**
+		 * @enum Layer
+		 * @brief Categories of entries. Used to filter queries.
+		 */
+		enum Layer : uint32_t
+		{
+			Renderable = 1 << 0,
+			PointLight = 1 << 1,
+			SpotLight = 1 << 2,
+			Light = PointLight | SpotLight,
+			All = 0xFFFFFFFF
+		};
+
+		/**
+		 * @brief Default constructor.
+		 */
+		SpatialIndex() = default;
+
+		/**
+		 * @brief Default destructor.
+		 */
+		~SpatialIndex() = default;
+
+		/**
+		 * @brief Get a proxy representing nothing.
+		 * @return Null proxy.
+		 */
+		static inline size_t nullProxy()
+		{
+			return std::numeric_limits<size_t>::max();
+		}
+
+		/**
+		 * @brief Get number of entries in the index.
+		 * @return Number of entries.
+		 */
+		inline size_t getProxyCount() const
+		{
+			return m_proxyCount;
+		}
+
+		/**
+		 * @brief Get height of the tree.
+		 * @return Height of the tree.
+		 */
+		inline int32_t getHeight() const
+		{
+			return m_root == nullProxy() ? 0 : m_nodes[m_root].height;
+		}
+
+		/**
+		 * @brief Get the entity an entry represents.
+		 * @param Proxy.
+		 * @return Entity.
+		 */
+		inline Entity getEntity(size_t proxy) const
+		{
+			return m_nodes[proxy].entity;
+		}
+
+		/**
+		 * @brief Get the bounds of an entry.
+		 * @param Proxy.
+		 * @return Bounds.
+		 */
+		inline const AABB& getBounds(size_t proxy) const
+		{
+			return m_nodes[proxy].tight;
+		}
+
+		/**
+		 * @brief Get the layer of an entry.
+		 * @param Proxy.
+		 * @return Layer.
+		 */
+		inline uint32_t getLayer(size_t proxy) const
+		{
+			return m_nodes[proxy].layers;
+		}
+
+		/**
+		 * @brief Get the value the owner of an entry stored in it.
+		 * @param Proxy.
+		 * @return User data (std::numeric_limits<size_t>::max() if never set.)
+		 */
+		inline size_t getUserData(size_t proxy) const
+		{
+			return m_nodes[proxy].userData;
+		}
+
+		/**
+		 * @brief Store a value in an entry.
+		 * @param Proxy.
+		 * @param User data.
+		 * @note Lets query results be mapped back to whatever the owner keeps without searching for the entities components.
+		 */
+		inline void setUserData(size_t proxy, size_t userData)
+		{
+			m_nodes[proxy].userData = userData;
+		}
+
+		/**
+		 * @brief Add an entry to the index.
+		 * @param World space bounds.
+		 * @param Entity the entry represents.
+		 * @param Layer of the entry.
+		 * @return Proxy used to refer to the entry.
+		 */
+		size_t insert(const AABB& box, Entity entity, uint32_t layer);
+
+		/**
+		 * @brief Remove an entry from the index.
+		 * @param Proxy.
+		 */
+		void remove(size_t proxy);
+
+		/**
+		 * @brief Update the bounds of an entry.
+		 * @param Proxy.
+		 * @param New world space bounds.
+		 * @return If the entry had to be reinserted.
+		 * @note Cheap when the new bounds are still within the enlarged leaf.
+		 */
+		bool update(size_t proxy, const AABB& box);
+
+		/**
+		 * @brief Remove every entry.
+		 */
+		void clear();
+
+		/**
+		 * @brief Find entries overlapping a box.
+		 * @param Box.
+		 * @param List to append entities to.
+		 * @param Layers to include.
+		 */
+		void query(const AABB& box, std::vector<Entity>& results, uint32_t layers = All) const;
+
+		/**
+		 * @brief Find entries overlapping a sphere.
+		 * @param Sphere.
+		 * @param List to append entities to.
+		 * @param Layers to include.
+		 */
+		void query(const BoundingSphere& sphere, std::vector<Entity>& results, uint32_t layers = All) const;
+
+		/**
+		 * @brief Find entries inside a frustum.
+		 * @param Frustum.
+		 * @param List to append entities to.
+		 * @param Layers to include.
+		 * @note Subtrees entirely inside the frustum are added without further tests.
+		 */
+		void query(const Frustum& frustum, std::vector<Entity>& results, uint32_t layers = All) const;
+
+		/**
+		 * @brief Find entries inside a frustum.
+		 * @param Frustum.
+		 * @param List to append proxies to.
+		 * @param Layers to include.
+		 * @note Subtrees entirely inside the frustum are added without further tests.
+		 */
+		void queryProxies(const Frustum& frustum, std::vector<size_t>& results, uint32_t layers = All) const;
+
+		/**
+		 * @brief Find entries hit by a ray.
+		 * @param Ray origin.
+		 * @param Ray direction.
+		 * @param Maximum distance along the ray.
+		 * @param List to append entities to.
+		 * @param Layers to include.
+		 * @note Results are not sorted by distance.
+		 */
+		void raycast
+		(
+			const glm::vec3& origin,
+			const glm::vec3& direction,
+			float maxDistance,
+			std::vector<Entity>& results,
+			uint32_t layers = All
+		) const;
+
+	private:
+
+		/**
+		 * @struct Node
+		 * @brief Node in the tree.
+		 */
+		struct Node
+		{
+			/** Enlarged bounds for leaves and union of children otherwise. */
+			AABB box = {};
+
+			/** Exact bounds (Leaves only.) */
+			AABB tight = {};
+
+			/** Entity (Leaves only.) */
+			Entity entity = {};
+
+			/** Value stored by the owner of the entry (Leaves only.) */
+			size_t userData = std::numeric_limits<size_t>::max();
+
+			/** Parent node (Next free node when unused.) */
+			size_t parent = SpatialIndex::nullProxy();
+
+			/** Left child. */
+			size_t left = SpatialIndex::nullProxy();
+
+			/** Right child. */
+			size_t right = SpatialIndex::nullProxy();
+
+			/** Height of the node (Leaves are 0 and free nodes are -1.) */
+			int32_t height = -1;
+
+			/** Layers in the subtree. */
+			uint32_t layers = 0;
+
+			/**
+			 * @brief Check if the node is a leaf.
+			 * @return If the node is a leaf.
+			 */
+			inline bool isLeaf() const
+			{
+				return left == SpatialIndex::nullProxy();
+			}
+		};
+
+		/**
+		 * @brief Get a node from the free list.
+		 * @return Node index.
+		 */
+		size_t allocateNode();
+
+		/**
+		 * @brief Return a node to the free list.
+		 * @param Node index.
+		 */
+		void freeNode(size_t node);
+
+		/**
+		 * @brief Insert a leaf into the tree.
+		 * @param Leaf index.
+		 */
+		void insertLeaf(size_t leaf);
+
+		/**
+		 * @brief Remove a leaf from the tree.
+		 * @param Leaf index.
+		 */
+		void removeLeaf(size_t leaf);
+
+		/**
+		 * @brief Recompute a nodes bounds, height and layers from its children.
+		 * @param Node index.
+		 */
+		void refit(size_t node);
+
+		/**
+		 * @brief Refit and balance every node from a node up to the root.
+		 * @param Node index.
+		 */
+		void refitAncestors(size_t node);
+
+		/**
+		 * @brief Perform a rotation if the subtree is imbalanced.
+		 * @param Subtree root.
+		 * @return New subtree root.
+		 */
+		size_t balance(size_t node);
+
+		/**
+		 * @brief Add every leaf in a subtree to a result list.
+		 * @param Subtree root.
+		 * @param List to append proxies to.
+		 * @param Layers to include.
+		 */
+		void gather(size_t node, std::vector<size_t>& results, uint32_t layers) const;
+
+
+
+		/** Nodes. */
+		std::vector<Node> m_nodes = {};
+
+		/** Root node. */
+		size_t m_root = SpatialIndex::nullProxy();
+
+		/** First free node. */
+		size_t m_freeList = SpatialIndex::nullProxy();
+
+		/** Number of entries. */
+		size_t m_proxyCount = 0;
+	};
+}
@@ -173,6 +173,8 @@ namespace gust
 
 	void Transform::generateModelMatrix()
 	{
+		const glm::mat4 oldModelMatrix = m_modelMatrix;
+
 		m_modelMatrix = {};
 		m_unscaledModelMatrix = {};
 
@@ -193,6 +195,10 @@ namespace gust
 			m_unscaledModelMatrix = m_parent->m_unscaledModelMatrix * m_unscaledModelMatrix;
 		}
 
+		// Invalidate cached data if the matrix changed
+		if (m_modelMatrix != oldModelMatrix || m_modelMatrixVersion == 0)
+			++m_modelMatrixVersion;
+
 		// Update childrens model matrix
 		for (auto child : m_children)
 			child->generateModelMatrix();
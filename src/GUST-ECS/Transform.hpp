@@ -112,6 +112,16 @@ namespace gust
 			return m_modelMatrix;
 		}
 
+		/**
+		 * @brief Get the model matrix version.
+		 * @return Number incremented every time the model matrix changes.
+		 * @note Used to cache data derived from the model matrix.
+		 */
+		inline uint64_t getModelMatrixVersion() const
+		{
+			return m_modelMatrixVersion;
+		}
+
 		/**
 		 * @brief Get a forward vector realative to the transform.
 		 * @return Forward vector.
@@ -355,6 +365,9 @@ namespace gust
 		/** Model matrix without scale applied (Used for hierarchy.) */
 		glm::mat4 m_unscaledModelMatrix = {};
 
+		/** Model matrix version. */
+		uint64_t m_modelMatrixVersion = 0;
+
 		/** Children. */
 		std::vector<Handle<Transform>> m_children = {};
 
@@ -63,14 +63,52 @@ namespace gust
 
 	void CameraSystem::onPreRender(float deltaTime)
 	{
+		const SpatialIndex& spatialIndex = getScene()->getSpatialIndex();
+		const size_t none = std::numeric_limits<size_t>::max();
+
 		for (Handle<Camera> camera : *this)
 		{
 			camera->generateProjectionMatrix();
 			camera->generateViewMatrix();
 
-			camera->m_virtualCamera->view = camera->m_view;
-			camera->m_virtualCamera->projection = camera->m_projection;
-			camera->m_virtualCamera->viewPosition = camera->m_transform->getPosition();
+			Handle<VirtualCamera> virtualCamera = camera->m_virtualCamera;
+			virtualCamera->view = camera->m_view;
+			virtualCamera->projection = camera->m_projection;
+			virtualCamera->viewPosition = camera->m_transform->getPosition();
+
+			const Frustum frustum(camera->m_projection * camera->m_view);
+
+			// Meshes in view (Mesh renderers store their draw index in their entries)
+			m_proxies.clear();
+			spatialIndex.queryProxies(frustum, m_proxies, SpatialIndex::Renderable);
+
+			virtualCamera->meshCandidates.clear();
+
+			for (const size_t proxy : m_proxies)
+				if (spatialIndex.getUserData(proxy) != none)
+					virtualCamera->meshCandidates.push_back(spatialIndex.getUserData(proxy));
+
+			virtualCamera->hasMeshCandidates = true;
+
+			// Lights whose range reaches into the main cameras view
+			if (virtualCamera.getHandle() == gust::renderer.getMainCamera().getHandle())
+			{
+				m_proxies.clear();
+				m_pointLights.clear();
+				m_spotLights.clear();
+				spatialIndex.queryProxies(frustum, m_proxies, SpatialIndex::Light);
+
+				for (const size_t proxy : m_proxies)
+					if (spatialIndex.getUserData(proxy) != none)
+					{
+						if (spatialIndex.getLayer(proxy) == SpatialIndex::PointLight)
+							m_pointLights.push_back(spatialIndex.getUserData(proxy));
+						else
+							m_spotLights.push_back(spatialIndex.getUserData(proxy));
+					}
+
+				gust::renderer.setVisibleLights(m_pointLights, m_spotLights);
+			}
 		}
 	}
 
@@ -88,6 +88,15 @@ namespace gust
 			return m_virtualCamera->skybox;
 		}
 
+		/**
+		 * @brief Get transform.
+		 * @return Transform.
+		 */
+		inline Handle<Transform> getTransform() const
+		{
+			return m_transform;
+		}
+
 		/**
 		 * @brief Get view matrix.
 		 * @return View matrix.
@@ -229,6 +238,8 @@ namespace gust
 	/**
 	 * @class CameraSystem
 	 * @brief Implementation of the Camera class.
+	 * @note Finds each cameras meshes and the main cameras lights with the scenes spatial index,
+	 * so it must be added after the mesh renderer and light systems.
 	 */
 	class CameraSystem : public System
 	{
@@ -261,5 +272,16 @@ namespace gust
 		 * @brief Called when a component is removed from the system.
 		 */
 		void onEnd() override;
+
+	private:
+
+		/** Proxies found by the last spatial query. */
+		std::vector<size_t> m_proxies = {};
+
+		/** Point lights near the main cameras view. */
+		std::vector<size_t> m_pointLights = {};
+
+		/** Spot lights near the main cameras view. */
+		std::vector<size_t> m_spotLights = {};
 	};
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <tuple>
 #include <map>
+#include <limits>
 #include "Engine.hpp"
 #include "RigidBody.hpp"
 
@@ -55,14 +56,28 @@ namespace gust
 
 	void startup(const std::string& name, uint32_t width, uint32_t height)
 	{
+		Clock startupClock = {};
+
 		// Start modules
 		input.startup();
 		graphics.startup(name, width, height);
+		const float graphicsTime = startupClock.getElapsedTime();
+
 		resourceManager.startup(&graphics, &renderer, 20, 20, 10, 10);
 		renderer.startup(&graphics, resourceManager.getMeshAllocator(), resourceManager.getTextureAllocator(), 4);
+		const float rendererTime = startupClock.getElapsedTime() - graphicsTime;
+
 		scene.startup();
 		physics.startup({ 0, -9.82f, 0 });
 
+		// Compare with a run without PipelineCache.bin to see what the pipeline cache saves
+		gLog
+		(
+			"Startup took " << startupClock.getElapsedTime() << "s (Graphics " << graphicsTime << 
+			"s, Renderer " << rendererTime << "s, pipelines " << graphics.getPipelineCreationTime() << 
+			"s with a " << (graphics.isPipelineCacheWarm() ? "warm" : "cold") << " pipeline cache.)\n"
+		);
+
 		// Start threads
 		renderingThread = std::make_unique<SimulationThread>([]() { renderer.render(); });
 		physicsThread = std::make_unique<SimulationThread>([]() 
@@ -73,11 +88,16 @@ namespace gust
 	}
 
 	void simulate()
+	{
+		simulate(std::numeric_limits<uint64_t>::max());
+	}
+
+	void simulate(uint64_t frameCount)
 	{
 		// Reset delta time
 		gameClock.getDeltaTime();
 
-		while (!input.isClosing())
+		for (uint64_t frame = 0; frame < frameCount && !input.isClosing(); ++frame)
 		{
 			// Get delta time
 			float deltaTime = gameClock.getDeltaTime();
@@ -126,6 +146,10 @@ namespace gust
 			if (physicsTimer >= GUST_PHYSICS_STEP_RATE)
 				physicsThread->start();
 		}
+
+		// Finish the last frame
+		renderingThread->wait();
+		physicsThread->wait();
 	}
 
 	void shutdown()
@@ -37,6 +37,14 @@ namespace gust
 	 */
 	extern void simulate();
 
+	/**
+	 * @brief Simulate the engine for a number of frames.
+	 * @param Number of frames.
+	 * @note Stops early if the window is closed. Rendering and physics are finished when this returns.
+	 * @note This is called internally. Do not use.
+	 */
+	extern void simulate(uint64_t frameCount);
+
 	/**
 	 * @brief Shutdown the engine.
 	 * @note This is called internally. Do not use.
@@ -0,0 +1,81 @@
+#include <cmath>
+#include "Camera.hpp"
+#include "LODGroup.hpp"
+
+namespace gust
+{
+	LODGroup::LODGroup(Entity entity, Handle<LODGroup> handle) : Component<LODGroup>(entity, handle)
+	{
+
+	}
+
+	LODGroup::~LODGroup()
+	{
+
+	}
+
+
+
+	LODGroupSystem::LODGroupSystem(Scene* scene) : System(scene)
+	{
+		initialize<LODGroup>();
+	}
+
+	LODGroupSystem::~LODGroupSystem()
+	{
+
+	}
+
+	void LODGroupSystem::onBegin()
+	{
+		auto lodGroup = getComponent<LODGroup>();
+		lodGroup->m_meshRenderer = lodGroup->getEntity().getComponent<MeshRenderer>();
+	}
+
+	void LODGroupSystem::onPreRender(float deltaTime)
+	{
+		Handle<Camera> camera = Camera::getMainCamera();
+
+		if (camera == Handle<Camera>::nullHandle())
+			return;
+
+		const glm::vec3 viewPosition = camera->getTransform()->getPosition();
+		const float tanHalfFov = std::tan(glm::radians(camera->getFieldOfView()) * 0.5f);
+
+		for (Handle<LODGroup> lodGroup : *this)
+		{
+			if (lodGroup->m_levels.empty())
+				continue;
+
+			// The mesh renderer may have been added after the LOD group
+			if (lodGroup->m_meshRenderer == Handle<MeshRenderer>::nullHandle())
+			{
+				lodGroup->m_meshRenderer = lodGroup->getEntity().getComponent<MeshRenderer>();
+
+				if (lodGroup->m_meshRenderer == Handle<MeshRenderer>::nullHandle())
+					continue;
+			}
+
+			auto meshRenderer = lodGroup->m_meshRenderer;
+
+			if (meshRenderer->getMesh() == Handle<Mesh>::nullHandle())
+				meshRenderer->setMesh(lodGroup->m_levels[lodGroup->m_currentLevel].mesh);
+
+			// Fraction of the screens height covered by the bounding sphere
+			const BoundingSphere& sphere = meshRenderer->getWorldBounds().sphere;
+			const float distance = glm::length(sphere.center - viewPosition);
+			const float screenSize = distance > sphere.radius ? sphere.radius / (distance * tanHalfFov) : 1.0f;
+
+			// First level the object is large enough for, or the least detailed one
+			size_t level = 0;
+			while (level + 1 < lodGroup->m_levels.size() && screenSize < lodGroup->m_levels[level].screenSize)
+				++level;
+
+			if (level != lodGroup->m_currentLevel || meshRenderer->getMesh() != lodGroup->m_levels[level].mesh)
+			{
+				lodGroup->m_currentLevel = level;
+				meshRenderer->setMesh(lodGroup->m_levels[level].mesh);
+			}
+		}
+	}
+}
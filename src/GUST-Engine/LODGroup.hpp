@@ -0,0 +1,152 @@
+#pragma once
+
+/**
+ * @file LODGroup.hpp
+ * @brief LOD group header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/** Includes. */
+#include <vector>
+#include <Scene.hpp>
+#include <Mesh.hpp>
+
+#include "Transform.hpp"
+#include "MeshRenderer.hpp"
+
+namespace gust
+{
+	/**
+	 * @struct LODLevel
+	 * @brief Mesh used while an object covers enough of the screen.
+	 */
+	struct LODLevel
+	{
+		/** Mesh. */
+		Handle<Mesh> mesh = Handle<Mesh>::nullHandle();
+
+		/** Smallest fraction of the screens height the object can cover while using the mesh. */
+		float screenSize = 0.0f;
+	};
+
+	/**
+	 * @class LODGroup
+	 * @brief Swaps the mesh of a MeshRenderer depending on how large it appears on screen.
+	 * @note Levels are picked for the main camera only. A renderer submits a single mesh per frame,
+	 * so other cameras draw the level chosen for the main camera.
+	 */
+	class LODGroup : public Component<LODGroup>
+	{
+		friend class LODGroupSystem;
+
+	public:
+
+		/**
+		 * @brief Default constructor.
+		 */
+		LODGroup() = default;
+
+		/**
+		 * @brief Constructor.
+		 * @param Entity the component is attached to
+		 * @param Component handle
+		 */
+		LODGroup(Entity entity, Handle<LODGroup> handle);
+
+		/**
+		 * @brief Destructor.
+		 * @see Component::~Component
+		 */
+		~LODGroup();
+
+		/**
+		 * @brief Add a level.
+		 * @param Mesh.
+		 * @param Smallest fraction of the screens height the object can cover while using the mesh.
+		 * @note Levels must be added from most to least detailed.
+		 */
+		inline void addLevel(Handle<Mesh> mesh, float screenSize)
+		{
+			LODLevel level = {};
+			level.mesh = mesh;
+			level.screenSize = screenSize;
+			m_levels.push_back(level);
+		}
+
+		/**
+		 * @brief Set levels.
+		 * @param Levels ordered from most to least detailed.
+		 * @return Levels.
+		 */
+		inline const std::vector<LODLevel>& setLevels(const std::vector<LODLevel>& levels)
+		{
+			m_levels = levels;
+			m_currentLevel = 0;
+			return m_levels;
+		}
+
+		/**
+		 * @brief Get levels.
+		 * @return Levels.
+		 */
+		inline const std::vector<LODLevel>& getLevels() const
+		{
+			return m_levels;
+		}
+
+		/**
+		 * @brief Get the level currently in use.
+		 * @return Level index.
+		 */
+		inline size_t getCurrentLevel() const
+		{
+			return m_currentLevel;
+		}
+
+	private:
+
+		/** Mesh renderer. */
+		Handle<MeshRenderer> m_meshRenderer = Handle<MeshRenderer>::nullHandle();
+
+		/** Levels from most to least detailed. */
+		std::vector<LODLevel> m_levels = {};
+
+		/** Level currently in use. */
+		size_t m_currentLevel = 0;
+	};
+
+
+
+	/**
+	 * @class LODGroupSystem
+	 * @brief Implementation of LOD groups.
+	 * @note Must be added before the mesh renderer system so levels are picked before meshes are submitted.
+	 */
+	class LODGroupSystem : public System
+	{
+	public:
+
+		/**
+		 * @brief Constructor.
+		 * @param Scene the system is in.
+		 */
+		LODGroupSystem(Scene* scene);
+
+		/**
+		 * @brief Destructor.
+		 */
+		~LODGroupSystem();
+
+		/**
+		 * @brief Called when a component is added to the system.
+		 */
+		void onBegin() override;
+
+		/**
+		 * @brief Called once per tick, after onLateTick(), and before rendering.
+		 * @param Delta time.
+		 * @note Levels are picked against the main cameras final position for the frame.
+		 */
+		void onPreRender(float deltaTime) override;
+	};
+}
@@ -30,6 +30,8 @@ namespace gust
 
 	void PointLightSystem::onPreRender(float deltaTime)
 	{
+		auto& spatialIndex = getScene()->getSpatialIndex();
+
 		for (Handle<PointLight> pointLight : *this)
 		{
 			bool test = pointLight.getResourceAllocator()->isAllocated(0);
@@ -40,10 +42,30 @@ namespace gust
 			data.range = pointLight->m_range;
 			data.position = { pointLight->m_transform->getPosition(), 1 };
 
-			gust::renderer.draw(data);
+			// Keep the spatial index up to date
+			AABB box = {};
+			box.min = pointLight->m_transform->getPosition() - glm::vec3(pointLight->m_range);
+			box.max = pointLight->m_transform->getPosition() + glm::vec3(pointLight->m_range);
+
+			if (pointLight->m_spatialProxy == SpatialIndex::nullProxy())
+				pointLight->m_spatialProxy = spatialIndex.insert(box, pointLight->getEntity(), SpatialIndex::PointLight);
+			else
+				spatialIndex.update(pointLight->m_spatialProxy, box);
+
+			// Let camera queries find the light by its index this frame
+			spatialIndex.setUserData(pointLight->m_spatialProxy, gust::renderer.draw(data));
 		}
 	}
 
+	void PointLightSystem::onEnd()
+	{
+		auto pointLight = getComponent<PointLight>();
+
+		// Remove from spatial index
+		if (pointLight->m_spatialProxy != SpatialIndex::nullProxy())
+			getScene()->getSpatialIndex().remove(pointLight->m_spatialProxy);
+	}
+
 
 
 	DirectionalLight::DirectionalLight(Entity entity, Handle<DirectionalLight> handle) : Component<DirectionalLight>(entity, handle)
@@ -115,6 +137,8 @@ namespace gust
 
 	void SpotLightSystem::onPreRender(float deltaTime)
 	{
+		auto& spatialIndex = getScene()->getSpatialIndex();
+
 		for (Handle<SpotLight> spotLight : *this)
 		{
 			SpotLightData data = {};
@@ -125,7 +149,27 @@ namespace gust
 			data.range = spotLight->m_range;
 			data.position = { spotLight->m_transform->getPosition(), 1 };
 
-			gust::renderer.draw(data);
+			// Keep the spatial index up to date (Bounds of the whole range sphere)
+			AABB box = {};
+			box.min = spotLight->m_transform->getPosition() - glm::vec3(spotLight->m_range);
+			box.max = spotLight->m_transform->getPosition() + glm::vec3(spotLight->m_range);
+
+			if (spotLight->m_spatialProxy == SpatialIndex::nullProxy())
+				spotLight->m_spatialProxy = spatialIndex.insert(box, spotLight->getEntity(), SpatialIndex::SpotLight);
+			else
+				spatialIndex.update(spotLight->m_spatialProxy, box);
+
+			// Let camera queries find the light by its index this frame
+			spatialIndex.setUserData(spotLight->m_spatialProxy, gust::renderer.draw(data));
 		}
 	}
+
+	void SpotLightSystem::onEnd()
+	{
+		auto spotLight = getComponent<SpotLight>();
+
+		// Remove from spatial index
+		if (spotLight->m_spatialProxy != SpatialIndex::nullProxy())
+			getScene()->getSpatialIndex().remove(spotLight->m_spatialProxy);
+	}
 }
\ No newline at end of file
@@ -69,6 +69,9 @@ namespace gust
 		/** Light transform. */
 		Handle<Transform> m_transform = Handle<Transform>::nullHandle();
 
+		/** Spatial index proxy. */
+		size_t m_spatialProxy = SpatialIndex::nullProxy();
+
 	private:
 
 		/** Intensity. */
@@ -164,6 +167,11 @@ namespace gust
 		 * @param Delta time.
 		 */
 		void onPreRender(float deltaTime) override;
+
+		/**
+		 * @brief Called when a component is removed from the system.
+		 */
+		void onEnd() override;
 	};
 
 
@@ -338,5 +346,10 @@ namespace gust
 		 * @param Delta time.
 		 */
 		void onPreRender(float deltaTime) override;
+
+		/**
+		 * @brief Called when a component is removed from the system.
+		 */
+		void onEnd() override;
 	};
 }
\ No newline at end of file
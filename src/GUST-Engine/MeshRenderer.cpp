@@ -33,32 +33,19 @@ namespace gust
 		// Get transform
 		meshRenderer->m_transform = meshRenderer->getEntity().getComponent<Transform>();
 
-		// Create command buffers
-		meshRenderer->m_commandBuffer = gust::renderer.createCommandBuffer(vk::CommandBufferLevel::eSecondary);
-
-		// Fragment uniform buffer
-		meshRenderer->m_fragmentUniformBuffer = graphics->createBuffer
-		(
-			sizeof(FragmentShaderData),
-			vk::BufferUsageFlagBits::eUniformBuffer,
-			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
-		);
-
-		// Vertex uniform buffer
-		meshRenderer->m_vertexUniformBuffer = graphics->createBuffer
-		(
-			sizeof(VertexShaderData),
-			vk::BufferUsageFlagBits::eUniformBuffer,
-			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
-		);
-
-		vk::DescriptorPoolSize poolSize = {};
-		poolSize.setType(vk::DescriptorType::eUniformBuffer);
-		poolSize.setDescriptorCount(4);
+		// Bindless draws don't need a descriptor set of their own
+		if (graphics->isBindless())
+			return;
+
+		std::array<vk::DescriptorPoolSize, 2> poolSizes = {};
+		poolSizes[0].setType(vk::DescriptorType::eUniformBufferDynamic);
+		poolSizes[0].setDescriptorCount(2);
+		poolSizes[1].setType(vk::DescriptorType::eUniformBuffer);
+		poolSizes[1].setDescriptorCount(2);
 
 		vk::DescriptorPoolCreateInfo poolInfo = {};
-		poolInfo.setPoolSizeCount(1);
-		poolInfo.setPPoolSizes(&poolSize);
+		poolInfo.setPoolSizeCount(static_cast<uint32_t>(poolSizes.size()));
+		poolInfo.setPPoolSizes(poolSizes.data());
 		poolInfo.setMaxSets(1);
 
 		// Create descriptor pool
@@ -76,31 +63,31 @@ namespace gust
 
 		std::array<vk::WriteDescriptorSet, 2> writeSets = {};
 
-		// GUST vertex buffer
+		// GUST vertex buffer (Offset is supplied when drawing)
 		vk::DescriptorBufferInfo gustVertexBufferInfo = {};
-		gustVertexBufferInfo.setBuffer(meshRenderer->m_vertexUniformBuffer.buffer);
+		gustVertexBufferInfo.setBuffer(renderer->getUniformRingBuffer().getBuffer().buffer);
 		gustVertexBufferInfo.setOffset(0);
 		gustVertexBufferInfo.setRange(static_cast<vk::DeviceSize>(sizeof(VertexShaderData)));
 
 		writeSets[0].setDstSet(meshRenderer->m_descriptorSet);
 		writeSets[0].setDstBinding(0);
 		writeSets[0].setDstArrayElement(0);
-		writeSets[0].setDescriptorType(vk::DescriptorType::eUniformBuffer);
+		writeSets[0].setDescriptorType(vk::DescriptorType::eUniformBufferDynamic);
 		writeSets[0].setDescriptorCount(1);
 		writeSets[0].setPBufferInfo(&gustVertexBufferInfo);
 		writeSets[0].setPImageInfo(nullptr);
 		writeSets[0].setPTexelBufferView(nullptr);
 
-		// GUST fragment buffer
+		// GUST fragment buffer (Offset is supplied when drawing)
 		vk::DescriptorBufferInfo gustFragmentBufferInfo = {};
-		gustFragmentBufferInfo.setBuffer(meshRenderer->m_fragmentUniformBuffer.buffer);
+		gustFragmentBufferInfo.setBuffer(renderer->getUniformRingBuffer().getBuffer().buffer);
 		gustFragmentBufferInfo.setOffset(0);
 		gustFragmentBufferInfo.setRange(static_cast<vk::DeviceSize>(sizeof(FragmentShaderData)));
 
 		writeSets[1].setDstSet(meshRenderer->m_descriptorSet);
 		writeSets[1].setDstBinding(2);
 		writeSets[1].setDstArrayElement(0);
-		writeSets[1].setDescriptorType(vk::DescriptorType::eUniformBuffer);
+		writeSets[1].setDescriptorType(vk::DescriptorType::eUniformBufferDynamic);
 		writeSets[1].setDescriptorCount(1);
 		writeSets[1].setPBufferInfo(&gustFragmentBufferInfo);
 		writeSets[1].setPImageInfo(nullptr);
@@ -112,32 +99,72 @@ namespace gust
 
 	void MeshRendererSystem::onPreRender(float deltaTime)
 	{
+		auto& spatialIndex = getScene()->getSpatialIndex();
+
 		for (Handle<MeshRenderer> meshRenderer : *this)
 		{
-			if (meshRenderer->m_material != Handle<Material>::nullHandle() && meshRenderer->m_mesh != Handle<Mesh>::nullHandle())
+			// Keep the spatial index up to date
+			if (meshRenderer->m_mesh != Handle<Mesh>::nullHandle())
+			{
+				const AABB& box = meshRenderer->getWorldBounds().box;
+
+				if (meshRenderer->m_spatialProxy == SpatialIndex::nullProxy())
+					meshRenderer->m_spatialProxy = spatialIndex.insert(box, meshRenderer->getEntity(), SpatialIndex::Renderable);
+				else
+					spatialIndex.update(meshRenderer->m_spatialProxy, box);
+			}
+			else if (meshRenderer->m_spatialProxy != SpatialIndex::nullProxy())
+			{
+				spatialIndex.remove(meshRenderer->m_spatialProxy);
+				meshRenderer->m_spatialProxy = SpatialIndex::nullProxy();
+			}
+
+			// Keep the static draw up to date
+			if (meshRenderer->m_static && meshRenderer->m_staticDraw == Renderer::nullStaticDraw())
+				meshRenderer->m_staticDraw = gust::renderer.createStaticDraw();
+			else if (!meshRenderer->m_static && meshRenderer->m_staticDraw != Renderer::nullStaticDraw())
+			{
+				gust::renderer.destroyStaticDraw(meshRenderer->m_staticDraw);
+				meshRenderer->m_staticDraw = Renderer::nullStaticDraw();
+			}
+
+			// Resources are handed to the renderer once their uploads are done
+			if 
+			(
+				meshRenderer->m_material != Handle<Material>::nullHandle() && meshRenderer->m_mesh != Handle<Mesh>::nullHandle() &&
+				meshRenderer->m_mesh->isReady() && meshRenderer->m_material->isReady()
+			)
 			{
 				MeshData data = {};
-				data.commandBuffer = meshRenderer->m_commandBuffer;
 				data.material = meshRenderer->m_material;
 				data.mesh = meshRenderer->m_mesh;
 				data.model = meshRenderer->m_transform->getModelMatrix();
-				data.fragmentUniformBuffer = meshRenderer->m_fragmentUniformBuffer;
-				data.vertexUniformBuffer = meshRenderer->m_vertexUniformBuffer;
+				data.bounds = meshRenderer->getWorldBounds().box;
+				data.occluder = meshRenderer->m_occluder;
+				data.staticDraw = meshRenderer->m_staticDraw;
 
-				if (meshRenderer->m_material->getShader()->getTextureCount() > 0)
+				// Bindless draws share the renderers descriptor sets
+				if (!gust::graphics.isBindless())
 				{
-					data.descriptorSets.resize(2);
-					data.descriptorSets[0] = meshRenderer->m_descriptorSet;
-					data.descriptorSets[1] = meshRenderer->m_material->getTextureDescriptorSet();
-				}
-				else
-				{
-					data.descriptorSets.resize(1);
-					data.descriptorSets[0] = meshRenderer->m_descriptorSet;
+					if (meshRenderer->m_material->getShader()->getTextureCount() > 0)
+					{
+						data.descriptorSets.resize(2);
+						data.descriptorSets[0] = meshRenderer->m_descriptorSet;
+						data.descriptorSets[1] = meshRenderer->m_material->getTextureDescriptorSet();
+					}
+					else
+					{
+						data.descriptorSets.resize(1);
+						data.descriptorSets[0] = meshRenderer->m_descriptorSet;
+					}
 				}
 
-				gust::renderer.draw(data);
+				// Let camera queries find the mesh by its index this frame
+				const size_t meshIndex = gust::renderer.draw(data);
+				spatialIndex.setUserData(meshRenderer->m_spatialProxy, meshIndex);
 			}
+			else if (meshRenderer->m_spatialProxy != SpatialIndex::nullProxy())
+				spatialIndex.setUserData(meshRenderer->m_spatialProxy, std::numeric_limits<size_t>::max());
 		}
 	}
 
@@ -147,18 +174,16 @@ namespace gust
 		auto& graphics = gust::graphics;
 		const auto& logicalDevice = graphics.getLogicalDevice();
 
-		// Destroy command buffer
-		gust::renderer.destroyCommandBuffer(meshRenderer->m_commandBuffer);
-
-		// Destroy pool
-		logicalDevice.destroyDescriptorPool(meshRenderer->m_descriptorPool);
+		// Remove from spatial index
+		if (meshRenderer->m_spatialProxy != SpatialIndex::nullProxy())
+			getScene()->getSpatialIndex().remove(meshRenderer->m_spatialProxy);
 
-		// Cleanup fragment uniform buffer
-		logicalDevice.destroyBuffer(meshRenderer->m_fragmentUniformBuffer.buffer);
-		logicalDevice.freeMemory(meshRenderer->m_fragmentUniformBuffer.memory);
+		// Release cached command buffers
+		if (meshRenderer->m_staticDraw != Renderer::nullStaticDraw())
+			gust::renderer.destroyStaticDraw(meshRenderer->m_staticDraw);
 
-		// Cleanup vertex uniform buffer
-		logicalDevice.destroyBuffer(meshRenderer->m_vertexUniformBuffer.buffer);
-		logicalDevice.freeMemory(meshRenderer->m_vertexUniformBuffer.memory);
+		// Destroy pool
+		if (meshRenderer->m_descriptorPool)
+			logicalDevice.destroyDescriptorPool(meshRenderer->m_descriptorPool);
 	}
 }
@@ -7,7 +7,9 @@
  */
 
 /** Includes. */
+#include <limits>
 #include <Math.hpp>
+#include <Bounds.hpp>
 #include <Scene.hpp>
 #include <Renderer.hpp>
 
@@ -53,7 +55,8 @@ namespace gust
 		{
 			m_material = material;
 
-			if (m_material != Handle<Material>::nullHandle())
+			// Bindless shaders find the materials data through the descriptor heap
+			if (m_material != Handle<Material>::nullHandle() && !gust::graphics.isBindless())
 			{
 				std::array<vk::WriteDescriptorSet, 2> writeSets = {};
 				
@@ -102,9 +105,55 @@ namespace gust
 		inline Handle<Mesh> setMesh(Handle<Mesh> mesh)
 		{
 			m_mesh = mesh;
+			m_worldBoundsVersion = std::numeric_limits<uint64_t>::max();
 			return m_mesh;
 		}
 
+		/**
+		 * @brief Set if the mesh hides other meshes during occlusion culling.
+		 * @param If the mesh is an occluder.
+		 * @return If the mesh is an occluder.
+		 * @note Best used on large, simple meshes such as walls and floors.
+		 * @note Meshes without CPU geometry are never rasterized as occluders.
+		 * @see Mesh::hasCpuGeometry
+		 */
+		inline bool setOccluder(bool occluder)
+		{
+			m_occluder = occluder;
+			return m_occluder;
+		}
+
+		/**
+		 * @brief Check if the mesh hides other meshes during occlusion culling.
+		 * @return If the mesh is an occluder.
+		 */
+		inline bool isOccluder() const
+		{
+			return m_occluder;
+		}
+
+		/**
+		 * @brief Set if the mesh rarely changes.
+		 * @param If the mesh is static.
+		 * @return If the mesh is static.
+		 * @note Static meshes reuse their command buffers between frames. Moving them is fine, but
+		 * changing their mesh or material forces the command buffers to be recorded again.
+		 */
+		inline bool setStatic(bool isStatic)
+		{
+			m_static = isStatic;
+			return m_static;
+		}
+
+		/**
+		 * @brief Check if the mesh rarely changes.
+		 * @return If the mesh is static.
+		 */
+		inline bool isStatic() const
+		{
+			return m_static;
+		}
+
 		/**
 		 * @brief Get material.
 		 * @return Material.
@@ -123,6 +172,25 @@ namespace gust
 			return m_mesh;
 		}
 
+		/**
+		 * @brief Get world space bounds of the mesh.
+		 * @return World space bounds.
+		 * @note Only recomputed when the model matrix or mesh changes.
+		 */
+		inline const Bounds& getWorldBounds()
+		{
+			gAssert(m_mesh != Handle<Mesh>::nullHandle());
+			const uint64_t version = m_transform->getModelMatrixVersion();
+
+			if (version != m_worldBoundsVersion)
+			{
+				m_worldBounds = m_mesh->getBounds().transform(m_transform->getModelMatrix());
+				m_worldBoundsVersion = version;
+			}
+
+			return m_worldBounds;
+		}
+
 	private:
 
 		/** Transform component. */
@@ -134,20 +202,29 @@ namespace gust
 		/** Mesh to use when rendering. */
 		Handle<Mesh> m_mesh = Handle<Mesh>::nullHandle();
 
-		/** Command buffer to use when rendering. */
-		CommandBuffer m_commandBuffer = {};
-		
-		/** Fragment uniform buffer. */
-		Buffer m_fragmentUniformBuffer = {};
-		
-		/** Vertex uniform buffer. */
-		Buffer m_vertexUniformBuffer = {};
-		
 		/** Descriptor pool. */
 		vk::DescriptorPool m_descriptorPool = {};
 		
 		/** Vertex descriptor set. */
 		vk::DescriptorSet m_descriptorSet = {};
+
+		/** World space bounds. */
+		Bounds m_worldBounds = {};
+
+		/** Model matrix version the world space bounds were computed with (Never matches a real version until computed.) */
+		uint64_t m_worldBoundsVersion = std::numeric_limits<uint64_t>::max();
+
+		/** Spatial index proxy. */
+		size_t m_spatialProxy = SpatialIndex::nullProxy();
+
+		/** Static draw in the renderer. */
+		size_t m_staticDraw = Renderer::nullStaticDraw();
+
+		/** Does the mesh hide other meshes during occlusion culling? */
+		bool m_occluder = false;
+
+		/** Does the mesh rarely change? */
+		bool m_static = false;
 	};
 
 
@@ -1,3 +1,5 @@
+#include <FileIO.hpp>
+#include <GMesh.hpp>
 #include "ResourceManager.hpp"
 #include <Renderer.hpp>
 
@@ -49,7 +51,7 @@ namespace gust
 		m_textureAllocator = {};
 	}
 
-	Handle<Mesh> ResourceManager::createMesh(const std::string& path)
+	Handle<Mesh> ResourceManager::createMesh(const std::string& path, bool keepGeometry)
 	{
 		// Resize the array if necessary
 		if (m_meshAllocator->getResourceCount() == m_meshAllocator->getMaxResourceCount())
@@ -58,11 +60,81 @@ namespace gust
 		// Allocate mesh and call constructor
 		auto mesh = Handle<Mesh>(m_meshAllocator.get(), m_meshAllocator->allocate());
 		// *mesh.get() = Mesh(m_graphics, path);
-		::new(mesh.get())(Mesh)(m_graphics, path);
+		::new(mesh.get())(Mesh)(m_graphics, path, m_renderer->getThreadPool(), keepGeometry);
+
+		// Give the slot back if the file couldn't be loaded
+		if (!mesh->isLoaded())
+		{
+			m_meshAllocator->deallocate(mesh.getHandle());
+			return Handle<Mesh>::nullHandle();
+		}
+
+		return mesh;
+	}
+
+	Handle<Mesh> ResourceManager::createMesh(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices)
+	{
+		// Resize the array if necessary
+		if (m_meshAllocator->getResourceCount() == m_meshAllocator->getMaxResourceCount())
+			m_meshAllocator->resize(m_meshAllocator->getMaxResourceCount() + 100, true);
+
+		// Allocate mesh and call constructor
+		auto mesh = Handle<Mesh>(m_meshAllocator.get(), m_meshAllocator->allocate());
+		::new(mesh.get())(Mesh)(m_graphics, indices, vertices);
 
 		return mesh;
 	}
 
+	std::vector<Handle<Mesh>> ResourceManager::createMeshLODs
+	(
+		Handle<Mesh> mesh,
+		size_t levelCount,
+		float ratio,
+		float maxError
+	)
+	{
+		gAssert(mesh->hasCpuGeometry());
+		std::vector<Handle<Mesh>> levels = { mesh };
+
+		std::vector<Vertex> vertices = mesh->getVertices();
+		std::vector<uint32_t> indices = mesh->getIndices();
+
+		while (levels.size() < levelCount)
+		{
+			const size_t target = static_cast<size_t>((indices.size() / 3) * ratio) * 3;
+			SimplifiedMesh simplified = simplifyMesh(vertices, indices, target, maxError);
+
+			// Not worth another level
+			if (simplified.indices.empty() || simplified.indices.size() >= indices.size() * 9 / 10)
+				break;
+
+			levels.push_back(createMesh(simplified.indices, simplified.vertices));
+			vertices = std::move(simplified.vertices);
+			indices = std::move(simplified.indices);
+		}
+
+		return levels;
+	}
+
+	std::vector<Handle<Mesh>> ResourceManager::createMeshLODs(const std::string& path, bool keepGeometry)
+	{
+		const GMeshFile file(path);
+		std::vector<Handle<Mesh>> levels(file.getLevelCount());
+
+		for (size_t i = 0; i < levels.size(); ++i)
+		{
+			// Resize the array if necessary
+			if (m_meshAllocator->getResourceCount() == m_meshAllocator->getMaxResourceCount())
+				m_meshAllocator->resize(m_meshAllocator->getMaxResourceCount() + 100, true);
+
+			// Allocate mesh and call constructor
+			levels[i] = Handle<Mesh>(m_meshAllocator.get(), m_meshAllocator->allocate());
+			::new(levels[i].get())(Mesh)(m_graphics, file, i, keepGeometry);
+		}
+
+		return levels;
+	}
+
 	Handle<Texture> ResourceManager::createTexture(const std::string& path, vk::Filter filtering)
 	{
 		// Resize the array if necessary
@@ -105,7 +177,7 @@ namespace gust
 		vk::Image image,
 		vk::ImageView imageView,
 		vk::Sampler sampler,
-		vk::DeviceMemory memory,
+		VmaAllocation allocation,
 		uint32_t width,
 		uint32_t height
 	)
@@ -116,8 +188,8 @@ namespace gust
 
 		// Allocate texture and call constructor
 		auto texture = Handle<Texture>(m_textureAllocator.get(), m_textureAllocator->allocate());
-		// *texture.get() = Texture(m_graphics, image, imageView, sampler, memory, width, height);
-		::new(texture.get())(Texture)(m_graphics, image, imageView, sampler, memory, width, height);
+		// *texture.get() = Texture(m_graphics, image, imageView, sampler, allocation, width, height);
+		::new(texture.get())(Texture)(m_graphics, image, imageView, sampler, allocation, width, height);
 
 		return texture;
 	}
@@ -127,7 +199,7 @@ namespace gust
 		vk::Image image,
 		vk::ImageView imageView,
 		vk::Sampler sampler,
-		vk::DeviceMemory memory,
+		VmaAllocation allocation,
 		uint32_t width,
 		uint32_t height
 	)
@@ -138,8 +210,8 @@ namespace gust
 
 		// Allocate texture and call constructor
 		auto cubemap = Handle<Cubemap>(m_textureAllocator.get(), m_textureAllocator->allocate());
-		// *cubemap.get() = Cubemap(m_graphics, image, imageView, sampler, memory, width, height);
-		::new(cubemap.get())(Cubemap)(m_graphics, image, imageView, sampler, memory, width, height);
+		// *cubemap.get() = Cubemap(m_graphics, image, imageView, sampler, allocation, width, height);
+		::new(cubemap.get())(Cubemap)(m_graphics, image, imageView, sampler, allocation, width, height);
 
 		return cubemap;
 	}
@@ -152,46 +224,64 @@ namespace gust
 		size_t fragmentDataSize,
 		size_t textureCount,
 		bool depthTesting,
-		bool lighting
+		bool lighting,
+		const std::string& instancedVertexPath
 	)
 	{
-		// Resize the array if necessary
-		if (m_shaderAllocator->getResourceCount() == m_shaderAllocator->getMaxResourceCount())
+		ShaderDescription description = {};
+		description.vertexPath = vertexPath;
+		description.fragmentPath = fragmentPath;
+		description.vertexDataSize = vertexDataSize;
+		description.fragmentDataSize = fragmentDataSize;
+		description.textureCount = textureCount;
+		description.depthTesting = depthTesting;
+		description.lighting = lighting;
+		description.instancedVertexPath = instancedVertexPath;
+
+		return createShaders({ description })[0];
+	}
+
+	std::vector<Handle<Shader>> ResourceManager::createShaders(const std::vector<ShaderDescription>& descriptions)
+	{
+		// Resize the array if necessary (Workers can't allocate)
+		while (m_shaderAllocator->getResourceCount() + descriptions.size() > m_shaderAllocator->getMaxResourceCount())
 			m_shaderAllocator->resize(m_shaderAllocator->getMaxResourceCount() + 100, true);
 
-		// Allocate shader and call constructor
-		auto shader = Handle<Shader>(m_shaderAllocator.get(), m_shaderAllocator->allocate());
-		/*
-		*shader.get() = Shader
-		(
-			m_graphics,
-			{ m_renderer->getStandardLayout() },
-			m_renderer->getOffscreenRenderPass(),
-			vertexPath,
-			fragmentPath,
-			vertexDataSize,
-			fragmentDataSize,
-			textureCount,
-			depthTesting,
-			lighting
-		);
-		*/
-
-		::new(shader.get())(Shader)
-			(
-				m_graphics, 
-				{m_renderer->getStandardLayout()}, 
-				m_renderer->getOffscreenRenderPass(), 
-				vertexPath, 
-				fragmentPath,
-				vertexDataSize,
-				fragmentDataSize,
-				textureCount,
-				depthTesting,
-				lighting
-			);
-
-		return shader;
+		std::vector<Handle<Shader>> shaders(descriptions.size());
+		ThreadPool* threadPool = m_renderer->getThreadPool();
+
+		for (size_t i = 0; i < descriptions.size(); ++i)
+		{
+			// Allocate shader
+			shaders[i] = Handle<Shader>(m_shaderAllocator.get(), m_shaderAllocator->allocate());
+			Shader* shader = shaders[i].get();
+			const ShaderDescription* description = &descriptions[i];
+
+			// Create modules and pipelines on a worker (Pipeline creation and the pipeline cache are thread safe)
+			threadPool->workers[i % threadPool->getWorkerCount()]->addJob([this, shader, description]()
+			{
+				::new(shader)(Shader)
+				(
+					m_graphics, 
+					m_renderer->getStandardLayouts(), 
+					m_renderer->getOffscreenRenderPass(), 
+					description->vertexPath, 
+					description->fragmentPath,
+					description->vertexDataSize,
+					description->fragmentDataSize,
+					description->textureCount,
+					description->depthTesting,
+					description->lighting
+				);
+
+				// Instanced variant (Optional, so shaders still work if it wasn't built)
+				if (!description->instancedVertexPath.empty() && fileExists(description->instancedVertexPath))
+					shader->enableInstancing(readBinary(description->instancedVertexPath), m_renderer->getOffscreenRenderPass());
+			});
+		}
+
+		threadPool->wait();
+		return shaders;
 	}
 
 	Handle<Material> ResourceManager::createMaterial(Handle<Shader> shader)
@@ -9,7 +9,9 @@
 /** Includes. */
 #include "vulkan\vulkan.hpp"
 #include "Allocators.hpp"
+#include "Threading.hpp"
 #include "Mesh.hpp"
+#include "MeshSimplifier.hpp"
 #include "Material.hpp"
 #include "Shader.hpp"
 #include "Texture.hpp"
@@ -102,10 +104,46 @@ namespace gust
 
 		/**
 		 * @brief Create a mesh.
-		 * @param Path to an OBJ file containing the mesh.
+		 * @param Path to an OBJ or cooked (GUST_GMESH_EXTENSION) file containing the mesh.
+		 * @param Keep a CPU copy of the vertices and indices (Needed for occluders, simplification and meshlets.)
+		 * @return Mesh handle (Null if the file can't be loaded.)
+		 * @note OBJ files are parsed on the renderers thread pool.
+		 */
+		Handle<Mesh> createMesh(const std::string& path, bool keepGeometry = false);
+
+		/**
+		 * @brief Create a mesh.
+		 * @param Meshes indices.
+		 * @param Meshes vertices.
 		 * @return Mesh handle.
 		 */
-		Handle<Mesh> createMesh(const std::string& path);
+		Handle<Mesh> createMesh(const std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices);
+
+		/**
+		 * @brief Create a chain of progressively simpler meshes.
+		 * @param Mesh to simplify (Must have CPU geometry.)
+		 * @param Maximum number of levels (Including the original mesh.)
+		 * @param Fraction of triangles each level keeps from the previous one.
+		 * @param Largest distance (In mesh units) a surface may move per level.
+		 * @return Levels of detail, starting with the original mesh.
+		 * @note Stops early once the mesh can't be simplified further.
+		 */
+		std::vector<Handle<Mesh>> createMeshLODs
+		(
+			Handle<Mesh> mesh,
+			size_t levelCount,
+			float ratio = 0.5f,
+			float maxError = std::numeric_limits<float>::max()
+		);
+
+		/**
+		 * @brief Create every level of detail in a cooked mesh.
+		 * @param Path to a cooked (GUST_GMESH_EXTENSION) file.
+		 * @param Keep a CPU copy of every levels vertices and indices.
+		 * @return Levels of detail, starting with the original mesh (Empty if the file is invalid.)
+		 * @note The file is mapped once for all of the levels.
+		 */
+		std::vector<Handle<Mesh>> createMeshLODs(const std::string& path, bool keepGeometry = false);
 
 		/**
 		 * @brief Create a texture.
@@ -142,7 +180,7 @@ namespace gust
 		 * @param Image.
 		 * @param Image view.
 		 * @param Sampler.
-		 * @param Image memory.
+		 * @param Image allocation.
 		 * @param Width.
 		 * @param Height.
 		 * @return Texture handle.
@@ -152,7 +190,7 @@ namespace gust
 			vk::Image image, 
 			vk::ImageView imageView, 
 			vk::Sampler sampler, 
-			vk::DeviceMemory memory, 
+			VmaAllocation allocation, 
 			uint32_t width, 
 			uint32_t height
 		);
@@ -162,7 +200,7 @@ namespace gust
 		 * @param Image.
 		 * @param Image view.
 		 * @param Sampler.
-		 * @param Image memory.
+		 * @param Image allocation.
 		 * @param Width.
 		 * @param Height.
 		 * @return Texture handle.
@@ -172,7 +210,7 @@ namespace gust
 			vk::Image image, 
 			vk::ImageView imageView, 
 			vk::Sampler sampler, 
-			vk::DeviceMemory memory, 
+			VmaAllocation allocation, 
 			uint32_t width, 
 			uint32_t height
 		);
@@ -186,6 +224,7 @@ namespace gust
 		 * @param Number of textures used by the shader.
 		 * @param Should the shader perform depth testing?
 		 * @param Should the shader perform lighting calculations?
+		 * @param Path to an instanced variant of the vertex shader (Empty to disable instancing. Skipped if the file is missing.)
 		 * @return Shader handle.
 		 */
 		Handle<Shader> createShader
@@ -196,9 +235,19 @@ namespace gust
 			size_t fragmentDataSize,
 			size_t textureCount,
 			bool depthTesting,
-			bool lighting
+			bool lighting,
+			const std::string& instancedVertexPath = ""
 		);
 
+		/**
+		 * @brief Create many shaders at once.
+		 * @param Shader descriptions.
+		 * @return Shader handles, in the same order as the descriptions.
+		 * @note Shader modules and pipelines are created in parallel on the renderers thread pool,
+		 * so prefer this over createShader() when loading several shaders.
+		 */
+		std::vector<Handle<Shader>> createShaders(const std::vector<ShaderDescription>& descriptions);
+
 		/**
 		 * @brief Create a material.
 		 * @param Shader used by the material.
@@ -0,0 +1,564 @@
+#include <algorithm>
+#include <cstring>
+#include <FileIO.hpp>
+#include <Frustum.hpp>
+#include <Debugging.hpp>
+#include "Renderer.hpp"
+#include "ClusterCuller.hpp"
+
+namespace gust
+{
+	ClusterCuller::ClusterCuller(Graphics* graphics, uint32_t frameCount) :
+		m_graphics(graphics),
+		m_frameCount(frameCount)
+	{
+		// Create per frame buffers (Mapped once for their lifetime)
+		m_clusterBuffers.resize(m_frameCount);
+		m_clusters.resize(m_frameCount);
+		m_drawBuffers.resize(m_frameCount);
+		m_draws.resize(m_frameCount);
+		m_commandBuffers.resize(m_frameCount);
+		m_commands.resize(m_frameCount);
+
+		for (uint32_t i = 0; i < m_frameCount; ++i)
+		{
+			m_clusterBuffers[i] = m_graphics->createBuffer
+			(
+				static_cast<vk::DeviceSize>(sizeof(GpuCluster) * GUST_CLUSTER_CULLING_MAX_CLUSTERS),
+				vk::BufferUsageFlagBits::eStorageBuffer,
+				vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+			);
+
+			m_drawBuffers[i] = m_graphics->createBuffer
+			(
+				static_cast<vk::DeviceSize>(sizeof(GpuClusterDraw) * GUST_CLUSTER_CULLING_MAX_DRAWS),
+				vk::BufferUsageFlagBits::eStorageBuffer,
+				vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+			);
+
+			m_commandBuffers[i] = m_graphics->createBuffer
+			(
+				static_cast<vk::DeviceSize>(sizeof(vk::DrawIndexedIndirectCommand) * GUST_CLUSTER_CULLING_MAX_DRAWS),
+				vk::BufferUsageFlagBits::eTransferSrc,
+				vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+			);
+
+			m_clusters[i] = static_cast<GpuCluster*>(m_graphics->mapBuffer(m_clusterBuffers[i]));
+			m_draws[i] = static_cast<GpuClusterDraw*>(m_graphics->mapBuffer(m_drawBuffers[i]));
+			m_commands[i] = static_cast<vk::DrawIndexedIndirectCommand*>(m_graphics->mapBuffer(m_commandBuffers[i]));
+		}
+
+		initPipeline();
+	}
+
+	uint32_t ClusterCuller::beginFrame(uint32_t frameIndex, const std::vector<MeshData>& meshes, std::vector<bool>& clustered)
+	{
+		m_frameIndex = frameIndex;
+
+		m_groups.clear();
+		m_groupLookup.clear();
+		m_drawMeshes.clear();
+		m_drawGroups.clear();
+		clustered.assign(meshes.size(), false);
+
+		const size_t meshCount = meshes.size();
+		size_t clusterCount = 0;
+		size_t indexCount = 0;
+
+		// Group meshes with meshlets sharing a material and geometry block
+		for (size_t i = 0; i < meshCount; ++i)
+		{
+			const MeshData& mesh = meshes[i];
+			const auto& meshlets = mesh.mesh->getMeshlets();
+
+			if (meshlets.empty())
+				continue;
+
+			// Meshes that don't fit are culled whole instead
+			if
+			(
+				m_drawMeshes.size() == GUST_CLUSTER_CULLING_MAX_DRAWS ||
+				clusterCount + meshlets.size() > GUST_CLUSTER_CULLING_MAX_CLUSTERS ||
+				indexCount + mesh.mesh->getIndexCount() > GUST_CLUSTER_CULLING_MAX_INDICES
+			)
+				continue;
+
+			const uint64_t key = (static_cast<uint64_t>(mesh.material.getHandle()) << 32) | mesh.mesh->getGeometryBlock();
+			auto it = m_groupLookup.find(key);
+
+			if (it == m_groupLookup.end())
+			{
+				ClusterDrawGroup group = {};
+				group.material = mesh.material;
+				group.block = mesh.mesh->getGeometryBlock();
+
+				it = m_groupLookup.emplace(key, static_cast<uint32_t>(m_groups.size())).first;
+				m_groups.push_back(group);
+			}
+
+			++m_groups[it->second].drawCount;
+			m_groups[it->second].clusterCount += static_cast<uint32_t>(meshlets.size());
+
+			m_drawMeshes.push_back(static_cast<uint32_t>(i));
+			m_drawGroups.push_back(it->second);
+			clustered[i] = true;
+
+			clusterCount += meshlets.size();
+			indexCount += mesh.mesh->getIndexCount();
+		}
+
+		m_drawCount = static_cast<uint32_t>(m_drawMeshes.size());
+
+		// Order groups so those sharing a shader are drawn together
+		std::vector<uint32_t> order(m_groups.size());
+		for (uint32_t i = 0; i < order.size(); ++i)
+			order[i] = i;
+
+		std::sort(order.begin(), order.end(), [this](uint32_t lh, uint32_t rh)
+		{
+			const size_t lhShader = m_groups[lh].material->getShader().getHandle();
+			const size_t rhShader = m_groups[rh].material->getShader().getHandle();
+			return lhShader != rhShader ? lhShader < rhShader : lh < rh;
+		});
+
+		std::vector<ClusterDrawGroup> groups(m_groups.size());
+		std::vector<uint32_t> remap(m_groups.size());
+
+		for (uint32_t i = 0; i < order.size(); ++i)
+		{
+			groups[i] = m_groups[order[i]];
+			remap[order[i]] = i;
+		}
+
+		m_groups = std::move(groups);
+
+		// Give each group a contiguous range of commands and meshlets (Meshlets are dispatched per group)
+		std::vector<uint32_t> drawCursors(m_groups.size());
+		std::vector<uint32_t> clusterCursors(m_groups.size());
+		uint32_t firstDraw = 0;
+		uint32_t firstCluster = 0;
+
+		for (uint32_t i = 0; i < m_groups.size(); ++i)
+		{
+			m_groups[i].firstDraw = firstDraw;
+			m_groups[i].firstCluster = firstCluster;
+			drawCursors[i] = firstDraw;
+			clusterCursors[i] = firstCluster;
+			firstDraw += m_groups[i].drawCount;
+			firstCluster += m_groups[i].clusterCount;
+		}
+
+		// Write meshes, meshlets and the commands culling starts from
+		GpuCluster* clusters = m_clusters[m_frameIndex];
+		GpuClusterDraw* draws = m_draws[m_frameIndex];
+		vk::DrawIndexedIndirectCommand* commands = m_commands[m_frameIndex];
+		uint32_t outputFirstIndex = 0;
+
+		for (size_t i = 0; i < m_drawMeshes.size(); ++i)
+		{
+			const MeshData& mesh = meshes[m_drawMeshes[i]];
+			const uint32_t group = remap[m_drawGroups[i]];
+			const uint32_t index = drawCursors[group]++;
+
+			// Spheres grow by the largest scale and cones only survive rotations and uniform scales
+			const glm::mat3 basis = glm::mat3(mesh.model);
+			const glm::vec3 scales = glm::vec3(glm::length(basis[0]), glm::length(basis[1]), glm::length(basis[2]));
+			const float maxScale = std::max(scales.x, std::max(scales.y, scales.z));
+			const float minScale = std::min(scales.x, std::min(scales.y, scales.z));
+
+			GpuClusterDraw& draw = draws[index];
+			draw.model = mesh.model;
+			draw.sourceFirstIndex = mesh.mesh->getFirstIndex();
+			draw.shortIndices = mesh.mesh->getIndexType() == vk::IndexType::eUint16 ? 1 : 0;
+			draw.outputFirstIndex = outputFirstIndex;
+			draw.scale = maxScale;
+			draw.coneCulling = minScale >= maxScale * 0.999f && glm::determinant(basis) > 0.0f ? 1 : 0;
+
+			vk::DrawIndexedIndirectCommand& command = commands[index];
+			command.setIndexCount(0);
+			command.setInstanceCount(1);
+			command.setFirstIndex(outputFirstIndex);
+			command.setVertexOffset(mesh.mesh->getVertexOffset());
+			command.setFirstInstance(m_drawMeshes[i]);
+
+			for (const Meshlet& meshlet : mesh.mesh->getMeshlets())
+			{
+				GpuCluster& cluster = clusters[clusterCursors[group]++];
+				cluster.sphere = glm::vec4(meshlet.center, meshlet.radius);
+				cluster.cone = glm::vec4(meshlet.coneAxis, meshlet.coneCutoff);
+				cluster.firstIndex = meshlet.firstIndex;
+				cluster.indexCount = meshlet.indexCount;
+				cluster.draw = index;
+			}
+
+			outputFirstIndex += mesh.mesh->getIndexCount();
+		}
+
+		return m_drawCount;
+	}
+
+	void ClusterCuller::cull(const vk::CommandBuffer& commandBuffer, size_t camera, const glm::mat4& viewProjection, const glm::vec3& viewPosition)
+	{
+		if (m_drawCount == 0)
+			return;
+
+		const CullOutput& output = getCamera(camera).frames[m_frameIndex];
+
+		// Start every draw with no indices
+		{
+			vk::BufferCopy region = {};
+			region.setSrcOffset(0);
+			region.setDstOffset(0);
+			region.setSize(static_cast<vk::DeviceSize>(sizeof(vk::DrawIndexedIndirectCommand) * m_drawCount));
+
+			commandBuffer.copyBuffer(m_commandBuffers[m_frameIndex].buffer, output.commandBuffer.buffer, 1, &region);
+
+			vk::MemoryBarrier barrier = {};
+			barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+			barrier.setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+
+			commandBuffer.pipelineBarrier
+			(
+				vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader,
+				(vk::DependencyFlagBits)0,
+				1, &barrier,
+				0, nullptr,
+				0, nullptr
+			);
+		}
+
+		const Frustum frustum(viewProjection);
+
+		PushConstants constants = {};
+		constants.viewPosition = glm::vec4(viewPosition, 1);
+
+		for (size_t i = 0; i < constants.planes.size(); ++i)
+			constants.planes[i] = frustum.getPlane(i);
+
+		commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_pipeline);
+
+		// One workgroup per meshlet, dispatched per group since each reads its own geometry block
+		for (const ClusterDrawGroup& group : m_groups)
+		{
+			const std::array<vk::DescriptorSet, 2> descriptorSets =
+			{
+				output.descriptorSet,
+				getBlockDescriptorSet(group.block)
+			};
+
+			constants.firstCluster = group.firstCluster;
+
+			commandBuffer.bindDescriptorSets
+			(
+				vk::PipelineBindPoint::eCompute,
+				m_pipelineLayout,
+				0,
+				static_cast<uint32_t>(descriptorSets.size()),
+				descriptorSets.data(),
+				0,
+				nullptr
+			);
+
+			commandBuffer.pushConstants(m_pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(PushConstants), &constants);
+			commandBuffer.dispatch(group.clusterCount, 1, 1);
+		}
+
+		// Make commands and indices visible to indirect draws
+		vk::MemoryBarrier barrier = {};
+		barrier.setSrcAccessMask(vk::AccessFlagBits::eShaderWrite);
+		barrier.setDstAccessMask(vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eIndexRead);
+
+		commandBuffer.pipelineBarrier
+		(
+			vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput,
+			(vk::DependencyFlagBits)0,
+			1, &barrier,
+			0, nullptr,
+			0, nullptr
+		);
+	}
+
+	void ClusterCuller::draw(const vk::CommandBuffer& commandBuffer, size_t camera, size_t group)
+	{
+		const CullOutput& output = getCamera(camera).frames[m_frameIndex];
+		const ClusterDrawGroup& drawGroup = m_groups[group];
+
+		// Meshes with no visible meshlets draw no indices
+		commandBuffer.bindIndexBuffer(output.indexBuffer.buffer, 0, vk::IndexType::eUint32);
+		commandBuffer.drawIndexedIndirect
+		(
+			output.commandBuffer.buffer,
+			static_cast<vk::DeviceSize>(sizeof(vk::DrawIndexedIndirectCommand) * drawGroup.firstDraw),
+			drawGroup.drawCount,
+			static_cast<uint32_t>(sizeof(vk::DrawIndexedIndirectCommand))
+		);
+	}
+
+	void ClusterCuller::free()
+	{
+		if (m_graphics)
+		{
+			auto logicalDevice = m_graphics->getLogicalDevice();
+
+			for (auto& camera : m_cameras)
+			{
+				for (auto& output : camera.frames)
+				{
+					m_graphics->destroyBuffer(output.commandBuffer);
+					m_graphics->destroyBuffer(output.indexBuffer);
+				}
+
+				logicalDevice.destroyDescriptorPool(camera.descriptorPool);
+			}
+
+			m_cameras.clear();
+
+			for (uint32_t i = 0; i < m_frameCount; ++i)
+			{
+				m_graphics->unmapBuffer(m_clusterBuffers[i]);
+				m_graphics->unmapBuffer(m_drawBuffers[i]);
+				m_graphics->unmapBuffer(m_commandBuffers[i]);
+				m_graphics->destroyBuffer(m_clusterBuffers[i]);
+				m_graphics->destroyBuffer(m_drawBuffers[i]);
+				m_graphics->destroyBuffer(m_commandBuffers[i]);
+			}
+
+			m_clusterBuffers.clear();
+			m_clusters.clear();
+			m_drawBuffers.clear();
+			m_draws.clear();
+			m_commandBuffers.clear();
+			m_commands.clear();
+
+			logicalDevice.destroyDescriptorPool(m_blockDescriptorPool);
+			m_blockDescriptorSets.clear();
+
+			logicalDevice.destroyPipeline(m_pipeline);
+			logicalDevice.destroyPipelineLayout(m_pipelineLayout);
+			logicalDevice.destroyDescriptorSetLayout(m_blockDescriptorSetLayout);
+			logicalDevice.destroyDescriptorSetLayout(m_descriptorSetLayout);
+			logicalDevice.destroyShaderModule(m_shader);
+
+			m_graphics = nullptr;
+		}
+	}
+
+	void ClusterCuller::initPipeline()
+	{
+		auto logicalDevice = m_graphics->getLogicalDevice();
+
+		// Create descriptor set layout (Meshlets, meshes, commands and output indices)
+		{
+			std::array<vk::DescriptorSetLayoutBinding, 4> bindings = {};
+
+			for (uint32_t i = 0; i < bindings.size(); ++i)
+			{
+				bindings[i].setBinding(i);
+				bindings[i].setDescriptorType(vk::DescriptorType::eStorageBuffer);
+				bindings[i].setDescriptorCount(1);
+				bindings[i].setStageFlags(vk::ShaderStageFlagBits::eCompute);
+			}
+
+			vk::DescriptorSetLayoutCreateInfo createInfo = {};
+			createInfo.setBindingCount(static_cast<uint32_t>(bindings.size()));
+			createInfo.setPBindings(bindings.data());
+
+			m_descriptorSetLayout = logicalDevice.createDescriptorSetLayout(createInfo);
+		}
+
+		// Create geometry block descriptor set layout (Source indices)
+		{
+			vk::DescriptorSetLayoutBinding binding = {};
+			binding.setBinding(0);
+			binding.setDescriptorType(vk::DescriptorType::eStorageBuffer);
+			binding.setDescriptorCount(1);
+			binding.setStageFlags(vk::ShaderStageFlagBits::eCompute);
+
+			vk::DescriptorSetLayoutCreateInfo createInfo = {};
+			createInfo.setBindingCount(1);
+			createInfo.setPBindings(&binding);
+
+			m_blockDescriptorSetLayout = logicalDevice.createDescriptorSetLayout(createInfo);
+		}
+
+		// Create geometry block descriptor pool
+		{
+			vk::DescriptorPoolSize poolSize = {};
+			poolSize.setType(vk::DescriptorType::eStorageBuffer);
+			poolSize.setDescriptorCount(GUST_MAX_GEOMETRY_BLOCKS);
+
+			vk::DescriptorPoolCreateInfo poolInfo = {};
+			poolInfo.setPoolSizeCount(1);
+			poolInfo.setPPoolSizes(&poolSize);
+			poolInfo.setMaxSets(GUST_MAX_GEOMETRY_BLOCKS);
+
+			m_blockDescriptorPool = logicalDevice.createDescriptorPool(poolInfo);
+			m_blockDescriptorSets.resize(GUST_MAX_GEOMETRY_BLOCKS);
+		}
+
+		// Create pipeline layout
+		{
+			const std::array<vk::DescriptorSetLayout, 2> setLayouts = { m_descriptorSetLayout, m_blockDescriptorSetLayout };
+
+			vk::PushConstantRange pushConstantRange = {};
+			pushConstantRange.setStageFlags(vk::ShaderStageFlagBits::eCompute);
+			pushConstantRange.setOffset(0);
+			pushConstantRange.setSize(sizeof(PushConstants));
+
+			vk::PipelineLayoutCreateInfo layoutInfo = {};
+			layoutInfo.setSetLayoutCount(static_cast<uint32_t>(setLayouts.size()));
+			layoutInfo.setPSetLayouts(setLayouts.data());
+			layoutInfo.setPushConstantRangeCount(1);
+			layoutInfo.setPPushConstantRanges(&pushConstantRange);
+
+			m_pipelineLayout = logicalDevice.createPipelineLayout(layoutInfo);
+		}
+
+		// Create shader module
+		{
+			std::vector<char> source = readBinary(GUST_CLUSTER_CULLING_COMPUTE_SHADER_PATH);
+
+			// Align code
+			std::vector<uint32_t> codeAligned(source.size() / sizeof(uint32_t) + 1);
+			memcpy(codeAligned.data(), source.data(), source.size());
+
+			vk::ShaderModuleCreateInfo createInfo = {};
+			createInfo.setCodeSize(source.size());
+			createInfo.setPCode(codeAligned.data());
+
+			m_shader = logicalDevice.createShaderModule(createInfo);
+		}
+
+		// Create pipeline
+		{
+			vk::PipelineShaderStageCreateInfo stageInfo = {};
+			stageInfo.setStage(vk::ShaderStageFlagBits::eCompute);
+			stageInfo.setModule(m_shader);
+			stageInfo.setPName("main");
+
+			vk::ComputePipelineCreateInfo pipelineInfo = {};
+			pipelineInfo.setStage(stageInfo);
+			pipelineInfo.setLayout(m_pipelineLayout);
+
+			m_pipeline = logicalDevice.createComputePipeline(m_graphics->getPipelineCache(), pipelineInfo);
+		}
+	}
+
+	ClusterCuller::CullCamera& ClusterCuller::getCamera(size_t camera)
+	{
+		if (camera >= m_cameras.size())
+			m_cameras.resize(camera + 1);
+
+		CullCamera& data = m_cameras[camera];
+
+		// Already created
+		if (data.descriptorPool)
+			return data;
+
+		auto logicalDevice = m_graphics->getLogicalDevice();
+
+		// Create descriptor pool
+		{
+			vk::DescriptorPoolSize poolSize = {};
+			poolSize.setType(vk::DescriptorType::eStorageBuffer);
+			poolSize.setDescriptorCount(4 * m_frameCount);
+
+			vk::DescriptorPoolCreateInfo poolInfo = {};
+			poolInfo.setPoolSizeCount(1);
+			poolInfo.setPPoolSizes(&poolSize);
+			poolInfo.setMaxSets(m_frameCount);
+
+			data.descriptorPool = logicalDevice.createDescriptorPool(poolInfo);
+		}
+
+		data.frames.resize(m_frameCount);
+
+		for (uint32_t i = 0; i < m_frameCount; ++i)
+		{
+			CullOutput& output = data.frames[i];
+
+			// Create command buffer
+			output.commandBuffer = m_graphics->createBuffer
+			(
+				static_cast<vk::DeviceSize>(sizeof(vk::DrawIndexedIndirectCommand) * GUST_CLUSTER_CULLING_MAX_DRAWS),
+				vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst,
+				vk::MemoryPropertyFlagBits::eDeviceLocal
+			);
+
+			// Create index buffer
+			output.indexBuffer = m_graphics->createBuffer
+			(
+				static_cast<vk::DeviceSize>(sizeof(uint32_t) * GUST_CLUSTER_CULLING_MAX_INDICES),
+				vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndexBuffer,
+				vk::MemoryPropertyFlagBits::eDeviceLocal
+			);
+
+			// Allocate descriptor set
+			vk::DescriptorSetAllocateInfo allocInfo = {};
+			allocInfo.setDescriptorPool(data.descriptorPool);
+			allocInfo.setDescriptorSetCount(1);
+			allocInfo.setPSetLayouts(&m_descriptorSetLayout);
+
+			output.descriptorSet = logicalDevice.allocateDescriptorSets(allocInfo)[0];
+
+			// Point the set at the frames buffers
+			std::array<vk::DescriptorBufferInfo, 4> bufferInfos = {};
+			bufferInfos[0].setBuffer(m_clusterBuffers[i].buffer);
+			bufferInfos[1].setBuffer(m_drawBuffers[i].buffer);
+			bufferInfos[2].setBuffer(output.commandBuffer.buffer);
+			bufferInfos[3].setBuffer(output.indexBuffer.buffer);
+
+			std::array<vk::WriteDescriptorSet, 4> writeSets = {};
+
+			for (uint32_t j = 0; j < writeSets.size(); ++j)
+			{
+				bufferInfos[j].setOffset(0);
+				bufferInfos[j].setRange(VK_WHOLE_SIZE);
+
+				writeSets[j].setDstSet(output.descriptorSet);
+				writeSets[j].setDstBinding(j);
+				writeSets[j].setDstArrayElement(0);
+				writeSets[j].setDescriptorType(vk::DescriptorType::eStorageBuffer);
+				writeSets[j].setDescriptorCount(1);
+				writeSets[j].setPBufferInfo(&bufferInfos[j]);
+			}
+
+			logicalDevice.updateDescriptorSets(static_cast<uint32_t>(writeSets.size()), writeSets.data(), 0, nullptr);
+		}
+
+		return data;
+	}
+
+	vk::DescriptorSet ClusterCuller::getBlockDescriptorSet(uint32_t block)
+	{
+		// Blocks are never moved or freed before the pool, so their sets never change
+		if (m_blockDescriptorSets[block])
+			return m_blockDescriptorSets[block];
+
+		auto logicalDevice = m_graphics->getLogicalDevice();
+
+		vk::DescriptorSetAllocateInfo allocInfo = {};
+		allocInfo.setDescriptorPool(m_blockDescriptorPool);
+		allocInfo.setDescriptorSetCount(1);
+		allocInfo.setPSetLayouts(&m_blockDescriptorSetLayout);
+
+		m_blockDescriptorSets[block] = logicalDevice.allocateDescriptorSets(allocInfo)[0];
+
+		vk::DescriptorBufferInfo bufferInfo = {};
+		bufferInfo.setBuffer(m_graphics->getGeometryPool().getIndexBuffer(block).buffer);
+		bufferInfo.setOffset(0);
+		bufferInfo.setRange(VK_WHOLE_SIZE);
+
+		vk::WriteDescriptorSet writeSet = {};
+		writeSet.setDstSet(m_blockDescriptorSets[block]);
+		writeSet.setDstBinding(0);
+		writeSet.setDstArrayElement(0);
+		writeSet.setDescriptorType(vk::DescriptorType::eStorageBuffer);
+		writeSet.setDescriptorCount(1);
+		writeSet.setPBufferInfo(&bufferInfo);
+
+		logicalDevice.updateDescriptorSets(1, &writeSet, 0, nullptr);
+
+		return m_blockDescriptorSets[block];
+	}
+}
@@ -0,0 +1,344 @@
+#pragma once
+
+/**
+ * @file ClusterCuller.hpp
+ * @brief Cluster culler header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/** Includes. */
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include <Allocators.hpp>
+#include "Vulkan.hpp"
+
+/**
+ * @def GUST_CLUSTER_CULLING_COMPUTE_SHADER_PATH
+ * @brief Path to the file containing the cluster culling compute shader.
+ */
+#define GUST_CLUSTER_CULLING_COMPUTE_SHADER_PATH "./Shaders/cluster-culling-comp.spv"
+
+/**
+ * @def GUST_CLUSTER_CULLING_MAX_CLUSTERS
+ * @brief Maximum number of meshlets culled on the GPU per frame.
+ * @note Each meshlet is a workgroup, so this stays within the smallest maxComputeWorkGroupCount.
+ */
+#define GUST_CLUSTER_CULLING_MAX_CLUSTERS 65535
+
+/**
+ * @def GUST_CLUSTER_CULLING_MAX_INDICES
+ * @brief Maximum number of indices (Visible or not) of the meshes culled by meshlet per frame.
+ */
+#define GUST_CLUSTER_CULLING_MAX_INDICES (4 * 1024 * 1024)
+
+/**
+ * @def GUST_CLUSTER_CULLING_MAX_DRAWS
+ * @brief Maximum number of meshes culled by meshlet per frame.
+ */
+#define GUST_CLUSTER_CULLING_MAX_DRAWS 1024
+
+/**
+ * @def GUST_CLUSTER_CULLING_GROUP_SIZE
+ * @brief Number of invocations copying each visible meshlets indices (Must match cluster-culling.comp.)
+ */
+#define GUST_CLUSTER_CULLING_GROUP_SIZE 64
+
+namespace gust
+{
+	class Graphics;
+	class Material;
+	struct MeshData;
+
+	/**
+	 * @struct GpuCluster
+	 * @brief A meshlet to be culled on the GPU (Mirrors GUST_CLUSTER in cluster-culling.comp.)
+	 */
+	struct GpuCluster
+	{
+		/** Local space bounding sphere (Center and radius.) */
+		glm::vec4 sphere = {};
+
+		/** Local space normal cone (Axis and cutoff.) */
+		glm::vec4 cone = {};
+
+		/** First index relative to the meshes first index. */
+		uint32_t firstIndex = 0;
+
+		/** Number of indices. */
+		uint32_t indexCount = 0;
+
+		/** Draw the meshlet belongs to. */
+		uint32_t draw = 0;
+
+		/** Padding. */
+		uint32_t padding = 0;
+	};
+
+	static_assert(sizeof(GpuCluster) == 48, "GPU clusters must match the cluster culling shaders layout.");
+
+	/**
+	 * @struct GpuClusterDraw
+	 * @brief A mesh culled by meshlet (Mirrors GUST_CLUSTER_DRAW in cluster-culling.comp.)
+	 */
+	struct GpuClusterDraw
+	{
+		/** Model matrix. */
+		glm::mat4 model = {};
+
+		/** First index in the geometry block (Counted in indices of the meshes index type.) */
+		uint32_t sourceFirstIndex = 0;
+
+		/** Are the source indices 16-bit? */
+		uint32_t shortIndices = 0;
+
+		/** First index written to the output index buffer. */
+		uint32_t outputFirstIndex = 0;
+
+		/** Largest scale of the model matrix (Applied to bounding sphere radii.) */
+		float scale = 1.0f;
+
+		/** Should meshlets be cone culled? (Not when the scale is non uniform or mirrored.) */
+		uint32_t coneCulling = 0;
+
+		/** Padding. */
+		std::array<uint32_t, 3> padding = {};
+	};
+
+	static_assert(sizeof(GpuClusterDraw) == 96, "GPU cluster draws must match the cluster culling shaders layout.");
+
+	/**
+	 * @struct ClusterDrawGroup
+	 * @brief Meshes culled by meshlet drawn with a single indirect draw.
+	 */
+	struct ClusterDrawGroup
+	{
+		/** Material (Which also decides the shader.) */
+		Handle<Material> material = Handle<Material>::nullHandle();
+
+		/** Geometry block. */
+		uint32_t block = 0;
+
+		/** First indirect command. */
+		uint32_t firstDraw = 0;
+
+		/** Number of meshes in the group. */
+		uint32_t drawCount = 0;
+
+		/** First meshlet. */
+		uint32_t firstCluster = 0;
+
+		/** Number of meshlets. */
+		uint32_t clusterCount = 0;
+	};
+
+
+
+	/**
+	 * @class ClusterCuller
+	 * @brief Culls the meshlets of large meshes with a compute shader and draws the survivors.
+	 * @note Each meshlet is tested against the frustum and its normal cone, and the indices of those
+	 * left are copied into an index buffer owned by the camera. Every mesh is then one indexed indirect
+	 * draw over its part of that buffer, whose index count the shader grows with each visible meshlet.
+	 * Only needs Vulkan 1.0 compute (No mesh shaders or draw counts.)
+	 * @note Meshlets are uploaded every frame in local space along with their meshes model matrix.
+	 */
+	class ClusterCuller
+	{
+	public:
+
+		/**
+		 * @brief Default constructor.
+		 */
+		ClusterCuller() = default;
+
+		/**
+		 * @brief Constructor.
+		 * @param Graphics context.
+		 * @param Number of frames in flight.
+		 */
+		ClusterCuller(Graphics* graphics, uint32_t frameCount);
+
+		/**
+		 * @brief Default destructor.
+		 */
+		~ClusterCuller() = default;
+
+		/**
+		 * @brief Upload the meshlets of every mesh that has them and build draw groups.
+		 * @param Frame index.
+		 * @param Meshes to draw this frame.
+		 * @param Set for each mesh taken (Others must be drawn some other way.)
+		 * @return Number of meshes taken.
+		 * @note Mesh i is drawn as instance i, so its model matrix is expected at that index of the per draw data.
+		 */
+		uint32_t beginFrame(uint32_t frameIndex, const std::vector<MeshData>& meshes, std::vector<bool>& clustered);
+
+		/**
+		 * @brief Record culling for a camera.
+		 * @param Command buffer (Outside of a render pass.)
+		 * @param Camera index.
+		 * @param Cameras view projection matrix.
+		 * @param Cameras position.
+		 */
+		void cull(const vk::CommandBuffer& commandBuffer, size_t camera, const glm::mat4& viewProjection, const glm::vec3& viewPosition);
+
+		/**
+		 * @brief Record a draw groups indirect draw for a camera.
+		 * @param Command buffer (Pipeline, sets and vertex buffer must be bound.)
+		 * @param Camera index.
+		 * @param Draw group index.
+		 * @note Binds the cameras index buffer.
+		 */
+		void draw(const vk::CommandBuffer& commandBuffer, size_t camera, size_t group);
+
+		/**
+		 * @brief Get draw groups.
+		 * @return Draw groups.
+		 */
+		inline const std::vector<ClusterDrawGroup>& getGroups() const
+		{
+			return m_groups;
+		}
+
+		/**
+		 * @brief Free memory.
+		 * @note Used internally. Do not call.
+		 */
+		void free();
+
+	private:
+
+		/**
+		 * @struct CullOutput
+		 * @brief Culling output of a camera for a single frame.
+		 */
+		struct CullOutput
+		{
+			/** Indirect draw commands. */
+			Buffer commandBuffer = {};
+
+			/** Indices of visible meshlets. */
+			Buffer indexBuffer = {};
+
+			/** Descriptor set. */
+			vk::DescriptorSet descriptorSet = {};
+		};
+
+		/**
+		 * @struct CullCamera
+		 * @brief Culling output of a camera.
+		 */
+		struct CullCamera
+		{
+			/** Descriptor pool. */
+			vk::DescriptorPool descriptorPool = {};
+
+			/** Per frame output. */
+			std::vector<CullOutput> frames = {};
+		};
+
+		/**
+		 * @struct PushConstants
+		 * @brief Push constants of the cluster culling shader.
+		 */
+		struct PushConstants
+		{
+			/** Frustum planes. */
+			std::array<glm::vec4, 6> planes = {};
+
+			/** Camera position. */
+			glm::vec4 viewPosition = {};
+
+			/** First meshlet of the dispatch. */
+			uint32_t firstCluster = 0;
+		};
+
+		/**
+		 * @brief Create the culling pipeline.
+		 */
+		void initPipeline();
+
+		/**
+		 * @brief Create a cameras output buffers if it doesn't have them yet.
+		 * @param Camera index.
+		 * @return Camera data.
+		 */
+		CullCamera& getCamera(size_t camera);
+
+		/**
+		 * @brief Create the descriptor set reading a geometry blocks indices if it doesn't exist yet.
+		 * @param Geometry block.
+		 * @return Descriptor set.
+		 */
+		vk::DescriptorSet getBlockDescriptorSet(uint32_t block);
+
+
+
+		/** Graphics context. */
+		Graphics* m_graphics = nullptr;
+
+		/** Compute shader. */
+		vk::ShaderModule m_shader = {};
+
+		/** Descriptor set layout of the per frame buffers. */
+		vk::DescriptorSetLayout m_descriptorSetLayout = {};
+
+		/** Descriptor set layout of a geometry blocks indices. */
+		vk::DescriptorSetLayout m_blockDescriptorSetLayout = {};
+
+		/** Pipeline layout. */
+		vk::PipelineLayout m_pipelineLayout = {};
+
+		/** Pipeline. */
+		vk::Pipeline m_pipeline = {};
+
+		/** Descriptor pool of the geometry block sets. */
+		vk::DescriptorPool m_blockDescriptorPool = {};
+
+		/** Descriptor set of each geometry block. */
+		std::vector<vk::DescriptorSet> m_blockDescriptorSets = {};
+
+		/** Number of frames in flight. */
+		uint32_t m_frameCount = 0;
+
+		/** Meshlets of each frame. */
+		std::vector<Buffer> m_clusterBuffers = {};
+
+		/** Mapped meshlets of each frame. */
+		std::vector<GpuCluster*> m_clusters = {};
+
+		/** Meshes of each frame. */
+		std::vector<Buffer> m_drawBuffers = {};
+
+		/** Mapped meshes of each frame. */
+		std::vector<GpuClusterDraw*> m_draws = {};
+
+		/** Indirect commands each frame starts from (No indices drawn yet.) */
+		std::vector<Buffer> m_commandBuffers = {};
+
+		/** Mapped indirect commands of each frame. */
+		std::vector<vk::DrawIndexedIndirectCommand*> m_commands = {};
+
+		/** Culling output of each camera. */
+		std::vector<CullCamera> m_cameras = {};
+
+		/** Frame being recorded. */
+		uint32_t m_frameIndex = 0;
+
+		/** Number of meshes uploaded this frame. */
+		uint32_t m_drawCount = 0;
+
+		/** Draw groups. */
+		std::vector<ClusterDrawGroup> m_groups = {};
+
+		/** Index of each mesh taken this frame. */
+		std::vector<uint32_t> m_drawMeshes = {};
+
+		/** Draw group of each mesh taken this frame. */
+		std::vector<uint32_t> m_drawGroups = {};
+
+		/** Draw group index of each material and geometry block. */
+		std::unordered_map<uint64_t, uint32_t> m_groupLookup = {};
+	};
+}
@@ -0,0 +1,185 @@
+#include <Debugging.hpp>
+#include "Graphics.hpp"
+#include "DescriptorHeap.hpp"
+
+namespace gust
+{
+	DescriptorHeap::DescriptorHeap(Graphics* graphics) : m_graphics(graphics)
+	{
+		auto logicalDevice = m_graphics->getLogicalDevice();
+
+		// Create descriptor set layout
+		{
+			std::array<vk::DescriptorSetLayoutBinding, 2> bindings = {};
+
+			// Textures
+			bindings[0].setBinding(0);
+			bindings[0].setDescriptorType(vk::DescriptorType::eCombinedImageSampler);
+			bindings[0].setDescriptorCount(GUST_BINDLESS_TEXTURE_COUNT);
+			bindings[0].setStageFlags(vk::ShaderStageFlagBits::eFragment);
+
+			// Materials
+			bindings[1].setBinding(1);
+			bindings[1].setDescriptorType(vk::DescriptorType::eStorageBuffer);
+			bindings[1].setDescriptorCount(1);
+			bindings[1].setStageFlags(vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment);
+
+			// Unused textures may be left empty and written while the set is bound
+			std::array<vk::DescriptorBindingFlagsEXT, 2> bindingFlags =
+			{
+				vk::DescriptorBindingFlagBitsEXT::ePartiallyBound |
+				vk::DescriptorBindingFlagBitsEXT::eUpdateAfterBind |
+				vk::DescriptorBindingFlagBitsEXT::eUpdateUnusedWhilePending,
+				vk::DescriptorBindingFlagsEXT()
+			};
+
+			vk::DescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo = {};
+			bindingFlagsInfo.setBindingCount(static_cast<uint32_t>(bindingFlags.size()));
+			bindingFlagsInfo.setPBindingFlags(bindingFlags.data());
+
+			vk::DescriptorSetLayoutCreateInfo createInfo = {};
+			createInfo.setFlags(vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPoolEXT);
+			createInfo.setBindingCount(static_cast<uint32_t>(bindings.size()));
+			createInfo.setPBindings(bindings.data());
+			createInfo.setPNext(&bindingFlagsInfo);
+
+			m_descriptorSetLayout = logicalDevice.createDescriptorSetLayout(createInfo);
+		}
+
+		// Create descriptor pool
+		{
+			std::array<vk::DescriptorPoolSize, 2> poolSizes = {};
+			poolSizes[0].setType(vk::DescriptorType::eCombinedImageSampler);
+			poolSizes[0].setDescriptorCount(GUST_BINDLESS_TEXTURE_COUNT);
+			poolSizes[1].setType(vk::DescriptorType::eStorageBuffer);
+			poolSizes[1].setDescriptorCount(1);
+
+			vk::DescriptorPoolCreateInfo poolInfo = {};
+			poolInfo.setFlags(vk::DescriptorPoolCreateFlagBits::eUpdateAfterBindEXT);
+			poolInfo.setPoolSizeCount(static_cast<uint32_t>(poolSizes.size()));
+			poolInfo.setPPoolSizes(poolSizes.data());
+			poolInfo.setMaxSets(1);
+
+			m_descriptorPool = logicalDevice.createDescriptorPool(poolInfo);
+		}
+
+		// Allocate descriptor set
+		{
+			vk::DescriptorSetAllocateInfo allocInfo = {};
+			allocInfo.setDescriptorPool(m_descriptorPool);
+			allocInfo.setDescriptorSetCount(1);
+			allocInfo.setPSetLayouts(&m_descriptorSetLayout);
+
+			m_descriptorSet = logicalDevice.allocateDescriptorSets(allocInfo)[0];
+		}
+
+		// Create material buffer
+		m_materialBuffer = m_graphics->createBuffer
+		(
+			static_cast<vk::DeviceSize>(sizeof(BindlessMaterialData) * GUST_BINDLESS_MATERIAL_COUNT),
+			vk::BufferUsageFlagBits::eStorageBuffer,
+			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+		);
+
+		// Map once for the lifetime of the buffer
+		m_materials = static_cast<BindlessMaterialData*>(m_graphics->mapBuffer(m_materialBuffer));
+
+		vk::DescriptorBufferInfo bufferInfo = {};
+		bufferInfo.setBuffer(m_materialBuffer.buffer);
+		bufferInfo.setOffset(0);
+		bufferInfo.setRange(VK_WHOLE_SIZE);
+
+		vk::WriteDescriptorSet writeSet = {};
+		writeSet.setDstSet(m_descriptorSet);
+		writeSet.setDstBinding(1);
+		writeSet.setDstArrayElement(0);
+		writeSet.setDescriptorType(vk::DescriptorType::eStorageBuffer);
+		writeSet.setDescriptorCount(1);
+		writeSet.setPBufferInfo(&bufferInfo);
+
+		logicalDevice.updateDescriptorSets(1, &writeSet, 0, nullptr);
+	}
+
+	uint32_t DescriptorHeap::addTexture(const vk::ImageView& imageView, const vk::Sampler& sampler)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		uint32_t index = 0;
+
+		if (!m_freeTextures.empty())
+		{
+			index = m_freeTextures.back();
+			m_freeTextures.pop_back();
+		}
+		else
+		{
+			gAssert(m_textureCount < GUST_BINDLESS_TEXTURE_COUNT);
+			index = m_textureCount++;
+		}
+
+		vk::DescriptorImageInfo imageInfo = {};
+		imageInfo.setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+		imageInfo.setImageView(imageView);
+		imageInfo.setSampler(sampler);
+
+		vk::WriteDescriptorSet writeSet = {};
+		writeSet.setDstSet(m_descriptorSet);
+		writeSet.setDstBinding(0);
+		writeSet.setDstArrayElement(index);
+		writeSet.setDescriptorType(vk::DescriptorType::eCombinedImageSampler);
+		writeSet.setDescriptorCount(1);
+		writeSet.setPImageInfo(&imageInfo);
+
+		m_graphics->getLogicalDevice().updateDescriptorSets(1, &writeSet, 0, nullptr);
+		return index;
+	}
+
+	void DescriptorHeap::removeTexture(uint32_t index)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_freeTextures.push_back(index);
+	}
+
+	uint32_t DescriptorHeap::addMaterial()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		uint32_t index = 0;
+
+		if (!m_freeMaterials.empty())
+		{
+			index = m_freeMaterials.back();
+			m_freeMaterials.pop_back();
+		}
+		else
+		{
+			gAssert(m_materialCount < GUST_BINDLESS_MATERIAL_COUNT);
+			index = m_materialCount++;
+		}
+
+		m_materials[index] = BindlessMaterialData();
+		return index;
+	}
+
+	void DescriptorHeap::removeMaterial(uint32_t index)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_freeMaterials.push_back(index);
+	}
+
+	void DescriptorHeap::free()
+	{
+		if (m_graphics && m_descriptorPool)
+		{
+			auto logicalDevice = m_graphics->getLogicalDevice();
+
+			m_graphics->unmapBuffer(m_materialBuffer);
+			m_graphics->destroyBuffer(m_materialBuffer);
+			m_materials = nullptr;
+
+			logicalDevice.destroyDescriptorPool(m_descriptorPool);
+			logicalDevice.destroyDescriptorSetLayout(m_descriptorSetLayout);
+			m_descriptorPool = vk::DescriptorPool();
+		}
+	}
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+/**
+ * @file DescriptorHeap.hpp
+ * @brief Descriptor heap header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/** Includes. */
+#include <array>
+#include <mutex>
+#include <vector>
+#include <limits>
+#include "Vulkan.hpp"
+
+/**
+ * @def GUST_BINDLESS_TEXTURE_COUNT
+ * @brief Number of textures the descriptor heap can hold.
+ */
+#define GUST_BINDLESS_TEXTURE_COUNT 4096
+
+/**
+ * @def GUST_BINDLESS_MATERIAL_COUNT
+ * @brief Number of materials the descriptor heap can hold.
+ */
+#define GUST_BINDLESS_MATERIAL_COUNT 4096
+
+/**
+ * @def GUST_BINDLESS_MATERIAL_TEXTURE_COUNT
+ * @brief Number of textures a material can use in bindless mode.
+ */
+#define GUST_BINDLESS_MATERIAL_TEXTURE_COUNT 8
+
+namespace gust
+{
+	class Graphics;
+
+	/**
+	 * @struct BindlessMaterialData
+	 * @brief A materials slot in the descriptor heap (Mirrors GUST_MATERIAL_DATA in the bindless shaders.)
+	 */
+	struct BindlessMaterialData
+	{
+		/** Index of each texture in the heap. */
+		std::array<uint32_t, GUST_BINDLESS_MATERIAL_TEXTURE_COUNT> textures = {};
+
+		/** Data sent to the vertex shader. */
+		std::array<char, 64> vertexData = {};
+
+		/** Data sent to the fragment shader. */
+		std::array<char, 160> fragmentData = {};
+	};
+
+	static_assert(sizeof(BindlessMaterialData) == 256, "Bindless material data must match the shaders layout.");
+
+	/**
+	 * @struct BindlessDrawConstants
+	 * @brief Push constants of a bindless draw.
+	 */
+	struct BindlessDrawConstants
+	{
+		/** Index of the first instances per draw data. */
+		uint32_t draw = 0;
+
+		/** Index of the material in the heap. */
+		uint32_t material = 0;
+	};
+
+
+
+	/**
+	 * @class DescriptorHeap
+	 * @brief A single descriptor set holding every texture and material.
+	 * @note Binding 0 is an array of combined image samplers and binding 1 is a storage buffer
+	 * of material data. Shaders address both with indices from push constants, so the set is
+	 * bound once per command buffer instead of once per draw.
+	 */
+	class DescriptorHeap
+	{
+	public:
+
+		/**
+		 * @brief Default constructor.
+		 */
+		DescriptorHeap() = default;
+
+		/**
+		 * @brief Constructor.
+		 * @param Graphics context.
+		 */
+		DescriptorHeap(Graphics* graphics);
+
+		/**
+		 * @brief Default destructor.
+		 */
+		~DescriptorHeap() = default;
+
+		/**
+		 * @brief Index used for resources not in the heap.
+		 * @return Null index.
+		 */
+		static inline uint32_t nullIndex()
+		{
+			return std::numeric_limits<uint32_t>::max();
+		}
+
+		/**
+		 * @brief Get descriptor set layout.
+		 * @return Descriptor set layout.
+		 */
+		inline const vk::DescriptorSetLayout& getDescriptorSetLayout() const
+		{
+			return m_descriptorSetLayout;
+		}
+
+		/**
+		 * @brief Get descriptor set.
+		 * @return Descriptor set.
+		 */
+		inline const vk::DescriptorSet& getDescriptorSet() const
+		{
+			return m_descriptorSet;
+		}
+
+		/**
+		 * @brief Get a materials data.
+		 * @param Material index.
+		 * @return Material data.
+		 */
+		inline BindlessMaterialData& getMaterialData(uint32_t index) const
+		{
+			return m_materials[index];
+		}
+
+		/**
+		 * @brief Add a texture.
+		 * @param Image view.
+		 * @param Sampler.
+		 * @return Index of the texture.
+		 * @note Thread safe.
+		 */
+		uint32_t addTexture(const vk::ImageView& imageView, const vk::Sampler& sampler);
+
+		/**
+		 * @brief Remove a texture.
+		 * @param Index of the texture.
+		 * @note Thread safe.
+		 */
+		void removeTexture(uint32_t index);
+
+		/**
+		 * @brief Add a material.
+		 * @return Index of the material.
+		 * @note Thread safe.
+		 */
+		uint32_t addMaterial();
+
+		/**
+		 * @brief Remove a material.
+		 * @param Index of the material.
+		 * @note Thread safe.
+		 */
+		void removeMaterial(uint32_t index);
+
+		/**
+		 * @brief Free memory.
+		 * @note Used internally. Do not call.
+		 */
+		void free();
+
+	private:
+
+		/** Graphics context. */
+		Graphics* m_graphics = nullptr;
+
+		/** Descriptor set layout. */
+		vk::DescriptorSetLayout m_descriptorSetLayout = {};
+
+		/** Descriptor pool. */
+		vk::DescriptorPool m_descriptorPool = {};
+
+		/** Descriptor set. */
+		vk::DescriptorSet m_descriptorSet = {};
+
+		/** Material buffer. */
+		Buffer m_materialBuffer = {};
+
+		/** Mapped material buffer. */
+		BindlessMaterialData* m_materials = nullptr;
+
+		/** Number of texture indices ever used. */
+		uint32_t m_textureCount = 0;
+
+		/** Number of material indices ever used. */
+		uint32_t m_materialCount = 0;
+
+		/** Texture indices free to reuse. */
+		std::vector<uint32_t> m_freeTextures = {};
+
+		/** Material indices free to reuse. */
+		std::vector<uint32_t> m_freeMaterials = {};
+
+		/** Mutex. */
+		std::mutex m_mutex = {};
+	};
+}
@@ -0,0 +1,61 @@
+#include <array>
+#include <cstring>
+#include "DrawPacket.hpp"
+
+namespace gust
+{
+	uint64_t makeSortKey(DrawPass pass, size_t pipeline, size_t material, size_t mesh, float depth)
+	{
+		// Positive floats keep their order when compared as integers, so the top bits
+		// of the distance are a logarithmic quantization of it
+		uint32_t depthBits = 0;
+		if (depth > 0.0f)
+			std::memcpy(&depthBits, &depth, sizeof(float));
+
+		// | Pass 2 | Pipeline 12 | Material 16 | Mesh 18 | Depth 16 |
+		return
+			(static_cast<uint64_t>(pass) & 0x3) << 62 |
+			(static_cast<uint64_t>(pipeline) & 0xFFF) << 50 |
+			(static_cast<uint64_t>(material) & 0xFFFF) << 34 |
+			(static_cast<uint64_t>(mesh) & 0x3FFFF) << 16 |
+			static_cast<uint64_t>(depthBits >> 16);
+	}
+
+	void sortDrawPackets(std::vector<DrawPacket>& packets, std::vector<DrawPacket>& scratch)
+	{
+		if (packets.size() < 2)
+			return;
+
+		// Histograms of every digit in a single pass
+		std::array<std::array<size_t, 256>, 8> histograms = {};
+
+		for (const DrawPacket& packet : packets)
+			for (size_t digit = 0; digit < 8; ++digit)
+				++histograms[digit][(packet.key >> (digit * 8)) & 0xFF];
+
+		scratch.resize(packets.size());
+
+		for (size_t digit = 0; digit < 8; ++digit)
+		{
+			auto& histogram = histograms[digit];
+
+			// Every key has the same digit
+			if (histogram[(packets[0].key >> (digit * 8)) & 0xFF] == packets.size())
+				continue;
+
+			// Bucket offsets
+			size_t offset = 0;
+			for (size_t& count : histogram)
+			{
+				const size_t bucketSize = count;
+				count = offset;
+				offset += bucketSize;
+			}
+
+			for (const DrawPacket& packet : packets)
+				scratch[histogram[(packet.key >> (digit * 8)) & 0xFF]++] = packet;
+
+			packets.swap(scratch);
+		}
+	}
+}
\ No newline at end of file
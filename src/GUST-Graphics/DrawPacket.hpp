@@ -0,0 +1,60 @@
+#pragma once
+
+/**
+ * @file DrawPacket.hpp
+ * @brief Draw packet header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/** Includes. */
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace gust
+{
+	/**
+	 * @enum DrawPass
+	 * @brief Pass a draw belongs to (Most significant bits of a sort key.)
+	 */
+	enum class DrawPass : uint8_t
+	{
+		/** Opaque geometry drawn to the gbuffer. */
+		Opaque = 0
+	};
+
+	/**
+	 * @struct DrawPacket
+	 * @brief A draw and the key it is sorted by.
+	 */
+	struct DrawPacket
+	{
+		/** Sort key. */
+		uint64_t key = 0;
+
+		/** Index of the mesh being drawn. */
+		size_t mesh = 0;
+	};
+
+	/**
+	 * @brief Build a sort key.
+	 * @param Pass.
+	 * @param Pipeline identifier (Only the low 12 bits are used.)
+	 * @param Material identifier (Only the low 16 bits are used.)
+	 * @param Mesh identifier (Only the low 18 bits are used.)
+	 * @param Distance from the camera.
+	 * @return Sort key.
+	 * @note Keys order draws by pass, pipeline, material, mesh and then front to back so
+	 * consecutive draws share as much state as possible. Identifiers that don't fit their
+	 * field alias each other, which only costs state changes.
+	 */
+	extern uint64_t makeSortKey(DrawPass pass, size_t pipeline, size_t material, size_t mesh, float depth);
+
+	/**
+	 * @brief Sort draw packets by key.
+	 * @param Draw packets.
+	 * @param Scratch memory (Resized as needed.)
+	 * @note Stable least significant digit radix sort. Passes where every key shares a digit are skipped.
+	 */
+	extern void sortDrawPackets(std::vector<DrawPacket>& packets, std::vector<DrawPacket>& scratch);
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include <limits>
+#include <fstream>
+#include <Debugging.hpp>
+#include "GMesh.hpp"
+
+namespace gust
+{
+	/**
+	 * @brief Round a size in bytes up to a multiple of four.
+	 * @param Size in bytes.
+	 * @return Aligned size.
+	 */
+	static size_t alignIndexBytes(size_t size)
+	{
+		return (size + 3) & ~static_cast<size_t>(3);
+	}
+
+	bool writeGMesh(const std::string& path, const std::vector<GMeshLevel>& levels)
+	{
+		if (levels.empty())
+		{
+			gLog("Cooked mesh " << path << " needs at least one level.\n");
+			return false;
+		}
+
+		GMeshHeader header = {};
+		header.levelCount = static_cast<uint32_t>(levels.size());
+		header.bounds = Bounds::fromPoints
+		(
+			levels[0].vertices.empty() ? nullptr : &levels[0].vertices[0].position,
+			levels[0].vertices.size(),
+			sizeof(Vertex)
+		);
+
+		// Lay levels out one after another
+		std::vector<GMeshLevelRange> ranges(levels.size());
+		size_t vertexCount = 0;
+		size_t indexBytes = 0;
+
+		for (size_t i = 0; i < levels.size(); ++i)
+		{
+			GMeshLevelRange& range = ranges[i];
+			range.firstVertex = static_cast<uint32_t>(vertexCount);
+			range.vertexCount = static_cast<uint32_t>(levels[i].vertices.size());
+			range.indexOffset = static_cast<uint32_t>(indexBytes);
+			range.indexCount = static_cast<uint32_t>(levels[i].indices.size());
+			range.error = levels[i].error;
+			range.optimizationStats = levels[i].optimizationStats;
+
+			// Stored the way Mesh uploads them, so they can be copied as they are
+			range.indexSize = levels[i].vertices.size() <= std::numeric_limits<uint16_t>::max() ? sizeof(uint16_t) : sizeof(uint32_t);
+
+			vertexCount += range.vertexCount;
+			indexBytes += alignIndexBytes(static_cast<size_t>(range.indexSize) * range.indexCount);
+		}
+
+		header.vertexCount = static_cast<uint32_t>(vertexCount);
+		header.indexBytes = static_cast<uint32_t>(indexBytes);
+
+		std::ofstream stream(path, std::ios::binary | std::ios::out);
+		if (!stream.is_open())
+		{
+			gLog("Unable to write cooked mesh " << path << ".\n");
+			return false;
+		}
+
+		// Header and level table
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(GMeshHeader));
+		stream.write(reinterpret_cast<const char*>(ranges.data()), sizeof(GMeshLevelRange) * ranges.size());
+
+		// Vertices
+		for (const GMeshLevel& level : levels)
+			stream.write(reinterpret_cast<const char*>(level.vertices.data()), sizeof(Vertex) * level.vertices.size());
+
+		// Indices
+		for (size_t i = 0; i < levels.size(); ++i)
+		{
+			size_t size = 0;
+
+			if (ranges[i].indexSize == sizeof(uint16_t))
+			{
+				const std::vector<uint16_t> indices(levels[i].indices.begin(), levels[i].indices.end());
+				size = sizeof(uint16_t) * indices.size();
+				stream.write(reinterpret_cast<const char*>(indices.data()), size);
+			}
+			else
+			{
+				size = sizeof(uint32_t) * levels[i].indices.size();
+				stream.write(reinterpret_cast<const char*>(levels[i].indices.data()), size);
+			}
+
+			// Keep the next level aligned
+			const uint32_t padding = 0;
+			stream.write(reinterpret_cast<const char*>(&padding), alignIndexBytes(size) - size);
+		}
+
+		if (!stream.good())
+		{
+			gLog("Unable to write cooked mesh " << path << ".\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	bool isGMeshPath(const std::string& path)
+	{
+		const std::string extension = GUST_GMESH_EXTENSION;
+		return path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+	}
+
+
+
+	GMeshFile::GMeshFile(const std::string& path) : m_file(path)
+	{
+		if (!m_file.isOpen())
+		{
+			gLog("Unable to open cooked mesh " << path << ".\n");
+			return;
+		}
+
+		if (m_file.getSize() < sizeof(GMeshHeader))
+		{
+			gLog("Cooked mesh " << path << " is truncated.\n");
+			return;
+		}
+
+		const GMeshHeader* header = reinterpret_cast<const GMeshHeader*>(m_file.getData());
+
+		if (header->magic != GUST_GMESH_MAGIC || header->version != GUST_GMESH_VERSION || header->vertexSize != sizeof(Vertex))
+		{
+			gLog("Cooked mesh " << path << " is from another version. Cook it again.\n");
+			return;
+		}
+
+		// Every section must fit in the file
+		const size_t levelBytes = sizeof(GMeshLevelRange) * static_cast<size_t>(header->levelCount);
+		const size_t vertexBytes = sizeof(Vertex) * static_cast<size_t>(header->vertexCount);
+
+		if (header->levelCount == 0 || m_file.getSize() < sizeof(GMeshHeader) + levelBytes + vertexBytes + header->indexBytes)
+		{
+			gLog("Cooked mesh " << path << " is truncated.\n");
+			return;
+		}
+
+		const GMeshLevelRange* levels = reinterpret_cast<const GMeshLevelRange*>(m_file.getData() + sizeof(GMeshHeader));
+
+		for (size_t i = 0; i < header->levelCount; ++i)
+		{
+			const GMeshLevelRange& level = levels[i];
+
+			if
+			(
+				static_cast<size_t>(level.firstVertex) + level.vertexCount > header->vertexCount ||
+				(level.indexSize != sizeof(uint16_t) && level.indexSize != sizeof(uint32_t)) ||
+				static_cast<size_t>(level.indexOffset) + static_cast<size_t>(level.indexSize) * level.indexCount > header->indexBytes
+			)
+			{
+				gLog("Cooked mesh " << path << " has a level out of range.\n");
+				return;
+			}
+		}
+
+		// Only a well formed file is made valid
+		m_header = header;
+		m_levels = levels;
+		m_vertices = reinterpret_cast<const Vertex*>(m_file.getData() + sizeof(GMeshHeader) + levelBytes);
+		m_indices = m_file.getData() + sizeof(GMeshHeader) + levelBytes + vertexBytes;
+	}
+}
@@ -0,0 +1,230 @@
+#pragma once
+
+/**
+ * @file GMesh.hpp
+ * @brief Cooked mesh file header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/** Includes. */
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <Bounds.hpp>
+#include <FileIO.hpp>
+#include "Mesh.hpp"
+
+/**
+ * @def GUST_GMESH_MAGIC
+ * @brief First four bytes of every cooked mesh ("GMSH".)
+ */
+#define GUST_GMESH_MAGIC 0x48534D47
+
+/**
+ * @def GUST_GMESH_VERSION
+ * @brief Version of the cooked mesh layout. Files of any other version must be cooked again.
+ */
+#define GUST_GMESH_VERSION 1
+
+/**
+ * @def GUST_GMESH_EXTENSION
+ * @brief File extension of cooked meshes.
+ */
+#define GUST_GMESH_EXTENSION ".gmesh"
+
+namespace gust
+{
+	/**
+	 * @struct GMeshHeader
+	 * @brief Start of a cooked mesh file.
+	 * @note Followed by the level table, every levels vertices and then every levels indices.
+	 */
+	struct GMeshHeader
+	{
+		/** GUST_GMESH_MAGIC. */
+		uint32_t magic = GUST_GMESH_MAGIC;
+
+		/** GUST_GMESH_VERSION. */
+		uint32_t version = GUST_GMESH_VERSION;
+
+		/** Size of a vertex in bytes (Must match sizeof(Vertex).) */
+		uint32_t vertexSize = sizeof(Vertex);
+
+		/** Number of levels of detail. */
+		uint32_t levelCount = 0;
+
+		/** Total number of vertices. */
+		uint32_t vertexCount = 0;
+
+		/** Total size of the indices in bytes. */
+		uint32_t indexBytes = 0;
+
+		/** Local space bounds of the first level (Which bound every level.) */
+		Bounds bounds = {};
+	};
+
+	static_assert(std::is_trivially_copyable<GMeshHeader>::value, "Cooked mesh headers are read straight from the file.");
+
+	/**
+	 * @struct GMeshLevelRange
+	 * @brief Where a level of detail lives in a cooked mesh file.
+	 */
+	struct GMeshLevelRange
+	{
+		/** First vertex of the level. */
+		uint32_t firstVertex = 0;
+
+		/** Number of vertices. */
+		uint32_t vertexCount = 0;
+
+		/** Offset in bytes of the first index from the start of the index data. */
+		uint32_t indexOffset = 0;
+
+		/** Number of indices. */
+		uint32_t indexCount = 0;
+
+		/** Size of an index in bytes (2 for levels with fewer than 65536 vertices, otherwise 4.) */
+		uint32_t indexSize = sizeof(uint32_t);
+
+		/** Largest distance (In mesh units) a surface moved while simplifying. */
+		float error = 0.0f;
+
+		/** Vertex cache efficiency before and after optimizing. */
+		MeshOptimizationStats optimizationStats = {};
+	};
+
+	static_assert(std::is_trivially_copyable<GMeshLevelRange>::value, "Cooked mesh levels are read straight from the file.");
+
+	/**
+	 * @struct GMeshLevel
+	 * @brief Level of detail to cook.
+	 */
+	struct GMeshLevel
+	{
+		/** Vertices. */
+		std::vector<Vertex> vertices = {};
+
+		/** Triangle indices. */
+		std::vector<uint32_t> indices = {};
+
+		/** Largest distance (In mesh units) a surface moved while simplifying. */
+		float error = 0.0f;
+
+		/** Vertex cache efficiency before and after optimizing. */
+		MeshOptimizationStats optimizationStats = {};
+	};
+
+	/**
+	 * @brief Write levels of detail to a cooked mesh file.
+	 * @param Path to file.
+	 * @param Levels of detail, starting with the original mesh.
+	 * @return If the file was written.
+	 * @note Vertices and indices are written as they are, so they should already be optimized and have tangents.
+	 */
+	extern bool writeGMesh(const std::string& path, const std::vector<GMeshLevel>& levels);
+
+	/**
+	 * @brief Check if a path names a cooked mesh file.
+	 * @param Path to file.
+	 * @return If the path ends with GUST_GMESH_EXTENSION.
+	 */
+	extern bool isGMeshPath(const std::string& path);
+
+
+
+	/**
+	 * @class GMeshFile
+	 * @brief Cooked mesh file mapped into memory.
+	 * @note Vertices and indices are used in place, already in the layout the GPU expects.
+	 */
+	class GMeshFile
+	{
+	public:
+
+		/**
+		 * @brief Constructor.
+		 * @param Path to file.
+		 * @note The file is invalid if it is missing, truncated or from another version.
+		 */
+		GMeshFile(const std::string& path);
+
+		/**
+		 * @brief Default destructor.
+		 */
+		~GMeshFile() = default;
+
+		/**
+		 * @brief Check if the file was mapped and is well formed.
+		 * @return If the file is valid.
+		 */
+		inline bool isValid() const
+		{
+			return m_levels != nullptr;
+		}
+
+		/**
+		 * @brief Get the number of levels of detail.
+		 * @return Number of levels (Zero if the file is invalid.)
+		 */
+		inline size_t getLevelCount() const
+		{
+			return m_header ? m_header->levelCount : 0;
+		}
+
+		/**
+		 * @brief Get where a level lives in the file.
+		 * @param Level index.
+		 * @return Level range.
+		 */
+		inline const GMeshLevelRange& getLevel(size_t level) const
+		{
+			return m_levels[level];
+		}
+
+		/**
+		 * @brief Get local space bounds.
+		 * @return Bounds of the first level.
+		 */
+		inline const Bounds& getBounds() const
+		{
+			return m_header->bounds;
+		}
+
+		/**
+		 * @brief Get a levels vertices.
+		 * @param Level index.
+		 * @return Pointer to the first vertex.
+		 */
+		inline const Vertex* getVertices(size_t level) const
+		{
+			return m_vertices + m_levels[level].firstVertex;
+		}
+
+		/**
+		 * @brief Get a levels indices.
+		 * @param Level index.
+		 * @return Pointer to the first index (Of the levels index size.)
+		 */
+		inline const void* getIndices(size_t level) const
+		{
+			return m_indices + m_levels[level].indexOffset;
+		}
+
+	private:
+
+		/** Mapped file. */
+		MappedFile m_file = {};
+
+		/** Header. */
+		const GMeshHeader* m_header = nullptr;
+
+		/** Level table. */
+		const GMeshLevelRange* m_levels = nullptr;
+
+		/** Vertices of every level. */
+		const Vertex* m_vertices = nullptr;
+
+		/** Indices of every level. */
+		const char* m_indices = nullptr;
+	};
+}
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <iterator>
+#include <Debugging.hpp>
+#include "Graphics.hpp"
+#include "Mesh.hpp"
+#include "GeometryPool.hpp"
+
+namespace gust
+{
+	GeometryPool::GeometryPool(Graphics* graphics) : m_graphics(graphics)
+	{
+		createBlock(GUST_GEOMETRY_BLOCK_VERTEX_COUNT, GUST_GEOMETRY_BLOCK_INDEX_COUNT);
+	}
+
+	GeometryRange GeometryPool::allocate(uint32_t vertexCount, uint32_t indexCount)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		GeometryRange range = {};
+		range.vertexCount = vertexCount;
+		range.indexCount = indexCount;
+
+		// First block with room for both
+		for (uint32_t i = 0; i < m_blockCount.load(); ++i)
+		{
+			Block& block = m_blocks[i];
+
+			if (!allocateRange(block.freeVertices, vertexCount, range.firstVertex))
+				continue;
+
+			if (!allocateRange(block.freeIndices, indexCount, range.firstIndex))
+			{
+				freeRange(block.freeVertices, range.firstVertex, vertexCount);
+				continue;
+			}
+
+			range.block = i;
+			return range;
+		}
+
+		// Out of room, so make another block
+		range.block = createBlock
+		(
+			std::max<uint32_t>(vertexCount, GUST_GEOMETRY_BLOCK_VERTEX_COUNT),
+			std::max<uint32_t>(indexCount, GUST_GEOMETRY_BLOCK_INDEX_COUNT)
+		);
+
+		Block& block = m_blocks[range.block];
+		allocateRange(block.freeVertices, vertexCount, range.firstVertex);
+		allocateRange(block.freeIndices, indexCount, range.firstIndex);
+
+		return range;
+	}
+
+	void GeometryPool::deallocate(const GeometryRange& range)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		deallocateRange(range);
+	}
+
+	void GeometryPool::retire(const GeometryRange& range)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_retiredRanges.push_back({ m_frame, range });
+	}
+
+	void GeometryPool::beginFrame(uint32_t framesInFlight)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		++m_frame;
+
+		// The fence of the frame a range was retired in has been waited on once the frame count has moved past it
+		auto it = std::remove_if(m_retiredRanges.begin(), m_retiredRanges.end(), [this, framesInFlight](const std::pair<uint64_t, GeometryRange>& retired)
+		{
+			if (retired.first + framesInFlight > m_frame)
+				return false;
+
+			deallocateRange(retired.second);
+			return true;
+		});
+
+		m_retiredRanges.erase(it, m_retiredRanges.end());
+	}
+
+	void GeometryPool::free()
+	{
+		if (m_graphics)
+		{
+			for (uint32_t i = 0; i < m_blockCount.load(); ++i)
+			{
+				m_graphics->destroyBuffer(m_blocks[i].vertexBuffer);
+				m_graphics->destroyBuffer(m_blocks[i].indexBuffer);
+				m_blocks[i] = {};
+			}
+
+			m_blockCount = 0;
+			m_retiredRanges.clear();
+			m_graphics = nullptr;
+		}
+	}
+
+	uint32_t GeometryPool::createBlock(uint32_t vertexCount, uint32_t indexCount)
+	{
+		const uint32_t index = m_blockCount.load();
+		gAssert(index < GUST_MAX_GEOMETRY_BLOCKS);
+
+		Block& block = m_blocks[index];
+
+		// Create vertex buffer
+		block.vertexBuffer = m_graphics->createBuffer
+		(
+			static_cast<vk::DeviceSize>(sizeof(GpuVertex) * vertexCount),
+			vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
+			vk::MemoryPropertyFlagBits::eDeviceLocal
+		);
+
+		// Create index buffer (Also read by the cluster culler)
+		block.indexBuffer = m_graphics->createBuffer
+		(
+			static_cast<vk::DeviceSize>(sizeof(uint32_t) * indexCount),
+			vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eStorageBuffer,
+			vk::MemoryPropertyFlagBits::eDeviceLocal
+		);
+
+		block.freeVertices[0] = vertexCount;
+		block.freeIndices[0] = indexCount;
+
+		// Publish the block once its buffers exist
+		m_blockCount = index + 1;
+		return index;
+	}
+
+	bool GeometryPool::allocateRange(std::map<uint32_t, uint32_t>& freeRanges, uint32_t count, uint32_t& offset)
+	{
+		if (count == 0)
+		{
+			offset = 0;
+			return true;
+		}
+
+		for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it)
+			if (it->second >= count)
+			{
+				offset = it->first;
+
+				// Keep the remainder free
+				if (it->second > count)
+					freeRanges[it->first + count] = it->second - count;
+
+				freeRanges.erase(it);
+				return true;
+			}
+
+		return false;
+	}
+
+	void GeometryPool::freeRange(std::map<uint32_t, uint32_t>& freeRanges, uint32_t offset, uint32_t count)
+	{
+		if (count == 0)
+			return;
+
+		auto it = freeRanges.emplace(offset, count).first;
+
+		// Merge with the next range
+		auto next = std::next(it);
+		if (next != freeRanges.end() && it->first + it->second == next->first)
+		{
+			it->second += next->second;
+			freeRanges.erase(next);
+		}
+
+		// Merge with the previous range
+		if (it != freeRanges.begin())
+		{
+			auto prev = std::prev(it);
+			if (prev->first + prev->second == it->first)
+			{
+				prev->second += it->second;
+				freeRanges.erase(it);
+			}
+		}
+	}
+
+	void GeometryPool::deallocateRange(const GeometryRange& range)
+	{
+		Block& block = m_blocks[range.block];
+		freeRange(block.freeVertices, range.firstVertex, range.vertexCount);
+		freeRange(block.freeIndices, range.firstIndex, range.indexCount);
+	}
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+/**
+ * @file GeometryPool.hpp
+ * @brief Geometry pool header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/** Includes. */
+#include <map>
+#include <array>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include "Vulkan.hpp"
+
+/**
+ * @def GUST_GEOMETRY_BLOCK_VERTEX_COUNT
+ * @brief Number of vertices in each geometry block.
+ */
+#define GUST_GEOMETRY_BLOCK_VERTEX_COUNT (1024 * 1024)
+
+/**
+ * @def GUST_GEOMETRY_BLOCK_INDEX_COUNT
+ * @brief Number of indices in each geometry block.
+ */
+#define GUST_GEOMETRY_BLOCK_INDEX_COUNT (4 * 1024 * 1024)
+
+/**
+ * @def GUST_MAX_GEOMETRY_BLOCKS
+ * @brief Maximum number of geometry blocks.
+ */
+#define GUST_MAX_GEOMETRY_BLOCKS 16
+
+namespace gust
+{
+	class Graphics;
+
+	/**
+	 * @struct GeometryRange
+	 * @brief Vertices and indices of a mesh in the geometry pool.
+	 */
+	struct GeometryRange
+	{
+		/** Block the range is in. */
+		uint32_t block = 0;
+
+		/** First vertex in the blocks vertex buffer (The draws vertex offset.) */
+		uint32_t firstVertex = 0;
+
+		/** Number of vertices. */
+		uint32_t vertexCount = 0;
+
+		/** First index in the blocks index buffer (In 32-bit indices. 16-bit indices are packed two to each.) */
+		uint32_t firstIndex = 0;
+
+		/** Number of 32-bit indices. */
+		uint32_t indexCount = 0;
+	};
+
+
+
+	/**
+	 * @class GeometryPool
+	 * @brief Suballocates mesh vertices and indices from a few large device local buffers.
+	 * @note Meshes in the same block share their vertex and index buffers, so drawing them
+	 * one after another only needs the buffers bound once.
+	 */
+	class GeometryPool
+	{
+	public:
+
+		/**
+		 * @brief Default constructor.
+		 */
+		GeometryPool() = default;
+
+		/**
+		 * @brief Constructor.
+		 * @param Graphics context.
+		 */
+		GeometryPool(Graphics* graphics);
+
+		/**
+		 * @brief Default destructor.
+		 */
+		~GeometryPool() = default;
+
+		/**
+		 * @brief Allocate a range of vertices and indices.
+		 * @param Number of vertices.
+		 * @param Number of indices.
+		 * @return Geometry range.
+		 * @note A new block is created if no block has room (Sized to fit if the range is larger than a block.)
+		 * @note Thread safe.
+		 */
+		GeometryRange allocate(uint32_t vertexCount, uint32_t indexCount);
+
+		/**
+		 * @brief Return a range to the pool.
+		 * @param Geometry range.
+		 * @note Thread safe.
+		 */
+		void deallocate(const GeometryRange& range);
+
+		/**
+		 * @brief Return a range to the pool once frames that might draw it are done.
+		 * @param Geometry range.
+		 * @note Thread safe.
+		 */
+		void retire(const GeometryRange& range);
+
+		/**
+		 * @brief Start a frame, returning ranges retired before the oldest frame in flight.
+		 * @param Number of frames in flight.
+		 * @note Must be called after waiting on the frames fence.
+		 */
+		void beginFrame(uint32_t framesInFlight);
+
+		/**
+		 * @brief Get a blocks vertex buffer.
+		 * @param Block index.
+		 * @return Vertex buffer.
+		 */
+		inline const Buffer& getVertexBuffer(uint32_t block) const
+		{
+			return m_blocks[block].vertexBuffer;
+		}
+
+		/**
+		 * @brief Get a blocks index buffer.
+		 * @param Block index.
+		 * @return Index buffer.
+		 */
+		inline const Buffer& getIndexBuffer(uint32_t block) const
+		{
+			return m_blocks[block].indexBuffer;
+		}
+
+		/**
+		 * @brief Get number of blocks.
+		 * @return Number of blocks.
+		 */
+		inline uint32_t getBlockCount() const
+		{
+			return m_blockCount.load();
+		}
+
+		/**
+		 * @brief Free memory.
+		 * @note Used internally. Do not call.
+		 */
+		void free();
+
+	private:
+
+		/**
+		 * @struct Block
+		 * @brief A vertex and index buffer with the free ranges in each.
+		 */
+		struct Block
+		{
+			/** Vertex buffer. */
+			Buffer vertexBuffer = {};
+
+			/** Index buffer. */
+			Buffer indexBuffer = {};
+
+			/** Free vertex ranges (First vertex to vertex count.) */
+			std::map<uint32_t, uint32_t> freeVertices = {};
+
+			/** Free index ranges (First index to index count.) */
+			std::map<uint32_t, uint32_t> freeIndices = {};
+		};
+
+		/**
+		 * @brief Create a block.
+		 * @param Number of vertices.
+		 * @param Number of indices.
+		 * @return Block index.
+		 */
+		uint32_t createBlock(uint32_t vertexCount, uint32_t indexCount);
+
+		/**
+		 * @brief Take the first free range large enough.
+		 * @param Free ranges.
+		 * @param Number of elements.
+		 * @param Offset of the range.
+		 * @return If a range was found.
+		 */
+		static bool allocateRange(std::map<uint32_t, uint32_t>& freeRanges, uint32_t count, uint32_t& offset);
+
+		/**
+		 * @brief Return a range, merging it with its neighbours.
+		 * @param Free ranges.
+		 * @param Offset of the range.
+		 * @param Number of elements.
+		 */
+		static void freeRange(std::map<uint32_t, uint32_t>& freeRanges, uint32_t offset, uint32_t count);
+
+		/**
+		 * @brief Return a range without locking.
+		 * @param Geometry range.
+		 */
+		void deallocateRange(const GeometryRange& range);
+
+
+
+		/** Graphics context. */
+		Graphics* m_graphics = nullptr;
+
+		/** Blocks (Fixed so buffers can be read while blocks are added.) */
+		std::array<Block, GUST_MAX_GEOMETRY_BLOCKS> m_blocks = {};
+
+		/** Number of blocks. */
+		std::atomic<uint32_t> m_blockCount = { 0 };
+
+		/** Ranges waiting on frames in flight, with the frame they were retired in. */
+		std::vector<std::pair<uint64_t, GeometryRange>> m_retiredRanges = {};
+
+		/** Number of frames started. */
+		uint64_t m_frame = 0;
+
+		/** Mutex. */
+		std::mutex m_mutex = {};
+	};
+}
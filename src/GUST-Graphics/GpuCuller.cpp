@@ -0,0 +1,457 @@
+#include <algorithm>
+#include <cstring>
+#include <FileIO.hpp>
+#include <Frustum.hpp>
+#include <Debugging.hpp>
+#include "Renderer.hpp"
+#include "GpuCuller.hpp"
+
+namespace gust
+{
+	GpuCuller::GpuCuller(Graphics* graphics, uint32_t frameCount) :
+		m_graphics(graphics),
+		m_frameCount(frameCount)
+	{
+		// Draw counts let the GPU skip culled draws entirely
+		if (m_graphics->supportsDrawIndirectCount())
+			m_drawIndexedIndirectCount = (PFN_vkCmdDrawIndexedIndirectCountKHR)m_graphics->getLogicalDevice().getProcAddr("vkCmdDrawIndexedIndirectCountKHR");
+
+		reserve(GUST_GPU_CULLING_INITIAL_OBJECTS);
+		initPipeline();
+	}
+
+	uint32_t GpuCuller::beginFrame(uint32_t frameIndex, const std::vector<MeshData>& meshes, const std::vector<bool>& skipped)
+	{
+		m_frameIndex = frameIndex;
+		const size_t meshCount = meshes.size();
+		reserve(meshCount);
+
+		m_groups.clear();
+		m_groupLookup.clear();
+		m_objectMeshes.clear();
+
+		// Meshes drawn some other way are left out
+		for (size_t i = 0; i < meshCount; ++i)
+			if (skipped.empty() || !skipped[i])
+				m_objectMeshes.push_back(static_cast<uint32_t>(i));
+
+		m_objectCount = static_cast<uint32_t>(m_objectMeshes.size());
+		m_objectGroups.resize(m_objectCount);
+
+		// Group meshes sharing a material, geometry block and index type
+		for (uint32_t i = 0; i < m_objectCount; ++i)
+		{
+			const MeshData& mesh = meshes[m_objectMeshes[i]];
+			const bool shortIndices = mesh.mesh->getIndexType() == vk::IndexType::eUint16;
+			const uint64_t key = (static_cast<uint64_t>(mesh.material.getHandle()) << 32) | (mesh.mesh->getGeometryBlock() << 1) | (shortIndices ? 1 : 0);
+
+			auto it = m_groupLookup.find(key);
+
+			if (it == m_groupLookup.end())
+			{
+				if (m_groups.size() == GUST_GPU_CULLING_MAX_GROUPS)
+				{
+					gErr("GPU culling out of space for draw groups.\n");
+					m_objectCount = i;
+					break;
+				}
+
+				GpuDrawGroup group = {};
+				group.material = mesh.material;
+				group.block = mesh.mesh->getGeometryBlock();
+				group.indexType = mesh.mesh->getIndexType();
+
+				it = m_groupLookup.emplace(key, static_cast<uint32_t>(m_groups.size())).first;
+				m_groups.push_back(group);
+			}
+
+			m_objectGroups[i] = it->second;
+			++m_groups[it->second].meshCount;
+		}
+
+		// Order groups so those sharing a shader are drawn together
+		std::vector<uint32_t> order(m_groups.size());
+		for (uint32_t i = 0; i < order.size(); ++i)
+			order[i] = i;
+
+		std::sort(order.begin(), order.end(), [this](uint32_t lh, uint32_t rh)
+		{
+			const size_t lhShader = m_groups[lh].material->getShader().getHandle();
+			const size_t rhShader = m_groups[rh].material->getShader().getHandle();
+			return lhShader != rhShader ? lhShader < rhShader : lh < rh;
+		});
+
+		std::vector<GpuDrawGroup> groups(m_groups.size());
+		std::vector<uint32_t> remap(m_groups.size());
+
+		for (uint32_t i = 0; i < order.size(); ++i)
+		{
+			groups[i] = m_groups[order[i]];
+			remap[order[i]] = i;
+		}
+
+		m_groups = std::move(groups);
+
+		// Give each group a contiguous range of commands
+		std::vector<uint32_t> cursors(m_groups.size());
+		uint32_t firstCommand = 0;
+
+		for (uint32_t i = 0; i < m_groups.size(); ++i)
+		{
+			m_groups[i].firstCommand = firstCommand;
+			cursors[i] = firstCommand;
+			firstCommand += m_groups[i].meshCount;
+		}
+
+		// Write meshes for the culling shader
+		GpuCullObject* objects = m_objects[m_frameIndex];
+
+		for (uint32_t i = 0; i < m_objectCount; ++i)
+		{
+			const MeshData& mesh = meshes[m_objectMeshes[i]];
+			const uint32_t group = remap[m_objectGroups[i]];
+
+			GpuCullObject& object = objects[i];
+			object.center = glm::vec4(mesh.bounds.getCenter(), 1);
+			object.extents = glm::vec4(mesh.bounds.getExtents(), 0);
+			object.indexCount = mesh.mesh->getIndexCount();
+			object.firstIndex = mesh.mesh->getFirstIndex();
+			object.vertexOffset = mesh.mesh->getVertexOffset();
+			object.group = group;
+			object.firstCommand = m_groups[group].firstCommand;
+			object.command = cursors[group]++;
+			object.instance = m_objectMeshes[i];
+		}
+
+		return m_objectCount;
+	}
+
+	void GpuCuller::cull(const vk::CommandBuffer& commandBuffer, size_t camera, const glm::mat4& viewProjection)
+	{
+		const CullOutput& output = getCamera(camera).frames[m_frameIndex];
+		const bool compact = m_drawIndexedIndirectCount != nullptr;
+
+		// Reset draw counts
+		if (compact)
+		{
+			commandBuffer.fillBuffer(output.countBuffer.buffer, 0, VK_WHOLE_SIZE, 0);
+
+			vk::MemoryBarrier barrier = {};
+			barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+			barrier.setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+
+			commandBuffer.pipelineBarrier
+			(
+				vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader,
+				(vk::DependencyFlagBits)0,
+				1, &barrier,
+				0, nullptr,
+				0, nullptr
+			);
+		}
+
+		if (m_objectCount > 0)
+		{
+			const Frustum frustum(viewProjection);
+
+			PushConstants constants = {};
+			constants.objectCount = m_objectCount;
+			constants.compact = compact ? 1 : 0;
+
+			for (size_t i = 0; i < constants.planes.size(); ++i)
+				constants.planes[i] = frustum.getPlane(i);
+
+			commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_pipeline);
+			commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipelineLayout, 0, 1, &output.descriptorSet, 0, nullptr);
+			commandBuffer.pushConstants(m_pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(PushConstants), &constants);
+			commandBuffer.dispatch((m_objectCount + GUST_GPU_CULLING_GROUP_SIZE - 1) / GUST_GPU_CULLING_GROUP_SIZE, 1, 1);
+		}
+
+		// Make commands visible to indirect draws
+		vk::MemoryBarrier barrier = {};
+		barrier.setSrcAccessMask(vk::AccessFlagBits::eShaderWrite);
+		barrier.setDstAccessMask(vk::AccessFlagBits::eIndirectCommandRead);
+
+		commandBuffer.pipelineBarrier
+		(
+			vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eDrawIndirect,
+			(vk::DependencyFlagBits)0,
+			1, &barrier,
+			0, nullptr,
+			0, nullptr
+		);
+	}
+
+	void GpuCuller::draw(const vk::CommandBuffer& commandBuffer, size_t camera, size_t group)
+	{
+		const CullOutput& output = getCamera(camera).frames[m_frameIndex];
+		const GpuDrawGroup& drawGroup = m_groups[group];
+		const vk::DeviceSize offset = static_cast<vk::DeviceSize>(sizeof(vk::DrawIndexedIndirectCommand) * drawGroup.firstCommand);
+
+		if (m_drawIndexedIndirectCount)
+		{
+			// Only the commands of visible meshes are read
+			m_drawIndexedIndirectCount
+			(
+				static_cast<VkCommandBuffer>(commandBuffer),
+				static_cast<VkBuffer>(output.commandBuffer.buffer),
+				static_cast<VkDeviceSize>(offset),
+				static_cast<VkBuffer>(output.countBuffer.buffer),
+				static_cast<VkDeviceSize>(sizeof(uint32_t) * group),
+				drawGroup.meshCount,
+				static_cast<uint32_t>(sizeof(vk::DrawIndexedIndirectCommand))
+			);
+		}
+		else
+		{
+			// Culled meshes have zero instances
+			commandBuffer.drawIndexedIndirect
+			(
+				output.commandBuffer.buffer,
+				offset,
+				drawGroup.meshCount,
+				static_cast<uint32_t>(sizeof(vk::DrawIndexedIndirectCommand))
+			);
+		}
+	}
+
+	void GpuCuller::free()
+	{
+		if (m_graphics)
+		{
+			auto logicalDevice = m_graphics->getLogicalDevice();
+			destroyCameras();
+
+			for (uint32_t i = 0; i < m_frameCount; ++i)
+			{
+				m_graphics->unmapBuffer(m_objectBuffers[i]);
+				m_graphics->destroyBuffer(m_objectBuffers[i]);
+			}
+
+			m_objectBuffers.clear();
+			m_objects.clear();
+			m_capacity = 0;
+
+			logicalDevice.destroyPipeline(m_pipeline);
+			logicalDevice.destroyPipelineLayout(m_pipelineLayout);
+			logicalDevice.destroyDescriptorSetLayout(m_descriptorSetLayout);
+			logicalDevice.destroyShaderModule(m_shader);
+
+			m_graphics = nullptr;
+		}
+	}
+
+	void GpuCuller::reserve(size_t objectCount)
+	{
+		if (objectCount <= m_capacity)
+			return;
+
+		// Frames in flight may still be reading the old buffers
+		if (m_capacity > 0)
+			m_graphics->getLogicalDevice().waitIdle();
+
+		// Double to keep growth rare as scenes get bigger
+		size_t capacity = std::max<size_t>(m_capacity, GUST_GPU_CULLING_INITIAL_OBJECTS);
+
+		while (capacity < objectCount)
+			capacity *= 2;
+
+		// Commands are sized by the capacity and sets point at the object buffers
+		destroyCameras();
+
+		// Create object buffers (Mapped once for their lifetime)
+		m_objectBuffers.resize(m_frameCount);
+		m_objects.resize(m_frameCount);
+
+		for (uint32_t i = 0; i < m_frameCount; ++i)
+		{
+			if (m_objectBuffers[i].buffer)
+			{
+				m_graphics->unmapBuffer(m_objectBuffers[i]);
+				m_graphics->destroyBuffer(m_objectBuffers[i]);
+			}
+
+			m_objectBuffers[i] = m_graphics->createBuffer
+			(
+				static_cast<vk::DeviceSize>(sizeof(GpuCullObject) * capacity),
+				vk::BufferUsageFlagBits::eStorageBuffer,
+				vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+			);
+
+			m_objects[i] = static_cast<GpuCullObject*>(m_graphics->mapBuffer(m_objectBuffers[i]));
+		}
+
+		m_capacity = capacity;
+	}
+
+	void GpuCuller::destroyCameras()
+	{
+		auto logicalDevice = m_graphics->getLogicalDevice();
+
+		for (auto& camera : m_cameras)
+		{
+			for (auto& output : camera.frames)
+			{
+				m_graphics->destroyBuffer(output.commandBuffer);
+				m_graphics->destroyBuffer(output.countBuffer);
+			}
+
+			logicalDevice.destroyDescriptorPool(camera.descriptorPool);
+		}
+
+		m_cameras.clear();
+	}
+
+	void GpuCuller::initPipeline()
+	{
+		auto logicalDevice = m_graphics->getLogicalDevice();
+
+		// Create descriptor set layout (Objects, commands and counts)
+		{
+			std::array<vk::DescriptorSetLayoutBinding, 3> bindings = {};
+
+			for (uint32_t i = 0; i < bindings.size(); ++i)
+			{
+				bindings[i].setBinding(i);
+				bindings[i].setDescriptorType(vk::DescriptorType::eStorageBuffer);
+				bindings[i].setDescriptorCount(1);
+				bindings[i].setStageFlags(vk::ShaderStageFlagBits::eCompute);
+			}
+
+			vk::DescriptorSetLayoutCreateInfo createInfo = {};
+			createInfo.setBindingCount(static_cast<uint32_t>(bindings.size()));
+			createInfo.setPBindings(bindings.data());
+
+			m_descriptorSetLayout = logicalDevice.createDescriptorSetLayout(createInfo);
+		}
+
+		// Create pipeline layout
+		{
+			vk::PushConstantRange pushConstantRange = {};
+			pushConstantRange.setStageFlags(vk::ShaderStageFlagBits::eCompute);
+			pushConstantRange.setOffset(0);
+			pushConstantRange.setSize(sizeof(PushConstants));
+
+			vk::PipelineLayoutCreateInfo layoutInfo = {};
+			layoutInfo.setSetLayoutCount(1);
+			layoutInfo.setPSetLayouts(&m_descriptorSetLayout);
+			layoutInfo.setPushConstantRangeCount(1);
+			layoutInfo.setPPushConstantRanges(&pushConstantRange);
+
+			m_pipelineLayout = logicalDevice.createPipelineLayout(layoutInfo);
+		}
+
+		// Create shader module
+		{
+			std::vector<char> source = readBinary(GUST_CULLING_COMPUTE_SHADER_PATH);
+
+			// Align code
+			std::vector<uint32_t> codeAligned(source.size() / sizeof(uint32_t) + 1);
+			memcpy(codeAligned.data(), source.data(), source.size());
+
+			vk::ShaderModuleCreateInfo createInfo = {};
+			createInfo.setCodeSize(source.size());
+			createInfo.setPCode(codeAligned.data());
+
+			m_shader = logicalDevice.createShaderModule(createInfo);
+		}
+
+		// Create pipeline
+		{
+			vk::PipelineShaderStageCreateInfo stageInfo = {};
+			stageInfo.setStage(vk::ShaderStageFlagBits::eCompute);
+			stageInfo.setModule(m_shader);
+			stageInfo.setPName("main");
+
+			vk::ComputePipelineCreateInfo pipelineInfo = {};
+			pipelineInfo.setStage(stageInfo);
+			pipelineInfo.setLayout(m_pipelineLayout);
+
+			m_pipeline = logicalDevice.createComputePipeline(m_graphics->getPipelineCache(), pipelineInfo);
+		}
+	}
+
+	GpuCuller::CullCamera& GpuCuller::getCamera(size_t camera)
+	{
+		if (camera >= m_cameras.size())
+			m_cameras.resize(camera + 1);
+
+		CullCamera& data = m_cameras[camera];
+
+		// Already created
+		if (data.descriptorPool)
+			return data;
+
+		auto logicalDevice = m_graphics->getLogicalDevice();
+
+		// Create descriptor pool
+		{
+			vk::DescriptorPoolSize poolSize = {};
+			poolSize.setType(vk::DescriptorType::eStorageBuffer);
+			poolSize.setDescriptorCount(3 * m_frameCount);
+
+			vk::DescriptorPoolCreateInfo poolInfo = {};
+			poolInfo.setPoolSizeCount(1);
+			poolInfo.setPPoolSizes(&poolSize);
+			poolInfo.setMaxSets(m_frameCount);
+
+			data.descriptorPool = logicalDevice.createDescriptorPool(poolInfo);
+		}
+
+		data.frames.resize(m_frameCount);
+
+		for (uint32_t i = 0; i < m_frameCount; ++i)
+		{
+			CullOutput& output = data.frames[i];
+
+			// Create command buffer
+			output.commandBuffer = m_graphics->createBuffer
+			(
+				static_cast<vk::DeviceSize>(sizeof(vk::DrawIndexedIndirectCommand) * m_capacity),
+				vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer,
+				vk::MemoryPropertyFlagBits::eDeviceLocal
+			);
+
+			// Create count buffer
+			output.countBuffer = m_graphics->createBuffer
+			(
+				static_cast<vk::DeviceSize>(sizeof(uint32_t) * GUST_GPU_CULLING_MAX_GROUPS),
+				vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst,
+				vk::MemoryPropertyFlagBits::eDeviceLocal
+			);
+
+			// Allocate descriptor set
+			vk::DescriptorSetAllocateInfo allocInfo = {};
+			allocInfo.setDescriptorPool(data.descriptorPool);
+			allocInfo.setDescriptorSetCount(1);
+			allocInfo.setPSetLayouts(&m_descriptorSetLayout);
+
+			output.descriptorSet = logicalDevice.allocateDescriptorSets(allocInfo)[0];
+
+			// Point the set at the frames buffers
+			std::array<vk::DescriptorBufferInfo, 3> bufferInfos = {};
+			bufferInfos[0].setBuffer(m_objectBuffers[i].buffer);
+			bufferInfos[1].setBuffer(output.commandBuffer.buffer);
+			bufferInfos[2].setBuffer(output.countBuffer.buffer);
+
+			std::array<vk::WriteDescriptorSet, 3> writeSets = {};
+
+			for (uint32_t j = 0; j < writeSets.size(); ++j)
+			{
+				bufferInfos[j].setOffset(0);
+				bufferInfos[j].setRange(VK_WHOLE_SIZE);
+
+				writeSets[j].setDstSet(output.descriptorSet);
+				writeSets[j].setDstBinding(j);
+				writeSets[j].setDstArrayElement(0);
+				writeSets[j].setDescriptorType(vk::DescriptorType::eStorageBuffer);
+				writeSets[j].setDescriptorCount(1);
+				writeSets[j].setPBufferInfo(&bufferInfos[j]);
+			}
+
+			logicalDevice.updateDescriptorSets(static_cast<uint32_t>(writeSets.size()), writeSets.data(), 0, nullptr);
+		}
+
+		return data;
+	}
+}
@@ -0,0 +1,303 @@
+#pragma once
+
+/**
+ * @file GpuCuller.hpp
+ * @brief GPU culler header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/** Includes. */
+#include <array>
+#include <vector>
+#include <unordered_map>
+#include <Allocators.hpp>
+#include "Vulkan.hpp"
+
+/**
+ * @def GUST_CULLING_COMPUTE_SHADER_PATH
+ * @brief Path to the file containing the culling compute shader.
+ */
+#define GUST_CULLING_COMPUTE_SHADER_PATH "./Shaders/culling-comp.spv"
+
+/**
+ * @def GUST_GPU_CULLING_INITIAL_OBJECTS
+ * @brief Number of meshes the GPU culler has room for before its buffers grow.
+ */
+#define GUST_GPU_CULLING_INITIAL_OBJECTS (128 * 1024)
+
+/**
+ * @def GUST_GPU_CULLING_MAX_GROUPS
+ * @brief Maximum number of indirect draws (Unique material, geometry block and index type) per frame.
+ */
+#define GUST_GPU_CULLING_MAX_GROUPS 4096
+
+/**
+ * @def GUST_GPU_CULLING_GROUP_SIZE
+ * @brief Number of meshes tested by each compute shader invocation group (Must match culling.comp.)
+ */
+#define GUST_GPU_CULLING_GROUP_SIZE 64
+
+namespace gust
+{
+	class Graphics;
+	class Material;
+	struct MeshData;
+
+	/**
+	 * @struct GpuCullObject
+	 * @brief A mesh to be culled on the GPU (Mirrors GUST_CULL_OBJECT in culling.comp.)
+	 */
+	struct GpuCullObject
+	{
+		/** World space bounding box center. */
+		glm::vec4 center = {};
+
+		/** World space bounding box extents. */
+		glm::vec4 extents = {};
+
+		/** Number of indices. */
+		uint32_t indexCount = 0;
+
+		/** First index in the geometry block. */
+		uint32_t firstIndex = 0;
+
+		/** First vertex in the geometry block. */
+		int32_t vertexOffset = 0;
+
+		/** Draw group. */
+		uint32_t group = 0;
+
+		/** First indirect command of the draw group. */
+		uint32_t firstCommand = 0;
+
+		/** Indirect command owned by the mesh (Used when draw counts aren't supported.) */
+		uint32_t command = 0;
+
+		/** Instance the mesh is drawn as (Its index in the frames meshes.) */
+		uint32_t instance = 0;
+
+		/** Padding. */
+		uint32_t padding = 0;
+	};
+
+	static_assert(sizeof(GpuCullObject) == 64, "GPU cull objects must match the culling shaders layout.");
+
+	/**
+	 * @struct GpuDrawGroup
+	 * @brief Meshes drawn with a single indirect draw.
+	 */
+	struct GpuDrawGroup
+	{
+		/** Material (Which also decides the shader.) */
+		Handle<Material> material = Handle<Material>::nullHandle();
+
+		/** Geometry block. */
+		uint32_t block = 0;
+
+		/** Index type of every mesh in the group. */
+		vk::IndexType indexType = vk::IndexType::eUint32;
+
+		/** First indirect command. */
+		uint32_t firstCommand = 0;
+
+		/** Number of meshes in the group. */
+		uint32_t meshCount = 0;
+	};
+
+
+
+	/**
+	 * @class GpuCuller
+	 * @brief Frustum culls meshes with a compute shader and writes the survivors as indirect draws.
+	 * @note Every mesh is uploaded once per frame and grouped by material, geometry block and index type.
+	 * Each camera then records a dispatch and one indirect draw per group, so the CPU cost of
+	 * drawing doesn't grow with the number of meshes.
+	 */
+	class GpuCuller
+	{
+	public:
+
+		/**
+		 * @brief Default constructor.
+		 */
+		GpuCuller() = default;
+
+		/**
+		 * @brief Constructor.
+		 * @param Graphics context.
+		 * @param Number of frames in flight.
+		 */
+		GpuCuller(Graphics* graphics, uint32_t frameCount);
+
+		/**
+		 * @brief Default destructor.
+		 */
+		~GpuCuller() = default;
+
+		/**
+		 * @brief Upload every mesh and build draw groups.
+		 * @param Frame index.
+		 * @param Meshes to draw this frame.
+		 * @param Set for each mesh drawn some other way (Empty if there are none.)
+		 * @return Number of meshes uploaded.
+		 * @note Mesh i is drawn as instance i, so its model matrix is expected at that index of the per draw data.
+		 * @note Buffers grow to fit every mesh, which waits for the device to go idle.
+		 */
+		uint32_t beginFrame(uint32_t frameIndex, const std::vector<MeshData>& meshes, const std::vector<bool>& skipped = {});
+
+		/**
+		 * @brief Record culling for a camera.
+		 * @param Command buffer (Outside of a render pass.)
+		 * @param Camera index.
+		 * @param Cameras view projection matrix.
+		 */
+		void cull(const vk::CommandBuffer& commandBuffer, size_t camera, const glm::mat4& viewProjection);
+
+		/**
+		 * @brief Record a draw groups indirect draw for a camera.
+		 * @param Command buffer (Pipeline, sets and buffers must be bound.)
+		 * @param Camera index.
+		 * @param Draw group index.
+		 */
+		void draw(const vk::CommandBuffer& commandBuffer, size_t camera, size_t group);
+
+		/**
+		 * @brief Get draw groups.
+		 * @return Draw groups.
+		 */
+		inline const std::vector<GpuDrawGroup>& getGroups() const
+		{
+			return m_groups;
+		}
+
+		/**
+		 * @brief Free memory.
+		 * @note Used internally. Do not call.
+		 */
+		void free();
+
+	private:
+
+		/**
+		 * @struct CullOutput
+		 * @brief Culling output of a camera for a single frame.
+		 */
+		struct CullOutput
+		{
+			/** Indirect draw commands. */
+			Buffer commandBuffer = {};
+
+			/** Draw count of each group. */
+			Buffer countBuffer = {};
+
+			/** Descriptor set. */
+			vk::DescriptorSet descriptorSet = {};
+		};
+
+		/**
+		 * @struct CullCamera
+		 * @brief Culling output of a camera.
+		 */
+		struct CullCamera
+		{
+			/** Descriptor pool. */
+			vk::DescriptorPool descriptorPool = {};
+
+			/** Per frame output. */
+			std::vector<CullOutput> frames = {};
+		};
+
+		/**
+		 * @struct PushConstants
+		 * @brief Push constants of the culling shader.
+		 */
+		struct PushConstants
+		{
+			/** Frustum planes. */
+			std::array<glm::vec4, 6> planes = {};
+
+			/** Number of meshes. */
+			uint32_t objectCount = 0;
+
+			/** Should surviving draws be compacted? */
+			uint32_t compact = 0;
+		};
+
+		/**
+		 * @brief Create the culling pipeline.
+		 */
+		void initPipeline();
+
+		/**
+		 * @brief Grow the object and command buffers to fit a number of meshes.
+		 * @param Number of meshes.
+		 * @note Cameras output is recreated on its next use.
+		 */
+		void reserve(size_t objectCount);
+
+		/**
+		 * @brief Destroy every cameras output.
+		 */
+		void destroyCameras();
+
+		/**
+		 * @brief Create a cameras output buffers if it doesn't have them yet.
+		 * @param Camera index.
+		 * @return Camera data.
+		 */
+		CullCamera& getCamera(size_t camera);
+
+
+
+		/** Graphics context. */
+		Graphics* m_graphics = nullptr;
+
+		/** Compute shader. */
+		vk::ShaderModule m_shader = {};
+
+		/** Descriptor set layout. */
+		vk::DescriptorSetLayout m_descriptorSetLayout = {};
+
+		/** Pipeline layout. */
+		vk::PipelineLayout m_pipelineLayout = {};
+
+		/** Pipeline. */
+		vk::Pipeline m_pipeline = {};
+
+		/** Number of frames in flight. */
+		uint32_t m_frameCount = 0;
+
+		/** Number of meshes the object and command buffers have room for. */
+		size_t m_capacity = 0;
+
+		/** Meshes of each frame. */
+		std::vector<Buffer> m_objectBuffers = {};
+
+		/** Mapped meshes of each frame. */
+		std::vector<GpuCullObject*> m_objects = {};
+
+		/** Culling output of each camera. */
+		std::vector<CullCamera> m_cameras = {};
+
+		/** Frame being recorded. */
+		uint32_t m_frameIndex = 0;
+
+		/** Number of meshes uploaded this frame. */
+		uint32_t m_objectCount = 0;
+
+		/** Draw groups. */
+		std::vector<GpuDrawGroup> m_groups = {};
+
+		/** Index of each uploaded mesh in the frames meshes. */
+		std::vector<uint32_t> m_objectMeshes = {};
+
+		/** Draw group of each mesh. */
+		std::vector<uint32_t> m_objectGroups = {};
+
+		/** Draw group index of each material, geometry block and index type. */
+		std::unordered_map<uint64_t, uint32_t> m_groupLookup = {};
+
+		/** vkCmdDrawIndexedIndirectCountKHR (Null when draw counts aren't supported.) */
+		PFN_vkCmdDrawIndexedIndirectCountKHR m_drawIndexedIndirectCount = nullptr;
+	};
+}
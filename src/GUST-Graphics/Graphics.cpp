@@ -3,9 +3,73 @@
 #include <array>
 #include <map>
 #include <set>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
 #include <Debugging.hpp>
+#include <FileIO.hpp>
+#include <Clock.hpp>
 #include "Graphics.hpp"
 
+namespace
+{
+	/** Identifies a pipeline cache file. */
+	const uint32_t pipelineCacheMagic = 0x48435047;
+
+	/** Version of the pipeline cache file layout. */
+	const uint32_t pipelineCacheVersion = 1;
+
+	/**
+	 * @struct PipelineCacheHeader
+	 * @brief Written before the pipeline cache data so caches from other devices or drivers are rejected.
+	 */
+	struct PipelineCacheHeader
+	{
+		/** Magic number. */
+		uint32_t magic = 0;
+
+		/** File layout version. */
+		uint32_t version = 0;
+
+		/** Vendor of the device. */
+		uint32_t vendorID = 0;
+
+		/** Device. */
+		uint32_t deviceID = 0;
+
+		/** Driver version. */
+		uint32_t driverVersion = 0;
+
+		/** Pipeline cache UUID of the device. */
+		uint8_t uuid[VK_UUID_SIZE] = {};
+
+		/** Size of the cache data. */
+		uint64_t dataSize = 0;
+
+		/** Checksum of the cache data. */
+		uint64_t checksum = 0;
+	};
+
+	/**
+	 * @brief Compute a checksum that is stable between builds.
+	 * @param Data.
+	 * @param Size of the data.
+	 * @return FNV-1a hash of the data.
+	 */
+	uint64_t checksum(const char* data, size_t size)
+	{
+		uint64_t hash = 0xcbf29ce484222325;
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= static_cast<uint8_t>(data[i]);
+			hash *= 0x100000001b3;
+		}
+
+		return hash;
+	}
+}
+
 namespace gust
 {
 	void Graphics::startup(const std::string& name, uint32_t width, uint32_t height)
@@ -81,7 +145,11 @@ namespace gust
 		appInfo.setApplicationVersion(VK_MAKE_VERSION(1, 0, 0));	// Application version
 		appInfo.setPEngineName("GUST Engine");						// Engine name
 		appInfo.setEngineVersion(VK_MAKE_VERSION(1, 0, 0));			// Engine version
+#ifdef GUST_BINDLESS
+		appInfo.setApiVersion(VK_API_VERSION_1_1);					// Vulkan version (Needed to query descriptor indexing features)
+#else
 		appInfo.setApiVersion(VK_API_VERSION_1_0);					// Vulkan version
+#endif
 
 		// Get extensions and layers
 		m_layers = getLayers(requestedLayers);
@@ -171,6 +239,41 @@ namespace gust
 			// Requested features for the device
 			vk::PhysicalDeviceFeatures deviceFeatures = {};
 
+			// Descriptor indexing features used by the descriptor heap
+			vk::PhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures = {};
+			indexingFeatures.setRuntimeDescriptorArray(true);
+			indexingFeatures.setDescriptorBindingPartiallyBound(true);
+			indexingFeatures.setDescriptorBindingSampledImageUpdateAfterBind(true);
+			indexingFeatures.setDescriptorBindingUpdateUnusedWhilePending(true);
+
+#ifdef GUST_BINDLESS
+			m_bindless = supportsBindless(m_physicalDevice);
+
+			if (m_bindless)
+				m_deviceExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+			else
+				gLog("Device doesn't support descriptor indexing, bindless mode disabled.\n");
+#endif
+
+#ifdef GUST_GPU_CULLING
+			// Culled draws are written by a compute shader and read back as indirect draws
+			m_gpuCulling = m_bindless && supportsGpuCulling(m_physicalDevice);
+
+			if (m_gpuCulling)
+			{
+				deviceFeatures.setMultiDrawIndirect(true);
+				deviceFeatures.setDrawIndirectFirstInstance(true);
+
+				// Without a draw count culled draws are drawn with no instances
+				m_drawIndirectCount = hasDeviceExtension(m_physicalDevice, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+
+				if (m_drawIndirectCount)
+					m_deviceExtensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+			}
+			else
+				gLog("Device doesn't support multi draw indirect, GPU culling disabled.\n");
+#endif
+
 			// Logical device creation info
 			vk::DeviceCreateInfo createInfo = {};
 			createInfo.setFlags(vk::DeviceCreateFlags());
@@ -181,6 +284,7 @@ namespace gust
 			createInfo.setEnabledLayerCount(static_cast<uint32_t>(m_layers.size()));				// Validation layer count
 			createInfo.setPpEnabledExtensionNames(m_deviceExtensions.data());						// Extensions
 			createInfo.setEnabledExtensionCount(static_cast<uint32_t>(m_deviceExtensions.size()));	// Extension count
+			createInfo.setPNext(m_bindless ? &indexingFeatures : nullptr);							// Descriptor indexing features
 
 			// Create logical device
 			{
@@ -198,6 +302,49 @@ namespace gust
 			gAssert(check == VK_SUCCESS);
 		}
 
+		// Create small uniform buffer pool
+		{
+			// Memory types a uniform buffer may use
+			std::array<uint32_t, 2> queues =
+			{
+				static_cast<uint32_t>(m_queueFamilyIndices.graphicsFamily),
+				static_cast<uint32_t>(m_queueFamilyIndices.transferFamily)
+			};
+
+			vk::BufferCreateInfo bufferInfo = {};
+			bufferInfo.setSize(GUST_SMALL_UNIFORM_BUFFER_SIZE);
+			bufferInfo.setUsage(vk::BufferUsageFlagBits::eUniformBuffer);
+
+			if (hasDedicatedTransferFamily())
+			{
+				bufferInfo.setQueueFamilyIndexCount(2);
+				bufferInfo.setPQueueFamilyIndices(queues.data());
+				bufferInfo.setSharingMode(vk::SharingMode::eConcurrent);
+			}
+			else
+				bufferInfo.setSharingMode(vk::SharingMode::eExclusive);
+
+			vk::Buffer buffer = m_logicalDevice.createBuffer(bufferInfo);
+			const vk::MemoryRequirements memRequirements = m_logicalDevice.getBufferMemoryRequirements(buffer);
+			m_logicalDevice.destroyBuffer(buffer);
+
+			VmaAllocationCreateInfo allocInfo = {};
+			allocInfo.requiredFlags = static_cast<VkMemoryPropertyFlags>(vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+			VmaPoolCreateInfo poolInfo = {};
+			poolInfo.blockSize = GUST_UNIFORM_POOL_BLOCK_SIZE;
+			{
+				auto check = vmaFindMemoryTypeIndex(m_memoryAllocator, memRequirements.memoryTypeBits, &allocInfo, &poolInfo.memoryTypeIndex);
+				gAssert(check == VK_SUCCESS);
+			}
+
+			// Create pool
+			{
+				auto check = vmaCreatePool(m_memoryAllocator, &poolInfo, &m_uniformPool);
+				gAssert(check == VK_SUCCESS);
+			}
+		}
+
 		// Initialize surface formats
 		initSurfaceFormats(m_physicalDevice);
 
@@ -239,13 +386,45 @@ namespace gust
 			// Create single use pool
 			m_singleUsePool = m_logicalDevice.createCommandPool(commandPoolInfo);
 		}
+
+		initPipelineCache();
+
+		// Create upload manager
+		m_uploadManager = std::make_unique<UploadManager>(this);
+
+		// Create geometry pool
+		m_geometryPool = std::make_unique<GeometryPool>(this);
+
+		// Create descriptor heap
+		if (m_bindless)
+			m_descriptorHeap = std::make_unique<DescriptorHeap>(this);
 	}
 
 	void Graphics::shutdown()
 	{
 		m_logicalDevice.waitIdle();
 
+		// Save and destroy pipeline cache
+		savePipelineCache();
+		m_logicalDevice.destroyPipelineCache(m_pipelineCache);
+
+		// Destroy descriptor heap
+		if (m_descriptorHeap)
+		{
+			m_descriptorHeap->free();
+			m_descriptorHeap = nullptr;
+		}
+
+		// Destroy geometry pool
+		m_geometryPool->free();
+		m_geometryPool = nullptr;
+
+		// Finish uploads and free staging memory
+		m_uploadManager->free();
+		m_uploadManager = nullptr;
+
 		// Destroy memory allocator
+		vmaDestroyPool(m_memoryAllocator, m_uniformPool);
 		vmaDestroyAllocator(m_memoryAllocator);
 
 		// Cleanup pools
@@ -282,6 +461,25 @@ namespace gust
 		SDL_SetWindowSize(m_window, m_width, m_height);
 	}
 
+	MemoryStats Graphics::getMemoryStats()
+	{
+		VmaStats vmaStats = {};
+		vmaCalculateStats(m_memoryAllocator, &vmaStats);
+
+		VmaPoolStats poolStats = {};
+		vmaGetPoolStats(m_memoryAllocator, m_uniformPool, &poolStats);
+
+		MemoryStats stats = {};
+		stats.blockCount = vmaStats.total.blockCount;
+		stats.allocationCount = vmaStats.total.allocationCount;
+		stats.usedBytes = vmaStats.total.usedBytes;
+		stats.unusedBytes = vmaStats.total.unusedBytes;
+		stats.uniformPoolAllocationCount = poolStats.allocationCount;
+		stats.uniformPoolSize = poolStats.size;
+
+		return stats;
+	}
+
 	Buffer Graphics::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties)
 	{
 		// Buffer to return
@@ -296,67 +494,67 @@ namespace gust
 		vk::BufferCreateInfo bufferInfo = {};
 		bufferInfo.setSize(size);
 		bufferInfo.setUsage(usage);
-		bufferInfo.setQueueFamilyIndexCount(2);
-		bufferInfo.setPQueueFamilyIndices(queues.data());
-		bufferInfo.setSharingMode(vk::SharingMode::eConcurrent);
 
-		// Create buffer
-		buffer.buffer = m_logicalDevice.createBuffer(bufferInfo);
+		// Families can't be listed twice, so a shared family uses exclusive sharing
+		if (hasDedicatedTransferFamily())
+		{
+			bufferInfo.setQueueFamilyIndexCount(2);
+			bufferInfo.setPQueueFamilyIndices(queues.data());
+			bufferInfo.setSharingMode(vk::SharingMode::eConcurrent);
+		}
+		else
+			bufferInfo.setSharingMode(vk::SharingMode::eExclusive);
 
-		vk::MemoryRequirements memRequirements = {};
-		m_logicalDevice.getBufferMemoryRequirements(buffer.buffer, &memRequirements);
+		VmaAllocationCreateInfo allocInfo = {};
+		allocInfo.requiredFlags = static_cast<VkMemoryPropertyFlags>(properties);
 
-		vk::MemoryAllocateInfo allocInfo = {};
-		allocInfo.setAllocationSize(memRequirements.size);
-		allocInfo.setMemoryTypeIndex(findMemoryType(memRequirements.memoryTypeBits, properties));
+		// Small uniform buffers are packed together in their own pool
+		const bool small =
+			size <= GUST_SMALL_UNIFORM_BUFFER_SIZE &&
+			usage == vk::BufferUsageFlagBits::eUniformBuffer &&
+			properties == (vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
 
-		// Allocate memory
-		buffer.memory = m_logicalDevice.allocateMemory(allocInfo);
+		if (small)
+			allocInfo.pool = m_uniformPool;
 
-		// Bind memory
-		m_logicalDevice.bindBufferMemory(buffer.buffer, buffer.memory, 0);
+		// Create buffer and suballocate memory
+		VkBuffer vkBuffer = VK_NULL_HANDLE;
+		{
+			auto check = vmaCreateBuffer
+			(
+				m_memoryAllocator, 
+				reinterpret_cast<const VkBufferCreateInfo*>(&bufferInfo), 
+				&allocInfo, 
+				&vkBuffer, 
+				&buffer.allocation, 
+				nullptr
+			);
+			gAssert(check == VK_SUCCESS);
+		}
 
+		buffer.buffer = vkBuffer;
 		return buffer;
 	}
 
-	void Graphics::copyBuffer(const vk::Buffer& sourceBuffer, const vk::Buffer& destinationBuffer, vk::DeviceSize size)
+	void Graphics::destroyBuffer(const Buffer& buffer)
 	{
-		vk::CommandBufferAllocateInfo allocInfo = {};
-		allocInfo.setLevel(vk::CommandBufferLevel::ePrimary);
-		allocInfo.setCommandPool(m_transferPool);
-		allocInfo.setCommandBufferCount(1);
-
-		// Create command buffer
-		vk::CommandBuffer commandBuffer = {};
-		commandBuffer = m_logicalDevice.allocateCommandBuffers(allocInfo)[0];
-
-		vk::CommandBufferBeginInfo beginInfo = {};
-		beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
-
-		// Start recording to command buffer
-		commandBuffer.begin(beginInfo);
-
-		vk::BufferCopy copyRegion = {};
-		copyRegion.setSrcOffset(0);
-		copyRegion.setDstOffset(0);
-		copyRegion.setSize(size);
-
-		// Copy srcBuffer to dstBuffer
-		commandBuffer.copyBuffer(sourceBuffer, destinationBuffer, 1, &copyRegion);
-
-		// Stop recording to command buffer
-		commandBuffer.end();
+		vmaDestroyBuffer(m_memoryAllocator, static_cast<VkBuffer>(buffer.buffer), buffer.allocation);
+	}
 
-		vk::SubmitInfo submitInfo = {};
-		submitInfo.setCommandBufferCount(1);
-		submitInfo.setPCommandBuffers(&commandBuffer);
+	void* Graphics::mapBuffer(const Buffer& buffer)
+	{
+		void* data = nullptr;
+		{
+			auto check = vmaMapMemory(m_memoryAllocator, buffer.allocation, &data);
+			gAssert(check == VK_SUCCESS);
+		}
 
-		// Subit command buffer
-		m_transferQueue.submit(1, &submitInfo, {});
-		m_transferQueue.waitIdle();
+		return data;
+	}
 
-		// Destroy command buffer
-		m_logicalDevice.freeCommandBuffers(m_transferPool, 1, &commandBuffer);
+	void Graphics::unmapBuffer(const Buffer& buffer)
+	{
+		vmaUnmapMemory(m_memoryAllocator, buffer.allocation);
 	}
 
 	uint32_t Graphics::findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties)
@@ -382,43 +580,75 @@ namespace gust
 		vk::ImageUsageFlags usage,
 		vk::MemoryPropertyFlags properties,
 		vk::Image& image,
-		vk::DeviceMemory& imageMemory,
+		VmaAllocation& imageAllocation,
 		vk::ImageCreateFlags flags,
-		uint32_t arrayLayers
+		uint32_t arrayLayers,
+		uint32_t mipLevels
 	)
 	{
 		vk::ImageCreateInfo imageInfo = {};
 		imageInfo.setImageType(vk::ImageType::e2D);
 		imageInfo.setExtent({ width, height, 1 });;
-		imageInfo.setMipLevels(1);
+		imageInfo.setMipLevels(mipLevels);
 		imageInfo.setArrayLayers(arrayLayers);
 		imageInfo.setFormat(format);
 		imageInfo.setTiling(tiling);
 		imageInfo.setInitialLayout(vk::ImageLayout::eUndefined);
 		imageInfo.setUsage(usage);
 		imageInfo.setSamples(vk::SampleCountFlagBits::e1);
-		imageInfo.setSharingMode(vk::SharingMode::eExclusive);
 		imageInfo.setFlags(flags);
 
-		// Create image
+		std::array<uint32_t, 2> queues =
 		{
-			auto check = m_logicalDevice.createImage(&imageInfo, nullptr, &image);
-			gAssert(check == vk::Result::eSuccess);
+			static_cast<uint32_t>(m_queueFamilyIndices.graphicsFamily),
+			static_cast<uint32_t>(m_queueFamilyIndices.transferFamily)
+		};
+
+		// Images filled by the upload manager are written on the transfer queue (The same queue on single family devices)
+		if ((usage & vk::ImageUsageFlagBits::eTransferDst) && hasDedicatedTransferFamily())
+		{
+			imageInfo.setQueueFamilyIndexCount(2);
+			imageInfo.setPQueueFamilyIndices(queues.data());
+			imageInfo.setSharingMode(vk::SharingMode::eConcurrent);
 		}
+		else
+			imageInfo.setSharingMode(vk::SharingMode::eExclusive);
 
-		vk::MemoryRequirements memRequirements = m_logicalDevice.getImageMemoryRequirements(image);
+		createImage(imageInfo, properties, image, imageAllocation);
+	}
 
-		vk::MemoryAllocateInfo allocInfo = {};
-		allocInfo.setAllocationSize(memRequirements.size);
-		allocInfo.setMemoryTypeIndex(findMemoryType(memRequirements.memoryTypeBits, properties));
+	void Graphics::createImage
+	(
+		const vk::ImageCreateInfo& imageInfo,
+		vk::MemoryPropertyFlags properties,
+		vk::Image& image,
+		VmaAllocation& imageAllocation
+	)
+	{
+		VmaAllocationCreateInfo allocInfo = {};
+		allocInfo.requiredFlags = static_cast<VkMemoryPropertyFlags>(properties);
 
-		// Allocate memory
+		// Create image and suballocate memory
+		VkImage vkImage = VK_NULL_HANDLE;
 		{
-			auto check = m_logicalDevice.allocateMemory(&allocInfo, nullptr, &imageMemory);
-			gAssert(check == vk::Result::eSuccess);
+			auto check = vmaCreateImage
+			(
+				m_memoryAllocator, 
+				reinterpret_cast<const VkImageCreateInfo*>(&imageInfo), 
+				&allocInfo, 
+				&vkImage, 
+				&imageAllocation, 
+				nullptr
+			);
+			gAssert(check == VK_SUCCESS);
 		}
 
-		m_logicalDevice.bindImageMemory(image, imageMemory, 0);
+		image = vkImage;
+	}
+
+	void Graphics::destroyImage(const vk::Image& image, VmaAllocation imageAllocation)
+	{
+		vmaDestroyImage(m_memoryAllocator, static_cast<VkImage>(image), imageAllocation);
 	}
 
 	void Graphics::transitionImageLayout(const vk::Image& image, vk::Format format, vk::ImageLayout oldLayout, vk::ImageLayout newLayout, uint32_t imageCount)
@@ -490,41 +720,15 @@ namespace gust
 		endSingleTimeCommands(commandBuffer);
 	}
 
-	void Graphics::copyBufferToImage(const vk::Buffer& buffer, const vk::Image& image, uint32_t width, uint32_t height, uint32_t imageCount, uint32_t imageSize)
-	{
-		vk::CommandBuffer commandBuffer = beginSingleTimeCommands();
-
-		std::vector<vk::BufferImageCopy> regions(imageCount);
-		uint32_t offset = 0;
-
-		for (size_t i = 0; i < regions.size(); ++i)
-		{
-			regions[i].setBufferOffset(offset);
-			regions[i].setBufferRowLength(0);
-			regions[i].setBufferImageHeight(0);
-			regions[i].imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
-			regions[i].imageSubresource.mipLevel = 0;
-			regions[i].imageSubresource.baseArrayLayer = static_cast<uint32_t>(i);
-			regions[i].imageSubresource.layerCount = 1;
-			regions[i].setImageOffset({ 0, 0, 0 });
-			regions[i].setImageExtent({ width, height, 1 });
-			offset += imageSize;
-		}
-
-		// Copy buffer to image
-		commandBuffer.copyBufferToImage
-		(
-			buffer,
-			image,
-			vk::ImageLayout::eTransferDstOptimal,
-			static_cast<uint32_t>(regions.size()),
-			regions.data()
-		);
-
-		endSingleTimeCommands(commandBuffer);
-	}
-
-	vk::ImageView Graphics::createImageView(const vk::Image& image, vk::Format format, vk::ImageAspectFlags aspectFlags, vk::ImageViewType viewType, uint32_t imageCount)
+	vk::ImageView Graphics::createImageView
+	(
+		const vk::Image& image,
+		vk::Format format,
+		vk::ImageAspectFlags aspectFlags,
+		vk::ImageViewType viewType,
+		uint32_t imageCount,
+		uint32_t mipLevels
+	)
 	{
 		vk::ImageViewCreateInfo viewInfo = {};
 		viewInfo.setImage(image);
@@ -533,7 +737,7 @@ namespace gust
 		viewInfo.setComponents(vk::ComponentMapping());
 		viewInfo.subresourceRange.aspectMask = aspectFlags;
 		viewInfo.subresourceRange.baseMipLevel = 0;
-		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.levelCount = mipLevels;
 		viewInfo.subresourceRange.baseArrayLayer = 0;
 		viewInfo.subresourceRange.layerCount = imageCount;
 
@@ -547,6 +751,134 @@ namespace gust
 		return view;
 	}
 
+	bool Graphics::supportsLinearBlit(vk::Format format) const
+	{
+		const vk::FormatProperties properties = m_physicalDevice.getFormatProperties(format);
+		const vk::FormatFeatureFlags required = 
+			vk::FormatFeatureFlagBits::eBlitSrc | 
+			vk::FormatFeatureFlagBits::eBlitDst | 
+			vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+
+		return (properties.optimalTilingFeatures & required) == required;
+	}
+
+	void Graphics::generateMipmaps
+	(
+		vk::CommandBuffer commandBuffer,
+		const vk::Image& image,
+		uint32_t width,
+		uint32_t height,
+		uint32_t mipLevels,
+		uint32_t imageCount
+	)
+	{
+		vk::ImageMemoryBarrier barrier = {};
+		barrier.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+		barrier.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+		barrier.setImage(image);
+		barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = imageCount;
+
+		// Level 0 is read by the first blit (Chained to the wait on the copy, which made its writes available)
+		barrier.setOldLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+		barrier.setNewLayout(vk::ImageLayout::eTransferSrcOptimal);
+		barrier.setSrcAccessMask((vk::AccessFlagBits)0);
+		barrier.setDstAccessMask(vk::AccessFlagBits::eTransferRead);
+
+		commandBuffer.pipelineBarrier
+		(
+			vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer,
+			(vk::DependencyFlagBits)0,
+			0, nullptr,
+			0, nullptr,
+			1, &barrier
+		);
+
+		int32_t levelWidth = static_cast<int32_t>(width);
+		int32_t levelHeight = static_cast<int32_t>(height);
+
+		for (uint32_t i = 1; i < mipLevels; ++i)
+		{
+			const int32_t nextWidth = std::max(levelWidth / 2, 1);
+			const int32_t nextHeight = std::max(levelHeight / 2, 1);
+
+			// Prepare the level for writing
+			barrier.subresourceRange.baseMipLevel = i;
+			barrier.setOldLayout(vk::ImageLayout::eUndefined);
+			barrier.setNewLayout(vk::ImageLayout::eTransferDstOptimal);
+			barrier.setSrcAccessMask((vk::AccessFlagBits)0);
+			barrier.setDstAccessMask(vk::AccessFlagBits::eTransferWrite);
+
+			commandBuffer.pipelineBarrier
+			(
+				vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,
+				(vk::DependencyFlagBits)0,
+				0, nullptr,
+				0, nullptr,
+				1, &barrier
+			);
+
+			// Filter the level above down into it
+			vk::ImageBlit blit = {};
+			blit.srcSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+			blit.srcSubresource.mipLevel = i - 1;
+			blit.srcSubresource.baseArrayLayer = 0;
+			blit.srcSubresource.layerCount = imageCount;
+			blit.srcOffsets[1] = vk::Offset3D(levelWidth, levelHeight, 1);
+			blit.dstSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+			blit.dstSubresource.mipLevel = i;
+			blit.dstSubresource.baseArrayLayer = 0;
+			blit.dstSubresource.layerCount = imageCount;
+			blit.dstOffsets[1] = vk::Offset3D(nextWidth, nextHeight, 1);
+
+			commandBuffer.blitImage
+			(
+				image, vk::ImageLayout::eTransferSrcOptimal,
+				image, vk::ImageLayout::eTransferDstOptimal,
+				1, &blit,
+				vk::Filter::eLinear
+			);
+
+			// The next blit reads this level
+			barrier.setOldLayout(vk::ImageLayout::eTransferDstOptimal);
+			barrier.setNewLayout(vk::ImageLayout::eTransferSrcOptimal);
+			barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+			barrier.setDstAccessMask(vk::AccessFlagBits::eTransferRead);
+
+			commandBuffer.pipelineBarrier
+			(
+				vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer,
+				(vk::DependencyFlagBits)0,
+				0, nullptr,
+				0, nullptr,
+				1, &barrier
+			);
+
+			levelWidth = nextWidth;
+			levelHeight = nextHeight;
+		}
+
+		// Prepare every level for shader access
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = mipLevels;
+		barrier.setOldLayout(vk::ImageLayout::eTransferSrcOptimal);
+		barrier.setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+		barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferRead);
+		barrier.setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+
+		commandBuffer.pipelineBarrier
+		(
+			vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,
+			(vk::DependencyFlagBits)0,
+			0, nullptr,
+			0, nullptr,
+			1, &barrier
+		);
+	}
+
 	size_t Graphics::getDeviceScore(vk::PhysicalDevice device)
 	{
 		// Get physical device properties
@@ -609,6 +941,10 @@ namespace gust
 			++i;
 		}
 
+		// Devices without a transfer only family (Like lavapipe and many integrated GPUs) upload on the graphics family
+		if (indices.transferFamily < 0)
+			indices.transferFamily = indices.graphicsFamily;
+
 		return indices;
 	}
 
@@ -625,6 +961,42 @@ namespace gust
 		return requiredExtensions.empty();
 	}
 
+	bool Graphics::hasDeviceExtension(vk::PhysicalDevice physicalDevice, const char* extension)
+	{
+		const auto availableExtensions = physicalDevice.enumerateDeviceExtensionProperties();
+
+		for (const auto& available : availableExtensions)
+			if (std::strcmp(available.extensionName, extension) == 0)
+				return true;
+
+		return false;
+	}
+
+	bool Graphics::supportsBindless(vk::PhysicalDevice physicalDevice)
+	{
+		// Check for the extension
+		if (!hasDeviceExtension(physicalDevice, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME))
+			return false;
+
+		// Check for the features
+		vk::PhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures = {};
+		vk::PhysicalDeviceFeatures2 features = {};
+		features.setPNext(&indexingFeatures);
+		physicalDevice.getFeatures2(&features);
+
+		return
+			indexingFeatures.runtimeDescriptorArray &&
+			indexingFeatures.descriptorBindingPartiallyBound &&
+			indexingFeatures.descriptorBindingSampledImageUpdateAfterBind &&
+			indexingFeatures.descriptorBindingUpdateUnusedWhilePending;
+	}
+
+	bool Graphics::supportsGpuCulling(vk::PhysicalDevice physicalDevice)
+	{
+		const vk::PhysicalDeviceFeatures features = physicalDevice.getFeatures();
+		return features.multiDrawIndirect && features.drawIndirectFirstInstance;
+	}
+
 	std::vector<const char*> Graphics::getLayers(const std::vector<const char*>& layers)
 	{
 		// Get avaliable layers
@@ -706,6 +1078,78 @@ namespace gust
 		}
 	}
 
+	void Graphics::initPipelineCache()
+	{
+		const auto properties = m_physicalDevice.getProperties();
+		std::vector<char> data = {};
+
+		// Load the cache if it exists
+		std::ifstream stream(GUST_PIPELINE_CACHE_PATH, std::ios::binary | std::ios::in);
+		PipelineCacheHeader header = {};
+
+		if (stream.is_open() && stream.read(reinterpret_cast<char*>(&header), sizeof(PipelineCacheHeader)))
+		{
+			// Caches from a different device or driver are at best useless
+			const bool valid =
+				header.magic == pipelineCacheMagic &&
+				header.version == pipelineCacheVersion &&
+				header.vendorID == properties.vendorID &&
+				header.deviceID == properties.deviceID &&
+				header.driverVersion == properties.driverVersion &&
+				std::memcmp(header.uuid, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+
+			if (valid)
+			{
+				data.resize(static_cast<size_t>(header.dataSize));
+
+				if (!stream.read(data.data(), data.size()) || checksum(data.data(), data.size()) != header.checksum)
+					data.clear();
+			}
+
+			if (data.empty())
+				gLog("Pipeline cache is stale or corrupt and will be rebuilt.\n");
+		}
+
+		vk::PipelineCacheCreateInfo cacheInfo = {};
+		cacheInfo.setInitialDataSize(data.size());
+		cacheInfo.setPInitialData(data.empty() ? nullptr : data.data());
+
+		// Create pipeline cache
+		m_pipelineCache = m_logicalDevice.createPipelineCache(cacheInfo);
+		m_pipelineCacheWarm = !data.empty();
+	}
+
+	void Graphics::savePipelineCache()
+	{
+		const auto properties = m_physicalDevice.getProperties();
+		const auto data = m_logicalDevice.getPipelineCacheData(m_pipelineCache);
+
+		PipelineCacheHeader header = {};
+		header.magic = pipelineCacheMagic;
+		header.version = pipelineCacheVersion;
+		header.vendorID = properties.vendorID;
+		header.deviceID = properties.deviceID;
+		header.driverVersion = properties.driverVersion;
+		std::memcpy(header.uuid, properties.pipelineCacheUUID, VK_UUID_SIZE);
+		header.dataSize = static_cast<uint64_t>(data.size());
+		header.checksum = checksum(reinterpret_cast<const char*>(data.data()), data.size());
+
+		// Header followed by the cache data
+		std::vector<char> bytes(sizeof(PipelineCacheHeader) + data.size());
+		std::memcpy(bytes.data(), &header, sizeof(PipelineCacheHeader));
+		std::memcpy(bytes.data() + sizeof(PipelineCacheHeader), data.data(), data.size());
+
+		writeBinary(GUST_PIPELINE_CACHE_PATH, bytes);
+	}
+
+	vk::Pipeline Graphics::createGraphicsPipeline(const vk::GraphicsPipelineCreateInfo& pipelineInfo)
+	{
+		Clock clock = {};
+		vk::Pipeline pipeline = m_logicalDevice.createGraphicsPipeline(m_pipelineCache, pipelineInfo);
+		m_pipelineCreationTime += static_cast<uint64_t>(clock.getElapsedTime() * 1000000.0f);
+		return pipeline;
+	}
+
 	vk::CommandBuffer Graphics::beginSingleTimeCommands()
 	{
 		vk::CommandBufferAllocateInfo allocInfo = {};
@@ -8,11 +8,46 @@
 
  /** Includes. */
 #include <string>
+#include <memory>
 #include <vector>
+#include <atomic>
 
 #include "Vulkan.hpp"
 #include "Math.hpp"
 #include "VulkanDebugging.hpp"
+#include "UploadManager.hpp"
+#include "DescriptorHeap.hpp"
+#include "GeometryPool.hpp"
+
+/** 
+ * @def GUST_PIPELINE_CACHE_PATH
+ * @brief File the pipeline cache is loaded from at startup and saved to at shutdown.
+ */
+#define GUST_PIPELINE_CACHE_PATH "./PipelineCache.bin"
+
+/** 
+ * @def GUST_BINDLESS
+ * @brief Define to draw meshes through a global descriptor heap on devices supporting VK_EXT_descriptor_indexing.
+ * @note Targets Vulkan 1.1. Shaders must be written against the bindless GUST headers.
+ */
+
+/** 
+ * @def GUST_GPU_CULLING
+ * @brief Define (Along with GUST_BINDLESS) to cull meshes with a compute shader and draw them indirectly.
+ * @note Uses VK_KHR_draw_indirect_count when available.
+ */
+
+/** 
+ * @def GUST_SMALL_UNIFORM_BUFFER_SIZE
+ * @brief Largest host visible uniform buffer (In bytes) allocated from the small uniform buffer pool.
+ */
+#define GUST_SMALL_UNIFORM_BUFFER_SIZE 1024
+
+/** 
+ * @def GUST_UNIFORM_POOL_BLOCK_SIZE
+ * @brief Size of each block of device memory in the small uniform buffer pool.
+ */
+#define GUST_UNIFORM_POOL_BLOCK_SIZE (4 * 1024 * 1024)
 
 namespace gust
 {
@@ -31,6 +66,11 @@ namespace gust
 		/** Index of transfer family. */
 		int transferFamily = -1;
 
+		/**
+		 * @brief Check if every queue type was found.
+		 * @return If every family index is valid.
+		 * @note The transfer family falls back to the graphics family, so single family devices are complete.
+		 */
 		bool isComplete()
 		{
 			return graphicsFamily >= 0 && presentFamily >= 0 && transferFamily >= 0;
@@ -39,6 +79,33 @@ namespace gust
 
 
 
+	/**
+	 * @struct MemoryStats
+	 * @brief Device memory usage.
+	 */
+	struct MemoryStats
+	{
+		/** Number of device memory allocations made from the driver. */
+		uint32_t blockCount = 0;
+
+		/** Number of buffers and images suballocated from those blocks. */
+		uint32_t allocationCount = 0;
+
+		/** Bytes used by buffers and images. */
+		vk::DeviceSize usedBytes = 0;
+
+		/** Bytes allocated from the driver but not in use. */
+		vk::DeviceSize unusedBytes = 0;
+
+		/** Number of buffers in the small uniform buffer pool. */
+		size_t uniformPoolAllocationCount = 0;
+
+		/** Size of the small uniform buffer pool. */
+		vk::DeviceSize uniformPoolSize = 0;
+	};
+
+
+
 	/**
 	 * @class Graphics
 	 * @brief Manages interacting with Vulkan and a window.
@@ -170,6 +237,42 @@ namespace gust
 			return m_transferPool;
 		}
 
+		/**
+		 * @brief Get pipeline cache.
+		 * @return Pipeline cache.
+		 */
+		inline const vk::PipelineCache& getPipelineCache() const
+		{
+			return m_pipelineCache;
+		}
+
+		/**
+		 * @brief Check if the pipeline cache was loaded from disk.
+		 * @return If the pipeline cache was loaded from disk.
+		 */
+		inline bool isPipelineCacheWarm() const
+		{
+			return m_pipelineCacheWarm;
+		}
+
+		/**
+		 * @brief Get time spent creating graphics pipelines.
+		 * @return Time spent creating graphics pipelines.
+		 * @note In seconds, summed over every thread.
+		 */
+		inline float getPipelineCreationTime() const
+		{
+			return static_cast<float>(m_pipelineCreationTime.load()) / 1000000.0f;
+		}
+
+		/**
+		 * @brief Create a graphics pipeline using the pipeline cache.
+		 * @param Pipeline creation info.
+		 * @return New graphics pipeline.
+		 * @note Thread safe.
+		 */
+		vk::Pipeline createGraphicsPipeline(const vk::GraphicsPipelineCreateInfo& pipelineInfo);
+
 		/**
 		 * @brief Create a command buffer for a single use.
 		 * @return Single use command buffer.
@@ -209,22 +312,115 @@ namespace gust
 			return m_transferQueue;
 		}
 
+		/**
+		 * @brief Check if uploads run on a queue family of their own.
+		 * @return If the transfer family differs from the graphics family.
+		 * @note Buffers and images are only shared concurrently when the families differ.
+		 */
+		inline bool hasDedicatedTransferFamily() const
+		{
+			return m_queueFamilyIndices.transferFamily != m_queueFamilyIndices.graphicsFamily;
+		}
+
+		/**
+		 * @brief Get upload manager.
+		 * @return Upload manager.
+		 */
+		inline UploadManager& getUploadManager()
+		{
+			return *m_uploadManager;
+		}
+
+		/**
+		 * @brief Get geometry pool.
+		 * @return Geometry pool.
+		 */
+		inline GeometryPool& getGeometryPool()
+		{
+			return *m_geometryPool;
+		}
+
+		/**
+		 * @brief Check if meshes are drawn through the descriptor heap.
+		 * @return If bindless mode is enabled.
+		 */
+		inline bool isBindless() const
+		{
+			return m_bindless;
+		}
+
+		/**
+		 * @brief Check if meshes are culled and drawn on the GPU.
+		 * @return If GPU culling is enabled.
+		 */
+		inline bool isGpuCulling() const
+		{
+			return m_gpuCulling;
+		}
+
+		/**
+		 * @brief Check if indirect draws can read their draw count from a buffer.
+		 * @return If VK_KHR_draw_indirect_count is enabled.
+		 */
+		inline bool supportsDrawIndirectCount() const
+		{
+			return m_drawIndirectCount;
+		}
+
+		/**
+		 * @brief Get descriptor heap.
+		 * @return Descriptor heap.
+		 * @note Only exists in bindless mode.
+		 */
+		inline DescriptorHeap& getDescriptorHeap()
+		{
+			return *m_descriptorHeap;
+		}
+
+		/**
+		 * @brief Get memory allocator.
+		 * @return Memory allocator.
+		 */
+		inline VmaAllocator getMemoryAllocator() const
+		{
+			return m_memoryAllocator;
+		}
+
+		/**
+		 * @brief Get device memory usage.
+		 * @return Memory statistics.
+		 */
+		MemoryStats getMemoryStats();
+
 		/**
 		 * @brief Create buffer.
 		 * @param Size of data to buffer.
 		 * @param Usage flags.
 		 * @param Memory properties flags.
 		 * @return Buffer.
+		 * @note Memory is suballocated from large blocks. Small host visible uniform buffers use a dedicated pool.
 		 */
 		Buffer createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties);
 
 		/**
-		 * @brief Copy buffer.
-		 * @param Source buffer.
-		 * @param Destination buffer.
-		 * @param Size of source buffer.
+		 * @brief Destroy a buffer and free its memory.
+		 * @param Buffer.
+		 */
+		void destroyBuffer(const Buffer& buffer);
+
+		/**
+		 * @brief Map a host visible buffer.
+		 * @param Buffer.
+		 * @return Mapped memory.
+		 * @note Must be matched with a call to unmapBuffer().
+		 */
+		void* mapBuffer(const Buffer& buffer);
+
+		/**
+		 * @brief Unmap a buffer.
+		 * @param Buffer.
 		 */
-		void copyBuffer(const vk::Buffer& sourceBuffer, const vk::Buffer& destinationBuffer, vk::DeviceSize size);
+		void unmapBuffer(const Buffer& buffer);
 
 		/**
 		 * @ brief Find memory type based off memory properties.
@@ -243,8 +439,9 @@ namespace gust
 		 * @param Usage.
 		 * @param Memory property flags.
 		 * @param Image reference.
-		 * @param Image memory reference.
+		 * @param Image allocation reference.
 		 * @param Number of images.
+		 * @param Number of mip levels.
 		 */
 		void createImage
 		(
@@ -255,11 +452,34 @@ namespace gust
 			vk::ImageUsageFlags usage,
 			vk::MemoryPropertyFlags properties,
 			vk::Image& image,
-			vk::DeviceMemory& imageMemory,
+			VmaAllocation& imageAllocation,
 			vk::ImageCreateFlags flags = static_cast<vk::ImageCreateFlagBits>(0),
-			uint32_t arrayLayers = 1
+			uint32_t arrayLayers = 1,
+			uint32_t mipLevels = 1
+		);
+
+		/**
+		 * @brief Create image from a description.
+		 * @param Image creation info.
+		 * @param Memory properties flags.
+		 * @param Image reference.
+		 * @param Image allocation reference.
+		 */
+		void createImage
+		(
+			const vk::ImageCreateInfo& imageInfo,
+			vk::MemoryPropertyFlags properties,
+			vk::Image& image,
+			VmaAllocation& imageAllocation
 		);
 
+		/**
+		 * @brief Destroy an image and free its memory.
+		 * @param Image.
+		 * @param Image allocation.
+		 */
+		void destroyImage(const vk::Image& image, VmaAllocation imageAllocation);
+
 		/**
 		 * @brief Create transition image layout.
 		 * @param Image to create transition layout for.
@@ -277,26 +497,6 @@ namespace gust
 			uint32_t imageCount = 1
 		);
 
-		/**
-		 * @brief Copy a buffer to an image.
-		 * @param Buffer to copy from.
-		 * @param Image to copy to.
-		 * @param Image width.
-		 * @param Image height.
-		 * @param Number of images to copy.
-		 * @param Size of each image.
-		 * @note The image size can be zero if you only have one image to copy.
-		 */
-		void copyBufferToImage
-		(
-			const vk::Buffer& buffer, 
-			const vk::Image& image, 
-			uint32_t width, 
-			uint32_t height,
-			uint32_t imageCount = 1,
-			uint32_t imageSize = 0
-		);
-
 		/**
 		 * @brief Create image view.
 		 * @param Image to create view for.
@@ -304,6 +504,7 @@ namespace gust
 		 * @param Image aspect flags.
 		 * @param Image view type.
 		 * @param Number of images.
+		 * @param Number of mip levels.
 		 * @return New image view.
 		 */
 		vk::ImageView createImageView
@@ -312,6 +513,35 @@ namespace gust
 			vk::Format format, 
 			vk::ImageAspectFlags aspectFlags,
 			vk::ImageViewType viewType = vk::ImageViewType::e2D,
+			uint32_t imageCount = 1,
+			uint32_t mipLevels = 1
+		);
+
+		/**
+		 * @brief Check if mip levels of a format can be generated by blitting.
+		 * @param Image format.
+		 * @return If optimally tiled images of the format can be blitted with linear filtering.
+		 */
+		bool supportsLinearBlit(vk::Format format) const;
+
+		/**
+		 * @brief Record blits filling an images mip chain by blitting each level down from the one above it.
+		 * @param Command buffer for a graphics queue.
+		 * @param Image (Level 0 copied on the transfer stage and the rest undefined. Needs transfer source and destination usage.)
+		 * @param Image width.
+		 * @param Image height.
+		 * @param Number of mip levels.
+		 * @param Number of images.
+		 * @note Every level is left ready for shaders.
+		 * @see UploadManager::generateMipmaps
+		 */
+		void generateMipmaps
+		(
+			vk::CommandBuffer commandBuffer,
+			const vk::Image& image,
+			uint32_t width,
+			uint32_t height,
+			uint32_t mipLevels,
 			uint32_t imageCount = 1
 		);
 
@@ -352,12 +582,44 @@ namespace gust
 		 */
 		bool supportsDeviceExtensions(vk::PhysicalDevice physicalDevice);
 
+		/**
+		 * @brief Check if a device supports an extension.
+		 * @param Physical device to check.
+		 * @param Extension name.
+		 * @return If the device supports the extension.
+		 */
+		bool hasDeviceExtension(vk::PhysicalDevice physicalDevice, const char* extension);
+
+		/**
+		 * @brief Check if a device supports the descriptor indexing features used in bindless mode.
+		 * @param Physical device to check.
+		 * @return If the device supports bindless mode.
+		 */
+		bool supportsBindless(vk::PhysicalDevice physicalDevice);
+
+		/**
+		 * @brief Check if a device supports the indirect draw features used by GPU culling.
+		 * @param Physical device to check.
+		 * @return If the device supports GPU culling.
+		 */
+		bool supportsGpuCulling(vk::PhysicalDevice physicalDevice);
+
 		/**
 		 * @brief Initialize Vulkan surface formats.
 		 * @param Physical device needed too check if it supports certain formats.
 		 */
 		void initSurfaceFormats(vk::PhysicalDevice physicalDevice);
 
+		/**
+		 * @brief Create the pipeline cache, loading it from disk if it was made by the same device and driver.
+		 */
+		void initPipelineCache();
+
+		/**
+		 * @brief Save the pipeline cache to disk.
+		 */
+		void savePipelineCache();
+
 
 
 		/** SDL Window. */
@@ -395,6 +657,27 @@ namespace gust
 		/** Memory allocator. */
 		VmaAllocator m_memoryAllocator = {};
 
+		/** Pool for small host visible uniform buffers. */
+		VmaPool m_uniformPool = VK_NULL_HANDLE;
+
+		/** Upload manager. */
+		std::unique_ptr<UploadManager> m_uploadManager = nullptr;
+
+		/** Geometry pool. */
+		std::unique_ptr<GeometryPool> m_geometryPool = nullptr;
+
+		/** Descriptor heap (Bindless mode only.) */
+		std::unique_ptr<DescriptorHeap> m_descriptorHeap = nullptr;
+
+		/** Are meshes drawn through the descriptor heap? */
+		bool m_bindless = false;
+
+		/** Are meshes culled and drawn on the GPU? */
+		bool m_gpuCulling = false;
+
+		/** Is VK_KHR_draw_indirect_count enabled? */
+		bool m_drawIndirectCount = false;
+
 		/** Vulkan surface. */
 		vk::SurfaceKHR m_surface = {};
 
@@ -430,5 +713,14 @@ namespace gust
 
 		/** Single use command pool. */
 		vk::CommandPool m_singleUsePool = {};
+
+		/** Pipeline cache shared by every pipeline. */
+		vk::PipelineCache m_pipelineCache = {};
+
+		/** Was the pipeline cache loaded from disk? */
+		bool m_pipelineCacheWarm = false;
+
+		/** Time spent creating graphics pipelines in microseconds. */
+		std::atomic<uint64_t> m_pipelineCreationTime = { 0 };
 	};
 }
\ No newline at end of file
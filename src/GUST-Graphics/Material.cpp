@@ -6,6 +6,22 @@ namespace gust
 		m_graphics(graphics), 
 		m_shader(shader)
 	{
+		// Set texture array
+		m_textures.resize(shader->getTextureCount());
+		for (size_t i = 0; i < m_textures.size(); i++)
+			m_textures[i] = Handle<Texture>::nullHandle();
+
+		// Material data lives in the descriptor heap
+		if (m_graphics->isBindless())
+		{
+			gAssert(m_shader->getTextureCount() <= GUST_BINDLESS_MATERIAL_TEXTURE_COUNT);
+			gAssert(m_shader->getVertexDataSize() <= sizeof(BindlessMaterialData::vertexData));
+			gAssert(m_shader->getFragmentDataSize() <= sizeof(BindlessMaterialData::fragmentData));
+
+			m_heapIndex = m_graphics->getDescriptorHeap().addMaterial();
+			return;
+		}
+
 		// Create fragment uniform buffer
 		m_fragmentUniformBuffer = m_graphics->createBuffer
 		(
@@ -22,11 +38,6 @@ namespace gust
 			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
 		);
 
-		// Set texture array
-		m_textures.resize(shader->getTextureCount());
-		for (size_t i = 0; i < m_textures.size(); i++)
-			m_textures[i] = Handle<Texture>::nullHandle();
-
 		initDescriptorPool();
 		initDescriptorSets();
 	}
@@ -42,29 +53,43 @@ namespace gust
 		{
 			auto logicalDevice = m_graphics->getLogicalDevice();
 
+			// Release heap slot
+			if (m_heapIndex != DescriptorHeap::nullIndex())
+				m_graphics->getDescriptorHeap().removeMaterial(m_heapIndex);
+
 			// Destroy pool
 			if(m_descriptorPool)
 				logicalDevice.destroyDescriptorPool(m_descriptorPool);
 
 			// Cleanup fragment uniform buffer
 			if(m_fragmentUniformBuffer.buffer)
-				logicalDevice.destroyBuffer(m_fragmentUniformBuffer.buffer);
-
-			if(m_fragmentUniformBuffer.memory)
-				logicalDevice.freeMemory(m_fragmentUniformBuffer.memory);
+				m_graphics->destroyBuffer(m_fragmentUniformBuffer);
 
 			// Cleanup vertex uniform buffer
 			if(m_vertexUniformBuffer.buffer)
-				logicalDevice.destroyBuffer(m_vertexUniformBuffer.buffer);
-
-			if(m_vertexUniformBuffer.memory)
-				logicalDevice.freeMemory(m_vertexUniformBuffer.memory);
+				m_graphics->destroyBuffer(m_vertexUniformBuffer);
 		}
 	}
 
+	bool Material::isReady() const
+	{
+		for (const auto& texture : m_textures)
+			if (texture == Handle<Texture>::nullHandle() || !texture->isReady())
+				return false;
+
+		return true;
+	}
+
 	void Material::setTexture(Handle<Texture> texture, size_t index)
 	{
 		m_textures[index] = texture;
+
+		// Shaders look the texture up in the descriptor heap
+		if (m_graphics->isBindless())
+		{
+			m_graphics->getDescriptorHeap().getMaterialData(m_heapIndex).textures[index] = texture->getHeapIndex();
+			return;
+		}
 	
 		for (size_t i = 0; i < m_textures.size(); ++i)
 			if (m_textures[i] == Handle<Texture>::nullHandle())
@@ -8,6 +8,7 @@
 
 /** Includes. */
 #include <Allocators.hpp>
+#include <Debugging.hpp>
 
 #include "Shader.hpp"
 #include "Texture.hpp"
@@ -73,24 +74,22 @@ namespace gust
 		template<class T>
 		void setFragmentData(const T& data)
 		{
-			auto logicalDevice = m_graphics->getLogicalDevice();
-			void* cpyData;
+			// Write straight into the materials heap slot
+			if (m_graphics->isBindless())
+			{
+				gAssert(sizeof(T) <= sizeof(BindlessMaterialData::fragmentData));
+				memcpy(m_graphics->getDescriptorHeap().getMaterialData(m_heapIndex).fragmentData.data(), &data, sizeof(T));
+				return;
+			}
 
 			// Map memory
-			logicalDevice.mapMemory
-			(
-				m_fragmentUniformBuffer.memory,
-				0,
-				m_shader->getFragmentDataSize(),
-				static_cast<vk::MemoryMapFlagBits>(0),
-				&cpyData
-			);
+			void* cpyData = m_graphics->mapBuffer(m_fragmentUniformBuffer);
 
 			// Copy
 			memcpy(cpyData, &data, sizeof(T));
 
 			// Unmap memory
-			logicalDevice.unmapMemory(m_fragmentUniformBuffer.memory);
+			m_graphics->unmapBuffer(m_fragmentUniformBuffer);
 		}
 
 		/**
@@ -100,24 +99,22 @@ namespace gust
 		template<class T>
 		void setVertexData(const T& data)
 		{
-			auto logicalDevice = m_graphics->getLogicalDevice();
-			void* cpyData;
+			// Write straight into the materials heap slot
+			if (m_graphics->isBindless())
+			{
+				gAssert(sizeof(T) <= sizeof(BindlessMaterialData::vertexData));
+				memcpy(m_graphics->getDescriptorHeap().getMaterialData(m_heapIndex).vertexData.data(), &data, sizeof(T));
+				return;
+			}
 
 			// Map memory
-			logicalDevice.mapMemory
-			(
-				m_vertexUniformBuffer.memory,
-				0,
-				m_shader->getVertexDataSize(),
-				static_cast<vk::MemoryMapFlagBits>(0),
-				&cpyData
-			);
+			void* cpyData = m_graphics->mapBuffer(m_vertexUniformBuffer);
 
 			// Copy
 			memcpy(cpyData, &data, sizeof(T));
 
 			// Unmap memory
-			logicalDevice.unmapMemory(m_vertexUniformBuffer.memory);
+			m_graphics->unmapBuffer(m_vertexUniformBuffer);
 		}
 
 		/**
@@ -137,6 +134,12 @@ namespace gust
 			return m_textures[index];
 		}
 
+		/**
+		 * @brief Check if every texture is set and uploaded.
+		 * @return If the material can be drawn with.
+		 */
+		bool isReady() const;
+
 		/**
 		 * @brief Get texture descriptor set.
 		 * @return Texture descriptor set.
@@ -146,6 +149,16 @@ namespace gust
 			return m_textureDescriptorSet;
 		}
 
+		/**
+		 * @brief Get the index of the material in the descriptor heap.
+		 * @return Descriptor heap index.
+		 * @note Bindless mode only.
+		 */
+		inline uint32_t getHeapIndex() const
+		{
+			return m_heapIndex;
+		}
+
 		/**
 		 * @brief Free memory.
 		 * @note Used internally. Do not call.
@@ -184,5 +197,8 @@ namespace gust
 
 		/** Texture descriptor set. */
 		vk::DescriptorSet m_textureDescriptorSet = {};
+
+		/** Index in the descriptor heap. */
+		uint32_t m_heapIndex = DescriptorHeap::nullIndex();
 	};
 }
\ No newline at end of file
@@ -1,86 +1,80 @@
-#define TINYOBJLOADER_IMPLEMENTATION
-#include <tiny_obj_loader.h>
-
+#include <limits>
+#include <cstring>
+#include <Debugging.hpp>
+#include "ObjLoader.hpp"
+#include "GMesh.hpp"
 #include "Mesh.hpp"
 
 namespace gust
 {
-	Mesh::Mesh(Graphics* graphics, const std::string& path) : m_graphics(graphics)
+	/**
+	 * @brief Encode a unit vector as a point on an octahedron unfolded onto a square.
+	 * @param Unit vector.
+	 * @return Encoded vector in [-1, 1].
+	 */
+	static glm::vec2 octahedralEncode(const glm::vec3& vector)
 	{
-		tinyobj::attrib_t attrib;
-		std::vector<tinyobj::shape_t> shapes;
-		std::vector<tinyobj::material_t> materials;
-		std::string err;
-	
-		// Load OBJ
-		if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &err, path.c_str()))
-			throw std::runtime_error(err);
-	
-		std::vector<uint32_t> indices = {};
-	
-		std::vector<glm::vec3> vertices = {};
-		std::vector<glm::vec2> uvs = {};
-		std::vector<glm::vec3> normals = {};
-	
-		std::vector<Vertex> uniqueVertices = {};
-	
-		for (const auto& shape : shapes)
-			for (const auto& index : shape.mesh.indices)
-			{
-				Vertex vertex = {};
-	
-				// Get position
-				vertex.position =
-				{
-					attrib.vertices[3 * index.vertex_index + 0],
-					attrib.vertices[3 * index.vertex_index + 1],
-					attrib.vertices[3 * index.vertex_index + 2]
-				};
-	
-				// Get UV
-				if (attrib.texcoords.size() > 0)
-					vertex.uv =
-				{
-					attrib.texcoords[2 * index.texcoord_index + 0],
-					1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
-				};
-	
-				// Get normal
-				if (attrib.normals.size() > 0)
-					vertex.normal =
-				{
-					attrib.normals[3 * index.normal_index + 0],
-					attrib.normals[3 * index.normal_index + 1],
-					attrib.normals[3 * index.normal_index + 2]
-				};
-	
-				// Check if duplicate vertex
-				bool isUnique = true;
-	
-				for (size_t i = 0; i < uniqueVertices.size(); ++i)
-					if (uniqueVertices[i] == vertex)
-					{
-						indices.push_back(static_cast<uint32_t>(i));
-						isUnique = false;
-						break;
-					}
-	
-				if (isUnique)
-				{
-					indices.push_back(static_cast<uint32_t>(vertices.size()));
-					vertices.push_back(vertex.position);
-					uvs.push_back(vertex.uv);
-					normals.push_back(vertex.normal);
-					uniqueVertices.push_back(vertex);
-				}
-			}
-	
-		m_vertices = uniqueVertices;
-		m_indices = indices;
-	
-		initVertexBuffer();
-		initIndexBuffer();
-		calculateTangents();
+		const float length = glm::abs(vector.x) + glm::abs(vector.y) + glm::abs(vector.z);
+
+		if (length == 0.0f)
+			return glm::vec2();
+
+		const glm::vec3 n = vector / length;
+		glm::vec2 encoded = glm::vec2(n.x, n.y);
+
+		// Fold the lower hemisphere over the upper one
+		if (n.z < 0.0f)
+			encoded = glm::vec2
+			(
+				(1.0f - glm::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+				(1.0f - glm::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f)
+			);
+
+		return encoded;
+	}
+
+	Mesh::Mesh(Graphics* graphics, const std::string& path, ThreadPool* threadPool, bool keepGeometry) : m_graphics(graphics)
+	{
+		// Cooked meshes are ready to upload
+		if (isGMeshPath(path))
+		{
+			const GMeshFile file(path);
+
+			if (file.isValid())
+				loadGMesh(file, 0, keepGeometry);
+			else
+				m_graphics = nullptr;
+
+			return;
+		}
+
+		if (!loadOBJ(path, m_vertices, m_indices, threadPool))
+		{
+			m_graphics = nullptr;
+			return;
+		}
+
+		// Reorder for the post transform cache and vertex fetch
+		m_optimizationStats = optimizeMesh(m_vertices, m_indices);
+
+		// Tangents before the upload, so the vertices are only uploaded once
+		gust::calculateTangents(m_vertices, m_indices, threadPool);
+
+		calculateBounds();
+		initBuffers();
+
+		// The upload staged its own copy
+		if (!keepGeometry)
+		{
+			m_vertices = {};
+			m_indices = {};
+		}
+	}
+
+	Mesh::Mesh(Graphics* graphics, const GMeshFile& file, size_t level, bool keepGeometry) : m_graphics(graphics)
+	{
+		gAssert(level < file.getLevelCount());
+		loadGMesh(file, level, keepGeometry);
 	}
 
 	Mesh::Mesh
@@ -156,8 +150,22 @@ namespace gust
 			m_vertices[i].tangent = tangents[i];
 		}
 
-		initVertexBuffer();
-		initIndexBuffer();
+		calculateBounds();
+		initBuffers();
+	}
+
+	Mesh::Mesh
+	(
+		Graphics* graphics,
+		const std::vector<uint32_t>& indices,
+		const std::vector<Vertex>& vertices
+	) :
+		m_graphics(graphics),
+		m_vertices(vertices),
+		m_indices(indices)
+	{
+		calculateBounds();
+		initBuffers();
 	}
 
 	Mesh::~Mesh()
@@ -169,144 +177,160 @@ namespace gust
 	{
 		if (m_graphics)
 		{
-			auto logicalDevice = m_graphics->getLogicalDevice();
+			// The transfer queue may still be writing to the range, and frames in flight reading it
+			m_graphics->getUploadManager().wait(m_uploadValue);
+			m_graphics->getGeometryPool().retire(m_geometry);
+		}
+	}
+
+	void Mesh::initBuffers()
+	{
+		// Small meshes use 16-bit indices, packed two to each 32-bit index of the pool
+		m_indexType = m_vertices.size() <= std::numeric_limits<uint16_t>::max() ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+		const size_t indexSlots = m_indexType == vk::IndexType::eUint16 ? (m_indices.size() + 1) / 2 : m_indices.size();
+		m_indexCount = static_cast<uint32_t>(m_indices.size());
 
-			if (m_indexUniformBuffer.buffer)
-				logicalDevice.destroyBuffer(m_indexUniformBuffer.buffer);
+		// Allocate space in the geometry pool
+		m_geometry = m_graphics->getGeometryPool().allocate
+		(
+			static_cast<uint32_t>(m_vertices.size()),
+			static_cast<uint32_t>(indexSlots)
+		);
 
-			if (m_indexUniformBuffer.memory)
-				logicalDevice.freeMemory(m_indexUniformBuffer.memory);
+		uploadVertices(m_vertices.data(), m_vertices.size());
 
-			if (m_vertexUniformBuffer.buffer)
-				logicalDevice.destroyBuffer(m_vertexUniformBuffer.buffer);
+		if (m_indices.empty())
+			return;
 
-			if (m_vertexUniformBuffer.memory)
-				logicalDevice.freeMemory(m_vertexUniformBuffer.memory);
+		// Copy indices on the transfer queue (Recorded after the vertices, so in the same or a later batch)
+		if (m_indexType == vk::IndexType::eUint16)
+		{
+			const std::vector<uint16_t> indices(m_indices.begin(), m_indices.end());
+
+			m_uploadValue = m_graphics->getUploadManager().uploadBuffer
+			(
+				indices.data(),
+				static_cast<vk::DeviceSize>(sizeof(uint16_t) * indices.size()),
+				getIndexUniformBuffer().buffer,
+				static_cast<vk::DeviceSize>(sizeof(uint32_t) * m_geometry.firstIndex)
+			);
 		}
+		else
+			m_uploadValue = m_graphics->getUploadManager().uploadBuffer
+			(
+				m_indices.data(),
+				static_cast<vk::DeviceSize>(sizeof(uint32_t) * m_indices.size()),
+				getIndexUniformBuffer().buffer,
+				static_cast<vk::DeviceSize>(sizeof(uint32_t) * m_geometry.firstIndex)
+			);
 	}
 
-	void Mesh::initVertexBuffer()
+	void Mesh::uploadVertices(const Vertex* vertices, size_t vertexCount)
 	{
-		auto logicalDevice = m_graphics->getLogicalDevice();
-		const auto bufferSize = static_cast<vk::DeviceSize>(sizeof(m_vertices[0]) * m_vertices.size());
+		if (vertexCount == 0)
+			return;
 
-		// Create staging buffer
-		Buffer stagingBuffer = m_graphics->createBuffer
-		(
-			bufferSize,
-			vk::BufferUsageFlagBits::eTransferSrc,
-			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
-		);
+#ifdef GUST_COMPRESSED_VERTICES
+		// Compress vertices (Staged by the upload, so they needn't outlive it)
+		std::vector<PackedVertex> packed(vertexCount);
 
-		// Map memory
-		void* data;
-		logicalDevice.mapMemory(stagingBuffer.memory, 0, bufferSize, (vk::MemoryMapFlagBits)0, &data);
-		memcpy(data, m_vertices.data(), static_cast<size_t>(bufferSize));
-		logicalDevice.unmapMemory(stagingBuffer.memory);
+		for (size_t i = 0; i < vertexCount; ++i)
+			packed[i] = PackedVertex::pack(vertices[i], m_bounds.box);
 
-		// Create vertex buffer
-		m_vertexUniformBuffer = m_graphics->createBuffer
-		(
-			bufferSize,
-			vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
-			vk::MemoryPropertyFlagBits::eDeviceLocal
-		);
+		const GpuVertex* data = packed.data();
+#else
+		const GpuVertex* data = vertices;
+#endif
 
-		// Copy from staging buffer
-		m_graphics->copyBuffer
+		// Copy vertices on the transfer queue
+		m_uploadValue = m_graphics->getUploadManager().uploadBuffer
 		(
-			stagingBuffer.buffer,
-			m_vertexUniformBuffer.buffer,
-			bufferSize
+			data,
+			static_cast<vk::DeviceSize>(sizeof(GpuVertex) * vertexCount),
+			getVertexUniformBuffer().buffer,
+			static_cast<vk::DeviceSize>(sizeof(GpuVertex) * m_geometry.firstVertex)
 		);
-
-		// Cleanup staging buffer
-		logicalDevice.destroyBuffer(stagingBuffer.buffer);
-		logicalDevice.freeMemory(stagingBuffer.memory);
 	}
 
-	void Mesh::initIndexBuffer()
+	void Mesh::loadGMesh(const GMeshFile& file, size_t level, bool keepGeometry)
 	{
-		auto logicalDevice = m_graphics->getLogicalDevice();
-		const auto bufferSize = static_cast<vk::DeviceSize>(sizeof(m_indices[0]) * m_indices.size());
+		const GMeshLevelRange& range = file.getLevel(level);
+		const Vertex* vertices = file.getVertices(level);
+		const void* indices = file.getIndices(level);
 
-		// Create staging buffer
-		Buffer stagingBuffer = m_graphics->createBuffer
-		(
-			bufferSize,
-			vk::BufferUsageFlagBits::eTransferSrc,
-			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
-		);
+		// CPU copies only when asked for (Used for occlusion, simplification and meshlets)
+		if (keepGeometry)
+		{
+			m_vertices.assign(vertices, vertices + range.vertexCount);
+
+			if (range.indexSize == sizeof(uint16_t))
+			{
+				const uint16_t* shortIndices = static_cast<const uint16_t*>(indices);
+				m_indices.assign(shortIndices, shortIndices + range.indexCount);
+			}
+			else if (range.indexCount > 0)
+			{
+				m_indices.resize(range.indexCount);
+				std::memcpy(m_indices.data(), indices, sizeof(uint32_t) * range.indexCount);
+			}
+		}
 
-		// Load memory into buffer
-		void* data;
-		logicalDevice.mapMemory(stagingBuffer.memory, 0, bufferSize, (vk::MemoryMapFlagBits)0, &data);
-		memcpy(data, m_indices.data(), static_cast<size_t>(bufferSize));
-		logicalDevice.unmapMemory(stagingBuffer.memory);
+		m_indexCount = range.indexCount;
+		m_bounds = file.getBounds();
+		m_optimizationStats = range.optimizationStats;
+		m_indexType = range.indexSize == sizeof(uint16_t) ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
 
-		// Create index buffer
-		m_indexUniformBuffer = m_graphics->createBuffer
+		// Allocate space in the geometry pool (Indices were padded to whole 32-bit slots when cooked)
+		const size_t indexBytes = static_cast<size_t>(range.indexSize) * range.indexCount;
+		m_geometry = m_graphics->getGeometryPool().allocate
 		(
-			bufferSize,
-			vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
-			vk::MemoryPropertyFlagBits::eDeviceLocal
+			range.vertexCount,
+			static_cast<uint32_t>((indexBytes + 3) / sizeof(uint32_t))
 		);
 
-		// Copy to index buffer
-		m_graphics->copyBuffer
+		// Stage vertices straight from the mapped file
+		uploadVertices(vertices, range.vertexCount);
+
+		// Stage indices straight from the mapped file (Recorded after the vertices, so in the same or a later batch)
+		if (range.indexCount > 0)
+			m_uploadValue = m_graphics->getUploadManager().uploadBuffer
+			(
+				indices,
+				static_cast<vk::DeviceSize>(indexBytes),
+				getIndexUniformBuffer().buffer,
+				static_cast<vk::DeviceSize>(sizeof(uint32_t) * m_geometry.firstIndex)
+			);
+	}
+
+	void Mesh::calculateBounds()
+	{
+		m_bounds = Bounds::fromPoints
 		(
-			stagingBuffer.buffer,
-			m_indexUniformBuffer.buffer,
-			bufferSize
+			m_vertices.empty() ? nullptr : &m_vertices[0].position,
+			m_vertices.size(),
+			sizeof(Vertex)
 		);
-
-		// Cleanup staging buffer
-		logicalDevice.destroyBuffer(stagingBuffer.buffer);
-		logicalDevice.freeMemory(stagingBuffer.memory);
 	}
 
 	void Mesh::calculateTangents()
 	{
-		auto logicalDevice = m_graphics->getLogicalDevice();
-
-		logicalDevice.destroyBuffer(m_indexUniformBuffer.buffer);
-		logicalDevice.freeMemory(m_indexUniformBuffer.memory);
+		gAssert(hasCpuGeometry());
 
-		logicalDevice.destroyBuffer(m_vertexUniformBuffer.buffer);
-		logicalDevice.freeMemory(m_vertexUniformBuffer.memory);
-
-		for (size_t i = 0; i < m_indices.size(); i += 3)
-		{
-			Vertex& v0 = m_vertices[m_indices[i]];
-			Vertex& v1 = m_vertices[m_indices[i + 1]];
-			Vertex& v2 = m_vertices[m_indices[i + 2]];
+		// The previous vertices must land before they are overwritten
+		m_graphics->getUploadManager().wait(m_uploadValue);
 
-			const auto edge1 = v1.position - v0.position;
-			const auto edge2 = v2.position - v0.position;
+		gust::calculateTangents(m_vertices, m_indices);
 
-			const auto deltaU1 = v1.uv.x - v0.uv.x;
-			const auto deltaV1 = v1.uv.y - v0.uv.y;
-			const auto deltaU2 = v2.uv.x - v0.uv.x;
-			const auto deltaV2 = v2.uv.y - v0.uv.y;
-
-			const auto f = 1.0f / (deltaU1 * deltaV2 - deltaU2 * deltaV1);
-
-			glm::vec3 tangent = glm::vec3();
-
-			tangent.x = f * (deltaV2 * edge1.x - deltaV1 * edge2.x);
-			tangent.y = f * (deltaV2 * edge1.y - deltaV1 * edge2.y);
-			tangent.z = f * (deltaV2 * edge1.z - deltaV1 * edge2.z);
-
-			v0.tangent += tangent;
-			v1.tangent += tangent;
-			v2.tangent += tangent;
-		}
+		// Indices are unchanged, so only the vertices are uploaded again
+		uploadVertices(m_vertices.data(), m_vertices.size());
+	}
 
-		for (size_t i = 0; i < m_vertices.size(); ++i)
-			m_vertices[i].tangent = glm::normalize(m_vertices[i].tangent);
+	void Mesh::buildMeshlets()
+	{
+		gAssert(hasCpuGeometry());
 
-		initVertexBuffer();
-		initIndexBuffer();
+		// Meshlets are ranges of the index buffer, so nothing needs uploading again
+		m_meshlets = gust::buildMeshlets(m_vertices, m_indices);
 	}
 
 
@@ -356,4 +380,107 @@ namespace gust
 	{
 		return position == other.position && normal == other.normal && uv == other.uv && tangent == other.tangent;
 	}
+
+
+
+	PackedVertex PackedVertex::pack(const Vertex& vertex, const AABB& box, float tangentSign)
+	{
+		// Flat boxes are padded so their positions quantize to zero instead of dividing by zero
+		const glm::vec3 size = glm::max(box.max - box.min, glm::vec3(std::numeric_limits<float>::min()));
+		const glm::vec3 position = glm::clamp((vertex.position - box.min) / size, glm::vec3(0.0f), glm::vec3(1.0f));
+		const glm::vec4 unorm = glm::round(glm::vec4(position, tangentSign < 0.0f ? 0.0f : 1.0f) * 65535.0f);
+
+		PackedVertex packed = {};
+
+		for (glm::length_t i = 0; i < 4; ++i)
+			packed.position[i] = static_cast<uint16_t>(unorm[i]);
+
+		packed.uv = glm::packHalf2x16(vertex.uv);
+		packed.normal = glm::packSnorm2x16(octahedralEncode(vertex.normal));
+		packed.tangent = glm::packSnorm2x16(octahedralEncode(vertex.tangent));
+		return packed;
+	}
+
+	vk::VertexInputBindingDescription PackedVertex::getBindingDescription()
+	{
+		vk::VertexInputBindingDescription bindingDescription = {};
+		bindingDescription.setBinding(0);
+		bindingDescription.setStride(static_cast<uint32_t>(sizeof(PackedVertex)));
+		bindingDescription.setInputRate(vk::VertexInputRate::eVertex);
+
+		return bindingDescription;
+	}
+
+	std::array<vk::VertexInputAttributeDescription, 4> PackedVertex::getAttributeDescriptions()
+	{
+		std::array<vk::VertexInputAttributeDescription, 4> attributeDescriptions = {};
+
+		// Position
+		attributeDescriptions[0].setBinding(0);
+		attributeDescriptions[0].setLocation(0);
+		attributeDescriptions[0].setFormat(vk::Format::eR16G16B16A16Unorm);
+		attributeDescriptions[0].setOffset(offsetof(PackedVertex, position));
+
+		// UV
+		attributeDescriptions[1].setBinding(0);
+		attributeDescriptions[1].setLocation(1);
+		attributeDescriptions[1].setFormat(vk::Format::eR16G16Sfloat);
+		attributeDescriptions[1].setOffset(offsetof(PackedVertex, uv));
+
+		// Normal
+		attributeDescriptions[2].setBinding(0);
+		attributeDescriptions[2].setLocation(2);
+		attributeDescriptions[2].setFormat(vk::Format::eR16G16Snorm);
+		attributeDescriptions[2].setOffset(offsetof(PackedVertex, normal));
+
+		// Tangent
+		attributeDescriptions[3].setBinding(0);
+		attributeDescriptions[3].setLocation(3);
+		attributeDescriptions[3].setFormat(vk::Format::eR16G16Snorm);
+		attributeDescriptions[3].setOffset(offsetof(PackedVertex, tangent));
+
+		return attributeDescriptions;
+	}
+
+
+
+	vk::VertexInputBindingDescription InstanceData::getBindingDescription()
+	{
+		vk::VertexInputBindingDescription bindingDescription = {};
+		bindingDescription.setBinding(1);
+		bindingDescription.setStride(static_cast<uint32_t>(sizeof(InstanceData)));
+		bindingDescription.setInputRate(vk::VertexInputRate::eInstance);
+
+		return bindingDescription;
+	}
+
+	std::array<vk::VertexInputAttributeDescription, InstanceData::attributeCount> InstanceData::getAttributeDescriptions()
+	{
+		std::array<vk::VertexInputAttributeDescription, attributeCount> attributeDescriptions = {};
+
+		// One location per column of the model matrix
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			attributeDescriptions[i].setBinding(1);
+			attributeDescriptions[i].setLocation(4 + i);
+			attributeDescriptions[i].setFormat(vk::Format::eR32G32B32A32Sfloat);
+			attributeDescriptions[i].setOffset(static_cast<uint32_t>(offsetof(InstanceData, model) + sizeof(glm::vec4) * i));
+		}
+
+#ifdef GUST_COMPRESSED_VERTICES
+		// Position scale
+		attributeDescriptions[4].setBinding(1);
+		attributeDescriptions[4].setLocation(8);
+		attributeDescriptions[4].setFormat(vk::Format::eR32G32B32A32Sfloat);
+		attributeDescriptions[4].setOffset(offsetof(InstanceData, positionScale));
+
+		// Position bias
+		attributeDescriptions[5].setBinding(1);
+		attributeDescriptions[5].setLocation(9);
+		attributeDescriptions[5].setFormat(vk::Format::eR32G32B32A32Sfloat);
+		attributeDescriptions[5].setOffset(offsetof(InstanceData, positionBias));
+#endif
+
+		return attributeDescriptions;
+	}
 }
\ No newline at end of file
@@ -8,7 +8,29 @@
 
 /** Includes. */
 #include <array>
+#include <Bounds.hpp>
 #include "Graphics.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshTangents.hpp"
+#include "MeshletBuilder.hpp"
+
+/** 
+ * @def GUST_COMPRESSED_VERTICES
+ * @brief Define to store vertices in the geometry pool as PackedVertex instead of Vertex.
+ * @note Set by the GUST_COMPRESSED_VERTICES CMake option, since per draw data changes layout too.
+ * @note Vertex shaders must be compiled with GUST_COMPRESSED_VERTICES defined as well.
+ * @see GUST_VERTEX_SHADER_SUFFIX
+ */
+
+/**
+ * @def GUST_VERTEX_SHADER_SUFFIX
+ * @brief Ending of the vertex shader files that match the vertex layout in the geometry pool.
+ */
+#ifdef GUST_COMPRESSED_VERTICES
+	#define GUST_VERTEX_SHADER_SUFFIX "_packed-vert.spv"
+#else
+	#define GUST_VERTEX_SHADER_SUFFIX "-vert.spv"
+#endif
 
 namespace gust
 {
@@ -51,6 +73,104 @@ namespace gust
 		bool operator==(const Vertex& other) const;
 	};
 
+	/**
+	 * @struct PackedVertex
+	 * @brief Vertex info compressed for the GPU.
+	 * @note Positions are unorm16s relative to the meshes bounding box. UVs are half floats.
+	 * Normals and tangents are octahedral encoded as two snorm16s.
+	 */
+	struct PackedVertex
+	{
+		/** Vertex position in the meshes bounding box (Three unorm16s) and tangent sign (Fourth unorm16, zero when negative.) */
+		uint16_t position[4] = {};
+
+		/** Vertex UV (Two half floats.) */
+		uint32_t uv = 0;
+
+		/** Vertex normal (Two octahedral snorm16s.) */
+		uint32_t normal = 0;
+
+		/** Vertex tangent (Two octahedral snorm16s.) */
+		uint32_t tangent = 0;
+
+		/**
+		 * @brief Compress a vertex.
+		 * @param Vertex to compress.
+		 * @param Bounding box of the vertices mesh.
+		 * @param Sign of the bitangent relative to cross(normal, tangent).
+		 * @return Compressed vertex.
+		 * @note Vertex has no handedness, so meshes pack a positive sign.
+		 */
+		static PackedVertex pack(const Vertex& vertex, const AABB& box, float tangentSign = 1.0f);
+
+		/**
+		 * @brief Describes how to pass data to vertex shader.
+		 * @return Vertex input binding description.
+		 */
+		static vk::VertexInputBindingDescription getBindingDescription();
+
+		/**
+		 * @brief Describes each input to the vertex shader.
+		 * @return Array describing each input of the vertex shader.
+		 * @note Normals and tangents arrive as vec2s for the shader to decode.
+		 */
+		static std::array<vk::VertexInputAttributeDescription, 4> getAttributeDescriptions();
+	};
+
+	static_assert(sizeof(PackedVertex) == 20, "Packed vertices must match their attribute descriptions.");
+
+#ifdef GUST_COMPRESSED_VERTICES
+	/** Vertex layout in the geometry pool. */
+	using GpuVertex = PackedVertex;
+#else
+	/** Vertex layout in the geometry pool. */
+	using GpuVertex = Vertex;
+#endif
+
+	/**
+	 * @struct InstanceData
+	 * @brief Per instance vertex data used by instanced shaders.
+	 */
+	struct InstanceData
+	{
+		/** Model matrix. */
+		glm::mat4 model = glm::mat4();
+
+#ifdef GUST_COMPRESSED_VERTICES
+		/** Scale that dequantizes the meshes positions. */
+		glm::vec4 positionScale = glm::vec4(1.0f);
+
+		/** Bias that dequantizes the meshes positions. */
+		glm::vec4 positionBias = glm::vec4(0.0f);
+
+		/** Pads instances to a power of two, so ring buffer offsets stay whole instances. */
+		glm::vec4 padding[2] = {};
+
+		/** Number of vertex shader inputs. */
+		static constexpr size_t attributeCount = 6;
+#else
+		/** Number of vertex shader inputs. */
+		static constexpr size_t attributeCount = 4;
+#endif
+
+		/**
+		 * @brief Describes how to pass data to vertex shader.
+		 * @return Vertex input binding description.
+		 */
+		static vk::VertexInputBindingDescription getBindingDescription();
+
+		/**
+		 * @brief Describes each input to the vertex shader.
+		 * @return Array describing each input of the vertex shader.
+		 * @note The model matrix occupies locations 4 to 7, and the position scale and bias locations 8 and 9.
+		 */
+		static std::array<vk::VertexInputAttributeDescription, attributeCount> getAttributeDescriptions();
+	};
+
+	static_assert((sizeof(InstanceData) & (sizeof(InstanceData) - 1)) == 0, "Instances must be a power of two in size.");
+
+	class GMeshFile;
+
 	class Mesh
 	{
 	public:
@@ -63,9 +183,25 @@ namespace gust
 		/**
 		 * @brief Constructor.
 		 * @param Graphics context.
-		 * @param Path to OBJ file containing a mesh.
+		 * @param Path to an OBJ or cooked (GUST_GMESH_EXTENSION) file containing a mesh.
+		 * @param Thread pool to parse OBJ files with (Parsed on the calling thread when null.)
+		 * @param Keep a CPU copy of the vertices and indices.
+		 * @note Cooked files load their first level of detail.
+		 * @note The mesh is left unloaded if the file can't be loaded.
+		 * @see Mesh::isLoaded
+		 * @see Mesh::hasCpuGeometry
 		 */
-		Mesh(Graphics* graphics, const std::string& path);
+		Mesh(Graphics* graphics, const std::string& path, ThreadPool* threadPool = nullptr, bool keepGeometry = false);
+
+		/**
+		 * @brief Constructor.
+		 * @param Graphics context.
+		 * @param Cooked mesh file (Must be valid.)
+		 * @param Level of detail to load.
+		 * @param Keep a CPU copy of the vertices and indices (Otherwise they are uploaded straight from the file.)
+		 * @see Mesh::hasCpuGeometry
+		 */
+		Mesh(Graphics* graphics, const GMeshFile& file, size_t level, bool keepGeometry = false);
 
 		/**
 		 * @brief Constructor.
@@ -132,6 +268,19 @@ namespace gust
 			const std::vector<glm::vec3>& tangents
 		);
 
+		/**
+		 * @brief Constructor.
+		 * @param Graphics context.
+		 * @param Meshes indices.
+		 * @param Meshes vertices.
+		 */
+		Mesh
+		(
+			Graphics* graphics,
+			const std::vector<uint32_t>& indices,
+			const std::vector<Vertex>& vertices
+		);
+
 		/**
 		 * @Destructor.
 		 */
@@ -143,32 +292,180 @@ namespace gust
 		 */
 		inline uint32_t getIndexCount() const
 		{
-			return static_cast<uint32_t>(m_indices.size());
+			return m_indexCount;
+		}
+
+		/**
+		 * @brief Get vertices.
+		 * @return Vertices (Empty unless the mesh keeps its CPU geometry.)
+		 */
+		inline const std::vector<Vertex>& getVertices() const
+		{
+			return m_vertices;
+		}
+
+		/**
+		 * @brief Get indices.
+		 * @return Indices (Empty unless the mesh keeps its CPU geometry.)
+		 */
+		inline const std::vector<uint32_t>& getIndices() const
+		{
+			return m_indices;
+		}
+
+		/**
+		 * @brief Check if the mesh kept a CPU copy of its vertices and indices.
+		 * @return If the mesh has CPU geometry.
+		 * @note Meshes made from vertices and indices always keep them. Meshes loaded from a file only keep
+		 * them when asked to, since they are only needed for occlusion culling, simplification and meshlets.
+		 */
+		inline bool hasCpuGeometry() const
+		{
+			return !m_vertices.empty();
 		}
 
 		/**
 		 * @brief Get vertex uniform buffer
 		 * @return Vertex uniform buffer.
+		 * @note Shared by every mesh in the same geometry block. Draw with getVertexOffset().
 		 */
 		inline const Buffer& getVertexUniformBuffer() const
 		{
-			return m_vertexUniformBuffer;
+			return m_graphics->getGeometryPool().getVertexBuffer(m_geometry.block);
 		}
 
 		/**
 		 * @brief Get index uniform buffer
 		 * @return Index uniform buffer.
+		 * @note Shared by every mesh in the same geometry block. Draw with getFirstIndex().
 		 */
 		inline const Buffer& getIndexUniformBuffer() const
 		{
-			return m_indexUniformBuffer;
+			return m_graphics->getGeometryPool().getIndexBuffer(m_geometry.block);
+		}
+
+		/**
+		 * @brief Get the geometry block the mesh is in.
+		 * @return Geometry block.
+		 */
+		inline uint32_t getGeometryBlock() const
+		{
+			return m_geometry.block;
+		}
+
+		/**
+		 * @brief Get the type of the meshes indices on the GPU.
+		 * @return Index type (16-bit for meshes with fewer than 65536 vertices.)
+		 */
+		inline vk::IndexType getIndexType() const
+		{
+			return m_indexType;
+		}
+
+		/**
+		 * @brief Get the meshes first index in the index buffer.
+		 * @return First index (Counted in indices of getIndexType().)
+		 */
+		inline uint32_t getFirstIndex() const
+		{
+			return m_indexType == vk::IndexType::eUint16 ? m_geometry.firstIndex * 2 : m_geometry.firstIndex;
+		}
+
+		/**
+		 * @brief Get the meshes first vertex in the vertex buffer.
+		 * @return Vertex offset.
+		 */
+		inline int32_t getVertexOffset() const
+		{
+			return static_cast<int32_t>(m_geometry.firstVertex);
+		}
+
+		/**
+		 * @brief Get local space bounds.
+		 * @return Local space bounds.
+		 */
+		inline const Bounds& getBounds() const
+		{
+			return m_bounds;
+		}
+
+		/**
+		 * @brief Get the scale that dequantizes positions in the geometry pool.
+		 * @return Size of the bounding box (One when vertices aren't compressed.)
+		 */
+		inline glm::vec3 getPositionScale() const
+		{
+#ifdef GUST_COMPRESSED_VERTICES
+			return m_bounds.box.max - m_bounds.box.min;
+#else
+			return glm::vec3(1.0f);
+#endif
+		}
+
+		/**
+		 * @brief Get the bias that dequantizes positions in the geometry pool.
+		 * @return Minimum corner of the bounding box (Zero when vertices aren't compressed.)
+		 */
+		inline glm::vec3 getPositionBias() const
+		{
+#ifdef GUST_COMPRESSED_VERTICES
+			return m_bounds.box.min;
+#else
+			return glm::vec3(0.0f);
+#endif
+		}
+
+		/**
+		 * @brief Get vertex cache efficiency before and after optimizing.
+		 * @return Optimization statistics.
+		 * @note Only meshes loaded from files are optimized. Cooked meshes report the stats from when they were cooked.
+		 */
+		inline const MeshOptimizationStats& getOptimizationStats() const
+		{
+			return m_optimizationStats;
+		}
+
+		/**
+		 * @brief Get meshlets.
+		 * @return Meshlets (Empty unless buildMeshlets() was called.)
+		 */
+		inline const std::vector<Meshlet>& getMeshlets() const
+		{
+			return m_meshlets;
+		}
+
+		/**
+		 * @brief Check if the mesh was loaded.
+		 * @return If the mesh has geometry in the geometry pool.
+		 */
+		inline bool isLoaded() const
+		{
+			return m_graphics != nullptr;
+		}
+
+		/**
+		 * @brief Check if the vertex and index buffers have been uploaded.
+		 * @return If the mesh can be drawn.
+		 */
+		inline bool isReady() const
+		{
+			return m_graphics->getUploadManager().isComplete(m_uploadValue);
 		}
 
 		/**
 		 * @brief Calculates tangents for the mesh.
+		 * @note The mesh must have CPU geometry.
 		 */
 		void calculateTangents();
 
+		/**
+		 * @brief Split the mesh into meshlets.
+		 * @note Meshes with meshlets are culled a cluster at a time when culling on the GPU. Worth it for
+		 * large static meshes that are often only partly visible.
+		 * @note The mesh must have CPU geometry.
+		 */
+		void buildMeshlets();
+
 		/**
 		 * @brief Free memory.
 		 * @note Used internally. Do not call.
@@ -178,14 +475,30 @@ namespace gust
 	private:
 
 		/**
-		 * @brief Create vertex buffer.
+		 * @brief Allocate the meshes range in the geometry pool and upload its vertices and indices.
+		 */
+		void initBuffers();
+
+		/**
+		 * @brief Upload vertices to the meshes range in the geometry pool.
+		 * @param Vertices.
+		 * @param Number of vertices.
+		 * @note Compressed positions are quantized against the meshes bounds, so they must be set first.
 		 */
-		void initVertexBuffer();
+		void uploadVertices(const Vertex* vertices, size_t vertexCount);
 
 		/**
-		 * @brief Create index buffer.
+		 * @brief Load a level of detail from a cooked mesh file.
+		 * @param Cooked mesh file.
+		 * @param Level of detail.
+		 * @param Keep a CPU copy of the vertices and indices.
 		 */
-		void initIndexBuffer();
+		void loadGMesh(const GMeshFile& file, size_t level, bool keepGeometry);
+
+		/**
+		 * @brief Compute local space bounds from the vertices.
+		 */
+		void calculateBounds();
 
 
 
@@ -198,10 +511,25 @@ namespace gust
 		/** Index data. */
 		std::vector<uint32_t> m_indices = {};
 
-		/** Vertex uniform buffer */
-		Buffer m_vertexUniformBuffer = {};
+		/** Number of indices in the geometry pool. */
+		uint32_t m_indexCount = 0;
+
+		/** Vertices and indices in the geometry pool. */
+		GeometryRange m_geometry = {};
+
+		/** Type of the indices on the GPU. */
+		vk::IndexType m_indexType = vk::IndexType::eUint32;
+
+		/** Vertex cache efficiency before and after optimizing. */
+		MeshOptimizationStats m_optimizationStats = {};
+
+		/** Upload value the buffers are filled at. */
+		uint64_t m_uploadValue = 0;
+
+		/** Local space bounds. */
+		Bounds m_bounds = {};
 
-		/** Index uniform buffer. */
-		Buffer m_indexUniformBuffer = {};
+		/** Meshlets. */
+		std::vector<Meshlet> m_meshlets = {};
 	};
 }
\ No newline at end of file
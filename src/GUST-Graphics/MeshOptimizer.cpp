@@ -0,0 +1,237 @@
+#include <cmath>
+#include <algorithm>
+#include <array>
+#include <limits>
+#include "Mesh.hpp"
+#include "MeshOptimizer.hpp"
+
+/**
+ * @def GUST_FORSYTH_CACHE_SIZE
+ * @brief Number of entries in the LRU cache modeled while reordering triangles.
+ */
+#define GUST_FORSYTH_CACHE_SIZE 32
+
+namespace gust
+{
+	/**
+	 * @brief Score a vertex for Forsyth's optimizer.
+	 * @param Position in the LRU cache (Negative if not in the cache.)
+	 * @param Number of triangles left to emit that use the vertex.
+	 * @return Score.
+	 */
+	static float forsythVertexScore(int32_t cachePosition, uint32_t remainingTriangles)
+	{
+		// Nothing left to draw with it
+		if (remainingTriangles == 0)
+			return -1.0f;
+
+		float score = 0.0f;
+
+		if (cachePosition >= 0)
+		{
+			// The last triangles vertices get a fixed score so the next triangle doesn't prefer them too much
+			if (cachePosition < 3)
+				score = 0.75f;
+			else
+			{
+				const float scaler = 1.0f / (GUST_FORSYTH_CACHE_SIZE - 3);
+				score = std::pow(1.0f - (cachePosition - 3) * scaler, 1.5f);
+			}
+		}
+
+		// Favor finishing off vertices with few triangles left
+		score += 2.0f * std::pow(static_cast<float>(remainingTriangles), -0.5f);
+
+		return score;
+	}
+
+	float calculateACMR(const std::vector<uint32_t>& indices, size_t vertexCount, size_t cacheSize)
+	{
+		if (indices.size() < 3)
+			return 0.0f;
+
+		// A vertex is cached if it was added in the last cacheSize misses
+		std::vector<size_t> timestamps(vertexCount, 0);
+		size_t time = cacheSize + 1;
+		size_t misses = 0;
+
+		for (uint32_t index : indices)
+			if (time - timestamps[index] > cacheSize)
+			{
+				timestamps[index] = time++;
+				++misses;
+			}
+
+		return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+	}
+
+	std::vector<uint32_t> optimizeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount)
+	{
+		const size_t triangleCount = indices.size() / 3;
+
+		if (triangleCount == 0)
+			return indices;
+
+		// Triangles using each vertex
+		std::vector<uint32_t> remaining(vertexCount, 0);
+		std::vector<uint32_t> firstTriangle(vertexCount + 1, 0);
+		std::vector<uint32_t> vertexTriangles(triangleCount * 3);
+
+		for (size_t i = 0; i < triangleCount * 3; ++i)
+			++remaining[indices[i]];
+
+		for (size_t i = 0; i < vertexCount; ++i)
+			firstTriangle[i + 1] = firstTriangle[i] + remaining[i];
+
+		{
+			std::vector<uint32_t> cursors(firstTriangle.begin(), firstTriangle.end() - 1);
+
+			for (size_t i = 0; i < triangleCount * 3; ++i)
+				vertexTriangles[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+
+		// Initial scores
+		std::vector<int32_t> cachePositions(vertexCount, -1);
+		std::vector<float> vertexScores(vertexCount);
+		std::vector<float> triangleScores(triangleCount, 0.0f);
+		std::vector<uint8_t> emitted(triangleCount, 0);
+
+		for (size_t i = 0; i < vertexCount; ++i)
+			vertexScores[i] = forsythVertexScore(-1, remaining[i]);
+
+		for (size_t i = 0; i < triangleCount; ++i)
+			triangleScores[i] = vertexScores[indices[i * 3]] + vertexScores[indices[i * 3 + 1]] + vertexScores[indices[i * 3 + 2]];
+
+		// Start with the best triangle overall
+		size_t bestTriangle = 0;
+
+		for (size_t i = 1; i < triangleCount; ++i)
+			if (triangleScores[i] > triangleScores[bestTriangle])
+				bestTriangle = i;
+
+		std::array<uint32_t, GUST_FORSYTH_CACHE_SIZE + 3> cache = {};
+		size_t cacheCount = 0;
+		size_t searchStart = 0;
+
+		std::vector<uint32_t> optimized = {};
+		optimized.reserve(triangleCount * 3);
+
+		while (optimized.size() < triangleCount * 3)
+		{
+			const std::array<uint32_t, 3> triangle =
+			{
+				indices[bestTriangle * 3],
+				indices[bestTriangle * 3 + 1],
+				indices[bestTriangle * 3 + 2]
+			};
+
+			optimized.insert(optimized.end(), triangle.begin(), triangle.end());
+			emitted[bestTriangle] = 1;
+
+			// Remove the triangle from its vertices live triangles
+			for (uint32_t vertex : triangle)
+			{
+				const uint32_t first = firstTriangle[vertex];
+				const uint32_t last = first + remaining[vertex] - 1;
+
+				for (uint32_t i = first; i <= last; ++i)
+					if (vertexTriangles[i] == bestTriangle)
+					{
+						std::swap(vertexTriangles[i], vertexTriangles[last]);
+						break;
+					}
+
+				--remaining[vertex];
+			}
+
+			// Move the triangles vertices to the front of the cache
+			std::array<uint32_t, GUST_FORSYTH_CACHE_SIZE + 3> newCache = {};
+			size_t newCacheCount = 0;
+
+			for (uint32_t vertex : triangle)
+				newCache[newCacheCount++] = vertex;
+
+			for (size_t i = 0; i < cacheCount; ++i)
+				if (cache[i] != triangle[0] && cache[i] != triangle[1] && cache[i] != triangle[2])
+					newCache[newCacheCount++] = cache[i];
+
+			// Rescore every vertex that was or is in the cache
+			for (size_t i = 0; i < newCacheCount; ++i)
+			{
+				const uint32_t vertex = newCache[i];
+				cachePositions[vertex] = i < GUST_FORSYTH_CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+
+				const float score = forsythVertexScore(cachePositions[vertex], remaining[vertex]);
+				const float delta = score - vertexScores[vertex];
+				vertexScores[vertex] = score;
+
+				for (uint32_t j = firstTriangle[vertex]; j < firstTriangle[vertex] + remaining[vertex]; ++j)
+					triangleScores[vertexTriangles[j]] += delta;
+			}
+
+			cache = newCache;
+			cacheCount = std::min<size_t>(newCacheCount, GUST_FORSYTH_CACHE_SIZE);
+
+			// Next triangle is the best one touching the cache
+			float bestScore = -std::numeric_limits<float>::max();
+			bool found = false;
+
+			for (size_t i = 0; i < cacheCount; ++i)
+			{
+				const uint32_t vertex = cache[i];
+
+				for (uint32_t j = firstTriangle[vertex]; j < firstTriangle[vertex] + remaining[vertex]; ++j)
+					if (triangleScores[vertexTriangles[j]] > bestScore)
+					{
+						bestScore = triangleScores[vertexTriangles[j]];
+						bestTriangle = vertexTriangles[j];
+						found = true;
+					}
+			}
+
+			// Dead end, so continue from the next triangle not yet emitted
+			if (!found)
+			{
+				while (searchStart < triangleCount && emitted[searchStart])
+					++searchStart;
+
+				bestTriangle = searchStart;
+			}
+		}
+
+		return optimized;
+	}
+
+	void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		std::vector<uint32_t> remap(vertices.size(), std::numeric_limits<uint32_t>::max());
+		std::vector<Vertex> reordered = {};
+		reordered.reserve(vertices.size());
+
+		// Number vertices in the order they are first drawn
+		for (uint32_t& index : indices)
+		{
+			if (remap[index] == std::numeric_limits<uint32_t>::max())
+			{
+				remap[index] = static_cast<uint32_t>(reordered.size());
+				reordered.push_back(vertices[index]);
+			}
+
+			index = remap[index];
+		}
+
+		vertices = std::move(reordered);
+	}
+
+	MeshOptimizationStats optimizeMesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		MeshOptimizationStats stats = {};
+		stats.acmrBefore = calculateACMR(indices, vertices.size());
+
+		indices = optimizeVertexCache(indices, vertices.size());
+		optimizeVertexFetch(vertices, indices);
+
+		stats.acmrAfter = calculateACMR(indices, vertices.size());
+		return stats;
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+/**
+ * @file MeshOptimizer.hpp
+ * @brief Mesh optimizer header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/** Includes. */
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @def GUST_VERTEX_CACHE_SIZE
+ * @brief Number of entries in the FIFO post transform cache used to measure ACMR.
+ */
+#define GUST_VERTEX_CACHE_SIZE 16
+
+namespace gust
+{
+	struct Vertex;
+
+	/**
+	 * @struct MeshOptimizationStats
+	 * @brief Vertex cache efficiency before and after optimizing a mesh.
+	 */
+	struct MeshOptimizationStats
+	{
+		/** Average cache miss ratio (Vertices transformed per triangle) before optimizing. */
+		float acmrBefore = 0.0f;
+
+		/** Average cache miss ratio (Vertices transformed per triangle) after optimizing. */
+		float acmrAfter = 0.0f;
+	};
+
+	/**
+	 * @brief Measure the average cache miss ratio of a triangle list.
+	 * @param Triangle indices.
+	 * @param Number of vertices.
+	 * @param Number of entries in the simulated FIFO cache.
+	 * @return Vertices transformed per triangle (0.5 is ideal for a grid, 3 is the worst case.)
+	 */
+	extern float calculateACMR
+	(
+		const std::vector<uint32_t>& indices,
+		size_t vertexCount,
+		size_t cacheSize = GUST_VERTEX_CACHE_SIZE
+	);
+
+	/**
+	 * @brief Reorder triangles so vertices are reused while still in the post transform cache.
+	 * @param Triangle indices.
+	 * @param Number of vertices.
+	 * @return Reordered triangle indices.
+	 * @note Uses Tom Forsyth's linear speed vertex cache optimization.
+	 */
+	extern std::vector<uint32_t> optimizeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount);
+
+	/**
+	 * @brief Reorder vertices by first use so vertex fetches walk memory in order.
+	 * @param Vertices.
+	 * @param Triangle indices (Remapped to the new vertex order.)
+	 * @note Vertices no triangle uses are removed.
+	 */
+	extern void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+	/**
+	 * @brief Optimize a mesh for the vertex cache and then for vertex fetch.
+	 * @param Vertices.
+	 * @param Triangle indices.
+	 * @return Cache efficiency before and after.
+	 */
+	extern MeshOptimizationStats optimizeMesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+}
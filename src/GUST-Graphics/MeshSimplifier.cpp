@@ -0,0 +1,358 @@
+#include <queue>
+#include <algorithm>
+#include <cmath>
+#include "MeshSimplifier.hpp"
+
+namespace gust
+{
+	namespace
+	{
+		/**
+		 * @struct Quadric
+		 * @brief Symmetric 4x4 matrix summing squared distances to a set of planes.
+		 */
+		struct Quadric
+		{
+			/** Upper triangle of the matrix. */
+			double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+
+			/** Sum of plane weights. */
+			double weight = 0;
+
+			/**
+			 * @brief Add a plane.
+			 * @param Plane normal.
+			 * @param Plane distance.
+			 * @param Weight.
+			 */
+			inline void addPlane(const glm::vec3& n, float d, float w)
+			{
+				a2 += w * n.x * n.x;	ab += w * n.x * n.y;	ac += w * n.x * n.z;	ad += w * n.x * d;
+				b2 += w * n.y * n.y;	bc += w * n.y * n.z;	bd += w * n.y * d;
+				c2 += w * n.z * n.z;	cd += w * n.z * d;
+				d2 += w * d * d;
+				weight += w;
+			}
+
+			/**
+			 * @brief Add another quadric.
+			 * @param Quadric.
+			 */
+			inline void add(const Quadric& q)
+			{
+				a2 += q.a2;	ab += q.ab;	ac += q.ac;	ad += q.ad;
+				b2 += q.b2;	bc += q.bc;	bd += q.bd;
+				c2 += q.c2;	cd += q.cd;
+				d2 += q.d2;
+				weight += q.weight;
+			}
+
+			/**
+			 * @brief Get the mean squared distance from a point to every plane.
+			 * @param Point.
+			 * @param Quadric to sum with.
+			 * @return Mean squared distance.
+			 */
+			inline double evaluate(const glm::vec3& p, const Quadric& q) const
+			{
+				const double x = p.x, y = p.y, z = p.z;
+				const double error =
+					(a2 + q.a2) * x * x + 2.0 * (ab + q.ab) * x * y + 2.0 * (ac + q.ac) * x * z + 2.0 * (ad + q.ad) * x +
+					(b2 + q.b2) * y * y + 2.0 * (bc + q.bc) * y * z + 2.0 * (bd + q.bd) * y +
+					(c2 + q.c2) * z * z + 2.0 * (cd + q.cd) * z +
+					(d2 + q.d2);
+
+				const double totalWeight = weight + q.weight;
+				return totalWeight > 0.0 ? std::abs(error) / totalWeight : 0.0;
+			}
+		};
+
+		/**
+		 * @struct Collapse
+		 * @brief Candidate edge collapse moving one vertex onto another.
+		 */
+		struct Collapse
+		{
+			/** Error introduced by the collapse. */
+			double cost = 0;
+
+			/** Vertex being removed. */
+			uint32_t from = 0;
+
+			/** Vertex being kept. */
+			uint32_t to = 0;
+
+			/** Version of the removed vertex when the cost was computed. */
+			uint32_t fromVersion = 0;
+
+			/** Version of the kept vertex when the cost was computed. */
+			uint32_t toVersion = 0;
+
+			/**
+			 * @brief Comparison operator.
+			 * @param Collapse to compare with.
+			 * @return If this collapse is more expensive.
+			 */
+			inline bool operator>(const Collapse& other) const
+			{
+				return cost > other.cost;
+			}
+		};
+	}
+
+	SimplifiedMesh simplifyMesh
+	(
+		const std::vector<Vertex>& vertices,
+		const std::vector<uint32_t>& indices,
+		size_t targetIndexCount,
+		float maxError
+	)
+	{
+		const size_t vertexCount = vertices.size();
+		const size_t triangleCount = indices.size() / 3;
+
+		// Group vertices sharing a position
+		std::vector<uint32_t> sorted(vertexCount);
+		for (size_t i = 0; i < vertexCount; ++i)
+			sorted[i] = static_cast<uint32_t>(i);
+
+		const auto lessPosition = [&vertices](uint32_t a, uint32_t b)
+		{
+			const glm::vec3& pa = vertices[a].position;
+			const glm::vec3& pb = vertices[b].position;
+			return pa.x != pb.x ? pa.x < pb.x : pa.y != pb.y ? pa.y < pb.y : pa.z < pb.z;
+		};
+
+		std::sort(sorted.begin(), sorted.end(), lessPosition);
+
+		std::vector<uint32_t> group(vertexCount);
+		std::vector<uint8_t> lockedGroup(vertexCount, 0);
+
+		for (size_t i = 0; i < vertexCount;)
+		{
+			size_t j = i + 1;
+			while (j < vertexCount && vertices[sorted[j]].position == vertices[sorted[i]].position)
+				++j;
+
+			// Seams split a position into several vertices so they can't move independently
+			for (size_t k = i; k < j; ++k)
+				group[sorted[k]] = sorted[i];
+
+			lockedGroup[sorted[i]] = j - i > 1 ? 1 : 0;
+			i = j;
+		}
+
+		// Edges not shared by exactly two triangles are borders (Or non-manifold)
+		std::vector<uint64_t> edges = {};
+		edges.reserve(triangleCount * 3);
+
+		for (size_t i = 0; i < triangleCount; ++i)
+			for (size_t j = 0; j < 3; ++j)
+			{
+				const uint64_t a = group[indices[i * 3 + j]];
+				const uint64_t b = group[indices[i * 3 + (j + 1) % 3]];
+				edges.push_back(a < b ? (a << 32) | b : (b << 32) | a);
+			}
+
+		std::sort(edges.begin(), edges.end());
+
+		for (size_t i = 0; i < edges.size();)
+		{
+			size_t j = i + 1;
+			while (j < edges.size() && edges[j] == edges[i])
+				++j;
+
+			if (j - i != 2)
+			{
+				lockedGroup[static_cast<uint32_t>(edges[i] >> 32)] = 1;
+				lockedGroup[static_cast<uint32_t>(edges[i] & 0xFFFFFFFF)] = 1;
+			}
+
+			i = j;
+		}
+
+		std::vector<uint8_t> locked(vertexCount);
+		for (size_t i = 0; i < vertexCount; ++i)
+			locked[i] = lockedGroup[group[i]];
+
+		// Triangle adjacency and plane quadrics
+		std::vector<uint32_t> triangles = indices;
+		std::vector<uint8_t> removed(triangleCount, 0);
+		std::vector<std::vector<uint32_t>> vertexTriangles(vertexCount);
+		std::vector<Quadric> quadrics(vertexCount);
+
+		for (size_t i = 0; i < triangleCount; ++i)
+		{
+			const glm::vec3& p0 = vertices[triangles[i * 3 + 0]].position;
+			const glm::vec3& p1 = vertices[triangles[i * 3 + 1]].position;
+			const glm::vec3& p2 = vertices[triangles[i * 3 + 2]].position;
+
+			for (size_t j = 0; j < 3; ++j)
+				vertexTriangles[triangles[i * 3 + j]].push_back(static_cast<uint32_t>(i));
+
+			glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			const float length = glm::length(normal);
+
+			if (length == 0.0f)
+				continue;
+
+			// Planes are weighted by triangle area
+			normal /= length;
+			const float distance = -glm::dot(normal, p0);
+
+			for (size_t j = 0; j < 3; ++j)
+				quadrics[triangles[i * 3 + j]].addPlane(normal, distance, length * 0.5f);
+		}
+
+		// Candidate collapses
+		std::vector<uint32_t> versions(vertexCount, 0);
+		std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> queue = {};
+
+		const auto pushCollapse = [&](uint32_t from, uint32_t to)
+		{
+			if (locked[from] || from == to)
+				return;
+
+			Collapse collapse = {};
+			collapse.cost = quadrics[from].evaluate(vertices[to].position, quadrics[to]);
+			collapse.from = from;
+			collapse.to = to;
+			collapse.fromVersion = versions[from];
+			collapse.toVersion = versions[to];
+			queue.push(collapse);
+		};
+
+		for (size_t i = 0; i < triangleCount; ++i)
+			for (size_t j = 0; j < 3; ++j)
+			{
+				const uint32_t a = triangles[i * 3 + j];
+				const uint32_t b = triangles[i * 3 + (j + 1) % 3];
+				pushCollapse(a, b);
+				pushCollapse(b, a);
+			}
+
+		// Check that moving a vertex doesn't flip any triangle
+		const auto isCollapseValid = [&](uint32_t from, uint32_t to)
+		{
+			const glm::vec3& target = vertices[to].position;
+
+			for (uint32_t triangle : vertexTriangles[from])
+			{
+				if (removed[triangle])
+					continue;
+
+				const uint32_t* tri = &triangles[triangle * 3];
+				if (tri[0] == to || tri[1] == to || tri[2] == to)
+					continue;
+
+				glm::vec3 before[3], after[3];
+				for (size_t j = 0; j < 3; ++j)
+				{
+					before[j] = vertices[tri[j]].position;
+					after[j] = tri[j] == from ? target : before[j];
+				}
+
+				const glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+				const glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+
+				if (glm::dot(normalBefore, normalAfter) <= 0.0f)
+					return false;
+			}
+
+			return true;
+		};
+
+		const double maxCost = static_cast<double>(maxError) * static_cast<double>(maxError);
+		size_t indexCount = triangleCount * 3;
+		double largestCost = 0.0;
+
+		while (indexCount > targetIndexCount && !queue.empty())
+		{
+			const Collapse collapse = queue.top();
+			queue.pop();
+
+			// Stale candidate
+			if (collapse.fromVersion != versions[collapse.from] || collapse.toVersion != versions[collapse.to])
+				continue;
+
+			if (collapse.cost > maxCost)
+				break;
+
+			if (!isCollapseValid(collapse.from, collapse.to))
+				continue;
+
+			// Move triangles onto the kept vertex and drop the ones that become degenerate
+			auto& keptTriangles = vertexTriangles[collapse.to];
+
+			for (uint32_t triangle : vertexTriangles[collapse.from])
+			{
+				if (removed[triangle])
+					continue;
+
+				uint32_t* tri = &triangles[triangle * 3];
+
+				if (tri[0] == collapse.to || tri[1] == collapse.to || tri[2] == collapse.to)
+				{
+					removed[triangle] = 1;
+					indexCount -= 3;
+					continue;
+				}
+
+				for (size_t j = 0; j < 3; ++j)
+					if (tri[j] == collapse.from)
+						tri[j] = collapse.to;
+
+				keptTriangles.push_back(triangle);
+			}
+
+			vertexTriangles[collapse.from].clear();
+			keptTriangles.erase
+			(
+				std::remove_if(keptTriangles.begin(), keptTriangles.end(), [&removed](uint32_t t) { return removed[t] != 0; }),
+				keptTriangles.end()
+			);
+
+			quadrics[collapse.to].add(quadrics[collapse.from]);
+			++versions[collapse.from];
+			++versions[collapse.to];
+			largestCost = std::max(largestCost, collapse.cost);
+
+			// Costs of every edge around the kept vertex changed
+			for (uint32_t triangle : keptTriangles)
+				for (size_t j = 0; j < 3; ++j)
+				{
+					const uint32_t neighbor = triangles[triangle * 3 + j];
+					pushCollapse(collapse.to, neighbor);
+					pushCollapse(neighbor, collapse.to);
+				}
+		}
+
+		// Compact remaining triangles and vertices
+		SimplifiedMesh result = {};
+		result.indices.reserve(indexCount);
+		result.error = static_cast<float>(std::sqrt(largestCost));
+
+		std::vector<uint32_t> remap(vertexCount, std::numeric_limits<uint32_t>::max());
+
+		for (size_t i = 0; i < triangleCount; ++i)
+		{
+			if (removed[i])
+				continue;
+
+			for (size_t j = 0; j < 3; ++j)
+			{
+				const uint32_t index = triangles[i * 3 + j];
+
+				if (remap[index] == std::numeric_limits<uint32_t>::max())
+				{
+					remap[index] = static_cast<uint32_t>(result.vertices.size());
+					result.vertices.push_back(vertices[index]);
+				}
+
+				result.indices.push_back(remap[index]);
+			}
+		}
+
+		return result;
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+/**
+ * @file MeshSimplifier.hpp
+ * @brief Mesh simplifier header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/** Includes. */
+#include <vector>
+#include <limits>
+#include "Mesh.hpp"
+
+namespace gust
+{
+	/**
+	 * @struct SimplifiedMesh
+	 * @brief Result of simplifying a mesh.
+	 */
+	struct SimplifiedMesh
+	{
+		/** Vertices. */
+		std::vector<Vertex> vertices = {};
+
+		/** Indices. */
+		std::vector<uint32_t> indices = {};
+
+		/** Largest distance (In mesh units) a surface moved while simplifying. */
+		float error = 0.0f;
+	};
+
+	/**
+	 * @brief Reduce the number of triangles in a mesh using quadric error metrics.
+	 * @param Vertices.
+	 * @param Triangle indices.
+	 * @param Number of indices to stop at.
+	 * @param Largest distance (In mesh units) a surface may move.
+	 * @return Simplified mesh.
+	 * @note Edges are collapsed onto one of their vertices so attributes are never interpolated.
+	 * @note Vertices on open borders and attribute seams (UV or normal splits) are never moved.
+	 */
+	extern SimplifiedMesh simplifyMesh
+	(
+		const std::vector<Vertex>& vertices,
+		const std::vector<uint32_t>& indices,
+		size_t targetIndexCount,
+		float maxError = std::numeric_limits<float>::max()
+	);
+}
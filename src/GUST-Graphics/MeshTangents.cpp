@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <Threading.hpp>
+#include "Mesh.hpp"
+#include "MeshTangents.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#include <xmmintrin.h>
+	#define GUST_TANGENTS_SSE
+#endif
+
+namespace gust
+{
+	/**
+	 * @brief Add the tangents of a range of triangles to the vertices they use.
+	 * @param Vertices.
+	 * @param Triangle indices.
+	 * @param First triangle.
+	 * @param One past the last triangle.
+	 * @param Tangent sums (X components of every vertex, then Y, then Z.)
+	 * @param Distance between the X, Y and Z components.
+	 */
+	static void sumTangents
+	(
+		const std::vector<Vertex>& vertices,
+		const std::vector<uint32_t>& indices,
+		size_t first,
+		size_t last,
+		float* sums,
+		size_t stride
+	)
+	{
+		float* const x = sums;
+		float* const y = sums + stride;
+		float* const z = sums + stride * 2;
+
+		size_t i = first;
+
+#if defined(GUST_TANGENTS_SSE)
+		// 4 triangles per iteration
+		for (; i + 4 <= last; i += 4)
+		{
+			// Corner, component, lane
+			alignas(16) float positions[3][3][4];
+			alignas(16) float uvs[3][2][4];
+
+			for (size_t lane = 0; lane < 4; ++lane)
+				for (size_t corner = 0; corner < 3; ++corner)
+				{
+					const Vertex& vertex = vertices[indices[(i + lane) * 3 + corner]];
+					positions[corner][0][lane] = vertex.position.x;
+					positions[corner][1][lane] = vertex.position.y;
+					positions[corner][2][lane] = vertex.position.z;
+					uvs[corner][0][lane] = vertex.uv.x;
+					uvs[corner][1][lane] = vertex.uv.y;
+				}
+
+			const __m128 deltaU1 = _mm_sub_ps(_mm_load_ps(uvs[1][0]), _mm_load_ps(uvs[0][0]));
+			const __m128 deltaV1 = _mm_sub_ps(_mm_load_ps(uvs[1][1]), _mm_load_ps(uvs[0][1]));
+			const __m128 deltaU2 = _mm_sub_ps(_mm_load_ps(uvs[2][0]), _mm_load_ps(uvs[0][0]));
+			const __m128 deltaV2 = _mm_sub_ps(_mm_load_ps(uvs[2][1]), _mm_load_ps(uvs[0][1]));
+
+			const __m128 f = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sub_ps(_mm_mul_ps(deltaU1, deltaV2), _mm_mul_ps(deltaU2, deltaV1)));
+
+			alignas(16) float tangents[3][4];
+
+			for (size_t component = 0; component < 3; ++component)
+			{
+				const __m128 edge1 = _mm_sub_ps(_mm_load_ps(positions[1][component]), _mm_load_ps(positions[0][component]));
+				const __m128 edge2 = _mm_sub_ps(_mm_load_ps(positions[2][component]), _mm_load_ps(positions[0][component]));
+				_mm_store_ps(tangents[component], _mm_mul_ps(f, _mm_sub_ps(_mm_mul_ps(deltaV2, edge1), _mm_mul_ps(deltaV1, edge2))));
+			}
+
+			// Scatter to the corners
+			for (size_t lane = 0; lane < 4; ++lane)
+				for (size_t corner = 0; corner < 3; ++corner)
+				{
+					const uint32_t index = indices[(i + lane) * 3 + corner];
+					x[index] += tangents[0][lane];
+					y[index] += tangents[1][lane];
+					z[index] += tangents[2][lane];
+				}
+		}
+#endif
+
+		for (; i < last; ++i)
+		{
+			const uint32_t i0 = indices[i * 3];
+			const uint32_t i1 = indices[i * 3 + 1];
+			const uint32_t i2 = indices[i * 3 + 2];
+
+			const Vertex& v0 = vertices[i0];
+			const Vertex& v1 = vertices[i1];
+			const Vertex& v2 = vertices[i2];
+
+			const auto edge1 = v1.position - v0.position;
+			const auto edge2 = v2.position - v0.position;
+
+			const auto deltaU1 = v1.uv.x - v0.uv.x;
+			const auto deltaV1 = v1.uv.y - v0.uv.y;
+			const auto deltaU2 = v2.uv.x - v0.uv.x;
+			const auto deltaV2 = v2.uv.y - v0.uv.y;
+
+			const auto f = 1.0f / (deltaU1 * deltaV2 - deltaU2 * deltaV1);
+
+			const glm::vec3 tangent = f * (deltaV2 * edge1 - deltaV1 * edge2);
+
+			for (uint32_t index : { i0, i1, i2 })
+			{
+				x[index] += tangent.x;
+				y[index] += tangent.y;
+				z[index] += tangent.z;
+			}
+		}
+	}
+
+	/**
+	 * @brief Add up every jobs tangent sums for a range of vertices and normalize them.
+	 * @param Vertices.
+	 * @param Tangent sums of every job.
+	 * @param Number of jobs.
+	 * @param Distance between the X, Y and Z components.
+	 * @param First vertex (Multiple of four.)
+	 * @param One past the last vertex (Multiple of four.)
+	 */
+	static void resolveTangents
+	(
+		std::vector<Vertex>& vertices,
+		const std::vector<float>& sums,
+		size_t jobCount,
+		size_t stride,
+		size_t first,
+		size_t last
+	)
+	{
+		for (size_t i = first; i < last; i += 4)
+		{
+			alignas(16) float tangents[3][4];
+
+#if defined(GUST_TANGENTS_SSE)
+			// 4 vertices per iteration
+			__m128 components[3] = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+
+			for (size_t job = 0; job < jobCount; ++job)
+				for (size_t component = 0; component < 3; ++component)
+					components[component] = _mm_add_ps(components[component], _mm_loadu_ps(&sums[(job * 3 + component) * stride + i]));
+
+			const __m128 length = _mm_sqrt_ps
+			(
+				_mm_add_ps
+				(
+					_mm_add_ps(_mm_mul_ps(components[0], components[0]), _mm_mul_ps(components[1], components[1])),
+					_mm_mul_ps(components[2], components[2])
+				)
+			);
+
+			for (size_t component = 0; component < 3; ++component)
+				_mm_store_ps(tangents[component], _mm_div_ps(components[component], length));
+#else
+			for (size_t lane = 0; lane < 4; ++lane)
+			{
+				glm::vec3 tangent = glm::vec3();
+
+				for (size_t job = 0; job < jobCount; ++job)
+					tangent += glm::vec3
+					(
+						sums[(job * 3) * stride + i + lane],
+						sums[(job * 3 + 1) * stride + i + lane],
+						sums[(job * 3 + 2) * stride + i + lane]
+					);
+
+				tangent = glm::normalize(tangent);
+				tangents[0][lane] = tangent.x;
+				tangents[1][lane] = tangent.y;
+				tangents[2][lane] = tangent.z;
+			}
+#endif
+
+			// Sums are padded to a multiple of four vertices
+			for (size_t lane = 0; lane < 4 && i + lane < vertices.size(); ++lane)
+				vertices[i + lane].tangent = glm::vec3(tangents[0][lane], tangents[1][lane], tangents[2][lane]);
+		}
+	}
+
+	void calculateTangents(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, ThreadPool* threadPool)
+	{
+		const size_t jobCount = threadPool ? std::max<size_t>(threadPool->getWorkerCount(), 1) : 1;
+		const size_t triangleCount = indices.size() / 3;
+		const size_t stride = (vertices.size() + 3) & ~static_cast<size_t>(3);
+
+		// X, Y and Z tangent sums of every vertex for each job (Added together afterwards instead of sharing one sum)
+		std::vector<float> sums(jobCount * 3 * stride, 0.0f);
+
+		runJobs(threadPool, jobCount, [&](size_t job)
+		{
+			sumTangents
+			(
+				vertices,
+				indices,
+				triangleCount * job / jobCount,
+				triangleCount * (job + 1) / jobCount,
+				sums.data() + job * 3 * stride,
+				stride
+			);
+		});
+
+		// Each job resolves its own groups of four vertices
+		const size_t groupCount = stride / 4;
+
+		runJobs(threadPool, jobCount, [&](size_t job)
+		{
+			resolveTangents
+			(
+				vertices,
+				sums,
+				jobCount,
+				stride,
+				groupCount * job / jobCount * 4,
+				groupCount * (job + 1) / jobCount * 4
+			);
+		});
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * @file MeshTangents.hpp
+ * @brief Mesh tangent generation header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/** Includes. */
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace gust
+{
+	struct Vertex;
+
+	class ThreadPool;
+
+	/**
+	 * @brief Calculate tangents from UVs.
+	 * @param Vertices.
+	 * @param Triangle indices.
+	 * @param Thread pool to calculate with (Calculated on the calling thread when null.)
+	 * @note Each worker sums the tangents of a range of triangles (Four at a time with SSE) into its own
+	 * buffer. The buffers are then added together and normalized four vertices at a time, so no vertex
+	 * is ever written by two threads.
+	 */
+	extern void calculateTangents
+	(
+		std::vector<Vertex>& vertices,
+		const std::vector<uint32_t>& indices,
+		ThreadPool* threadPool = nullptr
+	);
+}
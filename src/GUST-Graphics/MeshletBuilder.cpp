@@ -0,0 +1,196 @@
+#include <array>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "Mesh.hpp"
+#include "MeshletBuilder.hpp"
+
+namespace gust
+{
+	/**
+	 * @brief Fit a sphere around a set of points.
+	 * @param Points.
+	 * @param Meshlet to store the sphere in.
+	 * @note Ritter's algorithm. Starts from the furthest apart pair of axis extremes and grows to fit
+	 * any point outside, so the sphere is within a few percent of the smallest one.
+	 */
+	static void calculateSphere(const std::vector<glm::vec3>& points, Meshlet& meshlet)
+	{
+		// Points with the smallest and largest coordinate on each axis
+		std::array<size_t, 3> smallest = {};
+		std::array<size_t, 3> largest = {};
+
+		for (size_t i = 1; i < points.size(); ++i)
+			for (glm::length_t axis = 0; axis < 3; ++axis)
+			{
+				if (points[i][axis] < points[smallest[axis]][axis])
+					smallest[axis] = i;
+
+				if (points[i][axis] > points[largest[axis]][axis])
+					largest[axis] = i;
+			}
+
+		// Start with the pair furthest apart
+		size_t axis = 0;
+		float distance = 0.0f;
+
+		for (size_t i = 0; i < 3; ++i)
+		{
+			const glm::vec3 delta = points[largest[i]] - points[smallest[i]];
+			const float candidate = glm::dot(delta, delta);
+
+			if (candidate > distance)
+			{
+				distance = candidate;
+				axis = i;
+			}
+		}
+
+		glm::vec3 center = (points[smallest[axis]] + points[largest[axis]]) * 0.5f;
+		float radius = std::sqrt(distance) * 0.5f;
+
+		// Grow to fit every point
+		for (const glm::vec3& point : points)
+		{
+			const float length = glm::length(point - center);
+
+			if (length > radius)
+			{
+				const float grown = (radius + length) * 0.5f;
+				center += (point - center) * ((grown - radius) / length);
+				radius = grown;
+			}
+		}
+
+		meshlet.center = center;
+		meshlet.radius = radius;
+	}
+
+	/**
+	 * @brief Find the cone containing the normals of a meshlets triangles.
+	 * @param Vertices.
+	 * @param Triangle indices.
+	 * @param Meshlet to store the cone in (Its index range must be set.)
+	 */
+	static void calculateCone(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, Meshlet& meshlet)
+	{
+		const size_t triangleCount = meshlet.indexCount / 3;
+
+		// Normals of each triangle (Counter clockwise front faces)
+		std::vector<glm::vec3> normals = {};
+		normals.reserve(triangleCount);
+
+		glm::vec3 axis = glm::vec3();
+
+		for (size_t i = 0; i < triangleCount; ++i)
+		{
+			const size_t first = meshlet.firstIndex + i * 3;
+			const glm::vec3& p0 = vertices[indices[first]].position;
+			const glm::vec3& p1 = vertices[indices[first + 1]].position;
+			const glm::vec3& p2 = vertices[indices[first + 2]].position;
+
+			const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			const float length = glm::length(normal);
+
+			// Degenerate triangles are never drawn, so they can face anywhere
+			if (length == 0.0f)
+				continue;
+
+			normals.push_back(normal / length);
+			axis += normals.back();
+		}
+
+		meshlet.coneAxis = glm::vec3();
+		meshlet.coneCutoff = 1.0f;
+
+		const float axisLength = glm::length(axis);
+
+		if (normals.empty() || axisLength == 0.0f)
+			return;
+
+		axis /= axisLength;
+
+		// Cosine of the widest angle between the axis and a normal
+		float spread = 1.0f;
+
+		for (const glm::vec3& normal : normals)
+			spread = std::min(spread, glm::dot(normal, axis));
+
+		// Triangles facing more than 90 degrees apart can never all face away
+		if (spread <= 0.0f)
+			return;
+
+		meshlet.coneAxis = axis;
+		meshlet.coneCutoff = std::sqrt(1.0f - spread * spread);
+	}
+
+	std::vector<Meshlet> buildMeshlets
+	(
+		const std::vector<Vertex>& vertices,
+		const std::vector<uint32_t>& indices,
+		size_t maxVertices,
+		size_t maxTriangles
+	)
+	{
+		std::vector<Meshlet> meshlets = {};
+
+		if (indices.size() < 3 || maxVertices < 3 || maxTriangles == 0)
+			return meshlets;
+
+		// Meshlet that last used each vertex
+		std::vector<uint32_t> owners(vertices.size(), std::numeric_limits<uint32_t>::max());
+
+		// Positions of the current meshlets unique vertices
+		std::vector<glm::vec3> points = {};
+		points.reserve(maxVertices);
+
+		Meshlet meshlet = {};
+
+		const auto finish = [&]()
+		{
+			meshlet.vertexCount = static_cast<uint32_t>(points.size());
+			calculateSphere(points, meshlet);
+			calculateCone(vertices, indices, meshlet);
+			meshlets.push_back(meshlet);
+
+			meshlet = {};
+			meshlet.firstIndex = meshlets.back().firstIndex + meshlets.back().indexCount;
+			points.clear();
+		};
+
+		const size_t triangleCount = indices.size() / 3;
+
+		for (size_t i = 0; i < triangleCount; ++i)
+		{
+			const uint32_t* triangle = &indices[i * 3];
+			const uint32_t current = static_cast<uint32_t>(meshlets.size());
+
+			// Vertices the triangle would add
+			size_t added = 0;
+
+			for (size_t j = 0; j < 3; ++j)
+				if (owners[triangle[j]] != current && (j == 0 || triangle[j] != triangle[0]) && (j < 2 || triangle[j] != triangle[1]))
+					++added;
+
+			// Start a new meshlet if the triangle doesn't fit
+			if (meshlet.indexCount > 0 && (points.size() + added > maxVertices || meshlet.indexCount / 3 + 1 > maxTriangles))
+				finish();
+
+			const uint32_t owner = static_cast<uint32_t>(meshlets.size());
+
+			for (size_t j = 0; j < 3; ++j)
+				if (owners[triangle[j]] != owner)
+				{
+					owners[triangle[j]] = owner;
+					points.push_back(vertices[triangle[j]].position);
+				}
+
+			meshlet.indexCount += 3;
+		}
+
+		if (meshlet.indexCount > 0)
+			finish();
+
+		return meshlets;
+	}
+}
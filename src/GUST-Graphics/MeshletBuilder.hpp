@@ -0,0 +1,79 @@
+#pragma once
+
+/**
+ * @file MeshletBuilder.hpp
+ * @brief Meshlet builder header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/** Includes. */
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <Math.hpp>
+
+/**
+ * @def GUST_MESHLET_MAX_VERTICES
+ * @brief Most unique vertices referenced by a meshlet.
+ */
+#define GUST_MESHLET_MAX_VERTICES 64
+
+/**
+ * @def GUST_MESHLET_MAX_TRIANGLES
+ * @brief Most triangles in a meshlet.
+ */
+#define GUST_MESHLET_MAX_TRIANGLES 124
+
+namespace gust
+{
+	struct Vertex;
+
+	/**
+	 * @struct Meshlet
+	 * @brief A small cluster of a meshes triangles that can be culled on its own.
+	 */
+	struct Meshlet
+	{
+		/** Local space bounding sphere center. */
+		glm::vec3 center = glm::vec3();
+
+		/** Local space bounding sphere radius. */
+		float radius = 0.0f;
+
+		/** Average direction the triangles face (Zero if they face too many ways to be culled together.) */
+		glm::vec3 coneAxis = glm::vec3();
+
+		/** Sine of the angle between the cone axis and the triangle facing furthest from it (1 if the cone can't be culled.) */
+		float coneCutoff = 1.0f;
+
+		/** First index in the meshes index buffer. */
+		uint32_t firstIndex = 0;
+
+		/** Number of indices. */
+		uint32_t indexCount = 0;
+
+		/** Number of unique vertices. */
+		uint32_t vertexCount = 0;
+	};
+
+	/**
+	 * @brief Split a mesh into meshlets.
+	 * @param Vertices.
+	 * @param Triangle indices.
+	 * @param Most unique vertices per meshlet.
+	 * @param Most triangles per meshlet.
+	 * @return Meshlets.
+	 * @note Triangles are taken in the order they are drawn, so each meshlet is a contiguous range of
+	 * the index buffer and the mesh still draws the same way without culling. Cache optimized meshes
+	 * (See optimizeMesh()) are already ordered by locality, which keeps the clusters tight.
+	 * @note Front faces are counter clockwise in mesh space (Clockwise once projected, see Renderer.)
+	 * A meshlet is entirely back facing from a point P if dot(center - P, coneAxis) >= coneCutoff * |center - P| + radius.
+	 */
+	extern std::vector<Meshlet> buildMeshlets
+	(
+		const std::vector<Vertex>& vertices,
+		const std::vector<uint32_t>& indices,
+		size_t maxVertices = GUST_MESHLET_MAX_VERTICES,
+		size_t maxTriangles = GUST_MESHLET_MAX_TRIANGLES
+	);
+}
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include "Mipmaps.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define GUST_MIPMAPS_SSE
+#endif
+
+namespace gust
+{
+	/**
+	 * @brief Average a 2x2 block of RGBA8 texels for each texel of the next level.
+	 * @param Pixels of the level above.
+	 * @param Width of the level above.
+	 * @param Height of the level above.
+	 * @param Pixels of the next level.
+	 * @param Width of the next level.
+	 * @param Height of the next level.
+	 */
+	static void downsample
+	(
+		const uint8_t* source,
+		uint32_t sourceWidth,
+		uint32_t sourceHeight,
+		uint8_t* destination,
+		uint32_t width,
+		uint32_t height
+	)
+	{
+		for (uint32_t y = 0; y < height; ++y)
+		{
+			// Levels one texel tall reuse their only row
+			const uint8_t* row0 = source + static_cast<size_t>(std::min(y * 2, sourceHeight - 1)) * sourceWidth * 4;
+			const uint8_t* row1 = source + static_cast<size_t>(std::min(y * 2 + 1, sourceHeight - 1)) * sourceWidth * 4;
+			uint8_t* output = destination + static_cast<size_t>(y) * width * 4;
+
+			uint32_t x = 0;
+
+#if defined(GUST_MIPMAPS_SSE)
+			// 4 output texels (8 input texels from each row) per iteration
+			if (sourceWidth >= 2)
+			{
+				const __m128i zero = _mm_setzero_si128();
+				const __m128i round = _mm_set1_epi16(2);
+
+				for (; x + 4 <= width; x += 4)
+				{
+					__m128i halves[2];
+
+					for (size_t i = 0; i < 2; ++i)
+					{
+						const __m128i top = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + (x * 2 + i * 4) * 4));
+						const __m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + (x * 2 + i * 4) * 4));
+
+						// Add rows with each channel widened to 16 bits
+						const __m128i left = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+						const __m128i right = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+
+						// Add neighbouring texels and round
+						const __m128i leftSum = _mm_add_epi16(left, _mm_srli_si128(left, 8));
+						const __m128i rightSum = _mm_add_epi16(right, _mm_srli_si128(right, 8));
+						halves[i] = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(leftSum, rightSum), round), 2);
+					}
+
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(output + x * 4), _mm_packus_epi16(halves[0], halves[1]));
+				}
+			}
+#endif
+
+			for (; x < width; ++x)
+			{
+				// Levels one texel wide reuse their only column
+				const size_t column0 = static_cast<size_t>(std::min(x * 2, sourceWidth - 1)) * 4;
+				const size_t column1 = static_cast<size_t>(std::min(x * 2 + 1, sourceWidth - 1)) * 4;
+
+				for (size_t channel = 0; channel < 4; ++channel)
+					output[x * 4 + channel] = static_cast<uint8_t>
+					(
+						(row0[column0 + channel] + row0[column1 + channel] + row1[column0 + channel] + row1[column1 + channel] + 2) >> 2
+					);
+			}
+		}
+	}
+
+	uint32_t calculateMipLevels(uint32_t width, uint32_t height)
+	{
+		uint32_t levels = 1;
+
+		for (uint32_t size = std::max(width, height); size > 1; size >>= 1)
+			++levels;
+
+		return levels;
+	}
+
+	std::vector<uint8_t> buildMipChain
+	(
+		const uint8_t* pixels,
+		uint32_t width,
+		uint32_t height,
+		uint32_t layerCount,
+		uint32_t mipLevels
+	)
+	{
+		// Offset of every level
+		std::vector<size_t> offsets(mipLevels + 1, 0);
+
+		for (uint32_t i = 0; i < mipLevels; ++i)
+			offsets[i + 1] = offsets[i] + static_cast<size_t>(std::max(width >> i, 1u)) * std::max(height >> i, 1u) * 4 * layerCount;
+
+		std::vector<uint8_t> chain(offsets[mipLevels]);
+		std::copy(pixels, pixels + offsets[1], chain.begin());
+
+		for (uint32_t i = 1; i < mipLevels; ++i)
+		{
+			const uint32_t sourceWidth = std::max(width >> (i - 1), 1u);
+			const uint32_t sourceHeight = std::max(height >> (i - 1), 1u);
+			const uint32_t levelWidth = std::max(width >> i, 1u);
+			const uint32_t levelHeight = std::max(height >> i, 1u);
+
+			const size_t sourceLayerSize = static_cast<size_t>(sourceWidth) * sourceHeight * 4;
+			const size_t layerSize = static_cast<size_t>(levelWidth) * levelHeight * 4;
+
+			for (uint32_t layer = 0; layer < layerCount; ++layer)
+				downsample
+				(
+					chain.data() + offsets[i - 1] + sourceLayerSize * layer,
+					sourceWidth,
+					sourceHeight,
+					chain.data() + offsets[i] + layerSize * layer,
+					levelWidth,
+					levelHeight
+				);
+		}
+
+		return chain;
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+/**
+ * @file Mipmaps.hpp
+ * @brief Mipmap generation header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/** Includes. */
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace gust
+{
+	/**
+	 * @brief Get the number of mip levels in a full chain.
+	 * @param Width of the first level.
+	 * @param Height of the first level.
+	 * @return Number of levels down to 1x1.
+	 */
+	extern uint32_t calculateMipLevels(uint32_t width, uint32_t height);
+
+	/**
+	 * @brief Build a mip chain on the CPU by box filtering each level down from the one above it.
+	 * @param RGBA8 pixels of the first level (Layers are tightly packed.)
+	 * @param Width of the first level.
+	 * @param Height of the first level.
+	 * @param Number of layers.
+	 * @param Number of mip levels.
+	 * @return Every level (Including the first) one after another, laid out the way UploadManager::uploadImage() reads them.
+	 * @note Each level is half the size of the one above, rounded down, so odd rows and columns are dropped.
+	 * Four output texels are filtered at a time with SSE2 when it is available.
+	 */
+	extern std::vector<uint8_t> buildMipChain
+	(
+		const uint8_t* pixels,
+		uint32_t width,
+		uint32_t height,
+		uint32_t layerCount,
+		uint32_t mipLevels
+	);
+}
@@ -0,0 +1,671 @@
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstring>
+#include <FileIO.hpp>
+#include <Debugging.hpp>
+#include "ObjLoader.hpp"
+
+/**
+ * @def GUST_OBJ_MIN_CHUNK_SIZE
+ * @brief Smallest number of bytes of an OBJ file parsed by a single job.
+ */
+#define GUST_OBJ_MIN_CHUNK_SIZE (1024 * 1024)
+
+/**
+ * @def GUST_OBJ_JOBS_PER_WORKER
+ * @brief Number of jobs each worker gets per pass, so uneven chunks still balance.
+ */
+#define GUST_OBJ_JOBS_PER_WORKER 4
+
+namespace gust
+{
+	/** Bits of the vertex attributes an OBJ file can set. */
+	using VertexBits = std::array<uint32_t, 8>;
+
+	/** Position, UV and normal index of a face corner (-1 when missing.) */
+	using ObjCorner = std::array<int32_t, 3>;
+
+	/**
+	 * @struct ObjChunk
+	 * @brief Records parsed from a line aligned part of an OBJ file.
+	 */
+	struct ObjChunk
+	{
+		/** First character. */
+		const char* begin = nullptr;
+
+		/** One past the last character. */
+		const char* end = nullptr;
+
+		/** Positions (Three floats each.) */
+		std::vector<float> positions = {};
+
+		/** UVs (Two floats each.) */
+		std::vector<float> uvs = {};
+
+		/** Normals (Three floats each.) */
+		std::vector<float> normals = {};
+
+		/** Triangulated face corners. */
+		std::vector<ObjCorner> corners = {};
+
+		/** Corner attributes (corner * 3 + attribute) holding negative indices, which are relative to the chunk. */
+		std::vector<uint32_t> relativeIndices = {};
+
+		/** First position, UV, normal and corner of the chunk in the whole file. */
+		std::array<size_t, 4> first = {};
+
+		/** Number of corners. */
+		size_t cornerCount = 0;
+
+		/** Corners of the chunk in each dedup partition. */
+		std::vector<std::vector<uint32_t>> partitions = {};
+
+		/** Number of corners that are the first to use their vertex. */
+		size_t newVertexCount = 0;
+
+		/** Index of the chunks first new vertex. */
+		size_t firstVertex = 0;
+
+		/** Error found while parsing. */
+		std::string error = "";
+	};
+
+	/**
+	 * @struct ObjAttributes
+	 * @brief Vertex attributes of a whole OBJ file.
+	 */
+	struct ObjAttributes
+	{
+		/** Positions (Three floats each.) */
+		std::vector<float> positions = {};
+
+		/** UVs (Two floats each.) */
+		std::vector<float> uvs = {};
+
+		/** Normals (Three floats each.) */
+		std::vector<float> normals = {};
+	};
+
+	/**
+	 * @brief Check if a character separates tokens on a line.
+	 * @param Character.
+	 * @return If the character is a space or tab.
+	 */
+	static inline bool isSpace(char c)
+	{
+		return c == ' ' || c == '\t';
+	}
+
+	/**
+	 * @brief Check if a character ends a token.
+	 * @param Character.
+	 * @return If the character is a space, tab or carriage return.
+	 */
+	static inline bool isTokenEnd(char c)
+	{
+		return isSpace(c) || c == '\r';
+	}
+
+	/**
+	 * @brief Check if a character is a decimal digit.
+	 * @param Character.
+	 * @return If the character is a digit.
+	 */
+	static inline bool isDigit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	/**
+	 * @brief Parse a real number the same way tinyobjloader does, so files load to the same bits.
+	 * @param First character of the number.
+	 * @param One past the last character of the number.
+	 * @param Value (Unchanged if the number is malformed.)
+	 */
+	static void parseDouble(const char* s, const char* end, double& value)
+	{
+		double mantissa = 0.0;
+		int exponent = 0;
+		bool negative = false;
+
+		if (s == end)
+			return;
+
+		// Sign
+		if (*s == '+' || *s == '-')
+			negative = *(s++) == '-';
+		else if (!isDigit(*s))
+			return;
+
+		// Integer part
+		const char* digits = s;
+		for (; s != end && isDigit(*s); ++s)
+			mantissa = mantissa * 10 + static_cast<int>(*s - '0');
+
+		if (s == digits)
+			return;
+
+		// Fractional part
+		if (s != end && *s == '.')
+		{
+			static const double powers[] = { 1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001, 0.0000001 };
+			int read = 1;
+
+			for (++s; s != end && isDigit(*s); ++s, ++read)
+				mantissa += static_cast<int>(*s - '0') * (read < 8 ? powers[read] : std::pow(10.0, -read));
+		}
+
+		// Exponent
+		if (s != end && (*s == 'e' || *s == 'E'))
+		{
+			++s;
+			bool negativeExponent = false;
+
+			if (s != end && (*s == '+' || *s == '-'))
+				negativeExponent = *(s++) == '-';
+
+			// Empty exponents are malformed
+			if (s == end || !isDigit(*s))
+				return;
+
+			for (; s != end && isDigit(*s); ++s)
+				exponent = exponent * 10 + static_cast<int>(*s - '0');
+
+			if (negativeExponent)
+				exponent = -exponent;
+		}
+
+		value = (negative ? -1 : 1) * (exponent ? std::ldexp(mantissa * std::pow(5.0, exponent), exponent) : mantissa);
+	}
+
+	/**
+	 * @brief Parse the next real number on a line.
+	 * @param Position on the line (Moved past the number.)
+	 * @param End of the line.
+	 * @return Number (Zero if missing or malformed.)
+	 */
+	static float parseReal(const char*& s, const char* end)
+	{
+		while (s != end && isSpace(*s))
+			++s;
+
+		const char* tokenEnd = s;
+		while (tokenEnd != end && !isTokenEnd(*tokenEnd))
+			++tokenEnd;
+
+		double value = 0.0;
+		parseDouble(s, tokenEnd, value);
+
+		s = tokenEnd;
+		return static_cast<float>(value);
+	}
+
+	/**
+	 * @brief Parse an index of a face corner.
+	 * @param Position on the line (Moved to the next '/' or the end of the corner.)
+	 * @param End of the line.
+	 * @param Number of elements parsed so far in the chunk.
+	 * @param Set if the index is relative to the chunk.
+	 * @return Zero based index.
+	 */
+	static int32_t parseIndex(const char*& s, const char* end, size_t count, bool& relative)
+	{
+		// Same as atoi
+		bool negative = false;
+		int32_t index = 0;
+
+		if (s != end && (*s == '+' || *s == '-'))
+			negative = *(s++) == '-';
+
+		for (; s != end && isDigit(*s); ++s)
+			index = index * 10 + static_cast<int32_t>(*s - '0');
+
+		while (s != end && *s != '/' && !isTokenEnd(*s))
+			++s;
+
+		if (negative)
+			index = -index;
+
+		// Negative indices count back from the last element
+		if (index < 0)
+		{
+			relative = true;
+			return static_cast<int32_t>(count) + index;
+		}
+
+		return index > 0 ? index - 1 : 0;
+	}
+
+	/**
+	 * @brief Parse a line of an OBJ file.
+	 * @param Chunk to add records to.
+	 * @param First character of the line.
+	 * @param End of the line.
+	 * @param Scratch space for face corners.
+	 * @param Scratch space for which corner attributes are relative.
+	 */
+	static void parseLine
+	(
+		ObjChunk& chunk,
+		const char* s,
+		const char* end,
+		std::vector<ObjCorner>& face,
+		std::vector<std::array<bool, 3>>& faceRelative
+	)
+	{
+		while (s != end && isSpace(*s))
+			++s;
+
+		if (end - s < 2)
+			return;
+
+		// Position
+		if (s[0] == 'v' && isSpace(s[1]))
+		{
+			s += 2;
+			chunk.positions.push_back(parseReal(s, end));
+			chunk.positions.push_back(parseReal(s, end));
+			chunk.positions.push_back(parseReal(s, end));
+		}
+
+		// Normal
+		else if (s[0] == 'v' && s[1] == 'n' && end - s > 2 && isSpace(s[2]))
+		{
+			s += 3;
+			chunk.normals.push_back(parseReal(s, end));
+			chunk.normals.push_back(parseReal(s, end));
+			chunk.normals.push_back(parseReal(s, end));
+		}
+
+		// UV
+		else if (s[0] == 'v' && s[1] == 't' && end - s > 2 && isSpace(s[2]))
+		{
+			s += 3;
+			chunk.uvs.push_back(parseReal(s, end));
+			chunk.uvs.push_back(parseReal(s, end));
+		}
+
+		// Face
+		else if (s[0] == 'f' && isSpace(s[1]))
+		{
+			s += 2;
+			face.clear();
+			faceRelative.clear();
+
+			while (true)
+			{
+				while (s != end && isTokenEnd(*s))
+					++s;
+
+				if (s == end)
+					break;
+
+				ObjCorner corner = { -1, -1, -1 };
+				std::array<bool, 3> relative = { false, false, false };
+
+				// v, v/vt, v//vn or v/vt/vn
+				corner[0] = parseIndex(s, end, chunk.positions.size() / 3, relative[0]);
+
+				if (s != end && *s == '/')
+				{
+					++s;
+
+					if (s != end && *s == '/')
+					{
+						++s;
+						corner[2] = parseIndex(s, end, chunk.normals.size() / 3, relative[2]);
+					}
+					else
+					{
+						corner[1] = parseIndex(s, end, chunk.uvs.size() / 2, relative[1]);
+
+						if (s != end && *s == '/')
+						{
+							++s;
+							corner[2] = parseIndex(s, end, chunk.normals.size() / 3, relative[2]);
+						}
+					}
+				}
+
+				// Skip anything else in the corner
+				while (s != end && !isTokenEnd(*s))
+					++s;
+
+				face.push_back(corner);
+				faceRelative.push_back(relative);
+			}
+
+			// Triangle fan
+			for (size_t i = 2; i < face.size(); ++i)
+				for (size_t j : { static_cast<size_t>(0), i - 1, i })
+				{
+					for (size_t k = 0; k < 3; ++k)
+						if (faceRelative[j][k])
+							chunk.relativeIndices.push_back(static_cast<uint32_t>(chunk.corners.size() * 3 + k));
+
+					chunk.corners.push_back(face[j]);
+				}
+		}
+	}
+
+	/**
+	 * @brief Parse every line of a chunk.
+	 * @param Chunk.
+	 */
+	static void parseChunk(ObjChunk& chunk)
+	{
+		std::vector<ObjCorner> face = {};
+		std::vector<std::array<bool, 3>> faceRelative = {};
+
+		const char* s = chunk.begin;
+
+		while (s < chunk.end)
+		{
+			const char* lineEnd = static_cast<const char*>(std::memchr(s, '\n', chunk.end - s));
+
+			if (lineEnd == nullptr)
+				lineEnd = chunk.end;
+
+			parseLine(chunk, s, lineEnd, face, faceRelative);
+
+			s = lineEnd + 1;
+		}
+	}
+
+	/**
+	 * @brief Check if an index refers to an element.
+	 * @param Zero based index.
+	 * @param Number of elements.
+	 * @return If the index is in range.
+	 */
+	static inline bool isIndexValid(int32_t index, size_t count)
+	{
+		return index >= 0 && static_cast<size_t>(index) < count;
+	}
+
+	/**
+	 * @brief Build the vertex of a face corner.
+	 * @param Vertex attributes.
+	 * @param Face corner.
+	 * @return Vertex (Tangent is left at zero.)
+	 */
+	static Vertex getCornerVertex(const ObjAttributes& attributes, const ObjCorner& corner)
+	{
+		Vertex vertex = {};
+
+		// Get position
+		vertex.position =
+		{
+			attributes.positions[3 * corner[0] + 0],
+			attributes.positions[3 * corner[0] + 1],
+			attributes.positions[3 * corner[0] + 2]
+		};
+
+		// Get UV
+		if (corner[1] >= 0)
+			vertex.uv =
+		{
+			attributes.uvs[2 * corner[1] + 0],
+			1.0f - attributes.uvs[2 * corner[1] + 1]
+		};
+
+		// Get normal
+		if (corner[2] >= 0)
+			vertex.normal =
+		{
+			attributes.normals[3 * corner[2] + 0],
+			attributes.normals[3 * corner[2] + 1],
+			attributes.normals[3 * corner[2] + 2]
+		};
+
+		return vertex;
+	}
+
+	/**
+	 * @brief Get the bits of a vertices position, UV and normal.
+	 * @param Vertex.
+	 * @return Vertex bits.
+	 */
+	static VertexBits getVertexBits(const Vertex& vertex)
+	{
+		VertexBits bits = {};
+		std::memcpy(&bits[0], &vertex.position, sizeof(glm::vec3));
+		std::memcpy(&bits[3], &vertex.uv, sizeof(glm::vec2));
+		std::memcpy(&bits[5], &vertex.normal, sizeof(glm::vec3));
+		return bits;
+	}
+
+	/**
+	 * @brief Hash vertex bits.
+	 * @param Vertex bits.
+	 * @return Hash.
+	 */
+	static uint64_t hashVertexBits(const VertexBits& bits)
+	{
+		// FNV-1a over each word
+		uint64_t hash = 14695981039346656037ull;
+
+		for (uint32_t word : bits)
+		{
+			hash ^= word;
+			hash *= 1099511628211ull;
+		}
+
+		// Mix the high bits into the low bits used for the slot
+		return hash ^ (hash >> 29);
+	}
+
+	bool loadOBJ(const std::string& path, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, ThreadPool* threadPool)
+	{
+		vertices.clear();
+		indices.clear();
+
+		const MappedFile file(path);
+
+		if (!file.isOpen())
+		{
+			gLog("Unable to open OBJ file " << path << ".\n");
+			return false;
+		}
+
+		const size_t workerCount = threadPool ? threadPool->getWorkerCount() : 1;
+		const size_t jobCount = std::max<size_t>(workerCount * GUST_OBJ_JOBS_PER_WORKER, 1);
+
+		// Split into line aligned chunks
+		const size_t chunkCount = threadPool ? std::max<size_t>(std::min(file.getSize() / GUST_OBJ_MIN_CHUNK_SIZE, jobCount), 1) : 1;
+		std::vector<ObjChunk> chunks(chunkCount);
+
+		const char* fileEnd = file.getData() + file.getSize();
+		const char* begin = file.getData();
+
+		for (size_t i = 0; i < chunkCount; ++i)
+		{
+			const char* end = i == chunkCount - 1 ? fileEnd : std::max(begin, file.getData() + file.getSize() * (i + 1) / chunkCount);
+
+			// Finish the line
+			const char* newLine = static_cast<const char*>(std::memchr(end, '\n', fileEnd - end));
+			end = newLine ? newLine + 1 : fileEnd;
+
+			chunks[i].begin = begin;
+			chunks[i].end = end;
+			begin = end;
+		}
+
+		// Parse records
+		runJobs(threadPool, chunkCount, [&chunks](size_t i)
+		{
+			parseChunk(chunks[i]);
+		});
+
+		// Place each chunks records after the previous chunks
+		std::array<size_t, 4> totals = {};
+
+		for (ObjChunk& chunk : chunks)
+		{
+			chunk.first = totals;
+			chunk.cornerCount = chunk.corners.size();
+			totals[0] += chunk.positions.size() / 3;
+			totals[1] += chunk.uvs.size() / 2;
+			totals[2] += chunk.normals.size() / 3;
+			totals[3] += chunk.cornerCount;
+		}
+
+		if (totals[3] >= std::numeric_limits<uint32_t>::max() || totals[0] >= static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+		{
+			gLog("OBJ file " << path << " is too large.\n");
+			return false;
+		}
+
+		// Gather attributes and corners
+		ObjAttributes attributes = {};
+		attributes.positions.resize(totals[0] * 3);
+		attributes.uvs.resize(totals[1] * 2);
+		attributes.normals.resize(totals[2] * 3);
+		std::vector<ObjCorner> corners(totals[3]);
+
+		runJobs(threadPool, chunkCount, [&chunks, &attributes, &corners](size_t i)
+		{
+			ObjChunk& chunk = chunks[i];
+
+			// Resolve relative indices
+			for (uint32_t relative : chunk.relativeIndices)
+				chunk.corners[relative / 3][relative % 3] += static_cast<int32_t>(chunk.first[relative % 3]);
+
+			std::copy(chunk.positions.begin(), chunk.positions.end(), attributes.positions.begin() + chunk.first[0] * 3);
+			std::copy(chunk.uvs.begin(), chunk.uvs.end(), attributes.uvs.begin() + chunk.first[1] * 2);
+			std::copy(chunk.normals.begin(), chunk.normals.end(), attributes.normals.begin() + chunk.first[2] * 3);
+			std::copy(chunk.corners.begin(), chunk.corners.end(), corners.begin() + chunk.first[3]);
+
+			chunk.positions = {};
+			chunk.uvs = {};
+			chunk.normals = {};
+			chunk.corners = {};
+		});
+
+		// Split corners by hash, so each partition can be deduplicated on its own
+		const size_t partitionCount = threadPool ? jobCount : 1;
+		size_t partitionBits = 0;
+
+		while ((static_cast<size_t>(1) << partitionBits) < partitionCount)
+			++partitionBits;
+
+		runJobs(threadPool, chunkCount, [&chunks, &attributes, &corners, &totals, partitionBits](size_t i)
+		{
+			ObjChunk& chunk = chunks[i];
+			chunk.partitions.resize(static_cast<size_t>(1) << partitionBits);
+
+			for (size_t j = chunk.first[3]; j < chunk.first[3] + chunk.cornerCount; ++j)
+			{
+				const ObjCorner& corner = corners[j];
+
+				if
+				(
+					!isIndexValid(corner[0], totals[0]) ||
+					(corner[1] != -1 && !isIndexValid(corner[1], totals[1])) ||
+					(corner[2] != -1 && !isIndexValid(corner[2], totals[2]))
+				)
+				{
+					chunk.error = "has a face index out of range";
+					return;
+				}
+
+				const uint64_t hash = hashVertexBits(getVertexBits(getCornerVertex(attributes, corner)));
+				const size_t partition = partitionBits > 0 ? static_cast<size_t>(hash >> (64 - partitionBits)) : 0;
+				chunk.partitions[partition].push_back(static_cast<uint32_t>(j));
+			}
+		});
+
+		for (const ObjChunk& chunk : chunks)
+			if (!chunk.error.empty())
+			{
+				gLog("OBJ file " << path << " " << chunk.error << ".\n");
+				return false;
+			}
+
+		// Find the first corner with the same bits as each corner
+		std::vector<uint32_t> representatives(corners.size());
+
+		runJobs(threadPool, static_cast<size_t>(1) << partitionBits, [&chunks, &corners, &attributes, &representatives](size_t partition)
+		{
+			size_t cornerCount = 0;
+			for (const ObjChunk& chunk : chunks)
+				cornerCount += chunk.partitions[partition].size();
+
+			// Open addressing table of representative corners (At most half full)
+			const uint32_t emptySlot = std::numeric_limits<uint32_t>::max();
+			size_t slotCount = 16;
+
+			while (slotCount < cornerCount * 2)
+				slotCount *= 2;
+
+			std::vector<uint32_t> slots(slotCount, emptySlot);
+			std::vector<VertexBits> uniqueBits = {};
+			std::vector<uint32_t> uniqueCorners = {};
+
+			// Chunks are in file order, so the first corner found is the first in the file
+			for (const ObjChunk& chunk : chunks)
+				for (uint32_t corner : chunk.partitions[partition])
+				{
+					// Probe for a vertex with the same bits
+					const VertexBits bits = getVertexBits(getCornerVertex(attributes, corners[corner]));
+					size_t slot = hashVertexBits(bits) & (slotCount - 1);
+
+					while (slots[slot] != emptySlot && uniqueBits[slots[slot]] != bits)
+						slot = (slot + 1) & (slotCount - 1);
+
+					// First time seeing the vertex
+					if (slots[slot] == emptySlot)
+					{
+						slots[slot] = static_cast<uint32_t>(uniqueBits.size());
+						uniqueBits.push_back(bits);
+						uniqueCorners.push_back(corner);
+					}
+
+					representatives[corner] = uniqueCorners[slots[slot]];
+				}
+		});
+
+		// Number vertices in the order they first appear
+		runJobs(threadPool, chunkCount, [&chunks, &representatives](size_t i)
+		{
+			for (size_t j = chunks[i].first[3]; j < chunks[i].first[3] + chunks[i].cornerCount; ++j)
+				if (representatives[j] == j)
+					++chunks[i].newVertexCount;
+		});
+
+		size_t vertexCount = 0;
+		for (ObjChunk& chunk : chunks)
+		{
+			chunk.firstVertex = vertexCount;
+			vertexCount += chunk.newVertexCount;
+		}
+
+		vertices.resize(vertexCount);
+		indices.resize(corners.size());
+
+		runJobs(threadPool, chunkCount, [&chunks, &corners, &attributes, &representatives, &vertices, &indices](size_t i)
+		{
+			uint32_t vertex = static_cast<uint32_t>(chunks[i].firstVertex);
+
+			for (size_t j = chunks[i].first[3]; j < chunks[i].first[3] + chunks[i].cornerCount; ++j)
+				if (representatives[j] == j)
+				{
+					vertices[vertex] = getCornerVertex(attributes, corners[j]);
+					indices[j] = vertex++;
+				}
+		});
+
+		// Other corners use their representatives vertex (Numbered by the previous pass)
+		runJobs(threadPool, chunkCount, [&chunks, &representatives, &indices](size_t i)
+		{
+			for (size_t j = chunks[i].first[3]; j < chunks[i].first[3] + chunks[i].cornerCount; ++j)
+				if (representatives[j] != j)
+					indices[j] = indices[representatives[j]];
+		});
+
+		return true;
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+/**
+ * @file ObjLoader.hpp
+ * @brief OBJ loader header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/** Includes. */
+#include <string>
+#include <vector>
+#include <Threading.hpp>
+#include "Mesh.hpp"
+
+namespace gust
+{
+	/**
+	 * @brief Load the vertices and triangle indices of an OBJ file.
+	 * @param Path to the OBJ file.
+	 * @param Vertices (Tangents are left at zero.)
+	 * @param Triangle indices.
+	 * @param Thread pool to parse with (Parsed on the calling thread when null.)
+	 * @return If the file was loaded (Vertices and indices are left empty if not.)
+	 * @note The file is memory mapped and split into line aligned chunks. Chunks are parsed in parallel,
+	 * then deduplicated in parallel by splitting vertices into partitions by hash.
+	 * @note Vertices with the exact same position, UV and normal bits are merged, and are numbered in the
+	 * order they first appear regardless of the number of threads.
+	 * @note Polygons are triangulated as fans. Materials, groups and other records are ignored.
+	 */
+	extern bool loadOBJ
+	(
+		const std::string& path,
+		std::vector<Vertex>& vertices,
+		std::vector<uint32_t>& indices,
+		ThreadPool* threadPool = nullptr
+	);
+}
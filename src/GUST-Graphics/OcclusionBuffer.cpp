@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "OcclusionBuffer.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#include <xmmintrin.h>
+	#define GUST_OCCLUSION_SSE
+#endif
+
+namespace gust
+{
+	OcclusionBuffer::OcclusionBuffer(uint32_t width, uint32_t height) :
+		m_width(width),
+		m_height(height),
+		m_stride((width + 3) & ~3u)
+	{
+		m_depth.resize(static_cast<size_t>(m_stride) * m_height, 1.0f);
+
+		// Allocate Hi-Z levels
+		uint32_t levelWidth = m_width;
+		uint32_t levelHeight = m_height;
+
+		while (true)
+		{
+			Level level = {};
+			level.width = levelWidth;
+			level.height = levelHeight;
+			level.depth.resize(static_cast<size_t>(levelWidth) * levelHeight, 1.0f);
+			m_levels.push_back(std::move(level));
+
+			if (levelWidth == 1 && levelHeight == 1)
+				break;
+
+			levelWidth = std::max(levelWidth / 2, 1u);
+			levelHeight = std::max(levelHeight / 2, 1u);
+		}
+	}
+
+	void OcclusionBuffer::clear()
+	{
+		std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+	}
+
+	void OcclusionBuffer::rasterize
+	(
+		const glm::vec4* positions,
+		const uint32_t* indices,
+		size_t indexCount,
+		uint32_t rowBegin,
+		uint32_t rowEnd
+	)
+	{
+		const float halfWidth = m_width * 0.5f;
+		const float halfHeight = m_height * 0.5f;
+		rowEnd = std::min(rowEnd, m_height);
+
+		for (size_t i = 0; i + 2 < indexCount; i += 3)
+		{
+			glm::vec3 v[3];
+			bool skip = false;
+
+			// Project to screen space
+			for (size_t j = 0; j < 3; ++j)
+			{
+				const glm::vec4& clip = positions[indices[i + j]];
+
+				if (clip.w < 1e-5f)
+				{
+					skip = true;
+					break;
+				}
+
+				const float invW = 1.0f / clip.w;
+				v[j] = glm::vec3((clip.x * invW + 1.0f) * halfWidth, (clip.y * invW + 1.0f) * halfHeight, clip.z * invW);
+
+				if (v[j].z < 0.0f)
+				{
+					skip = true;
+					break;
+				}
+			}
+
+			if (skip)
+				continue;
+
+			// Orient the triangle so the area is positive (Occluders are two sided)
+			float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+
+			if (area == 0.0f)
+				continue;
+
+			if (area < 0.0f)
+			{
+				std::swap(v[1], v[2]);
+				area = -area;
+			}
+
+			// Bounding rectangle clipped to the buffer and row range
+			const int32_t minX = std::max(static_cast<int32_t>(std::floor(std::min(v[0].x, std::min(v[1].x, v[2].x)))), 0);
+			const int32_t maxX = std::min(static_cast<int32_t>(std::ceil(std::max(v[0].x, std::max(v[1].x, v[2].x)))), static_cast<int32_t>(m_width) - 1);
+			const int32_t minY = std::max(static_cast<int32_t>(std::floor(std::min(v[0].y, std::min(v[1].y, v[2].y)))), static_cast<int32_t>(rowBegin));
+			const int32_t maxY = std::min(static_cast<int32_t>(std::ceil(std::max(v[0].y, std::max(v[1].y, v[2].y)))), static_cast<int32_t>(rowEnd) - 1);
+
+			if (minX > maxX || minY > maxY)
+				continue;
+
+			// Edge functions (w = A * x + B * y + C) weighting the opposite vertex
+			float edgeA[3], edgeB[3], edgeC[3];
+			for (size_t j = 0; j < 3; ++j)
+			{
+				const glm::vec3& a = v[(j + 1) % 3];
+				const glm::vec3& b = v[(j + 2) % 3];
+				edgeA[j] = a.y - b.y;
+				edgeB[j] = b.x - a.x;
+				edgeC[j] = a.x * b.y - a.y * b.x;
+			}
+
+			// Depth plane
+			const float invArea = 1.0f / area;
+			const float depthA = (edgeA[0] * v[0].z + edgeA[1] * v[1].z + edgeA[2] * v[2].z) * invArea;
+			const float depthB = (edgeB[0] * v[0].z + edgeB[1] * v[1].z + edgeB[2] * v[2].z) * invArea;
+			const float depthC = (edgeC[0] * v[0].z + edgeC[1] * v[1].z + edgeC[2] * v[2].z) * invArea;
+
+			for (int32_t y = minY; y <= maxY; ++y)
+			{
+				const float py = y + 0.5f;
+				float* row = m_depth.data() + static_cast<size_t>(y) * m_stride;
+
+#if defined(GUST_OCCLUSION_SSE)
+				// 4 pixels per iteration
+				const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+				const __m128 zero = _mm_setzero_ps();
+				const __m128 width = _mm_set1_ps(static_cast<float>(m_width));
+
+				__m128 rowEdge[3], stepEdge[3];
+				for (size_t j = 0; j < 3; ++j)
+				{
+					rowEdge[j] = _mm_set1_ps(edgeB[j] * py + edgeC[j]);
+					stepEdge[j] = _mm_set1_ps(edgeA[j]);
+				}
+
+				const __m128 rowDepth = _mm_set1_ps(depthB * py + depthC);
+				const __m128 stepDepth = _mm_set1_ps(depthA);
+
+				for (int32_t x = minX & ~3; x <= maxX; x += 4)
+				{
+					const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+
+					const __m128 w0 = _mm_add_ps(_mm_mul_ps(stepEdge[0], px), rowEdge[0]);
+					const __m128 w1 = _mm_add_ps(_mm_mul_ps(stepEdge[1], px), rowEdge[1]);
+					const __m128 w2 = _mm_add_ps(_mm_mul_ps(stepEdge[2], px), rowEdge[2]);
+
+					__m128 mask = _mm_and_ps(_mm_cmpge_ps(w0, zero), _mm_cmpge_ps(w1, zero));
+					mask = _mm_and_ps(mask, _mm_cmpge_ps(w2, zero));
+					mask = _mm_and_ps(mask, _mm_cmplt_ps(px, width));
+
+					if (_mm_movemask_ps(mask) == 0)
+						continue;
+
+					// Keep the nearest depth
+					const __m128 depth = _mm_add_ps(_mm_mul_ps(stepDepth, px), rowDepth);
+					const __m128 old = _mm_loadu_ps(row + x);
+					const __m128 nearest = _mm_min_ps(old, depth);
+					_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(mask, nearest), _mm_andnot_ps(mask, old)));
+				}
+#else
+				for (int32_t x = minX; x <= maxX; ++x)
+				{
+					const float px = x + 0.5f;
+					const float w0 = edgeA[0] * px + edgeB[0] * py + edgeC[0];
+					const float w1 = edgeA[1] * px + edgeB[1] * py + edgeC[1];
+					const float w2 = edgeA[2] * px + edgeB[2] * py + edgeC[2];
+
+					if (w0 < 0 || w1 < 0 || w2 < 0)
+						continue;
+
+					const float depth = depthA * px + depthB * py + depthC;
+					row[x] = std::min(row[x], depth);
+				}
+#endif
+			}
+		}
+	}
+
+	void OcclusionBuffer::buildHiZ()
+	{
+		// Level 0 is a copy of the depth buffer without padding
+		for (uint32_t y = 0; y < m_height; ++y)
+			std::copy
+			(
+				m_depth.begin() + static_cast<size_t>(y) * m_stride,
+				m_depth.begin() + static_cast<size_t>(y) * m_stride + m_width,
+				m_levels[0].depth.begin() + static_cast<size_t>(y) * m_width
+			);
+
+		// Every other level stores the farthest depth of the level below
+		for (size_t i = 1; i < m_levels.size(); ++i)
+		{
+			const Level& source = m_levels[i - 1];
+			Level& level = m_levels[i];
+
+			for (uint32_t y = 0; y < level.height; ++y)
+				for (uint32_t x = 0; x < level.width; ++x)
+				{
+					const uint32_t x0 = std::min(x * 2, source.width - 1);
+					const uint32_t x1 = std::min(x * 2 + 1, source.width - 1);
+					const uint32_t y0 = std::min(y * 2, source.height - 1);
+					const uint32_t y1 = std::min(y * 2 + 1, source.height - 1);
+
+					float depth = std::max(source.depth[y0 * source.width + x0], source.depth[y0 * source.width + x1]);
+					depth = std::max(depth, std::max(source.depth[y1 * source.width + x0], source.depth[y1 * source.width + x1]));
+
+					// Odd sizes fold the last row/column into the final texel
+					if (x == level.width - 1 && source.width > x1 + 1)
+						for (uint32_t yy = y0; yy <= y1; ++yy)
+							depth = std::max(depth, source.depth[yy * source.width + source.width - 1]);
+
+					if (y == level.height - 1 && source.height > y1 + 1)
+						for (uint32_t xx = x0; xx <= x1; ++xx)
+							depth = std::max(depth, source.depth[(source.height - 1) * source.width + xx]);
+
+					if (x == level.width - 1 && y == level.height - 1 && source.width > x1 + 1 && source.height > y1 + 1)
+						depth = std::max(depth, source.depth[(source.height - 1) * source.width + source.width - 1]);
+
+					level.depth[y * level.width + x] = depth;
+				}
+		}
+	}
+
+	bool OcclusionBuffer::isVisible(const AABB& box, const glm::mat4& viewProjection) const
+	{
+		glm::vec3 minimum = glm::vec3(std::numeric_limits<float>::max());
+		glm::vec3 maximum = glm::vec3(-std::numeric_limits<float>::max());
+
+		// Project every corner
+		for (int i = 0; i < 8; ++i)
+		{
+			const glm::vec4 corner = glm::vec4
+			(
+				(i & 1) ? box.max.x : box.min.x,
+				(i & 2) ? box.max.y : box.min.y,
+				(i & 4) ? box.max.z : box.min.z,
+				1.0f
+			);
+
+			const glm::vec4 clip = viewProjection * corner;
+
+			// Crosses the near plane
+			if (clip.w < 1e-5f)
+				return true;
+
+			const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+			minimum = glm::min(minimum, ndc);
+			maximum = glm::max(maximum, ndc);
+		}
+
+		if (minimum.z < 0.0f)
+			return true;
+
+		// Screen space rectangle
+		const float x0 = (minimum.x + 1.0f) * m_width * 0.5f;
+		const float x1 = (maximum.x + 1.0f) * m_width * 0.5f;
+		const float y0 = (minimum.y + 1.0f) * m_height * 0.5f;
+		const float y1 = (maximum.y + 1.0f) * m_height * 0.5f;
+
+		// Off screen boxes are left to frustum culling
+		if (x1 < 0 || y1 < 0 || x0 >= m_width || y0 >= m_height)
+			return true;
+
+		int32_t minX = std::max(static_cast<int32_t>(x0), 0);
+		int32_t maxX = std::min(static_cast<int32_t>(x1), static_cast<int32_t>(m_width) - 1);
+		int32_t minY = std::max(static_cast<int32_t>(y0), 0);
+		int32_t maxY = std::min(static_cast<int32_t>(y1), static_cast<int32_t>(m_height) - 1);
+
+		// Pick the finest level where the rectangle covers at most 4x4 texels
+		size_t levelIndex = 0;
+		while ((maxX - minX > 3 || maxY - minY > 3) && levelIndex + 1 < m_levels.size())
+		{
+			minX >>= 1;
+			maxX >>= 1;
+			minY >>= 1;
+			maxY >>= 1;
+			++levelIndex;
+		}
+
+		const Level& level = m_levels[levelIndex];
+		minX = std::min(minX, static_cast<int32_t>(level.width) - 1);
+		maxX = std::min(maxX, static_cast<int32_t>(level.width) - 1);
+		minY = std::min(minY, static_cast<int32_t>(level.height) - 1);
+		maxY = std::min(maxY, static_cast<int32_t>(level.height) - 1);
+
+		// Farthest occluder depth under the rectangle
+		float depth = 0.0f;
+		for (int32_t y = minY; y <= maxY; ++y)
+			for (int32_t x = minX; x <= maxX; ++x)
+				depth = std::max(depth, level.depth[y * level.width + x]);
+
+		return minimum.z <= depth;
+	}
+}
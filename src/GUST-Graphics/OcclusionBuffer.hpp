@@ -0,0 +1,143 @@
+#pragma once
+
+/**
+ * @file OcclusionBuffer.hpp
+ * @brief Occlusion buffer header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/**
+ * @def GUST_OCCLUSION_BUFFER_WIDTH
+ * @brief Width of the software depth buffer used for occlusion culling.
+ */
+#define GUST_OCCLUSION_BUFFER_WIDTH 256
+
+/**
+ * @def GUST_OCCLUSION_BUFFER_HEIGHT
+ * @brief Height of the software depth buffer used for occlusion culling.
+ */
+#define GUST_OCCLUSION_BUFFER_HEIGHT 144
+
+/** Includes. */
+#include <vector>
+#include <cstdint>
+#include <Bounds.hpp>
+
+namespace gust
+{
+	/**
+	 * @class OcclusionBuffer
+	 * @brief Low resolution software depth buffer with a hierarchical (Hi-Z) max depth chain.
+	 * @note Depth is zero to one with zero being nearest. Occluders write their nearest depth
+	 * and each Hi-Z level stores the farthest depth of the 2x2 texels below it, so tests are conservative.
+	 */
+	class OcclusionBuffer
+	{
+	public:
+
+		/**
+		 * @brief Default constructor.
+		 */
+		OcclusionBuffer() = default;
+
+		/**
+		 * @brief Constructor.
+		 * @param Width.
+		 * @param Height.
+		 */
+		OcclusionBuffer(uint32_t width, uint32_t height);
+
+		/**
+		 * @brief Default destructor.
+		 */
+		~OcclusionBuffer() = default;
+
+		/**
+		 * @brief Get width.
+		 * @return Width.
+		 */
+		inline uint32_t getWidth() const
+		{
+			return m_width;
+		}
+
+		/**
+		 * @brief Get height.
+		 * @return Height.
+		 */
+		inline uint32_t getHeight() const
+		{
+			return m_height;
+		}
+
+		/**
+		 * @brief Reset every texel to the far plane.
+		 */
+		void clear();
+
+		/**
+		 * @brief Rasterize triangles into a range of rows.
+		 * @param Clip space vertex positions.
+		 * @param Triangle indices.
+		 * @param Number of indices.
+		 * @param First row to write to.
+		 * @param One past the last row to write to.
+		 * @note Different row ranges can be rasterized concurrently.
+		 * @note Triangles crossing the near plane are skipped (Which is conservative.)
+		 */
+		void rasterize
+		(
+			const glm::vec4* positions,
+			const uint32_t* indices,
+			size_t indexCount,
+			uint32_t rowBegin,
+			uint32_t rowEnd
+		);
+
+		/**
+		 * @brief Build the Hi-Z chain from the depth buffer.
+		 */
+		void buildHiZ();
+
+		/**
+		 * @brief Check if a box may be visible.
+		 * @param World space box.
+		 * @param View projection matrix the occluders were rasterized with.
+		 * @return False if the box is entirely behind occluders.
+		 */
+		bool isVisible(const AABB& box, const glm::mat4& viewProjection) const;
+
+	private:
+
+		/**
+		 * @struct Level
+		 * @brief Level of the Hi-Z chain.
+		 */
+		struct Level
+		{
+			/** Width. */
+			uint32_t width = 0;
+
+			/** Height. */
+			uint32_t height = 0;
+
+			/** Depth values. */
+			std::vector<float> depth = {};
+		};
+
+		/** Width. */
+		uint32_t m_width = 0;
+
+		/** Height. */
+		uint32_t m_height = 0;
+
+		/** Row stride (Width rounded up to a multiple of 4.) */
+		uint32_t m_stride = 0;
+
+		/** Depth buffer. */
+		std::vector<float> m_depth = {};
+
+		/** Hi-Z levels (Level 0 is the full resolution buffer.) */
+		std::vector<Level> m_levels = {};
+	};
+}
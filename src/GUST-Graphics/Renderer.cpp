@@ -1,9 +1,28 @@
+#include <algorithm>
 #include <FileIO.hpp>
 #include <iostream>
 #include "Renderer.hpp"
 
 namespace gust
 {
+	/**
+	 * @brief Copy the dequantization of a meshes positions into per draw data.
+	 * @param Per draw data (InstanceData or VertexShaderData.)
+	 * @param Mesh being drawn.
+	 * @note Does nothing unless vertices are compressed.
+	 */
+	template<typename T>
+	static void setPositionQuantization(T& data, Handle<Mesh> mesh)
+	{
+#ifdef GUST_COMPRESSED_VERTICES
+		data.positionScale = glm::vec4(mesh->getPositionScale(), 0.0f);
+		data.positionBias = glm::vec4(mesh->getPositionBias(), 0.0f);
+#else
+		(void)data;
+		(void)mesh;
+#endif
+	}
+
 	void Renderer::startup
 	(
 		Graphics* graphics,
@@ -17,30 +36,62 @@ namespace gust
 		m_cameraAllocator = std::make_unique<ResourceAllocator<VirtualCamera>>(10);
 		m_meshAllocator = meshAllocator;
 		m_textureAllocator = textureAllocator;
+		m_occlusionBuffer = OcclusionBuffer(GUST_OCCLUSION_BUFFER_WIDTH, GUST_OCCLUSION_BUFFER_HEIGHT);
+		m_uniformRing = std::make_unique<UniformRingBuffer>(graphics, GUST_UNIFORM_RING_FRAME_SIZE, GUST_FRAMES_IN_FLIGHT);
+		m_instanceRing = std::make_unique<UniformRingBuffer>
+		(
+			graphics, 
+			GUST_INSTANCE_RING_FRAME_SIZE, 
+			GUST_FRAMES_IN_FLIGHT, 
+			graphics->isBindless() ? 
+				vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eStorageBuffer :
+				vk::BufferUsageFlagBits::eVertexBuffer
+		);
+
+		// Cull and build draws on the GPU when supported (Culling stays on the CPU if the shader wasn't built)
+		if (graphics->isGpuCulling() && fileExists(GUST_CULLING_COMPUTE_SHADER_PATH))
+		{
+			m_gpuCuller = std::make_unique<GpuCuller>(graphics, GUST_FRAMES_IN_FLIGHT);
+
+			// Meshes with meshlets are culled whole if the meshlet shader wasn't built
+			if (fileExists(GUST_CLUSTER_CULLING_COMPUTE_SHADER_PATH))
+				m_clusterCuller = std::make_unique<ClusterCuller>(graphics, GUST_FRAMES_IN_FLIGHT);
+		}
+
+		// The first cameras keep their per frame data in place so cached draws can reference it
+		for (auto& offsets : m_cameraDataOffsets)
+		{
+			offsets[0] = m_uniformRing->reserve(static_cast<vk::DeviceSize>(sizeof(VertexShaderData)));
+			offsets[1] = m_uniformRing->reserve(static_cast<vk::DeviceSize>(sizeof(FragmentShaderData)));
+		}
 
 		initCommandPools();
 		initRenderPasses();
 		initSwapchain();
 		initDepthResources();
 		initSwapchainBuffers();
-		initSemaphores();
+		initFrames();
 		initLighting();
 		initDescriptorSetLayouts();
 		initDescriptorPool();
 		initDescriptorSets();
 		initShaders();
 		initCommandBuffers();
+
+		// The screen quad and skybox mesh must be uploaded before the first frame
+		m_graphics->getUploadManager().wait(m_graphics->getUploadManager().flush());
 	}
 
 	void Renderer::shutdown()
 	{
 		auto logicalDevice = m_graphics->getLogicalDevice();
 
+		// Wait for frames in flight
+		logicalDevice.waitIdle();
+
 		// Destroy thread pool
 		m_threadPool = nullptr;
 
-		destroyCommandBuffer(m_commands.skybox);
-
 		// Destroy cameras
 		for(size_t i = 0; i < m_cameraAllocator->getMaxResourceCount(); ++i)
 			if (m_cameraAllocator->isAllocated(i))
@@ -74,11 +125,44 @@ namespace gust
 		logicalDevice.destroyPipelineLayout(m_skyboxShader.graphicsPipelineLayout);
 		logicalDevice.destroyPipeline(m_skyboxShader.graphicsPipeline);
 
-		logicalDevice.destroyBuffer(m_lightingUniformBuffer.buffer);
-		logicalDevice.freeMemory(m_lightingUniformBuffer.memory);
+		for (auto& frame : m_frames)
+		{
+			m_graphics->destroyBuffer(frame.lightingUniformBuffer);
+		}
+
+		if (m_gpuCuller)
+		{
+			m_gpuCuller->free();
+			m_gpuCuller = nullptr;
+		}
+
+		if (m_clusterCuller)
+		{
+			m_clusterCuller->free();
+			m_clusterCuller = nullptr;
+		}
+
+		m_uniformRing->free();
+		m_uniformRing = nullptr;
 
-		logicalDevice.destroyBuffer(m_skyboxUniformBuffer.buffer);
-		logicalDevice.freeMemory(m_skyboxUniformBuffer.memory);
+		m_instanceRing->free();
+		m_instanceRing = nullptr;
+
+		// Destroy static draws
+		for (auto& staticDraw : m_staticDraws)
+			for (auto& cachedDraw : staticDraw.cache)
+				if (cachedDraw.commandBuffer.buffer)
+					destroyCommandBuffer(cachedDraw.commandBuffer);
+
+		for (auto& commandBuffers : m_retiredCommandBuffers)
+			for (auto commandBuffer : commandBuffers)
+				destroyCommandBuffer(commandBuffer);
+
+		if (m_staticInstanceBuffer.buffer)
+		{
+			m_graphics->unmapBuffer(m_staticInstanceBuffer);
+			m_graphics->destroyBuffer(m_staticInstanceBuffer);
+		}
 
 		logicalDevice.destroyDescriptorPool(m_descriptors.descriptorPool);
 
@@ -87,6 +171,9 @@ namespace gust
 		logicalDevice.destroyDescriptorSetLayout(m_descriptors.lightingDescriptorSetLayout);
 		logicalDevice.destroyDescriptorSetLayout(m_descriptors.skyboxDescriptorSetLayout);
 
+		if (m_descriptors.bindlessDescriptorSetLayout)
+			logicalDevice.destroyDescriptorSetLayout(m_descriptors.bindlessDescriptorSetLayout);
+
 		for(auto commandBuffer : m_commands.rendering)
 			destroyCommandBuffer(commandBuffer);
 
@@ -94,14 +181,16 @@ namespace gust
 		logicalDevice.destroyRenderPass(m_renderPasses.offscreen);
 		logicalDevice.destroyRenderPass(m_renderPasses.lighting);
 
-		logicalDevice.destroySemaphore(m_semaphores.imageAvailable);
-		logicalDevice.destroySemaphore(m_semaphores.renderFinished);
-		logicalDevice.destroySemaphore(m_semaphores.offscreen);
+		for (auto& frame : m_frames)
+		{
+			logicalDevice.destroySemaphore(frame.imageAvailable);
+			logicalDevice.destroySemaphore(frame.renderFinished);
+			logicalDevice.destroyFence(frame.fence);
+		}
 
 		// Cleanup depth texture
 		logicalDevice.destroyImageView(m_depthTexture.imageView);
-		logicalDevice.destroyImage(m_depthTexture.image);
-		logicalDevice.freeMemory(m_depthTexture.memory);
+		m_graphics->destroyImage(m_depthTexture.image, m_depthTexture.allocation);
 
 		// Destroy framebuffers and views
 		for (auto& buffer : m_swapchain.buffers)
@@ -122,9 +211,69 @@ namespace gust
 	{
 		if (m_mainCamera.getResourceAllocator() && m_mainCamera.get())
 		{
+			FrameData& frame = m_frames[m_frameIndex];
+
+			// Submit uploads made since the last frame and find out which are done
+			m_graphics->getUploadManager().flush();
+
+			// Only block once the GPU is GUST_FRAMES_IN_FLIGHT frames behind
+			m_graphics->getLogicalDevice().waitForFences(1, &frame.fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+
+			// Free command buffers retired after this frame was last submitted
+			for (auto commandBuffer : m_retiredCommandBuffers[m_frameIndex])
+				destroyCommandBuffer(commandBuffer);
+
+			m_retiredCommandBuffers[m_frameIndex].clear();
+
+			// Return mesh geometry no frame in flight can still draw
+			m_graphics->getGeometryPool().beginFrame(GUST_FRAMES_IN_FLIGHT);
+
+			// Start writing per draw data to the frames segment
+			m_uniformRing->beginFrame(m_frameIndex);
+			m_instanceRing->beginFrame(m_frameIndex);
+			m_frameSemaphores.clear();
+
 			// Submit lighting data
 			submitLightingData();
 
+			// Gather mesh bounds for culling
+			m_frameCullingStats = {};
+			m_frameDrawStats = {};
+			m_meshBounds.resize(m_meshes.size());
+
+			for (size_t i = 0; i < m_meshes.size(); ++i)
+				m_meshBounds.set(i, m_meshes[i].bounds);
+
+			// Upload every mesh once for each camera to cull on the GPU
+			// (If the instance ring can't fit them all the frame is culled on the CPU, which only writes visible instances)
+			m_gpuFrame = false;
+
+			if (m_gpuCuller && !m_meshes.empty())
+			{
+				const size_t modelCount = m_meshes.size();
+
+				if (m_instanceRing->allocate(static_cast<vk::DeviceSize>(sizeof(InstanceData) * modelCount), m_gpuModelOffset))
+				{
+					gAssert(m_gpuModelOffset % sizeof(InstanceData) == 0);
+					auto models = static_cast<InstanceData*>(m_instanceRing->getMappedMemory(m_gpuModelOffset));
+
+					for (size_t i = 0; i < modelCount; ++i)
+					{
+						models[i].model = m_meshes[i].model;
+						setPositionQuantization(models[i], m_meshes[i].mesh);
+					}
+
+					// Meshes with meshlets are culled a meshlet at a time and the rest whole
+					if (m_clusterCuller)
+						m_clusterCuller->beginFrame(m_frameIndex, m_meshes, m_clusteredMeshes);
+					else
+						m_clusteredMeshes.clear();
+
+					m_gpuCuller->beginFrame(m_frameIndex, m_meshes, m_clusteredMeshes);
+					m_gpuFrame = true;
+				}
+			}
+
 			// Draw everything to every camera
 			bool drew = false;
 
@@ -144,48 +293,49 @@ namespace gust
 			(
 				m_swapchain.swapchain,
 				std::numeric_limits<uint64_t>::max(),
-				m_semaphores.imageAvailable,
+				frame.imageAvailable,
 				{ nullptr }
 			).value;
 
-			std::array<vk::Semaphore, 2> semaphores =
-			{
-				m_semaphores.imageAvailable,
-				m_semaphores.offscreen
-			};
+			// Wait for the frame still using the image (If there are fewer images than frames in flight)
+			if (m_imageFences[imageIndex] && m_imageFences[imageIndex] != frame.fence)
+				m_graphics->getLogicalDevice().waitForFences(1, &m_imageFences[imageIndex], VK_TRUE, std::numeric_limits<uint64_t>::max());
 
-			std::array<vk::PipelineStageFlags, 2> waitStages =
-			{
-				vk::PipelineStageFlagBits::eColorAttachmentOutput,
-				vk::PipelineStageFlagBits::eColorAttachmentOutput
-			};
+			m_imageFences[imageIndex] = frame.fence;
+
+			// Wait for the image and every cameras lighting
+			m_frameSemaphores.push_back(frame.imageAvailable);
+			std::vector<vk::PipelineStageFlags> waitStages(m_frameSemaphores.size(), vk::PipelineStageFlagBits::eColorAttachmentOutput);
 
 			vk::SubmitInfo submitInfo = {};
-			submitInfo.setWaitSemaphoreCount(static_cast<uint32_t>(semaphores.size()));
-			submitInfo.setPWaitSemaphores(semaphores.data());
+			submitInfo.setWaitSemaphoreCount(static_cast<uint32_t>(m_frameSemaphores.size()));
+			submitInfo.setPWaitSemaphores(m_frameSemaphores.data());
 			submitInfo.setPWaitDstStageMask(waitStages.data());
 			submitInfo.setCommandBufferCount(1);
 			submitInfo.setPCommandBuffers(&m_commands.rendering[imageIndex].buffer);
 			submitInfo.setSignalSemaphoreCount(1);
-			submitInfo.setPSignalSemaphores(&m_semaphores.renderFinished);
+			submitInfo.setPSignalSemaphores(&frame.renderFinished);
 
-			// Submit draw command
-			m_graphics->getGraphicsQueue().submit(1, &submitInfo, { nullptr });
+			// Submit draw command (The fence is signaled once every submission of the frame is done)
+			m_graphics->getLogicalDevice().resetFences(1, &frame.fence);
+			m_graphics->getGraphicsQueue().submit(1, &submitInfo, frame.fence);
 
 			vk::PresentInfoKHR presentInfo = {};
 			presentInfo.setWaitSemaphoreCount(1);
-			presentInfo.setPWaitSemaphores(&m_semaphores.renderFinished);
+			presentInfo.setPWaitSemaphores(&frame.renderFinished);
 			presentInfo.setSwapchainCount(1);
 			presentInfo.setPSwapchains(&m_swapchain.swapchain);
 			presentInfo.setPImageIndices(&imageIndex);
 			presentInfo.setPResults(nullptr);
 
-			// Present and wait
+			// Present without waiting
 			m_graphics->getPresentationQueue().presentKHR(presentInfo);
-			m_graphics->getPresentationQueue().waitIdle();
+			m_frameIndex = (m_frameIndex + 1) % GUST_FRAMES_IN_FLIGHT;
 
 			// Clear mesh queue
 			m_meshes.clear();
+			m_cullingStats = m_frameCullingStats;
+			m_drawStats = m_frameDrawStats;
 		}
 	}
 
@@ -202,8 +352,58 @@ namespace gust
 		camera->width = m_graphics->getWidth();
 		camera->height = m_graphics->getHeight();
 
-		camera->commandBuffer = createCommandBuffer(vk::CommandBufferLevel::ePrimary);
-		camera->lightingCommandBuffer = createCommandBuffer(vk::CommandBufferLevel::ePrimary);
+		// Skybox descriptor pool (One set per frame)
+		std::array<vk::DescriptorPoolSize, 2> poolSizes = {};
+		poolSizes[0].setType(vk::DescriptorType::eUniformBufferDynamic);
+		poolSizes[0].setDescriptorCount(GUST_FRAMES_IN_FLIGHT);
+		poolSizes[1].setType(vk::DescriptorType::eCombinedImageSampler);
+		poolSizes[1].setDescriptorCount(GUST_FRAMES_IN_FLIGHT);
+
+		vk::DescriptorPoolCreateInfo poolInfo = {};
+		poolInfo.setPoolSizeCount(static_cast<uint32_t>(poolSizes.size()));
+		poolInfo.setPPoolSizes(poolSizes.data());
+		poolInfo.setMaxSets(GUST_FRAMES_IN_FLIGHT);
+
+		camera->descriptorPool = m_graphics->getLogicalDevice().createDescriptorPool(poolInfo);
+
+		for (auto& frame : camera->frames)
+		{
+			frame.commandBuffer = createCommandBuffer(vk::CommandBufferLevel::ePrimary);
+			frame.lightingCommandBuffer = createCommandBuffer(vk::CommandBufferLevel::ePrimary);
+			frame.skyboxCommandBuffer = createCommandBuffer(vk::CommandBufferLevel::eSecondary);
+
+			// One secondary command buffer per worker thread
+			frame.drawCommandBuffers.resize(m_commands.pools.size());
+			for (size_t i = 0; i < frame.drawCommandBuffers.size(); ++i)
+				frame.drawCommandBuffers[i] = createCommandBuffer(vk::CommandBufferLevel::eSecondary, i);
+
+			frame.offscreen = m_graphics->getLogicalDevice().createSemaphore(vk::SemaphoreCreateInfo());
+			frame.lighting = m_graphics->getLogicalDevice().createSemaphore(vk::SemaphoreCreateInfo());
+
+			// Allocate skybox descriptor set
+			vk::DescriptorSetAllocateInfo allocInfo = {};
+			allocInfo.setDescriptorPool(camera->descriptorPool);
+			allocInfo.setDescriptorSetCount(1);
+			allocInfo.setPSetLayouts(&m_descriptors.skyboxDescriptorSetLayout);
+
+			frame.skyboxDescriptorSet = m_graphics->getLogicalDevice().allocateDescriptorSets(allocInfo)[0];
+
+			// Skybox vertex data (Offset is supplied when drawing)
+			vk::DescriptorBufferInfo bufferInfo = {};
+			bufferInfo.setBuffer(m_uniformRing->getBuffer().buffer);
+			bufferInfo.setOffset(0);
+			bufferInfo.setRange(static_cast<vk::DeviceSize>(sizeof(VertexShaderData)));
+
+			vk::WriteDescriptorSet descWrite = {};
+			descWrite.setDstSet(frame.skyboxDescriptorSet);
+			descWrite.setDstBinding(0);
+			descWrite.setDstArrayElement(0);
+			descWrite.setDescriptorType(vk::DescriptorType::eUniformBufferDynamic);
+			descWrite.setDescriptorCount(1);
+			descWrite.setPBufferInfo(&bufferInfo);
+
+			m_graphics->getLogicalDevice().updateDescriptorSets(1, &descWrite, 0, nullptr);
+		}
 
 		// (World space) Positions
 		FrameBufferAttachment position = createAttachment
@@ -272,11 +472,11 @@ namespace gust
 		camera->misc		= Handle<Texture>(m_textureAllocator, m_textureAllocator->allocate());
 		camera->depth		= Handle<Texture>(m_textureAllocator, m_textureAllocator->allocate());
 
-		::new(camera->position.get())(Texture)(m_graphics, position.image, position.view, positionSampler, position.memory, camera->width, camera->height);
-		::new(camera->normal.get())(Texture)(m_graphics, normals.image, normals.view, normalSampler, normals.memory, camera->width, camera->height);
-		::new(camera->color.get())(Texture)(m_graphics, color.image, color.view, colorSampler, color.memory, camera->width, camera->height);
-		::new(camera->misc.get())(Texture)(m_graphics, misc.image, misc.view, miscSampler, misc.memory, camera->width, camera->height);
-		::new(camera->depth.get())(Texture)(m_graphics, depth.image, depth.view, depthSampler, depth.memory, camera->width, camera->height);
+		::new(camera->position.get())(Texture)(m_graphics, position.image, position.view, positionSampler, position.allocation, camera->width, camera->height);
+		::new(camera->normal.get())(Texture)(m_graphics, normals.image, normals.view, normalSampler, normals.allocation, camera->width, camera->height);
+		::new(camera->color.get())(Texture)(m_graphics, color.image, color.view, colorSampler, color.allocation, camera->width, camera->height);
+		::new(camera->misc.get())(Texture)(m_graphics, misc.image, misc.view, miscSampler, misc.allocation, camera->width, camera->height);
+		::new(camera->depth.get())(Texture)(m_graphics, depth.image, depth.view, depthSampler, depth.allocation, camera->width, camera->height);
 
 		std::array<vk::ImageView, 5> attachments;
 		attachments[0] = camera->position->getImageView();
@@ -300,6 +500,69 @@ namespace gust
 		return camera;
 	}
 
+	size_t Renderer::createStaticDraw()
+	{
+		size_t staticDraw = 0;
+
+		if (m_freeStaticDraws.empty())
+		{
+			staticDraw = m_staticDraws.size();
+			m_staticDraws.push_back(StaticDraw());
+		}
+		else
+		{
+			staticDraw = m_freeStaticDraws.back();
+			m_freeStaticDraws.pop_back();
+		}
+
+		m_staticDraws[staticDraw].allocated = true;
+
+		// Resize the static instance buffer if necessary
+		if (staticDraw >= m_staticInstanceCapacity)
+		{
+			// Cached draws may be using the old buffer
+			m_graphics->getLogicalDevice().waitIdle();
+
+			if (m_staticInstanceBuffer.buffer)
+			{
+				m_graphics->unmapBuffer(m_staticInstanceBuffer);
+				m_graphics->destroyBuffer(m_staticInstanceBuffer);
+			}
+
+			m_staticInstanceCapacity += 100;
+			m_staticInstanceBuffer = m_graphics->createBuffer
+			(
+				static_cast<vk::DeviceSize>(sizeof(InstanceData) * m_staticInstanceCapacity * GUST_FRAMES_IN_FLIGHT),
+				vk::BufferUsageFlagBits::eVertexBuffer,
+				vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+			);
+
+			m_staticInstances = static_cast<InstanceData*>(m_graphics->mapBuffer(m_staticInstanceBuffer));
+
+			// Instances moved, so every cached draw must be recorded again
+			for (auto& draw : m_staticDraws)
+				for (auto& cachedDraw : draw.cache)
+					cachedDraw.instanceBuffer = vk::Buffer();
+		}
+
+		return staticDraw;
+	}
+
+	void Renderer::destroyStaticDraw(size_t staticDraw)
+	{
+		gAssert(staticDraw < m_staticDraws.size() && m_staticDraws[staticDraw].allocated);
+
+		// Frames in flight may still execute the command buffers, so free them once the last submitted frame is done
+		const uint32_t lastFrame = (m_frameIndex + GUST_FRAMES_IN_FLIGHT - 1) % GUST_FRAMES_IN_FLIGHT;
+
+		for (auto& cachedDraw : m_staticDraws[staticDraw].cache)
+			if (cachedDraw.commandBuffer.buffer)
+				m_retiredCommandBuffers[lastFrame].push_back(cachedDraw.commandBuffer);
+
+		m_staticDraws[staticDraw] = StaticDraw();
+		m_freeStaticDraws.push_back(staticDraw);
+	}
+
 	void Renderer::initCommandPools()
 	{
 		// Create a command pools
@@ -612,7 +875,7 @@ namespace gust
 			vk::ImageUsageFlagBits::eDepthStencilAttachment,
 			vk::MemoryPropertyFlagBits::eDeviceLocal,
 			m_depthTexture.image,
-			m_depthTexture.memory
+			m_depthTexture.allocation
 		);
 
 		// Create image view
@@ -667,35 +930,34 @@ namespace gust
 		}
 	}
 
-	void Renderer::initSemaphores()
+	void Renderer::initFrames()
 	{
 		vk::SemaphoreCreateInfo semaphoreInfo = {};
 
-		m_semaphores.imageAvailable = m_graphics->getLogicalDevice().createSemaphore(semaphoreInfo);
-		m_semaphores.renderFinished = m_graphics->getLogicalDevice().createSemaphore(semaphoreInfo);
-		m_semaphores.offscreen = m_graphics->getLogicalDevice().createSemaphore(semaphoreInfo);
+		// Fences start signaled so the first frames don't wait
+		vk::FenceCreateInfo fenceInfo = {};
+		fenceInfo.setFlags(vk::FenceCreateFlagBits::eSignaled);
+
+		for (auto& frame : m_frames)
+		{
+			frame.imageAvailable = m_graphics->getLogicalDevice().createSemaphore(semaphoreInfo);
+			frame.renderFinished = m_graphics->getLogicalDevice().createSemaphore(semaphoreInfo);
+			frame.fence = m_graphics->getLogicalDevice().createFence(fenceInfo);
+		}
+
+		m_imageFences.resize(m_swapchain.images.size(), vk::Fence());
 	}
 
 	void Renderer::initLighting()
 	{
-		// create lighting uniform buffer
-		m_lightingUniformBuffer = m_graphics->createBuffer
-		(
-			static_cast<vk::DeviceSize>(sizeof(LightingData)),
-			vk::BufferUsageFlagBits::eUniformBuffer,
-			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
-		);
-
-		// create skybox uniform buffer
-		m_skyboxUniformBuffer = m_graphics->createBuffer
-		(
-			static_cast<vk::DeviceSize>(sizeof(VertexShaderData)),
-			vk::BufferUsageFlagBits::eUniformBuffer,
-			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
-		);
-
-		// Create skybox command buffer
-		m_commands.skybox = createCommandBuffer(vk::CommandBufferLevel::eSecondary);
+		// create lighting uniform buffers
+		for (auto& frame : m_frames)
+			frame.lightingUniformBuffer = m_graphics->createBuffer
+			(
+				static_cast<vk::DeviceSize>(sizeof(LightingData)),
+				vk::BufferUsageFlagBits::eUniformBuffer,
+				vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+			);
 	}
 
 	void Renderer::initDescriptorSetLayouts()
@@ -704,9 +966,9 @@ namespace gust
 		{
 			std::array<vk::DescriptorSetLayoutBinding, 4> bindings = {};
 
-			// Vertex bindings
+			// Vertex bindings (GUST data lives in the uniform ring buffer)
 			bindings[0].setBinding(0);
-			bindings[0].setDescriptorType(vk::DescriptorType::eUniformBuffer);
+			bindings[0].setDescriptorType(vk::DescriptorType::eUniformBufferDynamic);
 			bindings[0].setDescriptorCount(1);
 			bindings[0].setStageFlags(vk::ShaderStageFlagBits::eVertex);
 
@@ -717,7 +979,7 @@ namespace gust
 
 			// Fragment bindings
 			bindings[2].setBinding(2);
-			bindings[2].setDescriptorType(vk::DescriptorType::eUniformBuffer);
+			bindings[2].setDescriptorType(vk::DescriptorType::eUniformBufferDynamic);
 			bindings[2].setDescriptorCount(1);
 			bindings[2].setStageFlags(vk::ShaderStageFlagBits::eFragment);
 
@@ -798,9 +1060,9 @@ namespace gust
 		{
 			std::array<vk::DescriptorSetLayoutBinding, 2> bindings = {};
 
-			// Lighting
+			// Vertex data (Written to the uniform ring buffer each frame)
 			bindings[0].setBinding(0);
-			bindings[0].setDescriptorType(vk::DescriptorType::eUniformBuffer);
+			bindings[0].setDescriptorType(vk::DescriptorType::eUniformBufferDynamic);
 			bindings[0].setDescriptorCount(1);
 			bindings[0].setStageFlags(vk::ShaderStageFlagBits::eVertex);
 
@@ -817,28 +1079,76 @@ namespace gust
 			// Create descriptor set layout
 			m_descriptors.skyboxDescriptorSetLayout = m_graphics->getLogicalDevice().createDescriptorSetLayout(createInfo);
 		}
+
+		// Bindless descriptor set layout (Materials and textures live in the descriptor heap)
+		if (m_graphics->isBindless())
+		{
+			std::array<vk::DescriptorSetLayoutBinding, 3> bindings = {};
+
+			// Per draw data (Indexed with the draws push constants)
+			bindings[0].setBinding(0);
+			bindings[0].setDescriptorType(vk::DescriptorType::eStorageBuffer);
+			bindings[0].setDescriptorCount(1);
+			bindings[0].setStageFlags(vk::ShaderStageFlagBits::eVertex);
+
+			// Per camera vertex data
+			bindings[1].setBinding(1);
+			bindings[1].setDescriptorType(vk::DescriptorType::eUniformBufferDynamic);
+			bindings[1].setDescriptorCount(1);
+			bindings[1].setStageFlags(vk::ShaderStageFlagBits::eVertex);
+
+			// Per camera fragment data
+			bindings[2].setBinding(2);
+			bindings[2].setDescriptorType(vk::DescriptorType::eUniformBufferDynamic);
+			bindings[2].setDescriptorCount(1);
+			bindings[2].setStageFlags(vk::ShaderStageFlagBits::eFragment);
+
+			vk::DescriptorSetLayoutCreateInfo createInfo = {};
+			createInfo.setBindingCount(static_cast<uint32_t>(bindings.size()));
+			createInfo.setPBindings(bindings.data());
+
+			// Create descriptor set layout
+			m_descriptors.bindlessDescriptorSetLayout = m_graphics->getLogicalDevice().createDescriptorSetLayout(createInfo);
+		}
 	}
 
 	void Renderer::initDescriptorPool()
 	{
-		std::array<vk::DescriptorPoolSize, 2> poolSizes = {};
-		poolSizes[0].setDescriptorCount(3);
+		// One lighting set per frame and a screen set
+		std::vector<vk::DescriptorPoolSize> poolSizes(2);
+		poolSizes[0].setDescriptorCount(GUST_FRAMES_IN_FLIGHT);
 		poolSizes[0].setType(vk::DescriptorType::eUniformBuffer);
 
-		poolSizes[1].setDescriptorCount(6);
+		poolSizes[1].setDescriptorCount(4 * GUST_FRAMES_IN_FLIGHT + 1);
 		poolSizes[1].setType(vk::DescriptorType::eCombinedImageSampler);
 
+		uint32_t setCount = GUST_FRAMES_IN_FLIGHT + 1;
+
+		// And the bindless set
+		if (m_graphics->isBindless())
+		{
+			poolSizes.resize(4);
+			poolSizes[2].setDescriptorCount(1);
+			poolSizes[2].setType(vk::DescriptorType::eStorageBuffer);
+
+			poolSizes[3].setDescriptorCount(2);
+			poolSizes[3].setType(vk::DescriptorType::eUniformBufferDynamic);
+
+			++setCount;
+		}
+
 		vk::DescriptorPoolCreateInfo poolInfo = {};
 		poolInfo.setPoolSizeCount(static_cast<uint32_t>(poolSizes.size()));
 		poolInfo.setPPoolSizes(poolSizes.data());
-		poolInfo.setMaxSets(3);
+		poolInfo.setMaxSets(setCount);
 
 		m_descriptors.descriptorPool = m_graphics->getLogicalDevice().createDescriptorPool(poolInfo);
 	}
 
 	void Renderer::initDescriptorSets()
 	{
-		// Lighting descriptor set
+		// Lighting descriptor sets
+		for (auto& frame : m_frames)
 		{
 			vk::DescriptorSetAllocateInfo allocInfo = {};
 			allocInfo.setDescriptorPool(m_descriptors.descriptorPool);
@@ -846,16 +1156,16 @@ namespace gust
 			allocInfo.setPSetLayouts(&m_descriptors.lightingDescriptorSetLayout);
 
 			// Allocate descriptor sets
-			m_descriptors.lightingDescriptorSet = m_graphics->getLogicalDevice().allocateDescriptorSets(allocInfo)[0];
+			frame.lightingDescriptorSet = m_graphics->getLogicalDevice().allocateDescriptorSets(allocInfo)[0];
 
 			// Lighting
 			vk::DescriptorBufferInfo bufferInfo = {};
-			bufferInfo.setBuffer(m_lightingUniformBuffer.buffer);
+			bufferInfo.setBuffer(frame.lightingUniformBuffer.buffer);
 			bufferInfo.setOffset(0);
 			bufferInfo.setRange(static_cast<VkDeviceSize>(sizeof(LightingData)));
 
 			vk::WriteDescriptorSet descWrite = {};
-			descWrite.setDstSet(m_descriptors.lightingDescriptorSet);
+			descWrite.setDstSet(frame.lightingDescriptorSet);
 			descWrite.setDstBinding(0);
 			descWrite.setDstArrayElement(0);
 			descWrite.setDescriptorType(vk::DescriptorType::eUniformBuffer);
@@ -878,15 +1188,46 @@ namespace gust
 			m_descriptors.screenDescriptorSet = m_graphics->getLogicalDevice().allocateDescriptorSets(allocInfo)[0];
 		}
 
-		// Skybox descriptor set
+		// Bindless descriptor set (Every buffer it points to lives as long as the renderer)
+		if (m_graphics->isBindless())
 		{
 			vk::DescriptorSetAllocateInfo allocInfo = {};
 			allocInfo.setDescriptorPool(m_descriptors.descriptorPool);
 			allocInfo.setDescriptorSetCount(1);
-			allocInfo.setPSetLayouts(&m_descriptors.skyboxDescriptorSetLayout);
+			allocInfo.setPSetLayouts(&m_descriptors.bindlessDescriptorSetLayout);
 
 			// Allocate descriptor sets
-			m_descriptors.skyboxDescriptorSet = m_graphics->getLogicalDevice().allocateDescriptorSets(allocInfo)[0];
+			m_descriptors.bindlessDescriptorSet = m_graphics->getLogicalDevice().allocateDescriptorSets(allocInfo)[0];
+
+			std::array<vk::DescriptorBufferInfo, 3> bufferInfos = {};
+
+			// Per draw data (Every frame of the instance ring buffer)
+			bufferInfos[0].setBuffer(m_instanceRing->getBuffer().buffer);
+			bufferInfos[0].setOffset(0);
+			bufferInfos[0].setRange(VK_WHOLE_SIZE);
+
+			// Per camera data (Offsets are supplied when drawing)
+			bufferInfos[1].setBuffer(m_uniformRing->getBuffer().buffer);
+			bufferInfos[1].setOffset(0);
+			bufferInfos[1].setRange(static_cast<vk::DeviceSize>(sizeof(VertexShaderData)));
+
+			bufferInfos[2].setBuffer(m_uniformRing->getBuffer().buffer);
+			bufferInfos[2].setOffset(0);
+			bufferInfos[2].setRange(static_cast<vk::DeviceSize>(sizeof(FragmentShaderData)));
+
+			std::array<vk::WriteDescriptorSet, 3> writeSets = {};
+
+			for (size_t i = 0; i < writeSets.size(); ++i)
+			{
+				writeSets[i].setDstSet(m_descriptors.bindlessDescriptorSet);
+				writeSets[i].setDstBinding(static_cast<uint32_t>(i));
+				writeSets[i].setDstArrayElement(0);
+				writeSets[i].setDescriptorType(i == 0 ? vk::DescriptorType::eStorageBuffer : vk::DescriptorType::eUniformBufferDynamic);
+				writeSets[i].setDescriptorCount(1);
+				writeSets[i].setPBufferInfo(&bufferInfos[i]);
+			}
+
+			m_graphics->getLogicalDevice().updateDescriptorSets(static_cast<uint32_t>(writeSets.size()), writeSets.data(), 0, nullptr);
 		}
 	}
 
@@ -1084,10 +1425,11 @@ namespace gust
 			m_skyboxShader.shaderStages = { vertShaderStageInfo, fragShaderStageInfo };
 		}
 
-		// Create lighting graphics pipeline
+		// Create lighting graphics pipeline (Pipelines are independent, so each is compiled on its own worker)
+		m_threadPool->workers[0]->addJob([this]()
 		{
-			auto bindingDescription = Vertex::getBindingDescription();
-			auto attributeDescriptions = Vertex::getAttributeDescriptions();
+			auto bindingDescription = GpuVertex::getBindingDescription();
+			auto attributeDescriptions = GpuVertex::getAttributeDescriptions();
 
 			vk::PipelineVertexInputStateCreateInfo vertexInputInfo = {};
 			vertexInputInfo.setVertexBindingDescriptionCount(1);
@@ -1218,13 +1560,14 @@ namespace gust
 			pipelineInfo.setPDepthStencilState(&depthStencil);
 
 			// Create graphics pipeline
-			m_lightingShader.graphicsPipeline = m_graphics->getLogicalDevice().createGraphicsPipeline({}, pipelineInfo);
-		}
+			m_lightingShader.graphicsPipeline = m_graphics->createGraphicsPipeline(pipelineInfo);
+		});
 
 		// Create screen graphics pipeline
+		m_threadPool->workers[1 % m_threadPool->getWorkerCount()]->addJob([this]()
 		{
-			auto bindingDescription = Vertex::getBindingDescription();
-			auto attributeDescriptions = Vertex::getAttributeDescriptions();
+			auto bindingDescription = GpuVertex::getBindingDescription();
+			auto attributeDescriptions = GpuVertex::getAttributeDescriptions();
 
 			vk::PipelineVertexInputStateCreateInfo vertexInputInfo = {};
 			vertexInputInfo.setVertexBindingDescriptionCount(1);
@@ -1342,13 +1685,14 @@ namespace gust
 			pipelineInfo.setPDepthStencilState(&depthStencil);
 
 			// Create graphics pipeline
-			m_screenShader.graphicsPipeline = m_graphics->getLogicalDevice().createGraphicsPipeline({}, pipelineInfo);
-		}
+			m_screenShader.graphicsPipeline = m_graphics->createGraphicsPipeline(pipelineInfo);
+		});
 
 		// Create skybox graphics pipeline
+		m_threadPool->workers[2 % m_threadPool->getWorkerCount()]->addJob([this]()
 		{
-			auto bindingDescription = Vertex::getBindingDescription();
-			auto attributeDescriptions = Vertex::getAttributeDescriptions();
+			auto bindingDescription = GpuVertex::getBindingDescription();
+			auto attributeDescriptions = GpuVertex::getAttributeDescriptions();
 
 			vk::PipelineVertexInputStateCreateInfo vertexInputInfo = {};
 			vertexInputInfo.setVertexBindingDescriptionCount(1);
@@ -1479,8 +1823,10 @@ namespace gust
 			pipelineInfo.setPDepthStencilState(&depthStencil);
 
 			// Create graphics pipeline
-			m_skyboxShader.graphicsPipeline = m_graphics->getLogicalDevice().createGraphicsPipeline({}, pipelineInfo);
-		}
+			m_skyboxShader.graphicsPipeline = m_graphics->createGraphicsPipeline(pipelineInfo);
+		});
+
+		m_threadPool->wait();
 	}
 
 	void Renderer::initCommandBuffers()
@@ -1545,10 +1891,10 @@ namespace gust
 				vk::Buffer vertexBuffer = m_screenQuad->getVertexUniformBuffer().buffer;
 				vk::DeviceSize offset = 0;
 				commandBuffer.bindVertexBuffers(0, 1, &vertexBuffer, &offset);
-				commandBuffer.bindIndexBuffer(m_screenQuad->getIndexUniformBuffer().buffer, 0, vk::IndexType::eUint32);
+				commandBuffer.bindIndexBuffer(m_screenQuad->getIndexUniformBuffer().buffer, 0, m_screenQuad->getIndexType());
 
 				// Draw
-				commandBuffer.drawIndexed(static_cast<uint32_t>(m_screenQuad->getIndexCount()), 1, 0, 0, 0);
+				commandBuffer.drawIndexed(static_cast<uint32_t>(m_screenQuad->getIndexCount()), 1, m_screenQuad->getFirstIndex(), m_screenQuad->getVertexOffset(), 0);
 
 				commandBuffer.endRenderPass();
 				commandBuffer.end();
@@ -1590,17 +1936,7 @@ namespace gust
 		image.setUsage(usage | vk::ImageUsageFlagBits::eSampled);
 
 		// Create image
-		newAttachment.image = m_graphics->getLogicalDevice().createImage(image);
-
-		vk::MemoryAllocateInfo memAlloc = {};
-		vk::MemoryRequirements memReqs = m_graphics->getLogicalDevice().getImageMemoryRequirements(newAttachment.image);
-
-		memAlloc.allocationSize = memReqs.size;
-		memAlloc.memoryTypeIndex = m_graphics->findMemoryType(memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
-
-		// Allocate and bind image memory
-		newAttachment.memory = m_graphics->getLogicalDevice().allocateMemory(memAlloc);
-		m_graphics->getLogicalDevice().bindImageMemory(newAttachment.image, newAttachment.memory, 0);
+		m_graphics->createImage(image, vk::MemoryPropertyFlagBits::eDeviceLocal, newAttachment.image, newAttachment.allocation);
 
 		newAttachment.view = m_graphics->createImageView(newAttachment.image, format, aspectMask);
 
@@ -1613,17 +1949,27 @@ namespace gust
 		if(m_mainCamera != Handle<VirtualCamera>::nullHandle())
 			m_lightingData.viewPosition = glm::vec4(m_mainCamera->viewPosition, 1);
 
+		// Use every light unless a spatial query picked some
+		if (!m_hasVisibleLights)
+		{
+			m_visiblePointLights.resize(m_pointLights.size());
+			m_visibleSpotLights.resize(m_spotLights.size());
+
+			for (size_t i = 0; i < m_pointLights.size(); ++i)
+				m_visiblePointLights[i] = i;
+
+			for (size_t i = 0; i < m_spotLights.size(); ++i)
+				m_visibleSpotLights[i] = i;
+		}
+
 		// Set light counts
-		m_lightingData.directionalLightCount = static_cast<uint32_t>(m_directionalLights.size());
-		m_lightingData.pointLightCount = static_cast<uint32_t>(m_pointLights.size());
-		m_lightingData.spotLightCount = static_cast<uint32_t>(m_spotLights.size());
+		m_lightingData.directionalLightCount = static_cast<uint32_t>(std::min<size_t>(m_directionalLights.size(), GUST_DIRECTIONAL_LIGHT_COUNT));
+		m_lightingData.pointLightCount = static_cast<uint32_t>(std::min<size_t>(m_visiblePointLights.size(), GUST_POINT_LIGHT_COUNT));
+		m_lightingData.spotLightCount = static_cast<uint32_t>(std::min<size_t>(m_visibleSpotLights.size(), GUST_SPOT_LIGHT_COUNT));
 
 		// Set point lights
 		for (size_t i = 0; i < m_lightingData.pointLightCount; ++i)
-		{
-			m_lightingData.pointLights[i] = m_pointLights.front();
-			m_pointLights.pop();
-		}
+			m_lightingData.pointLights[i] = m_pointLights[m_visiblePointLights[i]];
 
 		// Set directional lights
 		for (size_t i = 0; i < m_lightingData.directionalLightCount; ++i)
@@ -1634,227 +1980,961 @@ namespace gust
 
 		// Set spot lights
 		for (size_t i = 0; i < m_lightingData.spotLightCount; ++i)
-		{
-			m_lightingData.spotLights[i] = m_spotLights.front();
-			m_spotLights.pop();
-		}
+			m_lightingData.spotLights[i] = m_spotLights[m_visibleSpotLights[i]];
+
+		m_directionalLights = std::queue<DirectionalLightData>();
+		m_pointLights.clear();
+		m_spotLights.clear();
+		m_hasVisibleLights = false;
 
 		// Set lighting data
 		{
-			void* cpyData;
-
-			m_graphics->getLogicalDevice().mapMemory
-			(
-				m_lightingUniformBuffer.memory,
-				0,
-				static_cast<vk::DeviceSize>(sizeof(LightingData)),
-				(vk::MemoryMapFlagBits)0,
-				&cpyData
-			);
-
+			void* cpyData = m_graphics->mapBuffer(m_frames[m_frameIndex].lightingUniformBuffer);
 			memcpy(cpyData, &m_lightingData, sizeof(LightingData));
-			m_graphics->getLogicalDevice().unmapMemory(m_lightingUniformBuffer.memory);
+			m_graphics->unmapBuffer(m_frames[m_frameIndex].lightingUniformBuffer);
 		}
 	}
 
-	void Renderer::drawMeshToFramebuffer
-	(
-		const MeshData& mesh,
-		const vk::CommandBufferInheritanceInfo& inheritanceInfo,
-		size_t threadIndex,
-		Handle<VirtualCamera> camera
-	)
+	void Renderer::cullMeshes(Handle<VirtualCamera> camera)
 	{
-		vk::CommandBufferBeginInfo beginInfo = {};
-		beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eSimultaneousUse);
-		beginInfo.setPInheritanceInfo(&inheritanceInfo);
+		const size_t meshCount = m_meshes.size();
 
-		// Submit vertex data
+		// A spatial query already found the meshes in view
+		if (camera->hasMeshCandidates)
 		{
-			VertexShaderData vData = {};
-			vData.model = mesh.model;
-			vData.MVP = camera->projection * camera->view * mesh.model;
+			m_visibleMeshes.clear();
 
-			void* cpyData;
+			for (const size_t meshIndex : camera->meshCandidates)
+				if (meshIndex < meshCount)
+					m_visibleMeshes.push_back(meshIndex);
 
-			m_graphics->getLogicalDevice().mapMemory
-			(
-				mesh.vertexUniformBuffer.memory,
-				0,
-				sizeof(VertexShaderData),
-				(vk::MemoryMapFlagBits)0,
-				&cpyData
-			);
+			// Walk the mesh list in order like the linear path does (Meshes in several cells are found more than once)
+			std::sort(m_visibleMeshes.begin(), m_visibleMeshes.end());
+			m_visibleMeshes.erase(std::unique(m_visibleMeshes.begin(), m_visibleMeshes.end()), m_visibleMeshes.end());
 
-			memcpy(cpyData, &vData, sizeof(VertexShaderData));
-			m_graphics->getLogicalDevice().unmapMemory(mesh.vertexUniformBuffer.memory);
-		}
+			m_frameCullingStats.culled += meshCount - m_visibleMeshes.size();
 
-		// Submit fragment data
-		{
-			FragmentShaderData fData = {};
-			fData.viewPosition = glm::vec4(camera->viewPosition, 1);
+			if (m_occlusionCulling)
+				occlusionCull(camera);
 
-			void* cpyData;
+			m_frameCullingStats.visible += m_visibleMeshes.size();
+			return;
+		}
 
-			m_graphics->getLogicalDevice().mapMemory
-			(
-				mesh.fragmentUniformBuffer.memory,
-				0,
-				sizeof(FragmentShaderData),
-				(vk::MemoryMapFlagBits)0,
-				&cpyData
-			);
+		const Frustum frustum(camera->projection * camera->view);
+		const size_t chunkCount = (meshCount + GUST_CULLING_CHUNK_SIZE - 1) / GUST_CULLING_CHUNK_SIZE;
 
-			memcpy(cpyData, &fData, sizeof(FragmentShaderData));
-			m_graphics->getLogicalDevice().unmapMemory(mesh.fragmentUniformBuffer.memory);
-		}
+		m_meshVisibility.resize(meshCount);
 
-		mesh.commandBuffer.buffer.begin(beginInfo);
+		// Test chunks of bounds in parallel
+		for (size_t i = 0; i < chunkCount; ++i)
+			m_threadPool->workers[i % m_threadPool->getWorkerCount()]->addJob([this, frustum, i, meshCount]()
+			{
+				const size_t first = i * GUST_CULLING_CHUNK_SIZE;
+				const size_t count = std::min<size_t>(GUST_CULLING_CHUNK_SIZE, meshCount - first);
+				frustum.intersects(m_meshBounds, first, count, m_meshVisibility.data() + first);
+			});
 
-		// Set viewport
-		vk::Viewport viewport = {};
-		viewport.setHeight((float)m_graphics->getHeight());
-		viewport.setWidth((float)m_graphics->getWidth());
-		viewport.setMinDepth(0);
-		viewport.setMaxDepth(1);
-		mesh.commandBuffer.buffer.setViewport(0, 1, &viewport);
+		m_threadPool->wait();
 
-		// Set scissor
-		vk::Rect2D scissor = {};
-		scissor.setExtent({ m_graphics->getWidth(), m_graphics->getHeight() });
-		scissor.setOffset({ 0, 0 });
-		mesh.commandBuffer.buffer.setScissor(0, 1, &scissor);
+		// Gather visible meshes
+		m_visibleMeshes.clear();
 
-		// Bind graphics pipeline
-		mesh.commandBuffer.buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, mesh.material->getShader()->getGraphicsPipeline());
+		for (size_t i = 0; i < meshCount; ++i)
+			if (m_meshVisibility[i])
+				m_visibleMeshes.push_back(i);
 
-		// Bind descriptor sets
-		mesh.commandBuffer.buffer.bindDescriptorSets
-		(
-			vk::PipelineBindPoint::eGraphics,
-			mesh.material->getShader()->getGraphicsPipelineLayout(),
-			0,
-			static_cast<uint32_t>(mesh.descriptorSets.size()),
-			mesh.descriptorSets.data(),
-			0,
-			nullptr
-		);
+		m_frameCullingStats.culled += meshCount - m_visibleMeshes.size();
 
-		// Bind vertex and index buffer
-		vk::Buffer vertexBuffer = mesh.mesh->getVertexUniformBuffer().buffer;
-		vk::DeviceSize offset = 0;
-		mesh.commandBuffer.buffer.bindVertexBuffers(0, 1, &vertexBuffer, &offset);
-		mesh.commandBuffer.buffer.bindIndexBuffer(mesh.mesh->getIndexUniformBuffer().buffer, 0, vk::IndexType::eUint32);
+		// Remove meshes hidden behind occluders
+		if (m_occlusionCulling)
+			occlusionCull(camera);
 
-		// Draw
-		mesh.commandBuffer.buffer.drawIndexed(static_cast<uint32_t>(mesh.mesh->getIndexCount()), 1, 0, 0, 0);
-		mesh.commandBuffer.buffer.end();
+		m_frameCullingStats.visible += m_visibleMeshes.size();
 	}
 
-	void Renderer::drawToCamera(Handle<VirtualCamera> camera)
+	void Renderer::occlusionCull(Handle<VirtualCamera> camera)
 	{
-		vk::CommandBufferBeginInfo cmdBufInfo = {};
-		cmdBufInfo.setFlags(vk::CommandBufferUsageFlagBits::eSimultaneousUse);
-		cmdBufInfo.setPInheritanceInfo(nullptr);
+		const glm::mat4 viewProjection = camera->projection * camera->view;
+		const size_t workerCount = m_threadPool->getWorkerCount();
 
-		// Begin renderpass
-		camera->commandBuffer.buffer.begin(cmdBufInfo);
+		// Gather occluders inside the frustum (Only meshes with CPU geometry can be rasterized)
+		m_occluders.clear();
 
-		// Clear values for all attachments written in the fragment shader
-		std::array<vk::ClearValue, 5> clearValues;
-		clearValues[0].setColor(std::array<float, 4>{ 0.0f, 0.0f, 0.0f, 0.0f });
-		clearValues[1].setColor(std::array<float, 4>{ 0.0f, 0.0f, 0.0f, 0.0f });
-		clearValues[2].setColor(std::array<float, 4>{ camera->clearColor.x, camera->clearColor.y, camera->clearColor.z, 0.0f });
-		clearValues[3].setColor(std::array<float, 4>{ 0.0f, 0.0f, 0.0f, 0.0f });
-		clearValues[4].setDepthStencil({ 1.0f, 0 });
+		for (auto meshIndex : m_visibleMeshes)
+			if (m_meshes[meshIndex].occluder && m_meshes[meshIndex].mesh->hasCpuGeometry())
+				m_occluders.push_back(meshIndex);
 
-		vk::RenderPassBeginInfo renderPassBeginInfo = {};
-		renderPassBeginInfo.setRenderPass(m_renderPasses.offscreen);
-		renderPassBeginInfo.setFramebuffer(camera->frameBuffer);
-		renderPassBeginInfo.renderArea.setExtent(vk::Extent2D(m_graphics->getWidth(), m_graphics->getHeight()));
-		renderPassBeginInfo.renderArea.offset = vk::Offset2D(0, 0);
-		renderPassBeginInfo.setClearValueCount(static_cast<uint32_t>(clearValues.size()));
-		renderPassBeginInfo.setPClearValues(clearValues.data());
+		if (m_occluders.empty())
+			return;
 
-		// Inheritance info for the meshes command buffers
-		vk::CommandBufferInheritanceInfo inheritanceInfo = {};
-		inheritanceInfo.setRenderPass(m_renderPasses.offscreen);
-		inheritanceInfo.setFramebuffer(camera->frameBuffer);
+		// Transform occluders to clip space
+		m_occluderVertices.resize(m_occluders.size());
 
-		camera->commandBuffer.buffer.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+		for (size_t i = 0; i < m_occluders.size(); ++i)
+			m_threadPool->workers[i % workerCount]->addJob([this, i, viewProjection]()
+			{
+				const MeshData& mesh = m_meshes[m_occluders[i]];
+				const auto& vertices = mesh.mesh->getVertices();
+				const glm::mat4 mvp = viewProjection * mesh.model;
 
-		std::vector<vk::CommandBuffer> commandBuffers(m_meshes.size() + (camera->skybox != Handle<Cubemap>::nullHandle() ? 1 : 0));
+				m_occluderVertices[i].resize(vertices.size());
+				for (size_t j = 0; j < vertices.size(); ++j)
+					m_occluderVertices[i][j] = mvp * glm::vec4(vertices[j].position, 1.0f);
+			});
 
 		m_threadPool->wait();
 
-		if (camera->skybox != Handle<Cubemap>::nullHandle())
-		{
-			// Submit vertex data
+		// Rasterize occluders with each worker owning a band of rows
+		m_occlusionBuffer.clear();
+		const size_t height = m_occlusionBuffer.getHeight();
+
+		for (size_t i = 0; i < workerCount; ++i)
+			m_threadPool->workers[i]->addJob([this, i, workerCount, height]()
 			{
-				glm::mat4 model = {};
-				model = glm::translate(model, camera->viewPosition);
+				const auto rowBegin = static_cast<uint32_t>((height * i) / workerCount);
+				const auto rowEnd = static_cast<uint32_t>((height * (i + 1)) / workerCount);
+
+				for (size_t j = 0; j < m_occluders.size(); ++j)
+				{
+					const auto& indices = m_meshes[m_occluders[j]].mesh->getIndices();
+					m_occlusionBuffer.rasterize(m_occluderVertices[j].data(), indices.data(), indices.size(), rowBegin, rowEnd);
+				}
+			});
+
+		m_threadPool->wait();
+		m_occlusionBuffer.buildHiZ();
+
+		// Test meshes against the Hi-Z buffer in parallel chunks (Occluders are always kept)
+		const size_t visibleCount = m_visibleMeshes.size();
+		const size_t chunkCount = (visibleCount + GUST_CULLING_CHUNK_SIZE - 1) / GUST_CULLING_CHUNK_SIZE;
+		m_occlusionVisibility.resize(visibleCount);
+
+		for (size_t i = 0; i < chunkCount; ++i)
+			m_threadPool->workers[i % workerCount]->addJob([this, i, visibleCount, viewProjection]()
+			{
+				const size_t first = i * GUST_CULLING_CHUNK_SIZE;
+				const size_t last = std::min<size_t>(first + GUST_CULLING_CHUNK_SIZE, visibleCount);
+
+				for (size_t j = first; j < last; ++j)
+				{
+					const MeshData& mesh = m_meshes[m_visibleMeshes[j]];
+					m_occlusionVisibility[j] = mesh.occluder || m_occlusionBuffer.isVisible(mesh.bounds, viewProjection);
+				}
+			});
+
+		m_threadPool->wait();
+
+		// Remove hidden meshes
+		size_t keptCount = 0;
+
+		for (size_t i = 0; i < visibleCount; ++i)
+			if (m_occlusionVisibility[i])
+				m_visibleMeshes[keptCount++] = m_visibleMeshes[i];
+
+		m_visibleMeshes.resize(keptCount);
+		m_frameCullingStats.occluded += visibleCount - keptCount;
+	}
+
+	void Renderer::batchMeshes(Handle<VirtualCamera> camera)
+	{
+		// Static meshes have cached command buffers for the static cameras (Bindless draws are cheap enough to record every frame)
+		m_staticMeshes.clear();
+
+		if (camera.getHandle() < GUST_STATIC_CAMERA_COUNT && !m_graphics->isBindless())
+		{
+			const auto isStatic = [this](size_t meshIndex)
+			{
+				const MeshData& mesh = m_meshes[meshIndex];
+				return mesh.staticDraw != nullStaticDraw() && mesh.material->getShader()->supportsInstancing();
+			};
+
+			for (size_t meshIndex : m_visibleMeshes)
+				if (isStatic(meshIndex))
+					m_staticMeshes.push_back(meshIndex);
+
+			m_visibleMeshes.erase(std::remove_if(m_visibleMeshes.begin(), m_visibleMeshes.end(), isStatic), m_visibleMeshes.end());
+		}
+
+		// Build a sort key for every visible mesh
+		m_drawPackets.resize(m_visibleMeshes.size());
+
+		for (size_t i = 0; i < m_visibleMeshes.size(); ++i)
+		{
+			const MeshData& mesh = m_meshes[m_visibleMeshes[i]];
+
+			m_drawPackets[i].mesh = m_visibleMeshes[i];
+			m_drawPackets[i].key = makeSortKey
+			(
+				DrawPass::Opaque,
+				mesh.material->getShader().getHandle(),
+				mesh.material.getHandle(),
+				mesh.mesh.getHandle(),
+				glm::length(mesh.bounds.getCenter() - camera->viewPosition)
+			);
+		}
+
+		// Sort so draws sharing state are adjacent
+		sortDrawPackets(m_drawPackets, m_drawPacketScratch);
+
+		for (size_t i = 0; i < m_drawPackets.size(); ++i)
+			m_visibleMeshes[i] = m_drawPackets[i].mesh;
+
+		m_drawBatches.clear();
+
+		for (size_t i = 0; i < m_visibleMeshes.size();)
+		{
+			const MeshData& first = m_meshes[m_visibleMeshes[i]];
+
+			DrawBatch batch = {};
+			batch.first = i;
+			batch.count = 1;
+
+			// Extend the batch over every mesh sharing the mesh and material
+			if (first.material->getShader()->supportsInstancing() || m_graphics->isBindless())
+				while (i + batch.count < m_visibleMeshes.size())
+				{
+					const MeshData& next = m_meshes[m_visibleMeshes[i + batch.count]];
+
+					if (next.mesh.getHandle() != first.mesh.getHandle() || next.material.getHandle() != first.material.getHandle())
+						break;
+
+					++batch.count;
+				}
+
+			m_drawBatches.push_back(batch);
+			i += batch.count;
+		}
+
+		m_frameCullingStats.drawCalls += m_drawBatches.size() + m_staticMeshes.size();
+	}
+
+	void Renderer::recordDrawBatches
+	(
+		size_t firstBatch,
+		size_t batchCount,
+		const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+		const CommandBuffer& commandBuffer,
+		Handle<VirtualCamera> camera,
+		const std::array<uint32_t, 2>& cameraOffsets,
+		DrawStats& stats
+	)
+	{
+		const vk::CommandBuffer& buffer = commandBuffer.buffer;
+
+		vk::CommandBufferBeginInfo beginInfo = {};
+		beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eSimultaneousUse);
+		beginInfo.setPInheritanceInfo(&inheritanceInfo);
+
+		buffer.begin(beginInfo);
+
+		// Set viewport
+		vk::Viewport viewport = {};
+		viewport.setHeight((float)m_graphics->getHeight());
+		viewport.setWidth((float)m_graphics->getWidth());
+		viewport.setMinDepth(0);
+		viewport.setMaxDepth(1);
+		buffer.setViewport(0, 1, &viewport);
+
+		// Set scissor
+		vk::Rect2D scissor = {};
+		scissor.setExtent({ m_graphics->getWidth(), m_graphics->getHeight() });
+		scissor.setOffset({ 0, 0 });
+		buffer.setScissor(0, 1, &scissor);
+
+		// Currently bound state
+		vk::Pipeline boundPipeline = {};
+		vk::PipelineLayout boundLayout = {};
+		vk::DescriptorSet boundSet = {};
+		vk::DescriptorSet boundTextureSet = {};
+		std::array<uint32_t, 2> boundOffsets = {};
+		bool instanceBufferBound = false;
+		vk::Buffer boundVertexBuffer = {};
+		vk::IndexType boundIndexType = vk::IndexType::eUint32;
+
+		for (size_t i = firstBatch; i < firstBatch + batchCount; ++i)
+		{
+			const DrawBatch& batch = m_drawBatches[i];
+			const MeshData& mesh = m_meshes[m_visibleMeshes[batch.first]];
+			const Handle<Shader> shader = mesh.material->getShader();
+			const bool instanced = batch.count > 1;
+
+			// Instanced draws share the per camera data (Dynamic offsets are ordered by binding)
+			std::array<uint32_t, 2> dynamicOffsets = cameraOffsets;
+			uint32_t firstInstance = 0;
+
+			if (instanced)
+			{
+				uint32_t instanceOffset = 0;
+				if (!m_instanceRing->allocate(static_cast<vk::DeviceSize>(sizeof(InstanceData) * batch.count), instanceOffset))
+					break;
 
+				// Submit instance data (Allocations are multiples of the instance size, so they can be addressed by instance)
+				auto instances = static_cast<InstanceData*>(m_instanceRing->getMappedMemory(instanceOffset));
+
+				for (size_t j = 0; j < batch.count; ++j)
+				{
+					const MeshData& instance = m_meshes[m_visibleMeshes[batch.first + j]];
+					instances[j].model = instance.model;
+					setPositionQuantization(instances[j], instance.mesh);
+				}
+
+				firstInstance = instanceOffset / static_cast<uint32_t>(sizeof(InstanceData));
+			}
+			else
+			{
+				// Submit vertex data
 				VertexShaderData vData = {};
-				vData.model = model;
-				vData.MVP = camera->projection * camera->view * model;
+				vData.model = mesh.model;
+				vData.MVP = camera->projection * camera->view * mesh.model;
+				setPositionQuantization(vData, mesh.mesh);
+
+				if (!m_uniformRing->push(vData, dynamicOffsets[0]))
+					break;
+			}
+
+			// Bind graphics pipeline
+			const vk::Pipeline pipeline = instanced ? shader->getInstancedGraphicsPipeline() : shader->getGraphicsPipeline();
+
+			if (pipeline != boundPipeline)
+			{
+				buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+				boundPipeline = pipeline;
+				++stats.pipelineBinds;
+			}
+			else
+				++stats.pipelineBindsElided;
 
-				void* cpyData;
+			// Sets bound with another shaders layout must be rebound
+			const vk::PipelineLayout layout = shader->getGraphicsPipelineLayout();
 
-				m_graphics->getLogicalDevice().mapMemory
+			if (layout != boundLayout)
+			{
+				boundLayout = layout;
+				boundSet = vk::DescriptorSet();
+				boundTextureSet = vk::DescriptorSet();
+			}
+
+			// Bind per draw and material data
+			if (mesh.descriptorSets[0] != boundSet || dynamicOffsets != boundOffsets)
+			{
+				buffer.bindDescriptorSets
 				(
-					m_skyboxUniformBuffer.memory,
+					vk::PipelineBindPoint::eGraphics,
+					layout,
 					0,
-					sizeof(VertexShaderData),
-					(vk::MemoryMapFlagBits)0,
-					&cpyData
+					1,
+					&mesh.descriptorSets[0],
+					static_cast<uint32_t>(dynamicOffsets.size()),
+					dynamicOffsets.data()
 				);
 
-				memcpy(cpyData, &vData, sizeof(VertexShaderData));
-				m_graphics->getLogicalDevice().unmapMemory(m_skyboxUniformBuffer.memory);
+				boundSet = mesh.descriptorSets[0];
+				boundOffsets = dynamicOffsets;
+				++stats.descriptorSetBinds;
 			}
+			else
+				++stats.descriptorSetBindsElided;
 
-			// Bind descriptor sets
+			// Bind material textures
+			if (mesh.descriptorSets.size() > 1)
+			{
+				if (mesh.descriptorSets[1] != boundTextureSet)
+				{
+					buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout, 1, 1, &mesh.descriptorSets[1], 0, nullptr);
+					boundTextureSet = mesh.descriptorSets[1];
+					++stats.descriptorSetBinds;
+				}
+				else
+					++stats.descriptorSetBindsElided;
+			}
+
+			// Bind vertex and index buffer (Shared by every mesh in the same geometry block)
+			vk::Buffer vertexBuffer = mesh.mesh->getVertexUniformBuffer().buffer;
+			const vk::IndexType indexType = mesh.mesh->getIndexType();
+
+			if (vertexBuffer != boundVertexBuffer || indexType != boundIndexType)
+			{
+				vk::DeviceSize offset = 0;
+				buffer.bindVertexBuffers(0, 1, &vertexBuffer, &offset);
+				buffer.bindIndexBuffer(mesh.mesh->getIndexUniformBuffer().buffer, 0, indexType);
+				boundVertexBuffer = vertexBuffer;
+				boundIndexType = indexType;
+				++stats.vertexBufferBinds;
+			}
+			else
+				++stats.vertexBufferBindsElided;
+
+			// Bind instance buffer (Never moves since instances are addressed by the first instance)
+			if (instanced && !instanceBufferBound)
+			{
+				vk::Buffer instanceBuffer = m_instanceRing->getBuffer().buffer;
+				vk::DeviceSize offset = 0;
+				buffer.bindVertexBuffers(1, 1, &instanceBuffer, &offset);
+				instanceBufferBound = true;
+			}
+
+			// Draw
+			buffer.drawIndexed
+			(
+				static_cast<uint32_t>(mesh.mesh->getIndexCount()), 
+				static_cast<uint32_t>(batch.count), 
+				mesh.mesh->getFirstIndex(), 
+				mesh.mesh->getVertexOffset(), 
+				firstInstance
+			);
+		}
+
+		buffer.end();
+	}
+
+	void Renderer::recordBindlessDrawBatches
+	(
+		size_t firstBatch,
+		size_t batchCount,
+		const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+		const CommandBuffer& commandBuffer,
+		Handle<VirtualCamera> camera,
+		const std::array<uint32_t, 2>& cameraOffsets,
+		DrawStats& stats
+	)
+	{
+		const vk::CommandBuffer& buffer = commandBuffer.buffer;
+
+		vk::CommandBufferBeginInfo beginInfo = {};
+		beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eSimultaneousUse);
+		beginInfo.setPInheritanceInfo(&inheritanceInfo);
+
+		buffer.begin(beginInfo);
+
+		// Set viewport
+		vk::Viewport viewport = {};
+		viewport.setHeight((float)m_graphics->getHeight());
+		viewport.setWidth((float)m_graphics->getWidth());
+		viewport.setMinDepth(0);
+		viewport.setMaxDepth(1);
+		buffer.setViewport(0, 1, &viewport);
+
+		// Set scissor
+		vk::Rect2D scissor = {};
+		scissor.setExtent({ m_graphics->getWidth(), m_graphics->getHeight() });
+		scissor.setOffset({ 0, 0 });
+		buffer.setScissor(0, 1, &scissor);
+
+		// Every bindless shader shares the same set layouts
+		const std::array<vk::DescriptorSet, 2> descriptorSets =
+		{
+			m_graphics->getDescriptorHeap().getDescriptorSet(),
+			m_descriptors.bindlessDescriptorSet
+		};
+
+		// Currently bound state
+		vk::Pipeline boundPipeline = {};
+		bool setsBound = false;
+		vk::Buffer boundVertexBuffer = {};
+		vk::IndexType boundIndexType = vk::IndexType::eUint32;
+
+		for (size_t i = firstBatch; i < firstBatch + batchCount; ++i)
+		{
+			const DrawBatch& batch = m_drawBatches[i];
+			const MeshData& mesh = m_meshes[m_visibleMeshes[batch.first]];
+			const Handle<Shader> shader = mesh.material->getShader();
+
+			// Submit per draw data
+			uint32_t drawOffset = 0;
+			if (!m_instanceRing->allocate(static_cast<vk::DeviceSize>(sizeof(InstanceData) * batch.count), drawOffset))
+				break;
+
+			gAssert(drawOffset % sizeof(InstanceData) == 0);
+			auto draws = static_cast<InstanceData*>(m_instanceRing->getMappedMemory(drawOffset));
+
+			for (size_t j = 0; j < batch.count; ++j)
+			{
+				const MeshData& draw = m_meshes[m_visibleMeshes[batch.first + j]];
+				draws[j].model = draw.model;
+				setPositionQuantization(draws[j], draw.mesh);
+			}
+
+			// Bind graphics pipeline
+			const vk::Pipeline pipeline = shader->getGraphicsPipeline();
+
+			if (pipeline != boundPipeline)
+			{
+				buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+				boundPipeline = pipeline;
+				++stats.pipelineBinds;
+			}
+			else
+				++stats.pipelineBindsElided;
+
+			// Bind the heap and per camera data (Compatible layouts keep them bound across pipelines)
+			if (!setsBound)
+			{
+				buffer.bindDescriptorSets
+				(
+					vk::PipelineBindPoint::eGraphics,
+					shader->getGraphicsPipelineLayout(),
+					0,
+					static_cast<uint32_t>(descriptorSets.size()),
+					descriptorSets.data(),
+					static_cast<uint32_t>(cameraOffsets.size()),
+					cameraOffsets.data()
+				);
+
+				setsBound = true;
+				++stats.descriptorSetBinds;
+			}
+			else
+				++stats.descriptorSetBindsElided;
+
+			// Point the shader at its per draw data and material
+			BindlessDrawConstants constants = {};
+			constants.draw = drawOffset / static_cast<uint32_t>(sizeof(InstanceData));
+			constants.material = mesh.material->getHeapIndex();
+
+			buffer.pushConstants
+			(
+				shader->getGraphicsPipelineLayout(),
+				vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment,
+				0,
+				sizeof(BindlessDrawConstants),
+				&constants
+			);
+
+			// Bind vertex and index buffer (Shared by every mesh in the same geometry block)
+			vk::Buffer vertexBuffer = mesh.mesh->getVertexUniformBuffer().buffer;
+			const vk::IndexType indexType = mesh.mesh->getIndexType();
+
+			if (vertexBuffer != boundVertexBuffer || indexType != boundIndexType)
+			{
+				vk::DeviceSize offset = 0;
+				buffer.bindVertexBuffers(0, 1, &vertexBuffer, &offset);
+				buffer.bindIndexBuffer(mesh.mesh->getIndexUniformBuffer().buffer, 0, indexType);
+				boundVertexBuffer = vertexBuffer;
+				boundIndexType = indexType;
+				++stats.vertexBufferBinds;
+			}
+			else
+				++stats.vertexBufferBindsElided;
+
+			// Draw
+			buffer.drawIndexed
+			(
+				static_cast<uint32_t>(mesh.mesh->getIndexCount()), 
+				static_cast<uint32_t>(batch.count), 
+				mesh.mesh->getFirstIndex(), 
+				mesh.mesh->getVertexOffset(), 
+				0
+			);
+		}
+
+		buffer.end();
+	}
+
+	void Renderer::recordGpuDraws
+	(
+		const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+		const CommandBuffer& commandBuffer,
+		Handle<VirtualCamera> camera,
+		const std::array<uint32_t, 2>& cameraOffsets,
+		DrawStats& stats
+	)
+	{
+		const vk::CommandBuffer& buffer = commandBuffer.buffer;
+
+		vk::CommandBufferBeginInfo beginInfo = {};
+		beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eSimultaneousUse);
+		beginInfo.setPInheritanceInfo(&inheritanceInfo);
+
+		buffer.begin(beginInfo);
+
+		// Set viewport
+		vk::Viewport viewport = {};
+		viewport.setHeight((float)m_graphics->getHeight());
+		viewport.setWidth((float)m_graphics->getWidth());
+		viewport.setMinDepth(0);
+		viewport.setMaxDepth(1);
+		buffer.setViewport(0, 1, &viewport);
+
+		// Set scissor
+		vk::Rect2D scissor = {};
+		scissor.setExtent({ m_graphics->getWidth(), m_graphics->getHeight() });
+		scissor.setOffset({ 0, 0 });
+		buffer.setScissor(0, 1, &scissor);
+
+		// Every bindless shader shares the same set layouts
+		const std::array<vk::DescriptorSet, 2> descriptorSets =
+		{
+			m_graphics->getDescriptorHeap().getDescriptorSet(),
+			m_descriptors.bindlessDescriptorSet
+		};
+
+		// Currently bound state
+		vk::Pipeline boundPipeline = {};
+		bool setsBound = false;
+		vk::Buffer boundVertexBuffer = {};
+		vk::Buffer boundIndexBuffer = {};
+		vk::IndexType boundIndexType = vk::IndexType::eUint32;
+
+		// Bind everything a group needs except its index buffer
+		const auto bindGroup = [&](const Handle<Material>& material, uint32_t block)
+		{
+			const Handle<Shader> shader = material->getShader();
+
+			// Bind graphics pipeline
+			const vk::Pipeline pipeline = shader->getGraphicsPipeline();
+
+			if (pipeline != boundPipeline)
+			{
+				buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+				boundPipeline = pipeline;
+				++stats.pipelineBinds;
+			}
+			else
+				++stats.pipelineBindsElided;
+
+			// Bind the heap and per camera data (Compatible layouts keep them bound across pipelines)
+			if (!setsBound)
+			{
+				buffer.bindDescriptorSets
+				(
+					vk::PipelineBindPoint::eGraphics,
+					shader->getGraphicsPipelineLayout(),
+					0,
+					static_cast<uint32_t>(descriptorSets.size()),
+					descriptorSets.data(),
+					static_cast<uint32_t>(cameraOffsets.size()),
+					cameraOffsets.data()
+				);
+
+				setsBound = true;
+				++stats.descriptorSetBinds;
+			}
+			else
+				++stats.descriptorSetBindsElided;
+
+			// Instances index the frames model matrices from the first mesh
+			BindlessDrawConstants constants = {};
+			constants.draw = m_gpuModelOffset / static_cast<uint32_t>(sizeof(InstanceData));
+			constants.material = material->getHeapIndex();
+
+			buffer.pushConstants
+			(
+				shader->getGraphicsPipelineLayout(),
+				vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment,
+				0,
+				sizeof(BindlessDrawConstants),
+				&constants
+			);
+
+			// Bind the groups geometry block
+			vk::Buffer vertexBuffer = m_graphics->getGeometryPool().getVertexBuffer(block).buffer;
+
+			if (vertexBuffer != boundVertexBuffer)
+			{
+				vk::DeviceSize offset = 0;
+				buffer.bindVertexBuffers(0, 1, &vertexBuffer, &offset);
+				boundVertexBuffer = vertexBuffer;
+				++stats.vertexBufferBinds;
+			}
+			else
+				++stats.vertexBufferBindsElided;
+		};
+
+		const auto& groups = m_gpuCuller->getGroups();
+
+		for (size_t i = 0; i < groups.size(); ++i)
+		{
+			const GpuDrawGroup& group = groups[i];
+			bindGroup(group.material, group.block);
+
+			// Bind the groups index buffer
+			vk::Buffer indexBuffer = m_graphics->getGeometryPool().getIndexBuffer(group.block).buffer;
+
+			if (indexBuffer != boundIndexBuffer || group.indexType != boundIndexType)
+			{
+				buffer.bindIndexBuffer(indexBuffer, 0, group.indexType);
+				boundIndexBuffer = indexBuffer;
+				boundIndexType = group.indexType;
+			}
+
+			// Draw every visible mesh in the group
+			m_gpuCuller->draw(buffer, camera.getHandle(), i);
+		}
+
+		// Meshes culled by meshlet draw from the cameras own index buffer
+		if (m_clusterCuller)
+		{
+			const auto& clusterGroups = m_clusterCuller->getGroups();
+
+			for (size_t i = 0; i < clusterGroups.size(); ++i)
+			{
+				bindGroup(clusterGroups[i].material, clusterGroups[i].block);
+				m_clusterCuller->draw(buffer, camera.getHandle(), i);
+			}
+		}
+
+		buffer.end();
+	}
+
+	vk::CommandBuffer Renderer::recordStaticDraw
+	(
+		size_t meshIndex,
+		const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+		size_t threadIndex,
+		Handle<VirtualCamera> camera,
+		const std::array<uint32_t, 2>& cameraOffsets,
+		DrawStats& stats
+	)
+	{
+		const MeshData& mesh = m_meshes[meshIndex];
+		const Handle<Shader> shader = mesh.material->getShader();
+
+		// Cached draws are indexed by camera and frame
+		auto& cache = m_staticDraws[mesh.staticDraw].cache;
+		const size_t cacheIndex = camera.getHandle() * GUST_FRAMES_IN_FLIGHT + m_frameIndex;
+
+		if (cache.size() <= cacheIndex)
+			cache.resize(cacheIndex + 1);
+
+		CachedDraw& cachedDraw = cache[cacheIndex];
+
+		// The model matrix lives in the frames slot, so moving the mesh doesn't invalidate the command buffer
+		const size_t firstInstance = m_frameIndex * m_staticInstanceCapacity + mesh.staticDraw;
+		m_staticInstances[firstInstance].model = mesh.model;
+		setPositionQuantization(m_staticInstances[firstInstance], mesh.mesh);
+
+		// State the command buffer depends on
+		CachedDraw state = {};
+		state.commandBuffer = cachedDraw.commandBuffer;
+		state.mesh = mesh.mesh;
+		state.material = mesh.material;
+		state.pipeline = shader->getInstancedGraphicsPipeline();
+		state.framebuffer = inheritanceInfo.framebuffer;
+		state.descriptorSets[0] = mesh.descriptorSets[0];
+		state.descriptorSets[1] = mesh.descriptorSets.size() > 1 ? mesh.descriptorSets[1] : vk::DescriptorSet();
+		state.dynamicOffsets = cameraOffsets;
+		state.instanceBuffer = m_staticInstanceBuffer.buffer;
+
+		if
+		(
+			cachedDraw.commandBuffer.buffer &&
+			cachedDraw.mesh == state.mesh &&
+			cachedDraw.material == state.material &&
+			cachedDraw.pipeline == state.pipeline &&
+			cachedDraw.framebuffer == state.framebuffer &&
+			cachedDraw.descriptorSets == state.descriptorSets &&
+			cachedDraw.dynamicOffsets == state.dynamicOffsets &&
+			cachedDraw.instanceBuffer == state.instanceBuffer
+		)
+		{
+			++stats.staticBuffersReused;
+			return cachedDraw.commandBuffer.buffer;
+		}
+
+		// Command buffers are only ever recorded on the thread owning their pool
+		if (!state.commandBuffer.buffer)
+			state.commandBuffer = createCommandBuffer(vk::CommandBufferLevel::eSecondary, threadIndex);
+
+		const vk::CommandBuffer& buffer = state.commandBuffer.buffer;
+
+		vk::CommandBufferBeginInfo beginInfo = {};
+		beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eSimultaneousUse);
+		beginInfo.setPInheritanceInfo(&inheritanceInfo);
+
+		buffer.begin(beginInfo);
+
+		// Set viewport
+		vk::Viewport viewport = {};
+		viewport.setHeight((float)m_graphics->getHeight());
+		viewport.setWidth((float)m_graphics->getWidth());
+		viewport.setMinDepth(0);
+		viewport.setMaxDepth(1);
+		buffer.setViewport(0, 1, &viewport);
+
+		// Set scissor
+		vk::Rect2D scissor = {};
+		scissor.setExtent({ m_graphics->getWidth(), m_graphics->getHeight() });
+		scissor.setOffset({ 0, 0 });
+		buffer.setScissor(0, 1, &scissor);
+
+		// Bind graphics pipeline
+		buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, state.pipeline);
+
+		// Bind descriptor sets
+		buffer.bindDescriptorSets
+		(
+			vk::PipelineBindPoint::eGraphics,
+			shader->getGraphicsPipelineLayout(),
+			0,
+			static_cast<uint32_t>(mesh.descriptorSets.size()),
+			mesh.descriptorSets.data(),
+			static_cast<uint32_t>(cameraOffsets.size()),
+			cameraOffsets.data()
+		);
+
+		// Bind vertex, instance and index buffers
+		std::array<vk::Buffer, 2> vertexBuffers = { mesh.mesh->getVertexUniformBuffer().buffer, m_staticInstanceBuffer.buffer };
+		std::array<vk::DeviceSize, 2> offsets = { 0, 0 };
+		buffer.bindVertexBuffers(0, static_cast<uint32_t>(vertexBuffers.size()), vertexBuffers.data(), offsets.data());
+		buffer.bindIndexBuffer(mesh.mesh->getIndexUniformBuffer().buffer, 0, mesh.mesh->getIndexType());
+
+		// Draw
+		buffer.drawIndexed
+		(
+			static_cast<uint32_t>(mesh.mesh->getIndexCount()), 
+			1, 
+			mesh.mesh->getFirstIndex(), 
+			mesh.mesh->getVertexOffset(), 
+			static_cast<uint32_t>(firstInstance)
+		);
+		buffer.end();
+
+		cachedDraw = state;
+		++stats.staticBuffersRecorded;
+		return buffer;
+	}
+
+	void Renderer::drawToCamera(Handle<VirtualCamera> camera)
+	{
+		CameraFrame& frame = camera->frames[m_frameIndex];
+
+		vk::CommandBufferBeginInfo cmdBufInfo = {};
+		cmdBufInfo.setFlags(vk::CommandBufferUsageFlagBits::eSimultaneousUse);
+		cmdBufInfo.setPInheritanceInfo(nullptr);
+
+		// Begin renderpass
+		frame.commandBuffer.buffer.begin(cmdBufInfo);
+
+		// Cull on the GPU before the render pass begins (Dispatches aren't allowed inside one)
+		bool gpuDraw = m_gpuFrame;
+
+		if (gpuDraw)
+		{
+			m_gpuCuller->cull(frame.commandBuffer.buffer, camera.getHandle(), camera->projection * camera->view);
+
+			if (m_clusterCuller)
+				m_clusterCuller->cull(frame.commandBuffer.buffer, camera.getHandle(), camera->projection * camera->view, camera->viewPosition);
+		}
+
+		// Clear values for all attachments written in the fragment shader
+		std::array<vk::ClearValue, 5> clearValues;
+		clearValues[0].setColor(std::array<float, 4>{ 0.0f, 0.0f, 0.0f, 0.0f });
+		clearValues[1].setColor(std::array<float, 4>{ 0.0f, 0.0f, 0.0f, 0.0f });
+		clearValues[2].setColor(std::array<float, 4>{ camera->clearColor.x, camera->clearColor.y, camera->clearColor.z, 0.0f });
+		clearValues[3].setColor(std::array<float, 4>{ 0.0f, 0.0f, 0.0f, 0.0f });
+		clearValues[4].setDepthStencil({ 1.0f, 0 });
+
+		vk::RenderPassBeginInfo renderPassBeginInfo = {};
+		renderPassBeginInfo.setRenderPass(m_renderPasses.offscreen);
+		renderPassBeginInfo.setFramebuffer(camera->frameBuffer);
+		renderPassBeginInfo.renderArea.setExtent(vk::Extent2D(m_graphics->getWidth(), m_graphics->getHeight()));
+		renderPassBeginInfo.renderArea.offset = vk::Offset2D(0, 0);
+		renderPassBeginInfo.setClearValueCount(static_cast<uint32_t>(clearValues.size()));
+		renderPassBeginInfo.setPClearValues(clearValues.data());
+
+		// Inheritance info for the meshes command buffers
+		vk::CommandBufferInheritanceInfo inheritanceInfo = {};
+		inheritanceInfo.setRenderPass(m_renderPasses.offscreen);
+		inheritanceInfo.setFramebuffer(camera->frameBuffer);
+
+		frame.commandBuffer.buffer.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+
+		m_threadPool->wait();
+
+		// Remove meshes outside the cameras view and group the rest (The GPU does both itself)
+		if (gpuDraw)
+		{
+			m_visibleMeshes.clear();
+			m_staticMeshes.clear();
+			m_drawBatches.clear();
+			m_frameCullingStats.drawCalls += m_gpuCuller->getGroups().size();
+
+			if (m_clusterCuller)
+				m_frameCullingStats.drawCalls += m_clusterCuller->getGroups().size();
+		}
+		else
+		{
+			cullMeshes(camera);
+			batchMeshes(camera);
+		}
+
+		camera->hasMeshCandidates = false;
+
+		// Submit data shared by every draw (Instanced shaders only read the view projection matrix)
+		VertexShaderData vData = {};
+		vData.MVP = camera->projection * camera->view;
+
+		FragmentShaderData fData = {};
+		fData.viewPosition = glm::vec4(camera->viewPosition, 1);
+
+		std::array<uint32_t, 2> cameraOffsets = {};
+
+		if (camera.getHandle() < GUST_STATIC_CAMERA_COUNT)
+		{
+			// Static cameras write to the same place every frame so cached draws stay valid
+			cameraOffsets[0] = m_uniformRing->getReservedOffset(m_cameraDataOffsets[camera.getHandle()][0]);
+			cameraOffsets[1] = m_uniformRing->getReservedOffset(m_cameraDataOffsets[camera.getHandle()][1]);
+			std::memcpy(m_uniformRing->getMappedMemory(cameraOffsets[0]), &vData, sizeof(VertexShaderData));
+			std::memcpy(m_uniformRing->getMappedMemory(cameraOffsets[1]), &fData, sizeof(FragmentShaderData));
+		}
+		else if (!m_uniformRing->push(vData, cameraOffsets[0]) || !m_uniformRing->push(fData, cameraOffsets[1]))
+		{
+			m_drawBatches.clear();
+			gpuDraw = false;
+		}
+
+		// Split batches into one contiguous range per worker so sorted state stays together
+		const bool drawSkybox = camera->skybox != Handle<Cubemap>::nullHandle() && camera->skybox->isReady();
+		const size_t skyboxCount = drawSkybox ? 1 : 0;
+		const size_t rangeCount = std::min(m_threadPool->getWorkerCount(), m_drawBatches.size());
+
+		const size_t gpuDrawCount = gpuDraw ? 1 : 0;
+
+		std::vector<vk::CommandBuffer> commandBuffers(rangeCount + skyboxCount + m_staticMeshes.size() + gpuDrawCount);
+		m_workerDrawStats.assign(m_threadPool->getWorkerCount(), DrawStats());
+
+		if (drawSkybox)
+		{
+			// Submit vertex data
+			uint32_t skyboxOffset = 0;
+			{
+				glm::mat4 model = {};
+				model = glm::translate(model, camera->viewPosition);
+
+				VertexShaderData vData = {};
+				vData.model = model;
+				vData.MVP = camera->projection * camera->view * model;
+				setPositionQuantization(vData, m_skybox);
+
+				m_uniformRing->push(vData, skyboxOffset);
+			}
+
+			// Bind descriptor sets (The frames set is not in use by the GPU)
 			{
-				std::array<vk::WriteDescriptorSet, 2> writeSets = {};
-
-				// Vertex data
-				vk::DescriptorBufferInfo gustVertexBufferInfo = {};
-				gustVertexBufferInfo.setBuffer(m_skyboxUniformBuffer.buffer);
-				gustVertexBufferInfo.setOffset(0);
-				gustVertexBufferInfo.setRange(static_cast<vk::DeviceSize>(sizeof(VertexShaderData)));
-
-				writeSets[0].setDstSet(m_descriptors.skyboxDescriptorSet);
-				writeSets[0].setDstBinding(0);
-				writeSets[0].setDstArrayElement(0);
-				writeSets[0].setDescriptorType(vk::DescriptorType::eUniformBuffer);
-				writeSets[0].setDescriptorCount(1);
-				writeSets[0].setPBufferInfo(&gustVertexBufferInfo);
-				writeSets[0].setPImageInfo(nullptr);
-				writeSets[0].setPTexelBufferView(nullptr);
-
-				// GUST fragment buffer
 				vk::DescriptorImageInfo samplerInfo = {};
 				samplerInfo.setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
 				samplerInfo.setImageView(camera->skybox->getImageView());
 				samplerInfo.setSampler(camera->skybox->getSampler());
 
-				writeSets[1].setDstSet(m_descriptors.skyboxDescriptorSet);
-				writeSets[1].setDstBinding(1);
-				writeSets[1].setDstArrayElement(0);
-				writeSets[1].setDescriptorType(vk::DescriptorType::eCombinedImageSampler);
-				writeSets[1].setDescriptorCount(1);
-				writeSets[1].setPImageInfo(&samplerInfo);
+				vk::WriteDescriptorSet writeSet = {};
+				writeSet.setDstSet(frame.skyboxDescriptorSet);
+				writeSet.setDstBinding(1);
+				writeSet.setDstArrayElement(0);
+				writeSet.setDescriptorType(vk::DescriptorType::eCombinedImageSampler);
+				writeSet.setDescriptorCount(1);
+				writeSet.setPImageInfo(&samplerInfo);
 
 				// Update descriptor sets
-				m_graphics->getLogicalDevice().updateDescriptorSets(static_cast<uint32_t>(writeSets.size()), writeSets.data(), 0, nullptr);
+				m_graphics->getLogicalDevice().updateDescriptorSets(1, &writeSet, 0, nullptr);
 			}
 
 			vk::CommandBufferBeginInfo beginInfo = {};
 			beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eSimultaneousUse);
 			beginInfo.setPInheritanceInfo(&inheritanceInfo);
 
-			m_commands.skybox.buffer.begin(beginInfo);
+			const vk::CommandBuffer& skyboxBuffer = frame.skyboxCommandBuffer.buffer;
+			skyboxBuffer.begin(beginInfo);
 
 			// Set viewport
 			vk::Viewport viewport = {};
@@ -1862,67 +2942,137 @@ namespace gust
 			viewport.setWidth((float)m_graphics->getWidth());
 			viewport.setMinDepth(0);
 			viewport.setMaxDepth(1);
-			m_commands.skybox.buffer.setViewport(0, 1, &viewport);
+			skyboxBuffer.setViewport(0, 1, &viewport);
 
 			// Set scissor
 			vk::Rect2D scissor = {};
 			scissor.setExtent({ m_graphics->getWidth(), m_graphics->getHeight() });
 			scissor.setOffset({ 0, 0 });
-			m_commands.skybox.buffer.setScissor(0, 1, &scissor);
+			skyboxBuffer.setScissor(0, 1, &scissor);
 
 			// Bind graphics pipeline
-			m_commands.skybox.buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_skyboxShader.graphicsPipeline);
+			skyboxBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_skyboxShader.graphicsPipeline);
 
 			// Bind descriptor sets
-			m_commands.skybox.buffer.bindDescriptorSets
+			skyboxBuffer.bindDescriptorSets
 			(
 				vk::PipelineBindPoint::eGraphics,
 				m_skyboxShader.graphicsPipelineLayout,
 				0,
 				1,
-				&m_descriptors.skyboxDescriptorSet,
-				0,
-				nullptr
+				&frame.skyboxDescriptorSet,
+				1,
+				&skyboxOffset
 			);
 
 			// Bind vertex and index buffer
 			vk::Buffer vertexBuffer = m_skybox->getVertexUniformBuffer().buffer;
 			vk::DeviceSize offset = 0;
-			m_commands.skybox.buffer.bindVertexBuffers(0, 1, &vertexBuffer, &offset);
-			m_commands.skybox.buffer.bindIndexBuffer(m_skybox->getIndexUniformBuffer().buffer, 0, vk::IndexType::eUint32);
+			skyboxBuffer.bindVertexBuffers(0, 1, &vertexBuffer, &offset);
+			skyboxBuffer.bindIndexBuffer(m_skybox->getIndexUniformBuffer().buffer, 0, m_skybox->getIndexType());
 
 			// Draw
-			m_commands.skybox.buffer.drawIndexed(static_cast<uint32_t>(m_skybox->getIndexCount()), 1, 0, 0, 0);
-			m_commands.skybox.buffer.end();
+			skyboxBuffer.drawIndexed(static_cast<uint32_t>(m_skybox->getIndexCount()), 1, m_skybox->getFirstIndex(), m_skybox->getVertexOffset(), 0);
+			skyboxBuffer.end();
+
+			commandBuffers[0] = skyboxBuffer;
+		}
+
+		// Record each range on its own worker
+		for (size_t i = 0; i < rangeCount; ++i)
+		{
+			const size_t firstBatch = (m_drawBatches.size() * i) / rangeCount;
+			const size_t batchCount = (m_drawBatches.size() * (i + 1)) / rangeCount - firstBatch;
+			const CommandBuffer drawBuffer = frame.drawCommandBuffers[i];
+			commandBuffers[i + skyboxCount] = drawBuffer.buffer;
+
+			m_threadPool->workers[i]->addJob([this, i, firstBatch, batchCount, inheritanceInfo, drawBuffer, camera, cameraOffsets]()
+			{
+				if (m_graphics->isBindless())
+					this->recordBindlessDrawBatches
+					(
+						firstBatch, 
+						batchCount, 
+						inheritanceInfo, 
+						drawBuffer, 
+						camera, 
+						cameraOffsets, 
+						m_workerDrawStats[i]
+					);
+				else
+					this->recordDrawBatches
+					(
+						firstBatch, 
+						batchCount, 
+						inheritanceInfo, 
+						drawBuffer, 
+						camera, 
+						cameraOffsets, 
+						m_workerDrawStats[i]
+					);
+			});
+		}
+
+		// Static meshes always use the same worker since their command buffers belong to its pool
+		for (size_t i = 0; i < m_staticMeshes.size(); ++i)
+		{
+			const size_t meshIndex = m_staticMeshes[i];
+			const size_t threadIndex = m_meshes[meshIndex].staticDraw % m_threadPool->getWorkerCount();
+			vk::CommandBuffer* commandBuffer = &commandBuffers[rangeCount + skyboxCount + i];
 
-			commandBuffers[0] = m_commands.skybox.buffer;
+			m_threadPool->workers[threadIndex]->addJob([this, meshIndex, threadIndex, commandBuffer, inheritanceInfo, camera, cameraOffsets]()
+			{
+				*commandBuffer = this->recordStaticDraw
+				(
+					meshIndex, 
+					inheritanceInfo, 
+					threadIndex, 
+					camera, 
+					cameraOffsets, 
+					m_workerDrawStats[threadIndex]
+				);
+			});
 		}
 
-		// Loop over meshes
-		for (size_t i = 0; i < m_meshes.size(); ++i)
+		// Every GPU culled group goes in one buffer (No batches were recorded, so the first draw buffer is free)
+		if (gpuDraw)
 		{
-			commandBuffers[i + (camera->skybox != Handle<Cubemap>::nullHandle() ? 1 : 0)] = m_meshes[i].commandBuffer.buffer;
+			const CommandBuffer drawBuffer = frame.drawCommandBuffers[0];
+			commandBuffers.back() = drawBuffer.buffer;
 
-			m_threadPool->workers[m_meshes[i].commandBuffer.index]->addJob([this, i, inheritanceInfo, camera]()
+			m_threadPool->workers[0]->addJob([this, inheritanceInfo, drawBuffer, camera, cameraOffsets]()
 			{
-				this->drawMeshToFramebuffer(m_meshes[i], inheritanceInfo, m_meshes[i].commandBuffer.index, camera);
+				this->recordGpuDraws(inheritanceInfo, drawBuffer, camera, cameraOffsets, m_workerDrawStats[0]);
 			});
 		}
 
 		m_threadPool->wait();
 
+		// Gather draw statistics
+		for (const DrawStats& stats : m_workerDrawStats)
+		{
+			m_frameDrawStats.pipelineBinds += stats.pipelineBinds;
+			m_frameDrawStats.pipelineBindsElided += stats.pipelineBindsElided;
+			m_frameDrawStats.descriptorSetBinds += stats.descriptorSetBinds;
+			m_frameDrawStats.descriptorSetBindsElided += stats.descriptorSetBindsElided;
+			m_frameDrawStats.vertexBufferBinds += stats.vertexBufferBinds;
+			m_frameDrawStats.vertexBufferBindsElided += stats.vertexBufferBindsElided;
+			m_frameDrawStats.staticBuffersRecorded += stats.staticBuffersRecorded;
+			m_frameDrawStats.staticBuffersReused += stats.staticBuffersReused;
+		}
+
 		// Execute command buffers and perform lighting
 		if (commandBuffers.size() > 0)
-			camera->commandBuffer.buffer.executeCommands(commandBuffers);
+			frame.commandBuffer.buffer.executeCommands(commandBuffers);
 
-		camera->commandBuffer.buffer.endRenderPass();
-		camera->commandBuffer.buffer.end();
+		frame.commandBuffer.buffer.endRenderPass();
+		frame.commandBuffer.buffer.end();
 
 		vk::SubmitInfo submitInfo = {};
 		submitInfo.setCommandBufferCount(1);
-		submitInfo.setPCommandBuffers(&camera->commandBuffer.buffer);
+		submitInfo.setPCommandBuffers(&frame.commandBuffer.buffer);
 		submitInfo.setSignalSemaphoreCount(1);
-		submitInfo.setPSignalSemaphores(&m_semaphores.offscreen);
+		submitInfo.setPSignalSemaphores(&frame.offscreen);
 
 		// Submit draw command
 		m_graphics->getGraphicsQueue().submit(1, &submitInfo, { nullptr });
@@ -1933,65 +3083,14 @@ namespace gust
 
 	void Renderer::performCameraLighting(Handle<VirtualCamera> camera)
 	{
-		std::array<vk::WriteDescriptorSet, 4> sets = {};
-
-		vk::DescriptorImageInfo position = {};
-		position.setImageLayout(vk::ImageLayout::eColorAttachmentOptimal);
-		position.setImageView(m_mainCamera->position->getImageView());
-		position.setSampler(m_mainCamera->position->getSampler());
-
-		vk::DescriptorImageInfo normal = {};
-		normal.setImageLayout(vk::ImageLayout::eColorAttachmentOptimal);
-		normal.setImageView(m_mainCamera->normal->getImageView());
-		normal.setSampler(m_mainCamera->normal->getSampler());
-
-		vk::DescriptorImageInfo color = {};
-		color.setImageLayout(vk::ImageLayout::eColorAttachmentOptimal);
-		color.setImageView(m_mainCamera->color->getImageView());
-		color.setSampler(m_mainCamera->color->getSampler());
-
-		vk::DescriptorImageInfo misc = {};
-		misc.setImageLayout(vk::ImageLayout::eColorAttachmentOptimal);
-		misc.setImageView(m_mainCamera->misc->getImageView());
-		misc.setSampler(m_mainCamera->misc->getSampler());
-
-		sets[0].setDstSet(m_descriptors.lightingDescriptorSet);
-		sets[0].setDstBinding(1);
-		sets[0].setDstArrayElement(0);
-		sets[0].setDescriptorType(vk::DescriptorType::eCombinedImageSampler);
-		sets[0].setDescriptorCount(1);
-		sets[0].setPImageInfo(&position);
-
-		sets[1].setDstSet(m_descriptors.lightingDescriptorSet);
-		sets[1].setDstBinding(2);
-		sets[1].setDstArrayElement(0);
-		sets[1].setDescriptorType(vk::DescriptorType::eCombinedImageSampler);
-		sets[1].setDescriptorCount(1);
-		sets[1].setPImageInfo(&normal);
-
-		sets[2].setDstSet(m_descriptors.lightingDescriptorSet);
-		sets[2].setDstBinding(3);
-		sets[2].setDstArrayElement(0);
-		sets[2].setDescriptorType(vk::DescriptorType::eCombinedImageSampler);
-		sets[2].setDescriptorCount(1);
-		sets[2].setPImageInfo(&color);
-
-		sets[3].setDstSet(m_descriptors.lightingDescriptorSet);
-		sets[3].setDstBinding(4);
-		sets[3].setDstArrayElement(0);
-		sets[3].setDescriptorType(vk::DescriptorType::eCombinedImageSampler);
-		sets[3].setDescriptorCount(1);
-		sets[3].setPImageInfo(&misc);
-
-		// Update lighting descriptor set
-		m_graphics->getLogicalDevice().updateDescriptorSets(static_cast<uint32_t>(sets.size()), sets.data(), 0, nullptr);
+		CameraFrame& frame = camera->frames[m_frameIndex];
 
 		vk::CommandBufferBeginInfo cmdBufInfo = {};
 		cmdBufInfo.setFlags(vk::CommandBufferUsageFlagBits::eSimultaneousUse);
 		cmdBufInfo.setPInheritanceInfo(nullptr);
 
 		// Begin renderpass
-		camera->lightingCommandBuffer.buffer.begin(cmdBufInfo);
+		frame.lightingCommandBuffer.buffer.begin(cmdBufInfo);
 
 		vk::RenderPassBeginInfo renderPassBeginInfo = {};
 		renderPassBeginInfo.setRenderPass(m_renderPasses.lighting);
@@ -2001,48 +3100,49 @@ namespace gust
 		renderPassBeginInfo.setClearValueCount(0);
 		renderPassBeginInfo.setPClearValues(nullptr);
 
-		camera->lightingCommandBuffer.buffer.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
+		frame.lightingCommandBuffer.buffer.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
 
 		// Bind descriptor sets
-		camera->lightingCommandBuffer.buffer.bindDescriptorSets
+		frame.lightingCommandBuffer.buffer.bindDescriptorSets
 		(
 			vk::PipelineBindPoint::eGraphics,
 			m_lightingShader.graphicsPipelineLayout,
 			0,
 			1,
-			&m_descriptors.lightingDescriptorSet,
+			&m_frames[m_frameIndex].lightingDescriptorSet,
 			0,
 			nullptr
 		);
 
 		// Bind graphics pipeline
-		camera->lightingCommandBuffer.buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_lightingShader.graphicsPipeline);
+		frame.lightingCommandBuffer.buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_lightingShader.graphicsPipeline);
 
 		// Bind vertex and index buffer
 		vk::Buffer vertexBuffer = m_screenQuad->getVertexUniformBuffer().buffer;
 		vk::DeviceSize offset = 0;
-		camera->lightingCommandBuffer.buffer.bindVertexBuffers(0, 1, &vertexBuffer, &offset);
-		camera->lightingCommandBuffer.buffer.bindIndexBuffer(m_screenQuad->getIndexUniformBuffer().buffer, 0, vk::IndexType::eUint32);
+		frame.lightingCommandBuffer.buffer.bindVertexBuffers(0, 1, &vertexBuffer, &offset);
+		frame.lightingCommandBuffer.buffer.bindIndexBuffer(m_screenQuad->getIndexUniformBuffer().buffer, 0, m_screenQuad->getIndexType());
 
 		// Draw
-		camera->lightingCommandBuffer.buffer.drawIndexed(static_cast<uint32_t>(m_screenQuad->getIndexCount()), 1, 0, 0, 0);
+		frame.lightingCommandBuffer.buffer.drawIndexed(static_cast<uint32_t>(m_screenQuad->getIndexCount()), 1, m_screenQuad->getFirstIndex(), m_screenQuad->getVertexOffset(), 0);
 
-		camera->lightingCommandBuffer.buffer.endRenderPass();
-		camera->lightingCommandBuffer.buffer.end();
+		frame.lightingCommandBuffer.buffer.endRenderPass();
+		frame.lightingCommandBuffer.buffer.end();
 
 		vk::PipelineStageFlags flags = vk::PipelineStageFlagBits::eAllGraphics;
 
 		vk::SubmitInfo submitInfo = {};
 		submitInfo.setCommandBufferCount(1);
-		submitInfo.setPCommandBuffers(&camera->lightingCommandBuffer.buffer);
+		submitInfo.setPCommandBuffers(&frame.lightingCommandBuffer.buffer);
 		submitInfo.setWaitSemaphoreCount(1);
-		submitInfo.setPWaitSemaphores(&m_semaphores.offscreen);
+		submitInfo.setPWaitSemaphores(&frame.offscreen);
 		submitInfo.setSignalSemaphoreCount(1);
-		submitInfo.setPSignalSemaphores(&m_semaphores.offscreen);
+		submitInfo.setPSignalSemaphores(&frame.lighting);
 		submitInfo.setPWaitDstStageMask(&flags);
 
-		// Submit draw command
+		// Submit draw command (The frames final pass waits on the lighting)
 		m_graphics->getGraphicsQueue().submit(1, &submitInfo, { nullptr });
+		m_frameSemaphores.push_back(frame.lighting);
 	}
 
 	CommandBuffer Renderer::createCommandBuffer(vk::CommandBufferLevel level)
@@ -2064,10 +3164,61 @@ namespace gust
 		return { commandBuffer[0], poolIndex };
 	}
 
+	CommandBuffer Renderer::createCommandBuffer(vk::CommandBufferLevel level, size_t threadIndex)
+	{
+		// Allocate command buffer
+		auto commandBuffer = m_graphics->getLogicalDevice().allocateCommandBuffers
+		(
+			vk::CommandBufferAllocateInfo
+			(
+				m_commands.pools[threadIndex],
+				level,
+				1
+			)
+		);
+
+		return { commandBuffer[0], threadIndex };
+	}
+
 	Handle<VirtualCamera> Renderer::setMainCamera(const Handle<VirtualCamera>& camera)
 	{
+		// Descriptor sets and command buffers below may be used by frames in flight
+		m_graphics->getLogicalDevice().waitIdle();
+
 		m_mainCamera = camera;
 
+		// Lighting reads the main cameras attachments
+		std::array<vk::DescriptorImageInfo, 4> attachments = {};
+		attachments[0].setImageView(m_mainCamera->position->getImageView());
+		attachments[0].setSampler(m_mainCamera->position->getSampler());
+		attachments[1].setImageView(m_mainCamera->normal->getImageView());
+		attachments[1].setSampler(m_mainCamera->normal->getSampler());
+		attachments[2].setImageView(m_mainCamera->color->getImageView());
+		attachments[2].setSampler(m_mainCamera->color->getSampler());
+		attachments[3].setImageView(m_mainCamera->misc->getImageView());
+		attachments[3].setSampler(m_mainCamera->misc->getSampler());
+
+		for (auto& attachment : attachments)
+			attachment.setImageLayout(vk::ImageLayout::eColorAttachmentOptimal);
+
+		for (auto& frame : m_frames)
+		{
+			std::array<vk::WriteDescriptorSet, 4> sets = {};
+
+			for (size_t i = 0; i < sets.size(); ++i)
+			{
+				sets[i].setDstSet(frame.lightingDescriptorSet);
+				sets[i].setDstBinding(static_cast<uint32_t>(i + 1));
+				sets[i].setDstArrayElement(0);
+				sets[i].setDescriptorType(vk::DescriptorType::eCombinedImageSampler);
+				sets[i].setDescriptorCount(1);
+				sets[i].setPImageInfo(&attachments[i]);
+			}
+
+			// Update lighting descriptor set
+			m_graphics->getLogicalDevice().updateDescriptorSets(static_cast<uint32_t>(sets.size()), sets.data(), 0, nullptr);
+		}
+
 		vk::WriteDescriptorSet set = {};
 
 		vk::DescriptorImageInfo color = {};
@@ -36,7 +36,7 @@
  * @def GUST_LIGHTING_VERTEX_SHADER_PATH
  * @brief Path to the file containing the lighting rendering vertex shader.
  */
-#define GUST_LIGHTING_VERTEX_SHADER_PATH "./Shaders/lighting-vert.spv"
+#define GUST_LIGHTING_VERTEX_SHADER_PATH "./Shaders/lighting" GUST_VERTEX_SHADER_SUFFIX
 
 /**
  * @def GUST_SCREEN_FRAGMENT_SHADER_PATH
@@ -48,19 +48,19 @@
  * @def GUST_SCREEN_VERTEX_SHADER_PATH
  * @brief Path to the file containing the screen rendering vertex shader.
  */
-#define GUST_SCREEN_VERTEX_SHADER_PATH "./Shaders/screen-vert.spv"
+#define GUST_SCREEN_VERTEX_SHADER_PATH "./Shaders/screen" GUST_VERTEX_SHADER_SUFFIX
 
 /**
  * @def GUST_SKYBOX_MESH_PATH
  * @brief Path to the file containing the cube used for a skybox.
  */
-#define GUST_SKYBOX_MESH_PATH "./Meshes/Skybox.obj"
+#define GUST_SKYBOX_MESH_PATH "./Meshes/Skybox.gmesh"
 
 /**
  * @def GUST_SKYBOX_VERTEX_SHADER_PATH
  * @brief Path to the file containing the skybox vertex shader.
  */
-#define GUST_SKYBOX_VERTEX_SHADER_PATH "./Shaders/skybox-vert.spv"
+#define GUST_SKYBOX_VERTEX_SHADER_PATH "./Shaders/skybox" GUST_VERTEX_SHADER_SUFFIX
 
 /**
  * @def GUST_SKYBOX_FRAGMENT_SHADER_PATH
@@ -68,10 +68,48 @@
  */
 #define GUST_SKYBOX_FRAGMENT_SHADER_PATH "./Shaders/skybox-frag.spv"
 
+/**
+ * @def GUST_CULLING_CHUNK_SIZE
+ * @brief Number of meshes frustum culled by a single job.
+ */
+#define GUST_CULLING_CHUNK_SIZE 1024
+
+/**
+ * @def GUST_UNIFORM_RING_FRAME_SIZE
+ * @brief Bytes of per draw uniform data available to a single frame.
+ */
+#define GUST_UNIFORM_RING_FRAME_SIZE (16 * 1024 * 1024)
+
+/**
+ * @def GUST_FRAMES_IN_FLIGHT
+ * @brief Number of frames the CPU may record ahead of the GPU.
+ */
+#define GUST_FRAMES_IN_FLIGHT 2
+
+/**
+ * @def GUST_STATIC_CAMERA_COUNT
+ * @brief Number of cameras whose per frame data has a fixed place in the uniform ring buffer.
+ * @note Static meshes are only cached for these cameras.
+ */
+#define GUST_STATIC_CAMERA_COUNT 16
+
+/**
+ * @def GUST_INSTANCE_RING_FRAME_SIZE
+ * @brief Bytes of per instance data available to a single frame.
+ * @note Twice what the GPU culler starts with, so compressed vertices (Larger instances) get more room.
+ */
+#define GUST_INSTANCE_RING_FRAME_SIZE (2 * GUST_GPU_CULLING_INITIAL_OBJECTS * sizeof(InstanceData))
+
 /** Includes. */
 #include <queue>
 #include <Allocators.hpp>
 #include <Threading.hpp>
+#include <Frustum.hpp>
+#include "OcclusionBuffer.hpp"
+#include "UniformRingBuffer.hpp"
+#include "GpuCuller.hpp"
+#include "ClusterCuller.hpp"
+#include "DrawPacket.hpp"
 #include "Mesh.hpp"
 #include "Material.hpp"
 #include "Graphics.hpp"
@@ -93,17 +131,76 @@ namespace gust
 		/** Descriptor sets. */
 		std::vector<vk::DescriptorSet> descriptorSets = {};
 
-		/** Command buffer to render the mesh with. */
-		CommandBuffer commandBuffer = {};
+		/** Model matrix to use for the mesh. */
+		glm::mat4 model = {};
 
-		/** Vertex data uniform buffer. */
-		Buffer vertexUniformBuffer = {};
+		/** World space bounding box used for culling. */
+		AABB bounds = {};
 
-		/** Fragment data uniform buffer. */
-		Buffer fragmentUniformBuffer = {};
+		/** Should the mesh be rasterized into the occlusion buffer? */
+		bool occluder = false;
 
-		/** Model matrix to use for the mesh. */
-		glm::mat4 model = {};
+		/** Cached draw of a static mesh (Or Renderer::nullStaticDraw().) */
+		size_t staticDraw = std::numeric_limits<size_t>::max();
+	};
+
+	/**
+	 * @struct CullingStats
+	 * @brief Culling statistics for a frame.
+	 */
+	struct CullingStats
+	{
+		/** Meshes that passed culling (Summed over every camera.) */
+		size_t visible = 0;
+
+		/** Meshes that were culled (Summed over every camera.) */
+		size_t culled = 0;
+
+		/** Meshes inside the frustum that were hidden by occluders (Summed over every camera.) */
+		size_t occluded = 0;
+
+		/** Draw calls issued for visible meshes (Summed over every camera.) */
+		size_t drawCalls = 0;
+
+		/**
+		 * @brief Get the fraction of meshes inside the frustum that were hidden by occluders.
+		 * @return Occlusion cull rate.
+		 */
+		inline float getOcclusionCullRate() const
+		{
+			return (visible + occluded) > 0 ? static_cast<float>(occluded) / static_cast<float>(visible + occluded) : 0.0f;
+		}
+	};
+
+	/**
+	 * @struct DrawStats
+	 * @brief State changes recorded while drawing a frame.
+	 */
+	struct DrawStats
+	{
+		/** Pipelines bound (Summed over every camera.) */
+		size_t pipelineBinds = 0;
+
+		/** Pipeline binds skipped because the pipeline was already bound (Summed over every camera.) */
+		size_t pipelineBindsElided = 0;
+
+		/** Descriptor sets bound (Summed over every camera.) */
+		size_t descriptorSetBinds = 0;
+
+		/** Descriptor set binds skipped because the set and offsets were already bound (Summed over every camera.) */
+		size_t descriptorSetBindsElided = 0;
+
+		/** Vertex and index buffers bound (Summed over every camera.) */
+		size_t vertexBufferBinds = 0;
+
+		/** Vertex and index buffer binds skipped because the mesh was already bound (Summed over every camera.) */
+		size_t vertexBufferBindsElided = 0;
+
+		/** Static mesh command buffers re-recorded (Summed over every camera.) */
+		size_t staticBuffersRecorded = 0;
+
+		/** Static mesh command buffers reused without recording (Summed over every camera.) */
+		size_t staticBuffersReused = 0;
 	};
 
 	/**
@@ -169,6 +266,34 @@ namespace gust
 		float range = 0;
 	};
 
+	/**
+	 * @struct CameraFrame
+	 * @brief Per frame camera resources (Only reused once the GPU is done with the frame.)
+	 */
+	struct CameraFrame
+	{
+		/** Command buffer for drawing to. */
+		CommandBuffer commandBuffer = {};
+
+		/** Command buffer for lighting. */
+		CommandBuffer lightingCommandBuffer = {};
+
+		/** Secondary command buffers meshes are drawn with (One per worker thread.) */
+		std::vector<CommandBuffer> drawCommandBuffers = {};
+
+		/** Skybox command buffer. */
+		CommandBuffer skyboxCommandBuffer = {};
+
+		/** Skybox descriptor set. */
+		vk::DescriptorSet skyboxDescriptorSet = {};
+
+		/** Signaled when drawing to the framebuffer finishes. */
+		vk::Semaphore offscreen = {};
+
+		/** Signaled when lighting finishes. */
+		vk::Semaphore lighting = {};
+	};
+
 	/**
 	 * @struct VirtualCamera
 	 * @brief Camera information used by renderers.
@@ -181,11 +306,11 @@ namespace gust
 		/** Framebuffer height. */
 		uint32_t height = 0;
 
-		/** Command buffer for drawing to. */
-		CommandBuffer commandBuffer = {};
+		/** Per frame resources. */
+		std::array<CameraFrame, GUST_FRAMES_IN_FLIGHT> frames = {};
 
-		/** Command buffer for lighting. */
-		CommandBuffer lightingCommandBuffer = {};
+		/** Descriptor pool for the skybox descriptor sets. */
+		vk::DescriptorPool descriptorPool = {};
 
 		/** Framebuffer. */
 		vk::Framebuffer frameBuffer = {};
@@ -219,6 +344,12 @@ namespace gust
 
 		/** Skybox. */
 		Handle<Cubemap> skybox = Handle<Cubemap>::nullHandle();
+
+		/** Meshes a spatial query found in the cameras view this frame (Indices returned by Renderer::draw().) */
+		std::vector<size_t> meshCandidates = {};
+
+		/** Should the candidates be used instead of testing every mesh? (Cleared once the camera is drawn.) */
+		bool hasMeshCandidates = false;
 	};
 
 
@@ -276,6 +407,16 @@ namespace gust
 			return m_threadPool->workers.size();
 		}
 
+		/**
+		 * @brief Get thread pool.
+		 * @return Thread pool.
+		 * @note Idle outside of render(), so resources are loaded on it too.
+		 */
+		inline ThreadPool* getThreadPool() const
+		{
+			return m_threadPool.get();
+		}
+
 		/**
 		 * @brief Get offscreen render pass.
 		 * @return Offscreen render pass.
@@ -294,6 +435,38 @@ namespace gust
 			return m_descriptors.descriptorSetLayout;
 		}
 
+		/**
+		 * @brief Get every descriptor set layout a standard shader is created with.
+		 * @return Descriptor set layouts for a standard shader.
+		 * @note In bindless mode these are the descriptor heap and the per frame bindless set.
+		 */
+		inline std::vector<vk::DescriptorSetLayout> getStandardLayouts() const
+		{
+			if (m_graphics->isBindless())
+				return { m_graphics->getDescriptorHeap().getDescriptorSetLayout(), m_descriptors.bindlessDescriptorSetLayout };
+
+			return { m_descriptors.descriptorSetLayout };
+		}
+
+		/**
+		 * @brief Get the ring buffer per draw uniform data is written to.
+		 * @return Uniform ring buffer.
+		 * @note Standard descriptor sets bind bindings 0 and 2 to it as dynamic uniform buffers.
+		 */
+		inline const UniformRingBuffer& getUniformRingBuffer() const
+		{
+			return *m_uniformRing;
+		}
+
+		/**
+		 * @brief Get the index of the frame being recorded.
+		 * @return Frame index (Less than GUST_FRAMES_IN_FLIGHT.)
+		 */
+		inline uint32_t getFrameIndex() const
+		{
+			return m_frameIndex;
+		}
+
 		/**
 		 * @brief Get swapchain.
 		 * @return Swapchain.
@@ -322,22 +495,67 @@ namespace gust
 			return m_swapchain.images.size();
 		}
 
+		/**
+		 * @brief Get culling statistics of the last frame.
+		 * @return Culling statistics.
+		 */
+		inline CullingStats getCullingStats() const
+		{
+			return m_cullingStats;
+		}
+
+		/**
+		 * @brief Get draw statistics of the last frame.
+		 * @return Draw statistics.
+		 */
+		inline DrawStats getDrawStats() const
+		{
+			return m_drawStats;
+		}
+
+		/**
+		 * @brief Enable or disable CPU occlusion culling.
+		 * @param If occlusion culling should be performed.
+		 * @return If occlusion culling should be performed.
+		 * @note Only meshes flagged as occluders hide other meshes.
+		 * @note The pass runs on the worker pool inside render(), which the engine runs after the scene tick,
+		 * so it adds to the frame instead of overlapping game code.
+		 */
+		inline bool setOcclusionCulling(bool enabled)
+		{
+			m_occlusionCulling = enabled;
+			return m_occlusionCulling;
+		}
+
+		/**
+		 * @brief Check if CPU occlusion culling is enabled.
+		 * @return If occlusion culling is enabled.
+		 */
+		inline bool getOcclusionCulling() const
+		{
+			return m_occlusionCulling;
+		}
+
 		/**
 		 * @brief Render a mesh.
 		 * @param Mesh to render.
+		 * @return Index of the mesh this frame.
 		 */
-		inline void draw(MeshData& mesh)
+		inline size_t draw(MeshData& mesh)
 		{
 			m_meshes.push_back(mesh);
+			return m_meshes.size() - 1;
 		}
 
 		/**
 		 * @brief Render a point light.
 		 * @param Point light to render.
+		 * @return Index of the point light this frame.
 		 */
-		inline void draw(PointLightData& pointLight)
+		inline size_t draw(PointLightData& pointLight)
 		{
-			m_pointLights.push(pointLight);
+			m_pointLights.push_back(pointLight);
+			return m_pointLights.size() - 1;
 		}
 
 		/**
@@ -352,10 +570,25 @@ namespace gust
 		/**
 		 * @brief Render a spot light.
 		 * @param Spot light to render.
+		 * @return Index of the spot light this frame.
 		 */
-		inline void draw(SpotLightData& spotLight)
+		inline size_t draw(SpotLightData& spotLight)
 		{
-			m_spotLights.push(spotLight);
+			m_spotLights.push_back(spotLight);
+			return m_spotLights.size() - 1;
+		}
+
+		/**
+		 * @brief Only light with some of the point and spot lights drawn this frame.
+		 * @param Indices of the point lights to use.
+		 * @param Indices of the spot lights to use.
+		 * @note Meant for the lights a spatial query found near the main cameras view. Every light is used otherwise.
+		 */
+		inline void setVisibleLights(const std::vector<size_t>& pointLights, const std::vector<size_t>& spotLights)
+		{
+			m_visiblePointLights = pointLights;
+			m_visibleSpotLights = spotLights;
+			m_hasVisibleLights = true;
 		}
 
 		/**
@@ -364,14 +597,53 @@ namespace gust
 		 */
 		Handle<VirtualCamera> createCamera();
 
+		/**
+		 * @brief Get the handle of a null static draw.
+		 * @return Null static draw.
+		 */
+		static inline size_t nullStaticDraw()
+		{
+			return std::numeric_limits<size_t>::max();
+		}
+
+		/**
+		 * @brief Create a cached draw for a static mesh.
+		 * @return Static draw.
+		 * @note Static meshes are recorded once per camera and frame and only re-recorded
+		 * when their mesh, material, pipeline, framebuffer or bound descriptors change.
+		 * @note Only meshes whose shader supports instancing are cached.
+		 */
+		size_t createStaticDraw();
+
+		/**
+		 * @brief Destroy a cached draw.
+		 * @param Static draw.
+		 */
+		void destroyStaticDraw(size_t staticDraw);
+
 		/**
 		 * @brief Destroy a camera.
 		 * @param Handle to camera.
 		 */
 		inline void destroyCamera(const Handle<VirtualCamera>& camera)
 		{
-			destroyCommandBuffer(camera->commandBuffer);
-			destroyCommandBuffer(camera->lightingCommandBuffer);
+			// The camera may be used by frames in flight
+			m_graphics->getLogicalDevice().waitIdle();
+
+			for (auto& frame : camera->frames)
+			{
+				destroyCommandBuffer(frame.commandBuffer);
+				destroyCommandBuffer(frame.lightingCommandBuffer);
+				destroyCommandBuffer(frame.skyboxCommandBuffer);
+
+				for (auto commandBuffer : frame.drawCommandBuffers)
+					destroyCommandBuffer(commandBuffer);
+
+				m_graphics->getLogicalDevice().destroySemaphore(frame.offscreen);
+				m_graphics->getLogicalDevice().destroySemaphore(frame.lighting);
+			}
+
+			m_graphics->getLogicalDevice().destroyDescriptorPool(camera->descriptorPool);
 			m_graphics->getLogicalDevice().destroyFramebuffer(camera->frameBuffer);
 
 			camera->color->free();
@@ -412,6 +684,14 @@ namespace gust
 		 */
 		CommandBuffer createCommandBuffer(vk::CommandBufferLevel level);
 
+		/**
+		 * @brief Create a command buffer on a specific thread.
+		 * @param Command buffer level.
+		 * @param Thread index.
+		 * @return New command buffer.
+		 */
+		CommandBuffer createCommandBuffer(vk::CommandBufferLevel level, size_t threadIndex);
+
 		/**
 		 * @brief Destroy a command buffer.
 		 * @param Command buffer to destroy.
@@ -489,9 +769,9 @@ namespace gust
 		void initSwapchainBuffers();
 
 		/**
-		 * @brief Initialize semaphores.
+		 * @brief Initialize fences and semaphores of every frame.
 		 */
-		void initSemaphores();
+		void initFrames();
 
 		/**
 		 * @brief Initialize lighting.
@@ -537,18 +817,121 @@ namespace gust
 		void submitLightingData();
 
 		/**
-		 * @brief Draw mesh to a framebuffer.
-		 * @param Mesh to render.
+		 * @brief Frustum cull queued meshes against a camera.
+		 * @param Camera to cull against.
+		 * @note Fills m_visibleMeshes with the indices of visible meshes. Uses the cameras mesh candidates
+		 * instead of testing every mesh when it has them.
+		 */
+		void cullMeshes(Handle<VirtualCamera> camera);
+
+		/**
+		 * @brief Rasterize occluders and remove hidden meshes from m_visibleMeshes.
+		 * @param Camera to cull against.
+		 * @note Rasterization and testing are split across the worker pool, but not overlapped with the scene tick.
+		 */
+		void occlusionCull(Handle<VirtualCamera> camera);
+
+		/**
+		 * @struct DrawBatch
+		 * @brief Range of visible meshes sharing a mesh and material.
+		 */
+		struct DrawBatch
+		{
+			/** Index of the first mesh in m_visibleMeshes. */
+			size_t first = 0;
+
+			/** Number of meshes. */
+			size_t count = 0;
+		};
+
+		/**
+		 * @brief Sort visible meshes by state and group them into draw batches.
+		 * @param Camera being drawn to.
+		 * @note Meshes are only grouped when their shader has an instanced variant or in bindless mode.
+		 */
+		void batchMeshes(Handle<VirtualCamera> camera);
+
+		/**
+		 * @brief Record a range of draw batches into a command buffer.
+		 * @param Index of the first batch.
+		 * @param Number of batches.
+		 * @param Command buffer inheritence info.
+		 * @param Command buffer to record into.
+		 * @param Camera rendering the meshes.
+		 * @param Dynamic offsets of the per camera vertex and fragment data.
+		 * @param Statistics to add to.
+		 * @note Batches of more than one mesh are drawn with a single instanced draw.
+		 * @note Pipeline, descriptor set and vertex buffer binds matching the bound state are skipped.
+		 */
+		void recordDrawBatches
+		(
+			size_t firstBatch,
+			size_t batchCount,
+			const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+			const CommandBuffer& commandBuffer,
+			Handle<VirtualCamera> camera,
+			const std::array<uint32_t, 2>& cameraOffsets,
+			DrawStats& stats
+		);
+
+		/**
+		 * @brief Record a range of draw batches into a command buffer using the descriptor heap.
+		 * @param Index of the first batch.
+		 * @param Number of batches.
+		 * @param Command buffer inheritence info.
+		 * @param Command buffer to record into.
+		 * @param Camera rendering the meshes.
+		 * @param Dynamic offsets of the per camera vertex and fragment data.
+		 * @param Statistics to add to.
+		 * @note Descriptor sets are bound once. Each batch pushes the index of its per draw data and material.
+		 */
+		void recordBindlessDrawBatches
+		(
+			size_t firstBatch,
+			size_t batchCount,
+			const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+			const CommandBuffer& commandBuffer,
+			Handle<VirtualCamera> camera,
+			const std::array<uint32_t, 2>& cameraOffsets,
+			DrawStats& stats
+		);
+
+		/**
+		 * @brief Record the draw groups culled on the GPU into a secondary command buffer.
+		 * @param Inheritance info.
+		 * @param Command buffer to record into.
+		 * @param Camera being drawn to.
+		 * @param Dynamic offsets of the per camera vertex and fragment data.
+		 * @param Statistics to add to.
+		 * @note Each group is one indirect draw. Mesh i reads the i'th model matrix written by render().
+		 */
+		void recordGpuDraws
+		(
+			const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+			const CommandBuffer& commandBuffer,
+			Handle<VirtualCamera> camera,
+			const std::array<uint32_t, 2>& cameraOffsets,
+			DrawStats& stats
+		);
+
+		/**
+		 * @brief Draw a static mesh with its cached command buffer, recording it if it is out of date.
+		 * @param Index of the mesh.
 		 * @param Command buffer inheritence info.
 		 * @param Thread index.
 		 * @param Camera rendering the mesh.
+		 * @param Dynamic offsets of the per camera vertex and fragment data.
+		 * @param Statistics to add to.
+		 * @return Command buffer to execute.
 		 */
-		void drawMeshToFramebuffer
+		vk::CommandBuffer recordStaticDraw
 		(
-			const MeshData& mesh,
+			size_t meshIndex,
 			const vk::CommandBufferInheritanceInfo& inheritanceInfo,
 			size_t threadIndex,
-			Handle<VirtualCamera> camera
+			Handle<VirtualCamera> camera,
+			const std::array<uint32_t, 2>& cameraOffsets,
+			DrawStats& stats
 		);
 
 		/**
@@ -580,8 +963,8 @@ namespace gust
 			/** Depth image view. */
 			vk::ImageView imageView = {};
 
-			/** Depth image memory */
-			vk::DeviceMemory memory = {};
+			/** Depth image allocation. */
+			VmaAllocation allocation = VK_NULL_HANDLE;
 
 		} m_depthTexture;
 
@@ -620,13 +1003,13 @@ namespace gust
 		} m_renderPasses;
 
 		/**
-		 * @struct Semaphores
-		 * @brief Semaphores used for rendering.
+		 * @struct FrameData
+		 * @brief Per frame resources (Only reused once the frames fence is signaled.)
 		 */
-		struct Semaphores
+		struct FrameData
 		{
-			/** Used to synchronize offscreen rendering and usage. */
-			vk::Semaphore offscreen = {};
+			/** Signaled when the GPU finishes the frame. */
+			vk::Fence fence = {};
 
 			/** Image avaliable semaphore. */
 			vk::Semaphore imageAvailable = {};
@@ -634,7 +1017,24 @@ namespace gust
 			/** Rendering has finished and presentation can happen. */
 			vk::Semaphore renderFinished = {};
 
-		} m_semaphores;
+			/** Uniform buffer for lighting data. */
+			Buffer lightingUniformBuffer = {};
+
+			/** Lighting descriptor set. */
+			vk::DescriptorSet lightingDescriptorSet = {};
+		};
+
+		/** Per frame resources. */
+		std::array<FrameData, GUST_FRAMES_IN_FLIGHT> m_frames = {};
+
+		/** Index of the frame being recorded. */
+		uint32_t m_frameIndex = 0;
+
+		/** Fence of the frame last rendered to each swapchain image. */
+		std::vector<vk::Fence> m_imageFences = {};
+
+		/** Semaphores the final pass of the frame being recorded waits on. */
+		std::vector<vk::Semaphore> m_frameSemaphores = {};
 
 		/**
 		 * @struct Descriptors
@@ -654,17 +1054,17 @@ namespace gust
 			/** Skybox descriptor set layout for deferred rendering. */
 			vk::DescriptorSetLayout skyboxDescriptorSetLayout = {};
 
+			/** Per draw and per camera data layout for bindless shaders. */
+			vk::DescriptorSetLayout bindlessDescriptorSetLayout = {};
+
 			/** Descriptor pool. */
 			vk::DescriptorPool descriptorPool = {};
 
-			/** Lighting descriptor set. */
-			vk::DescriptorSet lightingDescriptorSet = {};
-
 			/** Screen descriptor set. */
 			vk::DescriptorSet screenDescriptorSet = {};
 
-			/** Skybox descriptor set. */
-			vk::DescriptorSet skyboxDescriptorSet = {};
+			/** Per draw and per camera data for bindless shaders. */
+			vk::DescriptorSet bindlessDescriptorSet = {};
 
 		} m_descriptors;
 
@@ -802,9 +1202,6 @@ namespace gust
 			/** Rendering command buffers. */
 			std::vector<CommandBuffer> rendering = {};
 
-			/** Skybox command buffer. */
-			CommandBuffer skybox = {};
-
 		} m_commands;
 
 		/** Camera allocator. */
@@ -818,7 +1215,7 @@ namespace gust
 
 
 
-		/** Thread pool for rendering meshes. */
+		/** Thread pool for rendering meshes (And loading resources.) */
 		std::unique_ptr<ThreadPool> m_threadPool = nullptr;
 
 		/** Screen quad. */
@@ -830,22 +1227,162 @@ namespace gust
 		/** Main camera. */
 		Handle<VirtualCamera> m_mainCamera = Handle<VirtualCamera>::nullHandle();
 
-		/** Uniform buffer for lighting data. */
-		Buffer m_lightingUniformBuffer = {};
+		/** Per draw uniform data. */
+		std::unique_ptr<UniformRingBuffer> m_uniformRing = nullptr;
+
+		/** Per instance vertex data. */
+		std::unique_ptr<UniformRingBuffer> m_instanceRing = nullptr;
+
+		/** Frustum culls meshes and builds indirect draws on the GPU (Null unless Graphics::isGpuCulling().) */
+		std::unique_ptr<GpuCuller> m_gpuCuller = nullptr;
+
+		/** Culls meshes with meshlets a meshlet at a time on the GPU (Null unless Graphics::isGpuCulling() and its shader exists.) */
+		std::unique_ptr<ClusterCuller> m_clusterCuller = nullptr;
 
-		/** Skybox uniform buffer. */
-		Buffer m_skyboxUniformBuffer = {};
+		/** Meshes taken by the cluster culler this frame. */
+		std::vector<bool> m_clusteredMeshes = {};
+
+		/** Offset of every meshes model matrix in the instance ring (GPU culling only.) */
+		uint32_t m_gpuModelOffset = 0;
+
+		/** Were this frames meshes uploaded for GPU culling? */
+		bool m_gpuFrame = false;
 
 		/** List of meshes to render. */
 		std::vector<MeshData> m_meshes = {};
 
+		/** Bounds of the meshes to render. */
+		AABBList m_meshBounds = {};
+
+		/** Visibility of each mesh for the camera being drawn to. */
+		std::vector<uint8_t> m_meshVisibility = {};
+
+		/** Visibility of each mesh in m_visibleMeshes after occlusion culling (Indexed like m_visibleMeshes.) */
+		std::vector<uint8_t> m_occlusionVisibility = {};
+
+		/** Indices of meshes visible to the camera being drawn to. */
+		std::vector<size_t> m_visibleMeshes = {};
+
+		/** Draw packets for the camera being drawn to. */
+		std::vector<DrawPacket> m_drawPackets = {};
+
+		/** Scratch memory for sorting draw packets. */
+		std::vector<DrawPacket> m_drawPacketScratch = {};
+
+		/** Draw batches for the camera being drawn to. */
+		std::vector<DrawBatch> m_drawBatches = {};
+
+		/** Indices of visible static meshes drawn with cached command buffers. */
+		std::vector<size_t> m_staticMeshes = {};
+
+		/**
+		 * @struct CachedDraw
+		 * @brief A static meshes command buffer for one camera and frame, and the state it was recorded with.
+		 */
+		struct CachedDraw
+		{
+			/** Command buffer. */
+			CommandBuffer commandBuffer = {};
+
+			/** Mesh. */
+			Handle<Mesh> mesh = Handle<Mesh>::nullHandle();
+
+			/** Material. */
+			Handle<Material> material = Handle<Material>::nullHandle();
+
+			/** Pipeline. */
+			vk::Pipeline pipeline = {};
+
+			/** Framebuffer. */
+			vk::Framebuffer framebuffer = {};
+
+			/** Descriptor sets. */
+			std::array<vk::DescriptorSet, 2> descriptorSets = {};
+
+			/** Dynamic offsets. */
+			std::array<uint32_t, 2> dynamicOffsets = {};
+
+			/** Instance buffer. */
+			vk::Buffer instanceBuffer = {};
+		};
+
+		/**
+		 * @struct StaticDraw
+		 * @brief Cached command buffers of a static mesh.
+		 */
+		struct StaticDraw
+		{
+			/** Is the static draw in use? */
+			bool allocated = false;
+
+			/** Cached draws indexed by camera and frame. */
+			std::vector<CachedDraw> cache = {};
+		};
+
+		/** Static draws. */
+		std::vector<StaticDraw> m_staticDraws = {};
+
+		/** Unused static draws. */
+		std::vector<size_t> m_freeStaticDraws = {};
+
+		/** Model matrices of static meshes (One per static draw per frame.) */
+		Buffer m_staticInstanceBuffer = {};
+
+		/** Mapped static instance memory. */
+		InstanceData* m_staticInstances = nullptr;
+
+		/** Number of static draws the static instance buffer holds per frame. */
+		size_t m_staticInstanceCapacity = 0;
+
+		/** Command buffers to free once the frames that might use them are done. */
+		std::array<std::vector<CommandBuffer>, GUST_FRAMES_IN_FLIGHT> m_retiredCommandBuffers = {};
+
+		/** Offset of each static cameras vertex and fragment data in the uniform ring buffer segments. */
+		std::array<std::array<vk::DeviceSize, 2>, GUST_STATIC_CAMERA_COUNT> m_cameraDataOffsets = {};
+
+		/** Draw statistics of each worker thread. */
+		std::vector<DrawStats> m_workerDrawStats = {};
+
+		/** Is occlusion culling enabled? */
+		bool m_occlusionCulling = false;
+
+		/** Software depth buffer for occlusion culling. */
+		OcclusionBuffer m_occlusionBuffer = {};
+
+		/** Indices of occluders visible to the camera being drawn to. */
+		std::vector<size_t> m_occluders = {};
+
+		/** Clip space vertices of each occluder. */
+		std::vector<std::vector<glm::vec4>> m_occluderVertices = {};
+
+		/** Culling statistics for the frame being rendered. */
+		CullingStats m_frameCullingStats = {};
+
+		/** Culling statistics of the last frame. */
+		CullingStats m_cullingStats = {};
+
+		/** Draw statistics for the frame being rendered. */
+		DrawStats m_frameDrawStats = {};
+
+		/** Draw statistics of the last frame. */
+		DrawStats m_drawStats = {};
+
 		/** Point lights to be rendered. */
-		std::queue<PointLightData> m_pointLights = std::queue<PointLightData>();
+		std::vector<PointLightData> m_pointLights = {};
 
 		/** Directional lights to be rendered. */
 		std::queue<DirectionalLightData> m_directionalLights = std::queue<DirectionalLightData>();
 
 		/** Spot lights to be rendered. */
-		std::queue<SpotLightData> m_spotLights = std::queue<SpotLightData>();
+		std::vector<SpotLightData> m_spotLights = {};
+
+		/** Indices of the point lights to use this frame. */
+		std::vector<size_t> m_visiblePointLights = {};
+
+		/** Indices of the spot lights to use this frame. */
+		std::vector<size_t> m_visibleSpotLights = {};
+
+		/** Should only the visible lights be used? */
+		bool m_hasVisibleLights = false;
 	};
 }
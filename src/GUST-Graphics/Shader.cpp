@@ -90,10 +90,16 @@ namespace gust
 			if (m_vertexShader)
 				logicalDevice.destroyShaderModule(m_vertexShader);
 
+			if (m_instancedVertexShader)
+				logicalDevice.destroyShaderModule(m_instancedVertexShader);
+
 			// Destroy graphics pipeline and layout
 			if (m_graphicsPipeline)
 				logicalDevice.destroyPipeline(m_graphicsPipeline);
 
+			if (m_instancedGraphicsPipeline)
+				logicalDevice.destroyPipeline(m_instancedGraphicsPipeline);
+
 			if (m_graphicsPipelineLayout)
 				logicalDevice.destroyPipelineLayout(m_graphicsPipelineLayout);
 
@@ -156,6 +162,10 @@ namespace gust
 
 	void Shader::initDescriptorSetLayout()
 	{
+		// Textures come from the descriptor heap
+		if (m_graphics->isBindless())
+			return;
+
 		std::vector<vk::DescriptorSetLayoutBinding> bindings(m_textureCount);
 
 		// Texture bindings
@@ -175,16 +185,85 @@ namespace gust
 		m_textureDescriptorSetLayout = m_graphics->getLogicalDevice().createDescriptorSetLayout(createInfo);
 	}
 
+	void Shader::enableInstancing(const std::vector<char>& vertexShaderByteCode, const vk::RenderPass& renderPass)
+	{
+		auto logicalDevice = m_graphics->getLogicalDevice();
+
+		// Align code
+		std::vector<uint32_t> codeAligned(vertexShaderByteCode.size() / sizeof(uint32_t) + 1);
+		memcpy(codeAligned.data(), vertexShaderByteCode.data(), vertexShaderByteCode.size());
+
+		vk::ShaderModuleCreateInfo createInfo = {};
+		createInfo.setCodeSize(vertexShaderByteCode.size());
+		createInfo.setPCode(codeAligned.data());
+
+		// Create shader module
+		m_instancedVertexShader = logicalDevice.createShaderModule(createInfo);
+
+		// Same fragment stage as the regular pipeline
+		std::array<vk::PipelineShaderStageCreateInfo, 2> shaderStages = m_shaderStages;
+		shaderStages[0].setModule(m_instancedVertexShader);
+
+		m_instancedGraphicsPipeline = createGraphicsPipeline(renderPass, shaderStages, true);
+	}
+
 	void Shader::initGraphicsPipeline(const vk::RenderPass& renderPass)
 	{
-		auto bindingDescription = Vertex::getBindingDescription();
-		auto attributeDescriptions = Vertex::getAttributeDescriptions();
+		// Layouts
+		auto layouts = m_descriptorSetLayouts;
+		if (m_textureCount > 0 && !m_graphics->isBindless())
+			layouts.push_back(m_textureDescriptorSetLayout);
+
+		vk::PipelineLayoutCreateInfo pipelineLayoutInfo = {};	
+		pipelineLayoutInfo.setSetLayoutCount(static_cast<uint32_t>(layouts.size()));
+		pipelineLayoutInfo.setPSetLayouts(layouts.data());
+
+		// Bindless draws index the heap and per draw data with push constants
+		vk::PushConstantRange pushConstantRange = {};
+		pushConstantRange.setStageFlags(vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment);
+		pushConstantRange.setOffset(0);
+		pushConstantRange.setSize(sizeof(BindlessDrawConstants));
+
+		if (m_graphics->isBindless())
+		{
+			pipelineLayoutInfo.setPushConstantRangeCount(1);
+			pipelineLayoutInfo.setPPushConstantRanges(&pushConstantRange);
+		}
+
+		// Create pipeline layout
+		m_graphicsPipelineLayout = m_graphics->getLogicalDevice().createPipelineLayout(pipelineLayoutInfo);
+
+		// Create graphics pipeline
+		m_graphicsPipeline = createGraphicsPipeline(renderPass, m_shaderStages, false);
+	}
+
+	vk::Pipeline Shader::createGraphicsPipeline
+	(
+		const vk::RenderPass& renderPass,
+		const std::array<vk::PipelineShaderStageCreateInfo, 2>& shaderStages,
+		bool instanced
+	)
+	{
+		std::array<vk::VertexInputBindingDescription, 2> bindingDescriptions =
+		{
+			GpuVertex::getBindingDescription(),
+			InstanceData::getBindingDescription()
+		};
+
+		std::vector<vk::VertexInputAttributeDescription> attributeDescriptions = {};
+
+		for (const auto& attribute : GpuVertex::getAttributeDescriptions())
+			attributeDescriptions.push_back(attribute);
+
+		if (instanced)
+			for (const auto& attribute : InstanceData::getAttributeDescriptions())
+				attributeDescriptions.push_back(attribute);
 		
 		// Vertex input
 		vk::PipelineVertexInputStateCreateInfo vertexInputInfo = {};
-		vertexInputInfo.setVertexBindingDescriptionCount(1);
+		vertexInputInfo.setVertexBindingDescriptionCount(instanced ? 2 : 1);
 		vertexInputInfo.setVertexAttributeDescriptionCount(static_cast<uint32_t>(attributeDescriptions.size()));
-		vertexInputInfo.setPVertexBindingDescriptions(&bindingDescription);
+		vertexInputInfo.setPVertexBindingDescriptions(bindingDescriptions.data());
 		vertexInputInfo.setPVertexAttributeDescriptions(attributeDescriptions.data());
 		
 		// Input assembly
@@ -299,23 +378,9 @@ namespace gust
 		dynamicState.setDynamicStateCount(static_cast<uint32_t>(dynamicStates.size()));
 		dynamicState.setPDynamicStates(dynamicStates.data());
 		
-		// Layouts
-		auto layouts = m_descriptorSetLayouts;
-		if (m_textureCount > 0)
-			layouts.push_back(m_textureDescriptorSetLayout);
-
-		vk::PipelineLayoutCreateInfo pipelineLayoutInfo = {};	
-		pipelineLayoutInfo.setSetLayoutCount(static_cast<uint32_t>(layouts.size()));
-		pipelineLayoutInfo.setPSetLayouts(layouts.data());
-		
-		auto logicalDevice = m_graphics->getLogicalDevice();
-
-		// Create pipeline layout
-		m_graphicsPipelineLayout = logicalDevice.createPipelineLayout(pipelineLayoutInfo);
-		
 		vk::GraphicsPipelineCreateInfo pipelineInfo = {};
-		pipelineInfo.setStageCount(static_cast<uint32_t>(m_shaderStages.size()));
-		pipelineInfo.setPStages(m_shaderStages.data());
+		pipelineInfo.setStageCount(static_cast<uint32_t>(shaderStages.size()));
+		pipelineInfo.setPStages(shaderStages.data());
 		pipelineInfo.setPVertexInputState(&vertexInputInfo);
 		pipelineInfo.setPInputAssemblyState(&inputAssembly);
 		pipelineInfo.setPViewportState(&viewportState);
@@ -331,6 +396,6 @@ namespace gust
 		pipelineInfo.setPDepthStencilState(&depthStencil);
 		
 		// Create graphics pipeline
-		m_graphicsPipeline = logicalDevice.createGraphicsPipeline({}, pipelineInfo);
+		return m_graphics->createGraphicsPipeline(pipelineInfo);
 	}
 }
\ No newline at end of file
@@ -13,6 +13,39 @@
 
 namespace gust
 {
+	/**
+	 * @struct ShaderDescription
+	 * @brief Everything needed to create a shader from files.
+	 */
+	struct ShaderDescription
+	{
+		/** Path to vertex shader. */
+		std::string vertexPath = "";
+
+		/** Path to fragment shader. */
+		std::string fragmentPath = "";
+
+		/** Size of data sent to vertex shader. */
+		size_t vertexDataSize = 0;
+
+		/** Size of data sent to fragment shader. */
+		size_t fragmentDataSize = 0;
+
+		/** Number of textures used by the shader. */
+		size_t textureCount = 0;
+
+		/** Should the shader perform depth testing? */
+		bool depthTesting = true;
+
+		/** Should the shader perform lighting calculations? */
+		bool lighting = true;
+
+		/** Path to an instanced variant of the vertex shader (Empty to disable instancing. Skipped if the file is missing.) */
+		std::string instancedVertexPath = "";
+	};
+
+
+
 	/**
 	 * @class Shader
 	 * @brief Contains shader modules and their graphics pipelines.
@@ -129,6 +162,24 @@ namespace gust
 			return m_graphicsPipeline;
 		}
 
+		/**
+		 * @brief Get graphics pipeline used for instanced draws.
+		 * @return Instanced graphics pipeline.
+		 */
+		inline const vk::Pipeline& getInstancedGraphicsPipeline() const
+		{
+			return m_instancedGraphicsPipeline;
+		}
+
+		/**
+		 * @brief Check if meshes using the shader can be drawn with instancing.
+		 * @return If the shader has an instanced variant.
+		 */
+		inline bool supportsInstancing() const
+		{
+			return static_cast<bool>(m_instancedGraphicsPipeline);
+		}
+
 		/**
 		 * @brief Get graphics pipeline layout.
 		 * @return Graphics pipeline layout.
@@ -147,6 +198,14 @@ namespace gust
 			return static_cast<uint32_t>(m_textureCount);
 		}
 
+		/**
+		 * @brief Create an instanced variant of the shader.
+		 * @param Vertex shader byte code reading the model matrix from per instance inputs.
+		 * @param Render pass to use for the pipeline.
+		 * @see InstanceData
+		 */
+		void enableInstancing(const std::vector<char>& vertexShaderByteCode, const vk::RenderPass& renderPass);
+
 		/**
 		 * @brief Free memory.
 		 * @note Used internally. Do not call.
@@ -175,6 +234,20 @@ namespace gust
 		 */
 		void initGraphicsPipeline(const vk::RenderPass& renderPass);
 
+		/**
+		 * @brief Create a graphics pipeline using the shaders layout.
+		 * @param Render pass to use for the pipeline.
+		 * @param Shader stages.
+		 * @param Should per instance inputs be bound?
+		 * @return New graphics pipeline.
+		 */
+		vk::Pipeline createGraphicsPipeline
+		(
+			const vk::RenderPass& renderPass,
+			const std::array<vk::PipelineShaderStageCreateInfo, 2>& shaderStages,
+			bool instanced
+		);
+
 
 
 		/** Graphics context. */
@@ -195,6 +268,9 @@ namespace gust
 		/** Vertex shader module. */
 		vk::ShaderModule m_vertexShader = {};
 
+		/** Instanced vertex shader module. */
+		vk::ShaderModule m_instancedVertexShader = {};
+
 		/** Size of data sent to fragment shader. */
 		vk::DeviceSize m_fragmentDataSize;
 
@@ -215,5 +291,8 @@ namespace gust
 
 		/** Graphics pipeline. */
 		vk::Pipeline m_graphicsPipeline = {};
+
+		/** Graphics pipeline used for instanced draws. */
+		vk::Pipeline m_instancedGraphicsPipeline = {};
 	};
 }
\ No newline at end of file
@@ -2,16 +2,17 @@
 #include <stb_image.h>
 
 #include <Debugging.hpp>
+#include "Mipmaps.hpp"
 #include "Texture.hpp"
 
 namespace gust
 {
-	Texture::Texture(Graphics* graphics, vk::Image image, vk::ImageView& imageView, vk::Sampler sampler, vk::DeviceMemory memory, uint32_t width, uint32_t height) :
+	Texture::Texture(Graphics* graphics, vk::Image image, vk::ImageView& imageView, vk::Sampler sampler, VmaAllocation allocation, uint32_t width, uint32_t height) :
 		m_graphics(graphics),
 		m_image(image),
 		m_imageView(imageView),
 		m_sampler(sampler),
-		m_imageMemory(memory),
+		m_imageAllocation(allocation),
 		m_width(width),
 		m_height(height)
 	{
@@ -20,8 +21,6 @@ namespace gust
 
 	Texture::Texture(Graphics* graphics, const std::string& path, vk::Filter filter) : m_graphics(graphics), m_filtering(filter)
 	{
-		auto logicalDevice = m_graphics->getLogicalDevice();
-
 		// Load image from file
 		int texWidth = 0, texHeight = 0, texChannels = 0;
 		auto pixels = stbi_load(path.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
@@ -31,54 +30,89 @@ namespace gust
 	
 		gAssert(pixels);
 	
-		auto imageSize = static_cast<vk::DeviceSize>(m_width * m_height * 4);
-	
-		// Create staging buffer
-		Buffer stagingBuffer = m_graphics->createBuffer
-		(
-			imageSize,
-			vk::BufferUsageFlagBits::eTransferSrc,
-			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
-		);
-	
-		// Map image to memory
-		void* data;
-		logicalDevice.mapMemory(stagingBuffer.memory, 0, imageSize, (vk::MemoryMapFlagBits)0, &data);
-		memcpy(data, pixels, static_cast<size_t>(imageSize));
-		logicalDevice.unmapMemory(stagingBuffer.memory);
+		// Create image with its mip chain
+		initImage(pixels, 1, static_cast<vk::ImageCreateFlagBits>(0), vk::ImageViewType::e2D);
 	
-		// Free pixel data
+		// Free pixel data (The upload manager has its own copy)
 		stbi_image_free(pixels);
 	
+		// Create sampler
+		initSampler();
+	}
+
+	Texture::Texture(const Texture& other) :
+		m_graphics(other.m_graphics),
+		m_image(other.m_image),
+		m_imageView(other.m_imageView),
+		m_sampler(other.m_sampler),
+		m_imageAllocation(other.m_imageAllocation),
+		m_uploadValue(other.m_uploadValue),
+		m_heapIndex(other.m_heapIndex),
+		m_width(other.m_width),
+		m_height(other.m_height),
+		m_mipLevels(other.m_mipLevels)
+	{
+
+	}
+
+	Texture::~Texture()
+	{
+
+	}
+
+	uint32_t Texture::getHeapIndex()
+	{
+		if (m_heapIndex == DescriptorHeap::nullIndex())
+			m_heapIndex = m_graphics->getDescriptorHeap().addTexture(m_imageView, m_sampler);
+
+		return m_heapIndex;
+	}
+
+	void Texture::initImage(const uint8_t* pixels, uint32_t layerCount, vk::ImageCreateFlags flags, vk::ImageViewType viewType)
+	{
+		const vk::Format format = vk::Format::eR8G8B8A8Unorm;
+		const auto layerSize = static_cast<vk::DeviceSize>(m_width * m_height * 4);
+		m_mipLevels = calculateMipLevels(m_width, m_height);
+
 		// Create image
 		m_graphics->createImage
 		(
 			m_width,
 			m_height,
-			vk::Format::eR8G8B8A8Unorm,
+			format,
 			vk::ImageTiling::eOptimal,
-			vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
+			vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
 			vk::MemoryPropertyFlagBits::eDeviceLocal,
 			m_image,
-			m_imageMemory
+			m_imageAllocation,
+			flags,
+			layerCount,
+			m_mipLevels
 		);
-	
-		// Prepare texture for shader access
-		m_graphics->transitionImageLayout(m_image, vk::Format::eR8G8B8A8Unorm, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
-		m_graphics->copyBufferToImage(stagingBuffer.buffer, m_image, static_cast<uint32_t>(m_width), static_cast<uint32_t>(m_height));
-		m_graphics->transitionImageLayout(m_image, vk::Format::eR8G8B8A8Unorm, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
-	
-		// Cleanup staging buffer
-		logicalDevice.destroyBuffer(stagingBuffer.buffer);
-		logicalDevice.freeMemory(stagingBuffer.memory);
-	
+
+		if (m_graphics->supportsLinearBlit(format))
+		{
+			// Upload the first level on the transfer queue and blit the rest on the graphics queue once it lands
+			m_graphics->getUploadManager().uploadImage(pixels, layerSize, m_image, m_width, m_height, layerCount);
+			m_uploadValue = m_graphics->getUploadManager().generateMipmaps(m_image, m_width, m_height, m_mipLevels, layerCount);
+		}
+		else
+		{
+			// Filter every level on the CPU and upload them together
+			const std::vector<uint8_t> chain = buildMipChain(pixels, m_width, m_height, layerCount, m_mipLevels);
+			m_uploadValue = m_graphics->getUploadManager().uploadImage(chain.data(), layerSize, m_image, m_width, m_height, layerCount, m_mipLevels);
+		}
+
 		// Create texture image view
-		m_imageView = m_graphics->createImageView(m_image, vk::Format::eR8G8B8A8Unorm, vk::ImageAspectFlagBits::eColor);
-	
+		m_imageView = m_graphics->createImageView(m_image, format, vk::ImageAspectFlagBits::eColor, viewType, layerCount, m_mipLevels);
+	}
+
+	void Texture::initSampler()
+	{
 		// Sampler creation info
 		vk::SamplerCreateInfo samplerInfo = {};
-		samplerInfo.setMagFilter(filter);
-		samplerInfo.setMinFilter(filter);
+		samplerInfo.setMagFilter(m_filtering);
+		samplerInfo.setMinFilter(m_filtering);
 		samplerInfo.setAddressModeU(vk::SamplerAddressMode::eRepeat);
 		samplerInfo.setAddressModeV(vk::SamplerAddressMode::eRepeat);
 		samplerInfo.setAddressModeW(vk::SamplerAddressMode::eRepeat);
@@ -88,30 +122,13 @@ namespace gust
 		samplerInfo.setUnnormalizedCoordinates(false);
 		samplerInfo.setCompareEnable(false);
 		samplerInfo.setCompareOp(vk::CompareOp::eAlways);
-		samplerInfo.setMipmapMode(vk::SamplerMipmapMode::eLinear);
+		samplerInfo.setMipmapMode(m_filtering == vk::Filter::eLinear ? vk::SamplerMipmapMode::eLinear : vk::SamplerMipmapMode::eNearest);
 		samplerInfo.setMipLodBias(0.0f);
 		samplerInfo.setMinLod(0.0f);
-		samplerInfo.setMaxLod(0.0f);
+		samplerInfo.setMaxLod(static_cast<float>(m_mipLevels));
 	
 		// Create sampler
-		m_sampler = logicalDevice.createSampler(samplerInfo);
-	}
-
-	Texture::Texture(const Texture& other) :
-		m_graphics(other.m_graphics),
-		m_image(other.m_image),
-		m_imageView(other.m_imageView),
-		m_sampler(other.m_sampler),
-		m_imageMemory(other.m_imageMemory),
-		m_width(other.m_width),
-		m_height(other.m_height)
-	{
-
-	}
-
-	Texture::~Texture()
-	{
-
+		m_sampler = m_graphics->getLogicalDevice().createSampler(samplerInfo);
 	}
 
 	void Texture::free()
@@ -120,16 +137,22 @@ namespace gust
 		{
 			vk::Device logicalDevice = m_graphics->getLogicalDevice();
 
+			if (m_heapIndex != DescriptorHeap::nullIndex())
+				m_graphics->getDescriptorHeap().removeTexture(m_heapIndex);
+
+			// The transfer queue may still be writing to the image
+			m_graphics->getUploadManager().wait(m_uploadValue);
+
 			if (m_sampler)
 				logicalDevice.destroySampler(m_sampler);
 
 			if (m_imageView)
 				logicalDevice.destroyImageView(m_imageView);
 
-			if (m_imageMemory)
-				logicalDevice.freeMemory(m_imageMemory);
-
-			if (m_image)
+			// Images made elsewhere may not have been allocated by the graphics context
+			if (m_image && m_imageAllocation)
+				m_graphics->destroyImage(m_image, m_imageAllocation);
+			else if (m_image)
 				logicalDevice.destroyImage(m_image);
 		}
 	}
@@ -142,10 +165,10 @@ namespace gust
 		vk::Image image,
 		vk::ImageView& imageView,
 		vk::Sampler sampler,
-		vk::DeviceMemory memory,
+		VmaAllocation allocation,
 		uint32_t width,
 		uint32_t height
-	) : Texture(graphics, image, imageView, sampler, memory, width, height)
+	) : Texture(graphics, image, imageView, sampler, allocation, width, height)
 	{
 
 	}
@@ -165,8 +188,6 @@ namespace gust
 		m_graphics = graphics;
 		m_filtering = filter;
 
-		auto logicalDevice = m_graphics->getLogicalDevice();
-
 		// Load image from file
 		int texWidth = 0, texHeight = 0, texChannels = 0;
 		unsigned char* topPixels	= stbi_load(top.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
@@ -193,20 +214,6 @@ namespace gust
 		memcpy(total + (4 * singleImageSize), northPixels, singleImageSize);
 		memcpy(total + (5 * singleImageSize), southPixels, singleImageSize);
 
-		// Create staging buffer
-		Buffer stagingBuffer = m_graphics->createBuffer
-		(
-			imageSize,
-			vk::BufferUsageFlagBits::eTransferSrc,
-			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
-		);
-	
-		// Map image to memory
-		void* data;
-		logicalDevice.mapMemory(stagingBuffer.memory, 0, imageSize, (vk::MemoryMapFlagBits)0, &data);
-		memcpy(data, total, static_cast<size_t>(imageSize));
-		logicalDevice.unmapMemory(stagingBuffer.memory);
-	
 		// Free pixel data
 		stbi_image_free(topPixels);
 		stbi_image_free(bottomPixels);
@@ -214,54 +221,12 @@ namespace gust
 		stbi_image_free(eastPixels);
 		stbi_image_free(southPixels);
 		stbi_image_free(westPixels);
-		delete total;
-	
-		// Create image
-		m_graphics->createImage
-		(
-			m_width,
-			m_height,
-			vk::Format::eR8G8B8A8Unorm,
-			vk::ImageTiling::eOptimal,
-			vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
-			vk::MemoryPropertyFlagBits::eDeviceLocal,
-			m_image,
-			m_imageMemory,
-			vk::ImageCreateFlagBits::eCubeCompatible,
-			6
-		);
 	
-		// Prepare texture for shader access
-		m_graphics->transitionImageLayout(m_image, vk::Format::eR8G8B8A8Unorm, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, 6);
-		m_graphics->copyBufferToImage(stagingBuffer.buffer, m_image, static_cast<uint32_t>(m_width), static_cast<uint32_t>(m_height), 6, static_cast<uint32_t>(singleImageSize));
-		m_graphics->transitionImageLayout(m_image, vk::Format::eR8G8B8A8Unorm, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, 6);
-	
-		// Cleanup staging buffer
-		logicalDevice.destroyBuffer(stagingBuffer.buffer);
-		logicalDevice.freeMemory(stagingBuffer.memory);
-	
-		// Create texture image view
-		m_imageView = m_graphics->createImageView(m_image, vk::Format::eR8G8B8A8Unorm, vk::ImageAspectFlagBits::eColor, vk::ImageViewType::eCube, 6);
-	
-		// Sampler creation info
-		vk::SamplerCreateInfo samplerInfo = {};
-		samplerInfo.setMagFilter(filter);
-		samplerInfo.setMinFilter(filter);
-		samplerInfo.setAddressModeU(vk::SamplerAddressMode::eRepeat);
-		samplerInfo.setAddressModeV(vk::SamplerAddressMode::eRepeat);
-		samplerInfo.setAddressModeW(vk::SamplerAddressMode::eRepeat);
-		samplerInfo.setAnisotropyEnable(true);
-		samplerInfo.setMaxAnisotropy(1);
-		samplerInfo.setBorderColor(vk::BorderColor::eFloatOpaqueBlack);
-		samplerInfo.setUnnormalizedCoordinates(false);
-		samplerInfo.setCompareEnable(false);
-		samplerInfo.setCompareOp(vk::CompareOp::eAlways);
-		samplerInfo.setMipmapMode(vk::SamplerMipmapMode::eLinear);
-		samplerInfo.setMipLodBias(0.0f);
-		samplerInfo.setMinLod(0.0f);
-		samplerInfo.setMaxLod(0.0f);
+		// Create image with its mip chain
+		initImage(total, 6, vk::ImageCreateFlagBits::eCubeCompatible, vk::ImageViewType::eCube);
+		delete[] total;
 	
 		// Create sampler
-		m_sampler = logicalDevice.createSampler(samplerInfo);
+		initSampler();
 	}
 }
\ No newline at end of file
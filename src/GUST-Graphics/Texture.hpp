@@ -30,7 +30,7 @@ namespace gust
 		 * @param Image.
 		 * @param Image view.
 		 * @param Sampler.
-		 * @param Image memory.
+		 * @param Image allocation.
 		 * @param Width.
 		 * @param Height.
 		 */
@@ -40,7 +40,7 @@ namespace gust
 			vk::Image image, 
 			vk::ImageView& imageView, 
 			vk::Sampler sampler, 
-			vk::DeviceMemory memory, 
+			VmaAllocation allocation, 
 			uint32_t width, 
 			uint32_t height
 		);
@@ -82,6 +82,15 @@ namespace gust
 			return m_height;
 		}
 
+		/**
+		 * @brief Get number of mip levels.
+		 * @return Number of mip levels.
+		 */
+		inline uint32_t getMipLevels() const
+		{
+			return m_mipLevels;
+		}
+
 		/**
 		 * @brief Get texture image view.
 		 * @return Texture image view.
@@ -109,6 +118,22 @@ namespace gust
 			return m_filtering;
 		}
 
+		/**
+		 * @brief Check if the image has been uploaded.
+		 * @return If the texture can be sampled.
+		 */
+		inline bool isReady() const
+		{
+			return m_graphics->getUploadManager().isComplete(m_uploadValue);
+		}
+
+		/**
+		 * @brief Get the index of the texture in the descriptor heap.
+		 * @return Descriptor heap index.
+		 * @note The texture is added to the heap the first time it is asked for. Bindless mode only.
+		 */
+		uint32_t getHeapIndex();
+
 		/**
 		 * @brief Free image memory.
 		 * @note Used internally. Do not call.
@@ -117,6 +142,24 @@ namespace gust
 
 	protected:
 
+		/**
+		 * @brief Create the image with a full mip chain, upload it and create its view.
+		 * @param RGBA8 pixels of the first mip level (Layers are tightly packed.)
+		 * @param Number of layers.
+		 * @param Image creation flags.
+		 * @param Image view type.
+		 * @note Width and height must be set. Mip levels are blitted on the GPU when the format
+		 * supports it and box filtered on the CPU otherwise.
+		 */
+		void initImage(const uint8_t* pixels, uint32_t layerCount, vk::ImageCreateFlags flags, vk::ImageViewType viewType);
+
+		/**
+		 * @brief Create the sampler covering every mip level.
+		 */
+		void initSampler();
+
+
+
 		/** Graphics context. */
 		Graphics* m_graphics = nullptr;
 
@@ -132,14 +175,23 @@ namespace gust
 		/** Texture sampler. */
 		vk::Sampler m_sampler = {};
 
-		/** Texture image memory. */
-		vk::DeviceMemory m_imageMemory = {};
+		/** Texture image allocation. */
+		VmaAllocation m_imageAllocation = VK_NULL_HANDLE;
+
+		/** Upload value the image is filled at. */
+		uint64_t m_uploadValue = 0;
+
+		/** Index in the descriptor heap. */
+		uint32_t m_heapIndex = DescriptorHeap::nullIndex();
 
 		/** Texture width. */
 		uint32_t m_width = 0;
 
 		/** Texture height. */
 		uint32_t m_height = 0;
+
+		/** Number of mip levels. */
+		uint32_t m_mipLevels = 1;
 	};
 
 
@@ -158,7 +210,7 @@ namespace gust
 		 * @param Image.
 		 * @param Image view.
 		 * @param Sampler.
-		 * @param Image memory.
+		 * @param Image allocation.
 		 * @param Width.
 		 * @param Height.
 		 */
@@ -168,7 +220,7 @@ namespace gust
 			vk::Image image, 
 			vk::ImageView& imageView, 
 			vk::Sampler sampler, 
-			vk::DeviceMemory memory, 
+			VmaAllocation allocation, 
 			uint32_t width, 
 			uint32_t height
 		);
@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <Debugging.hpp>
+#include "UniformRingBuffer.hpp"
+
+namespace gust
+{
+	UniformRingBuffer::UniformRingBuffer
+	(
+		Graphics* graphics,
+		vk::DeviceSize frameSize,
+		uint32_t frameCount,
+		vk::BufferUsageFlags usage
+	) :
+		m_graphics(graphics),
+		m_frameCount(frameCount)
+	{
+		// Dynamic offsets must be a multiple of the devices alignment
+		m_alignment = std::max<vk::DeviceSize>(m_graphics->getPhysicalDevice().getProperties().limits.minUniformBufferOffsetAlignment, 16);
+		m_frameSize = ((frameSize + m_alignment - 1) / m_alignment) * m_alignment;
+
+		// Create buffer
+		m_buffer = m_graphics->createBuffer
+		(
+			m_frameSize * m_frameCount,
+			usage,
+			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+		);
+
+		// Map once for the lifetime of the buffer
+		m_mapped = m_graphics->mapBuffer(m_buffer);
+	}
+
+	vk::DeviceSize UniformRingBuffer::reserve(vk::DeviceSize size)
+	{
+		const vk::DeviceSize alignedSize = ((size + m_alignment - 1) / m_alignment) * m_alignment;
+		gAssert(m_reservedSize + alignedSize <= m_frameSize);
+
+		const vk::DeviceSize offset = m_reservedSize;
+		m_reservedSize += alignedSize;
+		m_offset = m_reservedSize;
+
+		return offset;
+	}
+
+	void UniformRingBuffer::beginFrame(uint32_t frameIndex)
+	{
+		m_frameIndex = frameIndex % m_frameCount;
+		m_offset = m_reservedSize;
+	}
+
+	bool UniformRingBuffer::allocate(vk::DeviceSize size, uint32_t& offset)
+	{
+		const vk::DeviceSize alignedSize = ((size + m_alignment - 1) / m_alignment) * m_alignment;
+		const vk::DeviceSize localOffset = m_offset.fetch_add(alignedSize);
+
+		if (localOffset + alignedSize > m_frameSize)
+		{
+			gErr("Uniform ring buffer out of space.\n");
+			return false;
+		}
+
+		offset = static_cast<uint32_t>(m_frameIndex * m_frameSize + localOffset);
+		return true;
+	}
+
+	void UniformRingBuffer::free()
+	{
+		if (m_graphics && m_buffer.buffer)
+		{
+			m_graphics->unmapBuffer(m_buffer);
+			m_graphics->destroyBuffer(m_buffer);
+			m_buffer = {};
+			m_mapped = nullptr;
+		}
+	}
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+/**
+ * @file UniformRingBuffer.hpp
+ * @brief Uniform ring buffer header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/** Includes. */
+#include <atomic>
+#include <cstring>
+#include "Graphics.hpp"
+
+namespace gust
+{
+	/**
+	 * @class UniformRingBuffer
+	 * @brief Persistently mapped uniform buffer split into one segment per frame.
+	 * @note Per draw data is linearly suballocated from the current frames segment and
+	 * bound with dynamic descriptor offsets, so no per draw buffers or map calls are needed.
+	 */
+	class UniformRingBuffer
+	{
+	public:
+
+		/**
+		 * @brief Default constructor.
+		 */
+		UniformRingBuffer() = default;
+
+		/**
+		 * @brief Constructor.
+		 * @param Graphics context.
+		 * @param Size of each frames segment in bytes.
+		 * @param Number of segments (Frames that may be in flight at once.)
+		 * @param Buffer usage (Per instance vertex data is streamed the same way.)
+		 */
+		UniformRingBuffer
+		(
+			Graphics* graphics,
+			vk::DeviceSize frameSize,
+			uint32_t frameCount,
+			vk::BufferUsageFlags usage = vk::BufferUsageFlagBits::eUniformBuffer
+		);
+
+		/**
+		 * @brief Default destructor.
+		 */
+		~UniformRingBuffer() = default;
+
+		/**
+		 * @brief Get the buffer.
+		 * @return Buffer.
+		 */
+		inline const Buffer& getBuffer() const
+		{
+			return m_buffer;
+		}
+
+		/**
+		 * @brief Get the index of the segment being written to.
+		 * @return Frame index.
+		 */
+		inline uint32_t getFrameIndex() const
+		{
+			return m_frameIndex;
+		}
+
+		/**
+		 * @brief Get mapped memory at an offset.
+		 * @param Offset from the start of the buffer.
+		 * @return Mapped memory.
+		 */
+		inline void* getMappedMemory(uint32_t offset) const
+		{
+			return static_cast<char*>(m_mapped) + offset;
+		}
+
+		/**
+		 * @brief Reserve space at the start of every segment.
+		 * @param Size in bytes.
+		 * @return Offset from the start of a segment.
+		 * @note Reserved space keeps its place every frame, so command buffers referencing it stay valid.
+		 * @note Must be called before the first frame.
+		 */
+		vk::DeviceSize reserve(vk::DeviceSize size);
+
+		/**
+		 * @brief Get the offset of reserved space in the current frames segment.
+		 * @param Offset from the start of a segment.
+		 * @return Offset from the start of the buffer.
+		 */
+		inline uint32_t getReservedOffset(vk::DeviceSize offset) const
+		{
+			return static_cast<uint32_t>(m_frameIndex * m_frameSize + offset);
+		}
+
+		/**
+		 * @brief Move to a frames segment and discard its old contents.
+		 * @param Frame index.
+		 * @note The GPU must be done with the segment being moved to.
+		 */
+		void beginFrame(uint32_t frameIndex);
+
+		/**
+		 * @brief Allocate space in the current frames segment.
+		 * @param Size in bytes.
+		 * @param Offset from the start of the buffer.
+		 * @return If there was enough space.
+		 * @note Thread safe.
+		 */
+		bool allocate(vk::DeviceSize size, uint32_t& offset);
+
+		/**
+		 * @brief Copy data into the current frames segment.
+		 * @tparam Type of data.
+		 * @param Data.
+		 * @param Offset from the start of the buffer (Used as a dynamic offset.)
+		 * @return If there was enough space.
+		 * @note Thread safe.
+		 */
+		template<typename T>
+		inline bool push(const T& data, uint32_t& offset)
+		{
+			if (!allocate(static_cast<vk::DeviceSize>(sizeof(T)), offset))
+				return false;
+
+			std::memcpy(static_cast<char*>(m_mapped) + offset, &data, sizeof(T));
+			return true;
+		}
+
+		/**
+		 * @brief Free memory.
+		 * @note Used internally. Do not call.
+		 */
+		void free();
+
+	private:
+
+		/** Graphics context. */
+		Graphics* m_graphics = nullptr;
+
+		/** Buffer. */
+		Buffer m_buffer = {};
+
+		/** Mapped memory. */
+		void* m_mapped = nullptr;
+
+		/** Size of each frames segment. */
+		vk::DeviceSize m_frameSize = 0;
+
+		/** Alignment of every allocation. */
+		vk::DeviceSize m_alignment = 0;
+
+		/** Number of segments. */
+		uint32_t m_frameCount = 0;
+
+		/** Segment being written to. */
+		uint32_t m_frameIndex = 0;
+
+		/** Bytes reserved at the start of each segment. */
+		vk::DeviceSize m_reservedSize = 0;
+
+		/** Next free byte in the current segment. */
+		std::atomic<vk::DeviceSize> m_offset = { 0 };
+	};
+}
@@ -0,0 +1,422 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <Debugging.hpp>
+#include "Graphics.hpp"
+#include "UploadManager.hpp"
+
+namespace gust
+{
+	UploadManager::UploadManager(Graphics* graphics, vk::DeviceSize stagingSize) :
+		m_graphics(graphics),
+		m_stagingSize(stagingSize)
+	{
+		// Copies into images need texel aligned source offsets
+		m_alignment = std::max<vk::DeviceSize>(m_graphics->getPhysicalDevice().getProperties().limits.optimalBufferCopyOffsetAlignment, 16);
+
+		// Create staging buffer
+		m_stagingBuffer = m_graphics->createBuffer
+		(
+			m_stagingSize,
+			vk::BufferUsageFlagBits::eTransferSrc,
+			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+		);
+
+		// Map once for the lifetime of the buffer
+		m_mapped = m_graphics->mapBuffer(m_stagingBuffer);
+
+		// Blits are recorded from any thread, so they get a pool of their own
+		m_graphicsPool = m_graphics->getLogicalDevice().createCommandPool
+		(
+			vk::CommandPoolCreateInfo
+			(
+				vk::CommandPoolCreateFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer),
+				static_cast<uint32_t>(m_graphics->getQueueFamilyIndices().graphicsFamily)
+			)
+		);
+	}
+
+	uint64_t UploadManager::uploadBuffer(const void* data, vk::DeviceSize size, const vk::Buffer& buffer, vk::DeviceSize offset)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		vk::Buffer source = {};
+		vk::DeviceSize sourceOffset = 0;
+		stage(data, size, source, sourceOffset);
+		beginBatch();
+
+		vk::BufferCopy copyRegion = {};
+		copyRegion.setSrcOffset(sourceOffset);
+		copyRegion.setDstOffset(offset);
+		copyRegion.setSize(size);
+
+		m_pending.commandBuffer.copyBuffer(source, buffer, 1, &copyRegion);
+
+		return m_pendingValue;
+	}
+
+	uint64_t UploadManager::uploadImage
+	(
+		const void* data,
+		vk::DeviceSize layerSize,
+		const vk::Image& image,
+		uint32_t width,
+		uint32_t height,
+		uint32_t layerCount,
+		uint32_t mipLevels
+	)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// Size of every level (Each is a quarter of the one above, rounded down)
+		const vk::DeviceSize texelSize = layerSize / (static_cast<vk::DeviceSize>(width) * height);
+		vk::DeviceSize size = 0;
+
+		for (uint32_t i = 0; i < mipLevels; ++i)
+			size += texelSize * std::max(width >> i, 1u) * std::max(height >> i, 1u) * layerCount;
+
+		vk::Buffer source = {};
+		vk::DeviceSize sourceOffset = 0;
+		stage(data, size, source, sourceOffset);
+		beginBatch();
+
+		vk::ImageMemoryBarrier barrier = {};
+		barrier.setOldLayout(vk::ImageLayout::eUndefined);
+		barrier.setNewLayout(vk::ImageLayout::eTransferDstOptimal);
+		barrier.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+		barrier.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+		barrier.setImage(image);
+		barrier.setDstAccessMask(vk::AccessFlagBits::eTransferWrite);
+		barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = mipLevels;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = layerCount;
+
+		// Prepare image for copying
+		m_pending.commandBuffer.pipelineBarrier
+		(
+			vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,
+			(vk::DependencyFlagBits)0,
+			0, nullptr,
+			0, nullptr,
+			1, &barrier
+		);
+
+		// One copy per level covering every layer
+		std::vector<vk::BufferImageCopy> regions(mipLevels);
+		vk::DeviceSize levelOffset = sourceOffset;
+
+		for (uint32_t i = 0; i < mipLevels; ++i)
+		{
+			const uint32_t levelWidth = std::max(width >> i, 1u);
+			const uint32_t levelHeight = std::max(height >> i, 1u);
+
+			regions[i].setBufferOffset(levelOffset);
+			regions[i].setBufferRowLength(0);
+			regions[i].setBufferImageHeight(0);
+			regions[i].imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+			regions[i].imageSubresource.mipLevel = i;
+			regions[i].imageSubresource.baseArrayLayer = 0;
+			regions[i].imageSubresource.layerCount = layerCount;
+			regions[i].setImageOffset({ 0, 0, 0 });
+			regions[i].setImageExtent({ levelWidth, levelHeight, 1 });
+
+			levelOffset += texelSize * levelWidth * levelHeight * layerCount;
+		}
+
+		// Copy buffer to image
+		m_pending.commandBuffer.copyBufferToImage
+		(
+			source,
+			image,
+			vk::ImageLayout::eTransferDstOptimal,
+			static_cast<uint32_t>(regions.size()),
+			regions.data()
+		);
+
+		// The transfer queue can't wait on shader stages, so the batches fence is what
+		// orders the copy before any frame sampling the image
+		barrier.setOldLayout(vk::ImageLayout::eTransferDstOptimal);
+		barrier.setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+		barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+		barrier.setDstAccessMask((vk::AccessFlagBits)0);
+
+		m_pending.commandBuffer.pipelineBarrier
+		(
+			vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe,
+			(vk::DependencyFlagBits)0,
+			0, nullptr,
+			0, nullptr,
+			1, &barrier
+		);
+
+		return m_pendingValue;
+	}
+
+	uint64_t UploadManager::generateMipmaps
+	(
+		const vk::Image& image,
+		uint32_t width,
+		uint32_t height,
+		uint32_t mipLevels,
+		uint32_t layerCount
+	)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// The copies signal the semaphore even if level 0 went out with an earlier batch
+		beginBatch();
+		beginGraphicsBatch();
+
+		m_graphics->generateMipmaps(m_pending.graphicsCommandBuffer, image, width, height, mipLevels, layerCount);
+
+		return m_pendingValue;
+	}
+
+	uint64_t UploadManager::flush()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		submitBatch();
+
+		// Retire every batch that is done without blocking
+		while (retireBatch(false));
+
+		return m_pendingValue - 1;
+	}
+
+	void UploadManager::wait(uint64_t value)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (value >= m_pendingValue)
+			submitBatch();
+
+		while (m_completedValue.load() < value && retireBatch(true));
+	}
+
+	void UploadManager::free()
+	{
+		if (m_graphics && m_stagingBuffer.buffer)
+		{
+			// Finish every upload
+			wait(std::numeric_limits<uint64_t>::max());
+
+			vk::Device logicalDevice = m_graphics->getLogicalDevice();
+
+			for (auto& batch : m_freeBatches)
+			{
+				logicalDevice.freeCommandBuffers(m_graphics->getTransferPool(), 1, &batch.commandBuffer);
+				logicalDevice.destroyFence(batch.fence);
+
+				if (batch.semaphore)
+					logicalDevice.destroySemaphore(batch.semaphore);
+			}
+
+			m_freeBatches.clear();
+
+			// Frees the graphics command buffers too
+			logicalDevice.destroyCommandPool(m_graphicsPool);
+			m_graphicsPool = vk::CommandPool();
+
+			m_graphics->unmapBuffer(m_stagingBuffer);
+			m_graphics->destroyBuffer(m_stagingBuffer);
+			m_stagingBuffer = {};
+			m_mapped = nullptr;
+		}
+	}
+
+	void UploadManager::stage(const void* data, vk::DeviceSize size, vk::Buffer& buffer, vk::DeviceSize& offset)
+	{
+		// Too large for the ring buffer, so give it a buffer of its own
+		if (size > m_stagingSize)
+		{
+			Buffer stagingBuffer = m_graphics->createBuffer
+			(
+				size,
+				vk::BufferUsageFlagBits::eTransferSrc,
+				vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+			);
+
+			void* mapped = m_graphics->mapBuffer(stagingBuffer);
+			std::memcpy(mapped, data, static_cast<size_t>(size));
+			m_graphics->unmapBuffer(stagingBuffer);
+
+			m_pending.dedicatedBuffers.push_back(stagingBuffer);
+			buffer = stagingBuffer.buffer;
+			offset = 0;
+			return;
+		}
+
+		// Make room by waiting on older batches
+		while (!allocateStaging(size, offset))
+		{
+			// Only the pending batch is holding on to staging memory
+			if (m_inFlight.empty())
+				submitBatch();
+
+			const bool retired = retireBatch(true);
+			gAssert(retired);
+		}
+
+		std::memcpy(static_cast<char*>(m_mapped) + offset, data, static_cast<size_t>(size));
+		buffer = m_stagingBuffer.buffer;
+	}
+
+	bool UploadManager::allocateStaging(vk::DeviceSize size, vk::DeviceSize& offset)
+	{
+		// Start over when nothing is in use
+		if (m_used == 0)
+			m_head = 0;
+
+		vk::DeviceSize start = ((m_head + m_alignment - 1) / m_alignment) * m_alignment;
+		vk::DeviceSize padding = start - m_head;
+
+		// Wrap around (The end of the buffer is wasted until the batch is done)
+		if (start + size > m_stagingSize)
+		{
+			start = 0;
+			padding = m_stagingSize - m_head;
+		}
+
+		if (m_used + padding + size > m_stagingSize)
+			return false;
+
+		m_used += padding + size;
+		m_pending.stagingSize += padding + size;
+		m_head = start + size;
+		offset = start;
+		return true;
+	}
+
+	void UploadManager::beginBatch()
+	{
+		if (m_pending.commandBuffer)
+			return;
+
+		// Reuse a retired command buffer and fence if possible
+		if (!m_freeBatches.empty())
+		{
+			m_pending.commandBuffer = m_freeBatches.back().commandBuffer;
+			m_pending.graphicsCommandBuffer = m_freeBatches.back().graphicsCommandBuffer;
+			m_pending.semaphore = m_freeBatches.back().semaphore;
+			m_pending.fence = m_freeBatches.back().fence;
+			m_freeBatches.pop_back();
+		}
+		else
+		{
+			vk::CommandBufferAllocateInfo allocInfo = {};
+			allocInfo.setLevel(vk::CommandBufferLevel::ePrimary);
+			allocInfo.setCommandPool(m_graphics->getTransferPool());
+			allocInfo.setCommandBufferCount(1);
+
+			m_pending.commandBuffer = m_graphics->getLogicalDevice().allocateCommandBuffers(allocInfo)[0];
+			m_pending.fence = m_graphics->getLogicalDevice().createFence({});
+		}
+
+		vk::CommandBufferBeginInfo beginInfo = {};
+		beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+
+		m_pending.commandBuffer.begin(beginInfo);
+	}
+
+	void UploadManager::beginGraphicsBatch()
+	{
+		gAssert(m_pending.commandBuffer);
+
+		if (m_pending.graphicsRecording)
+			return;
+
+		// Reused batches may not have blitted before
+		if (!m_pending.graphicsCommandBuffer)
+		{
+			vk::CommandBufferAllocateInfo allocInfo = {};
+			allocInfo.setLevel(vk::CommandBufferLevel::ePrimary);
+			allocInfo.setCommandPool(m_graphicsPool);
+			allocInfo.setCommandBufferCount(1);
+
+			m_pending.graphicsCommandBuffer = m_graphics->getLogicalDevice().allocateCommandBuffers(allocInfo)[0];
+			m_pending.semaphore = m_graphics->getLogicalDevice().createSemaphore({});
+		}
+
+		vk::CommandBufferBeginInfo beginInfo = {};
+		beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+
+		m_pending.graphicsCommandBuffer.begin(beginInfo);
+		m_pending.graphicsRecording = true;
+	}
+
+	void UploadManager::submitBatch()
+	{
+		if (!m_pending.commandBuffer)
+			return;
+
+		m_pending.commandBuffer.end();
+
+		vk::SubmitInfo submitInfo = {};
+		submitInfo.setCommandBufferCount(1);
+		submitInfo.setPCommandBuffers(&m_pending.commandBuffer);
+
+		if (m_pending.graphicsRecording)
+		{
+			m_pending.graphicsCommandBuffer.end();
+
+			// The blits start once the copies are done, so their fence covers the whole batch
+			submitInfo.setSignalSemaphoreCount(1);
+			submitInfo.setPSignalSemaphores(&m_pending.semaphore);
+
+			m_graphics->getTransferQueue().submit(1, &submitInfo, { nullptr });
+
+			const vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eTransfer;
+
+			vk::SubmitInfo graphicsSubmitInfo = {};
+			graphicsSubmitInfo.setWaitSemaphoreCount(1);
+			graphicsSubmitInfo.setPWaitSemaphores(&m_pending.semaphore);
+			graphicsSubmitInfo.setPWaitDstStageMask(&waitStage);
+			graphicsSubmitInfo.setCommandBufferCount(1);
+			graphicsSubmitInfo.setPCommandBuffers(&m_pending.graphicsCommandBuffer);
+
+			m_graphics->getGraphicsQueue().submit(1, &graphicsSubmitInfo, m_pending.fence);
+		}
+		else
+			m_graphics->getTransferQueue().submit(1, &submitInfo, m_pending.fence);
+
+		m_pending.value = m_pendingValue++;
+		m_inFlight.push_back(std::move(m_pending));
+		m_pending = {};
+	}
+
+	bool UploadManager::retireBatch(bool block)
+	{
+		if (m_inFlight.empty())
+			return false;
+
+		vk::Device logicalDevice = m_graphics->getLogicalDevice();
+		Batch& batch = m_inFlight.front();
+
+		if (block)
+			logicalDevice.waitForFences(1, &batch.fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+		else if (logicalDevice.getFenceStatus(batch.fence) != vk::Result::eSuccess)
+			return false;
+
+		// Batches finish in submission order, so their staging memory is freed in order too
+		m_used -= batch.stagingSize;
+
+		for (const auto& stagingBuffer : batch.dedicatedBuffers)
+			m_graphics->destroyBuffer(stagingBuffer);
+
+		logicalDevice.resetFences(1, &batch.fence);
+		m_completedValue = batch.value;
+
+		Batch retired = {};
+		retired.commandBuffer = batch.commandBuffer;
+		retired.graphicsCommandBuffer = batch.graphicsCommandBuffer;
+		retired.semaphore = batch.semaphore;
+		retired.fence = batch.fence;
+		m_freeBatches.push_back(retired);
+
+		m_inFlight.pop_front();
+		return true;
+	}
+}
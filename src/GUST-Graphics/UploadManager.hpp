@@ -0,0 +1,260 @@
+#pragma once
+
+/**
+ * @file UploadManager.hpp
+ * @brief Upload manager header file.
+ * @author Connor J. Bramham (ReeCocho)
+ */
+
+/** Includes. */
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include "Vulkan.hpp"
+
+/**
+ * @def GUST_STAGING_BUFFER_SIZE
+ * @brief Size of the staging ring buffer uploads are copied through.
+ */
+#define GUST_STAGING_BUFFER_SIZE (64 * 1024 * 1024)
+
+namespace gust
+{
+	class Graphics;
+
+	/**
+	 * @class UploadManager
+	 * @brief Batches copies into device local buffers and images on the transfer queue.
+	 * @note Source data is written to a persistently mapped staging ring buffer and every copy
+	 * and layout transition made between flushes is recorded into a single command buffer.
+	 * Mip chains are blitted in a graphics queue command buffer that waits on the copies with a semaphore.
+	 * Each batch is given an increasing value which is complete once the batches fence is signaled.
+	 */
+	class UploadManager
+	{
+	public:
+
+		/**
+		 * @brief Default constructor.
+		 */
+		UploadManager() = default;
+
+		/**
+		 * @brief Constructor.
+		 * @param Graphics context.
+		 * @param Size of the staging ring buffer in bytes.
+		 */
+		UploadManager(Graphics* graphics, vk::DeviceSize stagingSize = GUST_STAGING_BUFFER_SIZE);
+
+		/**
+		 * @brief Default destructor.
+		 */
+		~UploadManager() = default;
+
+		/**
+		 * @brief Copy data into a buffer.
+		 * @param Data.
+		 * @param Size of data in bytes.
+		 * @param Destination buffer.
+		 * @param Offset into the destination buffer.
+		 * @return Value the copy is complete at.
+		 * @note Thread safe.
+		 */
+		uint64_t uploadBuffer(const void* data, vk::DeviceSize size, const vk::Buffer& buffer, vk::DeviceSize offset = 0);
+
+		/**
+		 * @brief Copy pixels into an image and prepare it for shader access.
+		 * @param Pixel data (Each mip level follows the one above it. Layers are tightly packed.)
+		 * @param Size of each layer of the first mip level in bytes.
+		 * @param Destination image (Must be in an undefined layout.)
+		 * @param Image width.
+		 * @param Image height.
+		 * @param Number of layers.
+		 * @param Number of mip levels in the pixel data (Levels below are left untouched.)
+		 * @return Value the copy is complete at.
+		 * @note Thread safe.
+		 */
+		uint64_t uploadImage
+		(
+			const void* data,
+			vk::DeviceSize layerSize,
+			const vk::Image& image,
+			uint32_t width,
+			uint32_t height,
+			uint32_t layerCount = 1,
+			uint32_t mipLevels = 1
+		);
+
+		/**
+		 * @brief Fill an images mip chain by blitting each level down from the one above it.
+		 * @param Image (Level 0 uploaded by uploadImage() and the rest undefined. Needs transfer source and destination usage.)
+		 * @param Image width.
+		 * @param Image height.
+		 * @param Number of mip levels.
+		 * @param Number of layers.
+		 * @return Value the mip chain is complete at.
+		 * @note Blits need a graphics queue, so they are submitted there after the batches copies.
+		 * Every level is left ready for shaders.
+		 * @note Renderer::render() flushes pending batches at the start of each frame, before recording anything that
+		 * samples them. The graphics submit waits on the batches transfer semaphore, so that flush is what orders the
+		 * blits after the copies and before the frames draws.
+		 * @note Thread safe, but the graphics queue isn't locked, so don't flush or wait from another thread during Renderer::render().
+		 */
+		uint64_t generateMipmaps
+		(
+			const vk::Image& image,
+			uint32_t width,
+			uint32_t height,
+			uint32_t mipLevels,
+			uint32_t layerCount = 1
+		);
+
+		/**
+		 * @brief Submit every upload made since the last flush and retire finished batches.
+		 * @return Value of the submitted batch.
+		 * @note Thread safe.
+		 */
+		uint64_t flush();
+
+		/**
+		 * @brief Block until uploads are complete.
+		 * @param Value returned by an upload.
+		 * @note Thread safe.
+		 */
+		void wait(uint64_t value);
+
+		/**
+		 * @brief Check if uploads are complete.
+		 * @param Value returned by an upload.
+		 * @return If the uploads are complete.
+		 * @note Completion is only observed by flush() and wait().
+		 */
+		inline bool isComplete(uint64_t value) const
+		{
+			return value <= m_completedValue.load();
+		}
+
+		/**
+		 * @brief Free memory.
+		 * @note Used internally. Do not call.
+		 */
+		void free();
+
+	private:
+
+		/**
+		 * @struct Batch
+		 * @brief Uploads submitted together.
+		 */
+		struct Batch
+		{
+			/** Command buffer the uploads are recorded into. */
+			vk::CommandBuffer commandBuffer = {};
+
+			/** Graphics queue command buffer the blits are recorded into. */
+			vk::CommandBuffer graphicsCommandBuffer = {};
+
+			/** Were blits recorded since the batch began? */
+			bool graphicsRecording = false;
+
+			/** Semaphore the copies signal for the blits to wait on. */
+			vk::Semaphore semaphore = {};
+
+			/** Fence signaled once the batch is done (Signaled by the blits when there are any.) */
+			vk::Fence fence = {};
+
+			/** Value of the batch. */
+			uint64_t value = 0;
+
+			/** Bytes of the staging ring buffer used by the batch. */
+			vk::DeviceSize stagingSize = 0;
+
+			/** Staging buffers for uploads too large for the ring buffer. */
+			std::vector<Buffer> dedicatedBuffers = {};
+		};
+
+		/**
+		 * @brief Copy data into staging memory.
+		 * @param Data.
+		 * @param Size of data in bytes.
+		 * @param Buffer the data was copied to.
+		 * @param Offset into the buffer.
+		 */
+		void stage(const void* data, vk::DeviceSize size, vk::Buffer& buffer, vk::DeviceSize& offset);
+
+		/**
+		 * @brief Allocate space in the staging ring buffer.
+		 * @param Size in bytes.
+		 * @param Offset into the staging ring buffer.
+		 * @return If there was enough space.
+		 */
+		bool allocateStaging(vk::DeviceSize size, vk::DeviceSize& offset);
+
+		/**
+		 * @brief Start recording the pending batch if it isn't already.
+		 */
+		void beginBatch();
+
+		/**
+		 * @brief Start recording blits into the pending batch if it isn't already.
+		 */
+		void beginGraphicsBatch();
+
+		/**
+		 * @brief Submit the pending batch if anything was recorded.
+		 */
+		void submitBatch();
+
+		/**
+		 * @brief Retire the oldest batch in flight.
+		 * @param Should we block until it is done?
+		 * @return If a batch was retired.
+		 */
+		bool retireBatch(bool block);
+
+
+
+		/** Graphics context. */
+		Graphics* m_graphics = nullptr;
+
+		/** Command pool for blits on the graphics queue. */
+		vk::CommandPool m_graphicsPool = {};
+
+		/** Staging ring buffer. */
+		Buffer m_stagingBuffer = {};
+
+		/** Mapped staging memory. */
+		void* m_mapped = nullptr;
+
+		/** Size of the staging ring buffer. */
+		vk::DeviceSize m_stagingSize = 0;
+
+		/** Alignment of every staging allocation. */
+		vk::DeviceSize m_alignment = 0;
+
+		/** Next free byte in the staging ring buffer. */
+		vk::DeviceSize m_head = 0;
+
+		/** Bytes of the staging ring buffer used by batches that aren't done. */
+		vk::DeviceSize m_used = 0;
+
+		/** Batch being recorded. */
+		Batch m_pending = {};
+
+		/** Value the pending batch will be given. */
+		uint64_t m_pendingValue = 1;
+
+		/** Batches submitted, oldest first. */
+		std::deque<Batch> m_inFlight = {};
+
+		/** Retired command buffers, semaphores and fences to reuse. */
+		std::vector<Batch> m_freeBatches = {};
+
+		/** Value of the most recent batch known to be done. */
+		std::atomic<uint64_t> m_completedValue = { 0 };
+
+		/** Mutex. */
+		std::mutex m_mutex = {};
+	};
+}
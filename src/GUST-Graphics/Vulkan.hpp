@@ -29,8 +29,8 @@ namespace gust
 	 */
 	struct Buffer
 	{
-		/** Memory. */
-		vk::DeviceMemory memory = {};
+		/** Memory allocation. */
+		VmaAllocation allocation = VK_NULL_HANDLE;
 
 		/** Buffer. */
 		vk::Buffer buffer = {};
@@ -63,6 +63,14 @@ namespace gust
 
 		/** Just the model matrix. */
 		glm::mat4 model = glm::mat4();
+
+#ifdef GUST_COMPRESSED_VERTICES
+		/** Scale that dequantizes the meshes positions. */
+		glm::vec4 positionScale = glm::vec4(1.0f);
+
+		/** Bias that dequantizes the meshes positions. */
+		glm::vec4 positionBias = glm::vec4(0.0f);
+#endif
 	};
 
 
@@ -101,7 +109,7 @@ namespace gust
 	struct FrameBufferAttachment 
 	{
 		vk::Image image = {};
-		vk::DeviceMemory memory = {};
+		VmaAllocation allocation = VK_NULL_HANDLE;
 		vk::ImageView view = {};
 		vk::Format format;
 	};
@@ -2,6 +2,7 @@
 #include <Engine.hpp>
 #include <Transform.hpp>
 #include <MeshRenderer.hpp>
+#include <LODGroup.hpp>
 #include <Camera.hpp>
 #include <Lights.hpp>
 #include <RigidBody.hpp>
@@ -198,21 +199,30 @@ int main()
 		gust::scene.addSystem<gust::PointLightSystem>();
 		gust::scene.addSystem<gust::DirectionalLightSystem>();
 		gust::scene.addSystem<gust::SpotLightSystem>();
+		gust::scene.addSystem<gust::LODGroupSystem>();
 		gust::scene.addSystem<gust::MeshRendererSystem>();
 		gust::scene.addSystem<gust::CameraSystem>();
 	}
 
-	// Create shaders
-	auto shader = gust::resourceManager.createShader
-	(
-		"./Shaders/standard-vert.spv",
-		"./Shaders/standard-frag.spv",
-		sizeof(gust::EmptyVertexData),
-		sizeof(TestData),
-		5,
-		true,
-		true
-	);
+	// Create shaders (Bindless shaders read textures and material data from the descriptor heap)
+	const bool bindless = gust::graphics.isBindless();
+
+	gust::ShaderDescription standardDescription = {};
+	standardDescription.vertexPath = bindless ? "./Shaders/standard_bindless" GUST_VERTEX_SHADER_SUFFIX : "./Shaders/standard" GUST_VERTEX_SHADER_SUFFIX;
+	standardDescription.fragmentPath = bindless ? "./Shaders/standard_bindless-frag.spv" : "./Shaders/standard-frag.spv";
+	standardDescription.vertexDataSize = sizeof(gust::EmptyVertexData);
+	standardDescription.fragmentDataSize = sizeof(TestData);
+	standardDescription.textureCount = 5;
+	standardDescription.depthTesting = true;
+	standardDescription.lighting = true;
+	standardDescription.instancedVertexPath = bindless ? "" : "./Shaders/standard_instanced" GUST_VERTEX_SHADER_SUFFIX;
+
+	// Every shader is created in one batch, so their pipelines are built in parallel
+	const auto shaders = gust::resourceManager.createShaders({ standardDescription });
+	auto shader = shaders[0];
+
+	// Includes the engines own pipelines (Much lower once the pipeline cache is warm)
+	std::cout << "Pipelines created in " << gust::graphics.getPipelineCreationTime() << "s\n";
 
 	// Create textures
 	auto floor_n = gust::resourceManager.createTexture("./Textures/BrickFloor_n.png", vk::Filter::eLinear);
@@ -262,9 +272,16 @@ int main()
 	pom_mat->setFragmentData<TestData>(data);
 
 	// Create meshes
-	auto cube_mesh = gust::resourceManager.createMesh("./Meshes/Cube.obj");
-	auto sphere_mesh = gust::resourceManager.createMesh("./Meshes/Sphere.obj");
-	auto capsuleWall_mesh = gust::resourceManager.createMesh("./Meshes/CapsuleWall.obj");
+	auto cube_mesh = gust::resourceManager.createMesh("./Meshes/Cube.gmesh");
+	auto sphere_mesh = gust::resourceManager.createMesh("./Meshes/Sphere.gmesh", true);
+	auto capsuleWall_mesh = gust::resourceManager.createMesh("./Meshes/CapsuleWall.gmesh");
+
+	// Spheres are culled a meshlet at a time on the GPU, so the halves facing away aren't drawn
+	sphere_mesh->buildMeshlets();
+
+	// Vertices transformed per triangle before and after reordering at load
+	for (const auto& mesh : { cube_mesh, sphere_mesh, capsuleWall_mesh })
+		std::cout << "ACMR " << mesh->getOptimizationStats().acmrBefore << " -> " << mesh->getOptimizationStats().acmrAfter << '\n';
 
 	// Create floor
 	{
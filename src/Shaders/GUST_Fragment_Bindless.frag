@@ -0,0 +1,48 @@
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+#extension GL_EXT_nonuniform_qualifier : enable
+
+layout(location = 0) in vec3 GUST_NORMAL;
+layout(location = 1) in vec3 GUST_FRAG_POS;
+layout(location = 2) in vec2 GUST_UV;
+layout(location = 3) in vec3 GUST_TANGENT;
+layout(location = 4) in vec3 GUST_BITANGENT;
+
+layout(location = 0) out vec4 GUST_OUT_POSITION;
+layout(location = 1) out vec4 GUST_OUT_NORMAL;
+layout(location = 2) out vec4 GUST_OUT_COLOR;
+layout(location = 3) out vec4 GUST_OUT_MISC;
+
+#define GUST_OUT_ROUGHNESS GUST_OUT_MISC.r
+#define GUST_OUT_METALLIC GUST_OUT_MISC.g
+#define GUST_OUT_AO GUST_OUT_MISC.b
+
+// Every texture in the descriptor heap
+layout(set = 0, binding = 0) uniform sampler2D GUST_TEXTURES[];
+
+// Material data in the descriptor heap (Mirrors gust::BindlessMaterialData)
+struct GUST_MATERIAL_DATA
+{
+	uint TEXTURES[8];
+	vec4 VERTEX_DATA[4];
+	vec4 FRAGMENT_DATA[10];
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer GUST_MATERIALS
+{
+	GUST_MATERIAL_DATA DATA[];
+} GUST_MATERIAL_HEAP;
+
+layout(std140, set = 1, binding = 2) uniform GUST_FRAG_DATA
+{
+	layout(offset = 0) vec4 VIEW_POSITION;
+} GUST_DATA;
+
+layout(push_constant) uniform GUST_DRAW_CONSTANTS
+{
+	uint DRAW;
+	uint MATERIAL;
+} GUST_CONSTANTS;
+
+#define GUST_MATERIAL GUST_MATERIAL_HEAP.DATA[GUST_CONSTANTS.MATERIAL]
+#define GUST_TEXTURE(i) GUST_TEXTURES[GUST_MATERIAL.TEXTURES[i]]
\ No newline at end of file
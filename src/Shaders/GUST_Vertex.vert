@@ -1,17 +1,21 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
 
-layout(location = 0) in vec3 IN_POSITION;
-layout(location = 1) in vec2 IN_UV;
-layout(location = 2) in vec3 IN_NORMAL;
-layout(location = 3) in vec3 IN_TANGENT;
+#include "GUST_Vertex_Input.vert"
 
 layout(std140, set = 0, binding = 0) uniform GUST_VERT_DATA
 {
 	layout(offset = 0) mat4 MVP;
 	layout(offset = 64) mat4 MODEL;
+#ifdef GUST_COMPRESSED_VERTICES
+	layout(offset = 128) vec4 POSITION_SCALE;
+	layout(offset = 144) vec4 POSITION_BIAS;
+#endif
 } GUST_DATA;
 
+#define GUST_POSITION_SCALE GUST_DATA.POSITION_SCALE
+#define GUST_POSITION_BIAS GUST_DATA.POSITION_BIAS
+
 layout(location = 0) out vec3 GUST_NORMAL;
 layout(location = 1) out vec3 GUST_FRAG_POS;
 layout(location = 2) out vec2 GUST_UV;
@@ -0,0 +1,65 @@
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+#include "GUST_Vertex_Input.vert"
+
+// Material data in the descriptor heap (Mirrors gust::BindlessMaterialData)
+struct GUST_MATERIAL_DATA
+{
+	uint TEXTURES[8];
+	vec4 VERTEX_DATA[4];
+	vec4 FRAGMENT_DATA[10];
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer GUST_MATERIALS
+{
+	GUST_MATERIAL_DATA DATA[];
+} GUST_MATERIAL_HEAP;
+
+// Per draw data (Mirrors gust::InstanceData)
+struct GUST_DRAW
+{
+	mat4 MODEL;
+#ifdef GUST_COMPRESSED_VERTICES
+	vec4 POSITION_SCALE;
+	vec4 POSITION_BIAS;
+	vec4 PADDING[2];
+#endif
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer GUST_DRAWS
+{
+	GUST_DRAW DATA[];
+} GUST_DRAW_DATA;
+
+layout(std140, set = 1, binding = 1) uniform GUST_VERT_CAMERA_DATA
+{
+	layout(offset = 0) mat4 VIEW_PROJECTION;
+	layout(offset = 64) mat4 UNUSED;
+} GUST_CAMERA_DATA;
+
+layout(push_constant) uniform GUST_DRAW_CONSTANTS
+{
+	uint DRAW;
+	uint MATERIAL;
+} GUST_CONSTANTS;
+
+// Lets bindless shaders be written exactly like regular ones
+struct GUST_VERT_DATA
+{
+	mat4 MVP;
+	mat4 MODEL;
+};
+
+#define GUST_CURRENT_DRAW GUST_DRAW_DATA.DATA[GUST_CONSTANTS.DRAW + gl_InstanceIndex]
+#define GUST_MODEL GUST_CURRENT_DRAW.MODEL
+#define GUST_POSITION_SCALE GUST_CURRENT_DRAW.POSITION_SCALE
+#define GUST_POSITION_BIAS GUST_CURRENT_DRAW.POSITION_BIAS
+#define GUST_DATA GUST_VERT_DATA(GUST_CAMERA_DATA.VIEW_PROJECTION * GUST_MODEL, GUST_MODEL)
+#define GUST_MATERIAL GUST_MATERIAL_HEAP.DATA[GUST_CONSTANTS.MATERIAL]
+
+layout(location = 0) out vec3 GUST_NORMAL;
+layout(location = 1) out vec3 GUST_FRAG_POS;
+layout(location = 2) out vec2 GUST_UV;
+layout(location = 3) out vec3 GUST_TANGENT;
+layout(location = 4) out vec3 GUST_BITANGENT;
\ No newline at end of file
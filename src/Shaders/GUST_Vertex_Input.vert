@@ -0,0 +1,35 @@
+#ifdef GUST_COMPRESSED_VERTICES
+
+// Mirrors gust::PackedVertex (Unorm positions and half float UVs are decoded by the input assembler)
+layout(location = 0) in vec4 IN_PACKED_POSITION;
+layout(location = 1) in vec2 IN_UV;
+layout(location = 2) in vec2 IN_PACKED_NORMAL;
+layout(location = 3) in vec2 IN_PACKED_TANGENT;
+
+// Unfold an octahedral encoded unit vector
+vec3 GUST_OCTAHEDRAL_DECODE(vec2 encoded)
+{
+	vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float t = max(-n.z, 0.0);
+	n.x += n.x >= 0.0 ? -t : t;
+	n.y += n.y >= 0.0 ? -t : t;
+	return normalize(n);
+}
+
+// Positions are relative to the meshes bounding box (The including file defines GUST_POSITION_SCALE and GUST_POSITION_BIAS)
+#define IN_POSITION (GUST_POSITION_BIAS.xyz + IN_PACKED_POSITION.xyz * GUST_POSITION_SCALE.xyz)
+#define IN_NORMAL GUST_OCTAHEDRAL_DECODE(IN_PACKED_NORMAL)
+#define IN_TANGENT GUST_OCTAHEDRAL_DECODE(IN_PACKED_TANGENT)
+#define IN_TANGENT_SIGN (IN_PACKED_POSITION.w * 2.0 - 1.0)
+
+#else
+
+// Mirrors gust::Vertex
+layout(location = 0) in vec3 IN_POSITION;
+layout(location = 1) in vec2 IN_UV;
+layout(location = 2) in vec3 IN_NORMAL;
+layout(location = 3) in vec3 IN_TANGENT;
+
+#define IN_TANGENT_SIGN 1.0
+
+#endif
\ No newline at end of file
@@ -0,0 +1,37 @@
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+#include "GUST_Vertex_Input.vert"
+
+// Per instance model matrix (Locations 4 to 7)
+layout(location = 4) in mat4 IN_MODEL;
+
+#ifdef GUST_COMPRESSED_VERTICES
+// Per instance position dequantization (Locations 8 and 9)
+layout(location = 8) in vec4 IN_POSITION_SCALE;
+layout(location = 9) in vec4 IN_POSITION_BIAS;
+#endif
+
+#define GUST_POSITION_SCALE IN_POSITION_SCALE
+#define GUST_POSITION_BIAS IN_POSITION_BIAS
+
+layout(std140, set = 0, binding = 0) uniform GUST_VERT_INSTANCE_DATA
+{
+	layout(offset = 0) mat4 VIEW_PROJECTION;
+	layout(offset = 64) mat4 UNUSED;
+} GUST_INSTANCE_DATA;
+
+// Lets instanced shaders be written exactly like non-instanced ones
+struct GUST_VERT_DATA
+{
+	mat4 MVP;
+	mat4 MODEL;
+};
+
+#define GUST_DATA GUST_VERT_DATA(GUST_INSTANCE_DATA.VIEW_PROJECTION * IN_MODEL, IN_MODEL)
+
+layout(location = 0) out vec3 GUST_NORMAL;
+layout(location = 1) out vec3 GUST_FRAG_POS;
+layout(location = 2) out vec2 GUST_UV;
+layout(location = 3) out vec3 GUST_TANGENT;
+layout(location = 4) out vec3 GUST_BITANGENT;
\ No newline at end of file
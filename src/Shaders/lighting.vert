@@ -2,10 +2,15 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
 
+#ifdef GUST_COMPRESSED_VERTICES
+// The screen quads corners are its UVs moved to clip space, so positions needn't be dequantized
+layout(location = 1) in vec2 inUV;
+#else
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec2 inUV;
 layout(location = 2) in vec3 inNormal;
 layout(location = 3) in vec3 inTangent;
+#endif
 
 out gl_PerVertex 
 {
@@ -19,6 +24,10 @@ layout(location = 0) out VS_OUT
 
 void main()
 {
+#ifdef GUST_COMPRESSED_VERTICES
+	gl_Position = vec4(inUV * 2.0 - 1.0, 0.0, 1.0);
+#else
     gl_Position = vec4(inPosition, 1.0f);
+#endif
 	vsOut.uv = inUV;
 }
\ No newline at end of file
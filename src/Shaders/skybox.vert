@@ -1,11 +1,9 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
+#extension GL_GOOGLE_include_directive : require
 
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec2 inUV;
-layout(location = 2) in vec3 inNormal;
-layout(location = 3) in vec3 inTangent;
+#include "GUST_Vertex_Input.vert"
 
 out gl_PerVertex 
 {
@@ -20,15 +18,22 @@ layout(std140, set = 0, binding = 0) uniform UBO
 {
 	layout(offset = 0) mat4 MVP;
 	layout(offset = 64) mat4 Model;
+#ifdef GUST_COMPRESSED_VERTICES
+	layout(offset = 128) vec4 PositionScale;
+	layout(offset = 144) vec4 PositionBias;
+#endif
 } ubo;
 
+#define GUST_POSITION_SCALE ubo.PositionScale
+#define GUST_POSITION_BIAS ubo.PositionBias
+
 void main()
 {
-	normal = inNormal;
-	position = vec3(ubo.Model * vec4(inPosition, 1.0));
+	normal = IN_NORMAL;
+	position = vec3(ubo.Model * vec4(IN_POSITION, 1.0));
 
-	uvw = inPosition;
+	uvw = IN_POSITION;
 	uvw.x *= -1.0;
   
-	gl_Position = ubo.MVP * vec4(inPosition, 1.0);
+	gl_Position = ubo.MVP * vec4(IN_POSITION, 1.0);
 }
\ No newline at end of file
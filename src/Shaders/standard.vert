@@ -1,4 +1,5 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
 #include "GUST_Vertex.vert"
 
@@ -15,5 +16,5 @@ void main()
 	GUST_FRAG_POS = vec3(GUST_DATA.MODEL * vec4(IN_POSITION, 1.0));
 	GUST_UV = IN_UV;
 	GUST_TANGENT = tangent;
-	GUST_BITANGENT = cross(normal, tangent);
+	GUST_BITANGENT = cross(normal, tangent) * IN_TANGENT_SIGN;
 }
\ No newline at end of file
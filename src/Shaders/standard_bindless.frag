@@ -0,0 +1,39 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "GUST_Fragment_Bindless.frag"
+
+// Textures in the order they are set on the material
+#define tex GUST_TEXTURE(0)
+#define normal_map GUST_TEXTURE(1)
+#define metallic_map GUST_TEXTURE(2)
+#define ao_map GUST_TEXTURE(3)
+#define roughness_map GUST_TEXTURE(4)
+
+void main()
+{
+	// UV scale is the materials fragment data
+	vec2 uv = GUST_UV * GUST_MATERIAL.FRAGMENT_DATA[0].xy;
+
+	// Color
+	vec3 color = texture(tex, uv).rgb;
+	
+	// Metallic
+	GUST_OUT_METALLIC = texture(metallic_map, uv).r;
+	
+	// Roughness
+	GUST_OUT_ROUGHNESS = texture(roughness_map, uv).r;
+	
+	// AO
+	GUST_OUT_AO = texture(ao_map, uv).r;
+	
+	// Normal
+	mat3 TBN = mat3(GUST_TANGENT, GUST_BITANGENT, GUST_NORMAL);
+	vec3 normal = texture(normal_map, uv).rgb;
+	normal = normalize(normal * 2.0 - 1.0);
+	normal = normalize(TBN * normal);
+	
+	GUST_OUT_COLOR = vec4(color, 1.0);
+	GUST_OUT_NORMAL = vec4(normal, 1.0);
+	GUST_OUT_POSITION = vec4(GUST_FRAG_POS, 1.0);
+}
\ No newline at end of file